@@ -471,6 +471,15 @@ struct MapCompilerOptions
     /// <summary> Maximum num of parallel threads. </summary>
     int maxThreads = 4;
 
+    /// <summary> Let idle thread pool workers steal tasks from busy ones. </summary>
+    bool useWorkStealing = false;
+
+    /// <summary> Compute independent branches of the model concurrently (if parallelization enabled). </summary>
+    bool parallelizeBranches = false;
+
+    /// <summary> Keep model state in a context allocated by each caller, so the compiled model can be called from multiple threads (can't be used with parallelize). </summary>
+    bool threadSafe = false;
+
     /// <summary> Allow emitting more efficient code that isn't necessarily IEEE-754 compatible. </summary>
     bool useFastMath = true;
 
@@ -498,6 +507,12 @@ struct MapCompilerOptions
 
     /// <summary> Skip ELLCode optimization. </summary>
     bool skip_ellcode = false;
+
+    /// <summary> Time candidate loop nest schedules missing from the schedule tuning cache, and use the fastest. </summary>
+    bool tuneSchedules = false;
+
+    /// <summary> File that holds the fastest measured loop nest schedules. </summary>
+    std::string scheduleTuningCache;
 };
 
 //
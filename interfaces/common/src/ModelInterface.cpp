@@ -952,6 +952,9 @@ CompiledMap Map::Compile(const std::string& targetDevice, const std::string& mod
     settings.compilerSettings.parallelize = compilerSettings.parallelize;
     settings.compilerSettings.useThreadPool = compilerSettings.useThreadPool;
     settings.compilerSettings.maxThreads = compilerSettings.maxThreads;
+    settings.compilerSettings.useWorkStealing = compilerSettings.useWorkStealing;
+    settings.parallelizeBranches = compilerSettings.parallelizeBranches;
+    settings.compilerSettings.threadSafe = compilerSettings.threadSafe;
     settings.compilerSettings.useFastMath = compilerSettings.useFastMath;
     settings.compilerSettings.includeDiagnosticInfo = compilerSettings.includeDiagnosticInfo;
     settings.compilerSettings.useBlas = compilerSettings.useBlas;
@@ -961,6 +964,8 @@ CompiledMap Map::Compile(const std::string& targetDevice, const std::string& mod
     settings.compilerSettings.vectorWidth = compilerSettings.vectorWidth;
     settings.compilerSettings.debug = compilerSettings.debug;
     settings.compilerSettings.skip_ellcode = compilerSettings.skip_ellcode;
+    settings.compilerSettings.tuneSchedules = compilerSettings.tuneSchedules;
+    settings.compilerSettings.scheduleTuningCache = compilerSettings.scheduleTuningCache;
 
     ell::model::ModelOptimizerOptions optimizerOptions;
     optimizerOptions["fuseLinearFunctionNodes"] = optimizerSettings.fuseLinearFunctionNodes;
@@ -0,0 +1,24 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ArchiveFormat.h (common)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+namespace ell
+{
+namespace common
+{
+    /// <summary> The formats that models and maps can be saved in. </summary>
+    enum class ArchiveFormat
+    {
+        /// <summary> Human-readable JSON, written by `utilities::JsonArchiver`. </summary>
+        json,
+
+        /// <summary> Compact binary, written by `utilities::BinaryArchiver`. Faster to load than JSON. </summary>
+        binary
+    };
+} // namespace common
+} // namespace ell
@@ -49,6 +49,16 @@ namespace common
     /// <returns> The data iterator. </returns>
     data::AutoSupervisedMultiClassExampleIterator GetAutoSupervisedMultiClassExampleIterator(std::istream& stream);
 
+    /// <summary>
+    /// Gets an AutoSupervisedExampleIterator iterator over the examples in a file, which can be either a text file or
+    /// a binary dataset file (see data::BinaryDataset). The iterator keeps the file open until it's destroyed.
+    /// </summary>
+    ///
+    /// <param name="filepath"> The path of the file to load data from. </param>
+    ///
+    /// <returns> The data iterator. </returns>
+    data::AutoSupervisedExampleIterator GetAutoSupervisedExampleIterator(const std::string& filepath);
+
     /// <summary> Gets an AutoSupervisedDataset dataset from data load arguments. </summary>
     ///
     /// <param name="stream"> Input stream to load data from. </param>
@@ -63,6 +73,50 @@ namespace common
     /// <returns> The dataset. </returns>
     data::AutoSupervisedMultiClassDataset GetMultiClassDataset(std::istream& stream);
 
+    /// <summary>
+    /// Gets an AutoSupervisedDataset dataset from an input stream, parsing it on several threads. The text is split
+    /// into chunks at line boundaries and the examples are in the same order as they are in the text.
+    /// </summary>
+    ///
+    /// <param name="stream"> Input stream to load data from. </param>
+    /// <param name="numThreads"> The number of threads to parse with, or 0 to use one per hardware thread. </param>
+    ///
+    /// <returns> The dataset. </returns>
+    data::AutoSupervisedDataset GetDataset(std::istream& stream, size_t numThreads);
+
+    /// <summary>
+    /// Gets a multiclass dataset from an input stream, parsing it on several threads. The text is split into chunks
+    /// at line boundaries and the examples are in the same order as they are in the text.
+    /// </summary>
+    ///
+    /// <param name="stream"> Input stream to load data from. </param>
+    /// <param name="numThreads"> The number of threads to parse with, or 0 to use one per hardware thread. </param>
+    ///
+    /// <returns> The dataset. </returns>
+    data::AutoSupervisedMultiClassDataset GetMultiClassDataset(std::istream& stream, size_t numThreads);
+
+    /// <summary>
+    /// Gets an AutoSupervisedDataset dataset from a file, which can be either a text file or a binary dataset file
+    /// (see data::BinaryDataset). The file is memory-mapped, and text is parsed on several threads straight out of the mapping.
+    /// </summary>
+    ///
+    /// <param name="filepath"> The path of the file to load data from. </param>
+    /// <param name="numThreads"> The number of threads to parse text with, or 0 to use one per hardware thread. </param>
+    ///
+    /// <returns> The dataset. </returns>
+    data::AutoSupervisedDataset GetDataset(const std::string& filepath, size_t numThreads = 0);
+
+    /// <summary>
+    /// Gets a multiclass dataset from a file, which can be either a text file or a binary dataset file (see
+    /// data::BinaryDataset). The file is memory-mapped, and text is parsed on several threads straight out of the mapping.
+    /// </summary>
+    ///
+    /// <param name="filepath"> The path of the file to load data from. </param>
+    /// <param name="numThreads"> The number of threads to parse text with, or 0 to use one per hardware thread. </param>
+    ///
+    /// <returns> The dataset. </returns>
+    data::AutoSupervisedMultiClassDataset GetMultiClassDataset(const std::string& filepath, size_t numThreads = 0);
+
     /// <summary>
     /// Gets a new dataset by running an existing dataset through a map.
     /// </summary>
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "ArchiveFormat.h"
 #include "MapLoadArguments.h"
 
 #include <model/include/Map.h>
@@ -19,7 +20,8 @@ namespace ell
 {
 namespace common
 {
-    /// <summary> Loads a model from a file, or creates a new one if given an empty filename. </summary>
+    /// <summary> Loads a model from a file, or creates a new one if given an empty filename. The file can be in any
+    /// of the formats in `ArchiveFormat`. </summary>
     ///
     /// <param name="filename"> The filename. </param>
     /// <returns> The loaded model. </returns>
@@ -29,13 +31,15 @@ namespace common
     ///
     /// <param name="model"> The model. </param>
     /// <param name="filename"> The filename. </param>
-    void SaveModel(const model::Model& model, const std::string& filename);
+    /// <param name="format"> The format to save the model in. </param>
+    void SaveModel(const model::Model& model, const std::string& filename, ArchiveFormat format = ArchiveFormat::json);
 
     /// <summary> Saves a model to a stream. </summary>
     ///
     /// <param name="model"> The model. </param>
-    /// <param name="outStream"> The stream. </param>
-    void SaveModel(const model::Model& model, std::ostream& outStream);
+    /// <param name="outStream"> The stream, which should be opened in binary mode if `format` is `binary`. </param>
+    /// <param name="format"> The format to save the model in. </param>
+    void SaveModel(const model::Model& model, std::ostream& outStream, ArchiveFormat format = ArchiveFormat::json);
 
     /// <summary> Register known node types to a serialization context </summary>
     ///
@@ -47,7 +51,8 @@ namespace common
     /// <param name="context"> The `SerializationContext` </param>
     void RegisterMapTypes(utilities::SerializationContext& context);
 
-    /// <summary> Loads a map from a file, or creates a new one if given an empty filename. </summary>
+    /// <summary> Loads a map from a file, or creates a new one if given an empty filename. The file can be in any
+    /// of the formats in `ArchiveFormat`. </summary>
     ///
     /// <param name="filename"> The filename. </param>
     /// <returns> The loaded map. </returns>
@@ -63,13 +68,15 @@ namespace common
     ///
     /// <param name="map"> The map. </param>
     /// <param name="filename"> The filename. </param>
-    void SaveMap(const model::Map& map, const std::string& filename);
+    /// <param name="format"> The format to save the map in. </param>
+    void SaveMap(const model::Map& map, const std::string& filename, ArchiveFormat format = ArchiveFormat::json);
 
     /// <summary> Saves a map to a stream. </summary>
     ///
     /// <param name="map"> The map. </param>
-    /// <param name="outStream"> The stream. </param>
-    void SaveMap(const model::Map& map, std::ostream& outStream);
+    /// <param name="outStream"> The stream, which should be opened in binary mode if `format` is `binary`. </param>
+    /// <param name="format"> The format to save the map in. </param>
+    void SaveMap(const model::Map& map, std::ostream& outStream, ArchiveFormat format = ArchiveFormat::json);
 
     using CustomTypeFactoryFunction = std::function<void(utilities::SerializationContext&)>;
 
@@ -92,19 +99,21 @@ namespace common
 #include <utilities/include/Files.h>
 #include <utilities/include/JsonArchiver.h>
 
+#include <utility>
+
 namespace ell
 {
 namespace common
 {
     // STYLE internal use only from implementation, so not declared in main part of header file
-    template <typename UnarchiverType>
-    model::Map LoadArchivedMap(std::istream& stream)
+    template <typename UnarchiverType, typename SourceType>
+    model::Map LoadArchivedMap(SourceType&& source)
     {
         utilities::SerializationContext context;
         RegisterNodeTypes(context);
         RegisterMapTypes(context);
         AddCustomTypes(context);
-        UnarchiverType unarchiver(stream, context);
+        UnarchiverType unarchiver(std::forward<SourceType>(source), context);
         model::Map map;
         unarchiver.Unarchive(map);
         return map;
@@ -41,6 +41,13 @@ namespace common
         bool debug = false;
         utilities::Optional<bool> positionIndependentCode = false; // for generating -fPIC object code
         int globalValueAlignment = 32;
+        bool planPortMemory = false;
+        bool parallelizeBranches = false;
+        bool flattenForests = true;
+        bool threadSafe = false;
+        bool externalWeights = false; // write the weights to a separate file that's loaded at runtime
+        std::string compilationCache; // directory of compiled code to reuse across runs
+        int numCompilerThreads = 1; // threads to run LLVM's optimization passes on
 
         // potentially per-node options:
         bool enableVectorization = true;
@@ -48,11 +55,17 @@ namespace common
         bool parallelize = true;
         bool useThreadPool = true;
         int maxThreads = 4;
+        bool useWorkStealing = false;
 
         // optimization options (configurable per-node)
         bool fuseLinearOperations = true;
         bool optimizeReorderDataNodes = true;
         PreferredConvolutionMethod convolutionMethod = PreferredConvolutionMethod::automatic; // known methods: auto, unrolled, simple, diagonal, winograd
+        bool autotuneConvolution = false; // measure the convolution methods when convolutionMethod is auto
+        std::string convolutionTuningCache; // file that holds the fastest measured convolution methods
+        bool quantizeInt8 = false; // use int8 arithmetic for the calibrated layers and matrix multiplies
+        bool tuneSchedules = false; // measure candidate loop nest schedules (e.g., GEMM tile sizes) missing from the schedule tuning cache
+        std::string scheduleTuningCache; // file that holds the fastest measured loop nest schedules
 
         // raw options to store in metadata
         std::vector<std::string> modelOptions; // in format "<option-name>,<option-value-string>"
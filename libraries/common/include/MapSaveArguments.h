@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "ArchiveFormat.h"
+
 #include <utilities/include/CommandLineParser.h>
 #include <utilities/include/OutputStreamImpostor.h>
 
@@ -23,6 +25,9 @@ namespace common
         /// <summary> The filename to store the output map in. </summary>
         std::string outputMapFilename = "";
 
+        /// <summary> The format to store the output map in. </summary>
+        ArchiveFormat outputMapFormat = ArchiveFormat::json;
+
         /// <summary> An output stream to write the output map to. </summary>
         utilities::OutputStreamImpostor outputMapStream;
 
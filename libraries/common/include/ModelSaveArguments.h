@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "ArchiveFormat.h"
+
 #include <utilities/include/CommandLineParser.h>
 #include <utilities/include/OutputStreamImpostor.h>
 
@@ -23,6 +25,9 @@ namespace common
         /// <summary> The filename to store the output model in. </summary>
         std::string outputModelFilename = "";
 
+        /// <summary> The format to store the output model in. </summary>
+        ArchiveFormat outputModelFormat = ArchiveFormat::json;
+
         utilities::OutputStreamImpostor outputModelStream;
     };
 
@@ -0,0 +1,33 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SweepingTrainerArguments.h (common)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <utilities/include/CommandLineParser.h>
+
+#include <trainers/include/SweepingTrainer.h>
+
+namespace ell
+{
+namespace common
+{
+    /// <summary> Sweeping trainer parameters. </summary>
+    struct SweepingTrainerArguments : public trainers::SweepingTrainerParameters
+    {
+    };
+
+    /// <summary> Parsed version of sweeping trainer parameters. </summary>
+    struct ParsedSweepingTrainerArguments : public SweepingTrainerArguments
+        , public utilities::ParsedArgSet
+    {
+        /// <summary> Adds the arguments to the command line parser. </summary>
+        ///
+        /// <param name="parser"> [in,out] The command line parser. </param>
+        void AddArgs(utilities::CommandLineParser& parser) override;
+    };
+} // namespace common
+} // namespace ell
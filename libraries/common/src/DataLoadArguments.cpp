@@ -9,6 +9,8 @@
 #include "DataLoadArguments.h"
 #include "DataLoaders.h"
 
+#include <data/include/BinaryDataset.h>
+
 #include <utilities/include/CStringParser.h>
 #include <utilities/include/Files.h>
 
@@ -98,6 +100,13 @@ namespace common
                 return parseErrorMessages;
             }
 
+            if (data::IsBinaryDatasetFile(GetDataFilePath()))
+            {
+                // Binary datasets record their dimension in the header
+                parsedDataDimension = data::BinaryDataset(GetDataFilePath()).NumFeatures();
+                return parseErrorMessages;
+            }
+
             auto stream = utilities::OpenIfstream(GetDataFilePath());
             auto exampleIterator = GetAutoSupervisedExampleIterator(stream);
             while (exampleIterator.IsValid())
@@ -9,22 +9,162 @@
 #include "DataLoaders.h"
 
 #include <utilities/include/Files.h>
+#include <utilities/include/MemoryMappedFile.h>
 
 #include <data/include/Dataset.h>
 #include <data/include/SequentialLineIterator.h>
 
 #include <data/include/AutoDataVector.h>
+#include <data/include/BinaryDataset.h>
 #include <data/include/GeneralizedSparseParsingIterator.h>
 #include <data/include/SingleLineParsingExampleIterator.h>
 #include <data/include/WeightLabel.h>
 
+#include <algorithm>
+#include <fstream>
+#include <future>
 #include <memory>
+#include <sstream>
 #include <stdexcept>
+#include <streambuf>
+#include <thread>
+#include <vector>
 
 namespace ell
 {
 namespace common
 {
+    namespace
+    {
+        // Chunks smaller than this aren't worth a thread of their own
+        const size_t c_minParseChunkSize = 1 << 16;
+
+        // A read-only stream buffer over a range of memory, so a chunk of text can be parsed without copying it
+        class MemoryStreamBuffer : public std::streambuf
+        {
+        public:
+            MemoryStreamBuffer(const char* begin, const char* end)
+            {
+                setg(const_cast<char*>(begin), const_cast<char*>(begin), const_cast<char*>(end));
+            }
+        };
+
+        // Reads the rest of a stream into memory. When the stream can tell how much is left, the buffer is sized up front
+        // and filled with a single read, instead of being grown as the text is copied into it.
+        std::string ReadStream(std::istream& stream)
+        {
+            std::string text;
+            const auto begin = stream.tellg();
+            if (begin != std::istream::pos_type(-1) && stream.seekg(0, std::ios::end))
+            {
+                const auto size = static_cast<size_t>(stream.tellg() - begin);
+                stream.seekg(begin);
+                text.resize(size);
+                stream.read(&text[0], size);
+                text.resize(static_cast<size_t>(stream.gcount()));
+                return text;
+            }
+
+            stream.clear();
+            std::ostringstream contents;
+            contents << stream.rdbuf();
+            return contents.str();
+        }
+
+        // Splits the text into (at most) numChunks ranges of about the same size, each ending just after a newline
+        std::vector<std::pair<const char*, const char*>> GetChunks(const char* begin, const char* end, size_t numChunks)
+        {
+            const auto textSize = static_cast<size_t>(end - begin);
+            const auto chunkSize = std::max(c_minParseChunkSize, (textSize + numChunks - 1) / numChunks);
+            std::vector<std::pair<const char*, const char*>> chunks;
+            auto chunkBegin = begin;
+            while (chunkBegin < end)
+            {
+                auto chunkEnd = end;
+                if (static_cast<size_t>(end - chunkBegin) > chunkSize)
+                {
+                    auto newline = std::find(chunkBegin + chunkSize - 1, end, '\n');
+                    chunkEnd = newline == end ? end : newline + 1;
+                }
+                chunks.emplace_back(chunkBegin, chunkEnd);
+                chunkBegin = chunkEnd;
+            }
+            return chunks;
+        }
+
+        template <typename MetadataParserType, typename ExampleType>
+        data::Dataset<ExampleType> ParseDataset(const char* begin, const char* end, size_t numThreads)
+        {
+            if (numThreads == 0)
+            {
+                numThreads = std::max(1u, std::thread::hardware_concurrency());
+            }
+
+            std::vector<std::future<std::vector<ExampleType>>> chunkResults;
+            for (const auto& chunk : GetChunks(begin, end, numThreads))
+            {
+                chunkResults.push_back(std::async(std::launch::async, [chunk]() {
+                    MemoryStreamBuffer buffer(chunk.first, chunk.second);
+                    std::istream chunkStream(&buffer);
+                    auto exampleIterator = GetExampleIterator<data::SequentialLineIterator, MetadataParserType, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(chunkStream);
+                    std::vector<ExampleType> examples;
+                    while (exampleIterator.IsValid())
+                    {
+                        examples.push_back(exampleIterator.Get());
+                        exampleIterator.Next();
+                    }
+                    return examples;
+                }));
+            }
+
+            // Concatenating the chunks in order gives the same dataset as parsing the text sequentially
+            data::Dataset<ExampleType> dataset;
+            for (auto& chunkResult : chunkResults)
+            {
+                for (auto& example : chunkResult.get())
+                {
+                    dataset.AddExample(std::move(example));
+                }
+            }
+            return dataset;
+        }
+
+        template <typename MetadataParserType, typename ExampleType>
+        data::Dataset<ExampleType> ParseDataset(std::istream& stream, size_t numThreads)
+        {
+            const auto text = ReadStream(stream);
+            return ParseDataset<MetadataParserType, ExampleType>(text.data(), text.data() + text.size(), numThreads);
+        }
+
+        // Text files are parsed straight out of a memory-mapped view of the file, without copying them
+        template <typename MetadataParserType, typename ExampleType>
+        data::Dataset<ExampleType> ParseDataset(const std::string& filepath, size_t numThreads)
+        {
+            utilities::MemoryMappedFile file(filepath);
+            return ParseDataset<MetadataParserType, ExampleType>(file.GetData(), file.GetData() + file.GetSize(), numThreads);
+        }
+
+        // An example iterator that owns the file stream it reads from
+        template <typename ExampleType>
+        class FileExampleIterator : public data::IExampleIterator<ExampleType>
+        {
+        public:
+            template <typename GetExampleIteratorFunction>
+            FileExampleIterator(const std::string& filepath, GetExampleIteratorFunction getExampleIterator) :
+                _stream(std::make_unique<std::ifstream>(utilities::OpenIfstream(filepath))),
+                _exampleIterator(getExampleIterator(*_stream))
+            {
+            }
+
+            bool IsValid() const override { return _exampleIterator.IsValid(); }
+            void Next() override { _exampleIterator.Next(); }
+            ExampleType Get() const override { return _exampleIterator.Get(); }
+
+        private:
+            std::unique_ptr<std::ifstream> _stream;
+            data::ExampleIterator<ExampleType> _exampleIterator;
+        };
+    } // namespace
 
     data::AutoSupervisedExampleIterator GetAutoSupervisedExampleIterator(std::istream& stream)
     {
@@ -36,6 +176,17 @@ namespace common
         return GetExampleIterator<data::SequentialLineIterator, data::ClassIndexParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream);
     }
 
+    data::AutoSupervisedExampleIterator GetAutoSupervisedExampleIterator(const std::string& filepath)
+    {
+        if (data::IsBinaryDatasetFile(filepath))
+        {
+            return data::BinaryDataset(filepath).GetExampleIterator();
+        }
+
+        using IteratorType = FileExampleIterator<data::AutoSupervisedExample>;
+        return data::AutoSupervisedExampleIterator(std::make_unique<IteratorType>(filepath, [](std::istream& stream) { return GetAutoSupervisedExampleIterator(stream); }));
+    }
+
     data::AutoSupervisedDataset GetDataset(std::istream& stream)
     {
         return data::MakeDataset(GetExampleIterator<data::SequentialLineIterator, data::LabelParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream));
@@ -45,5 +196,35 @@ namespace common
     {
         return data::MakeDataset(GetExampleIterator<data::SequentialLineIterator, data::ClassIndexParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream));
     }
+
+    data::AutoSupervisedDataset GetDataset(std::istream& stream, size_t numThreads)
+    {
+        return ParseDataset<data::LabelParser, data::AutoSupervisedExample>(stream, numThreads);
+    }
+
+    data::AutoSupervisedMultiClassDataset GetMultiClassDataset(std::istream& stream, size_t numThreads)
+    {
+        return ParseDataset<data::ClassIndexParser, data::AutoSupervisedMultiClassExample>(stream, numThreads);
+    }
+
+    data::AutoSupervisedDataset GetDataset(const std::string& filepath, size_t numThreads)
+    {
+        if (data::IsBinaryDatasetFile(filepath))
+        {
+            return data::MakeDataset(data::BinaryDataset(filepath).GetExampleIterator());
+        }
+
+        return ParseDataset<data::LabelParser, data::AutoSupervisedExample>(filepath, numThreads);
+    }
+
+    data::AutoSupervisedMultiClassDataset GetMultiClassDataset(const std::string& filepath, size_t numThreads)
+    {
+        if (data::IsBinaryDatasetFile(filepath))
+        {
+            return data::MakeDataset(data::BinaryDataset(filepath).GetMultiClassExampleIterator());
+        }
+
+        return ParseDataset<data::ClassIndexParser, data::AutoSupervisedMultiClassExample>(filepath, numThreads);
+    }
 } // namespace common
 } // namespace ell
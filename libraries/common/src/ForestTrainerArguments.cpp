@@ -32,6 +32,12 @@ namespace common
                          "The number of boosting rounds to perform",
                          "10");
 
+        parser.AddOption(numThreads,
+                         "numThreads",
+                         "nt",
+                         "The number of threads used to train the forest (0 means one per hardware thread)",
+                         1);
+
         parser.AddOption(randomSeed,
                          "randomSeed",
                          "rs",
@@ -33,6 +33,7 @@
 #include <nodes/include/FastGRNNNode.h>
 #include <nodes/include/FFTNode.h>
 #include <nodes/include/FilterBankNode.h>
+#include <nodes/include/FlatForestPredictorNode.h>
 #include <nodes/include/ForestPredictorNode.h>
 #include <nodes/include/GRUNode.h>
 #include <nodes/include/HammingWindowNode.h>
@@ -49,6 +50,7 @@
 #include <nodes/include/MultiplexerNode.h>
 #include <nodes/include/NeuralNetworkPredictorNode.h>
 #include <nodes/include/ProtoNNPredictorNode.h>
+#include <nodes/include/QuantizedMatrixMultiplyNode.h>
 #include <nodes/include/RNNNode.h>
 #include <nodes/include/ReceptiveFieldMatrixNode.h>
 #include <nodes/include/ReinterpretLayoutNode.h>
@@ -77,8 +79,10 @@
 #include <predictors/neural/include/TanhActivation.h>
 
 #include <utilities/include/Archiver.h>
+#include <utilities/include/BinaryArchiver.h>
 #include <utilities/include/Files.h>
 #include <utilities/include/JsonArchiver.h>
+#include <utilities/include/MemoryMappedFile.h>
 
 #include <cstdint>
 
@@ -137,6 +141,7 @@ namespace common
         context.GetTypeFactory().AddType<model::Node, nodes::MovingAverageNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::MovingVarianceNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::NeuralNetworkPredictorNode<ElementType>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::QuantizedMatrixMultiplyNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::ReceptiveFieldMatrixNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::ReorderDataCodeNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::ReorderDataNode<ElementType>>();
@@ -262,6 +267,7 @@ namespace common
         context.GetTypeFactory().AddType<model::Node, nodes::ReinterpretLayoutNode<int>>();
         context.GetTypeFactory().AddType<model::Node, nodes::ReinterpretLayoutNode<bool>>();
 
+        context.GetTypeFactory().AddType<model::Node, nodes::FlatForestPredictorNode>();
         context.GetTypeFactory().AddType<model::Node, nodes::SimpleForestPredictorNode>();
 
         context.GetTypeFactory().AddType<model::Node, nodes::SingleElementThresholdNode>();
@@ -298,12 +304,12 @@ namespace common
         context.GetTypeFactory().AddType<model::Map, model::Map>();
     }
 
-    template <typename UnarchiverType>
-    model::Model LoadArchivedModel(std::istream& stream)
+    template <typename UnarchiverType, typename SourceType>
+    model::Model LoadArchivedModel(SourceType&& source)
     {
         SerializationContext context;
         RegisterNodeTypes(context);
-        UnarchiverType unarchiver(stream, context);
+        UnarchiverType unarchiver(std::forward<SourceType>(source), context);
         model::Model model;
         unarchiver.Unarchive(model);
         return model;
@@ -323,23 +329,36 @@ namespace common
             throw SystemException(SystemExceptionErrors::fileNotFound);
         }
 
-        auto filestream = OpenIfstream(filename);
+        // binary mode is harmless for JSON files, and lets us detect the format from the first byte
+        auto filestream = OpenBinaryIfstream(filename);
+        if (BinaryUnarchiver::IsBinaryArchive(filestream))
+        {
+            // map the file copy-on-write, so weights can be used in place and only the pages that get modified are copied
+            return LoadArchivedModel<BinaryUnarchiver>(std::make_shared<MemoryMappedFile>(filename, true));
+        }
         return LoadArchivedModel<JsonUnarchiver>(filestream);
     }
 
-    void SaveModel(const model::Model& model, const std::string& filename)
+    void SaveModel(const model::Model& model, const std::string& filename, ArchiveFormat format)
     {
         if (!IsFileWritable(filename))
         {
             throw SystemException(SystemExceptionErrors::fileNotWritable);
         }
-        auto filestream = OpenOfstream(filename);
-        SaveModel(model, filestream);
+        auto filestream = format == ArchiveFormat::binary ? OpenBinaryOfstream(filename) : OpenOfstream(filename);
+        SaveModel(model, filestream, format);
     }
 
-    void SaveModel(const model::Model& model, std::ostream& outStream)
+    void SaveModel(const model::Model& model, std::ostream& outStream, ArchiveFormat format)
     {
-        SaveArchivedObject<JsonArchiver>(model, outStream);
+        if (format == ArchiveFormat::binary)
+        {
+            SaveArchivedObject<BinaryArchiver>(model, outStream);
+        }
+        else
+        {
+            SaveArchivedObject<JsonArchiver>(model, outStream);
+        }
     }
 
     //
@@ -418,10 +437,14 @@ namespace common
             throw SystemException(SystemExceptionErrors::fileNotFound, "File not found '" + filename + "'");
         }
 
-        auto filestream = OpenIfstream(filename);
+        auto filestream = OpenBinaryIfstream(filename);
 
         try
         {
+            if (BinaryUnarchiver::IsBinaryArchive(filestream))
+            {
+                return LoadArchivedMap<BinaryUnarchiver>(std::make_shared<MemoryMappedFile>(filename, true));
+            }
             return LoadArchivedMap<JsonUnarchiver>(filestream);
         }
         catch (const std::exception& ex)
@@ -430,19 +453,26 @@ namespace common
         }
     }
 
-    void SaveMap(const model::Map& map, const std::string& filename)
+    void SaveMap(const model::Map& map, const std::string& filename, ArchiveFormat format)
     {
         if (!IsFileWritable(filename))
         {
             throw SystemException(SystemExceptionErrors::fileNotWritable);
         }
-        auto filestream = OpenOfstream(filename);
-        SaveMap(map, filestream);
+        auto filestream = format == ArchiveFormat::binary ? OpenBinaryOfstream(filename) : OpenOfstream(filename);
+        SaveMap(map, filestream, format);
     }
 
-    void SaveMap(const model::Map& map, std::ostream& outStream)
+    void SaveMap(const model::Map& map, std::ostream& outStream, ArchiveFormat format)
     {
-        SaveArchivedObject<JsonArchiver>(map, outStream);
+        if (format == ArchiveFormat::binary)
+        {
+            SaveArchivedObject<BinaryArchiver>(map, outStream);
+        }
+        else
+        {
+            SaveArchivedObject<JsonArchiver>(map, outStream);
+        }
     }
 
     CustomTypeFactoryFunction _func;
@@ -81,6 +81,41 @@ namespace common
               { "auto", PreferredConvolutionMethod::automatic } },
             "auto");
 
+        parser.AddOption(
+            autotuneConvolution,
+            "autotune",
+            "",
+            "Measure each convolution method for the convolutional layers whose method is 'auto', and use the fastest (only for host targets)",
+            false);
+
+        parser.AddOption(
+            convolutionTuningCache,
+            "tuningCache",
+            "",
+            "File that holds the fastest convolution method for each layer shape, target and thread count. Autotuning adds its results to it",
+            "");
+
+        parser.AddOption(
+            quantizeInt8,
+            "quantize",
+            "",
+            "Use 8-bit integer arithmetic for the convolutional, fully-connected and matrix multiply nodes that have calibrated input ranges (see the quantize tool)",
+            false);
+
+        parser.AddOption(
+            tuneSchedules,
+            "tuneSchedules",
+            "",
+            "Time candidate schedules (tile sizes, unrolling) for the loop nests missing from the schedule tuning cache, and use the fastest (only for host targets)",
+            false);
+
+        parser.AddOption(
+            scheduleTuningCache,
+            "scheduleTuningCache",
+            "",
+            "File that holds the fastest schedule for each loop nest shape and target. Schedule tuning adds its results to it",
+            "");
+
         parser.AddOption(
             modelOptions,
             "modelOption",
@@ -130,6 +165,13 @@ namespace common
             "Maximum num of parallel threads",
             4);
 
+        parser.AddOption(
+            useWorkStealing,
+            "workStealing",
+            "ws",
+            "Let idle thread pool workers steal tasks from busy ones (if thread pool enabled)",
+            false);
+
         parser.AddOption(
             debug,
             "debug",
@@ -199,6 +241,55 @@ namespace common
             "The number of bytes to align global buffers to",
             32);
         
+        parser.AddOption(
+            planPortMemory,
+            "planPortMemory",
+            "ppm",
+            "Share storage between intermediate buffers whose lifetimes don't overlap",
+            false);
+
+        parser.AddOption(
+            parallelizeBranches,
+            "parallelizeBranches",
+            "pb",
+            "Compute independent branches of the model concurrently (requires parallelize)",
+            false);
+
+        parser.AddOption(
+            flattenForests,
+            "flattenForests",
+            "ff",
+            "Compile simple forests as a loop over a flat array of trees, instead of a node per split",
+            true);
+
+        parser.AddOption(
+            threadSafe,
+            "threadSafe",
+            "ts",
+            "Keep model state in a context allocated by each caller, so the compiled model can be called from multiple threads (can't be used with parallelize)",
+            false);
+
+        parser.AddOption(
+            externalWeights,
+            "externalWeights",
+            "ew",
+            "Write the model weights to a separate .weights file that can be memory-mapped at runtime, instead of into the compiled code",
+            false);
+
+        parser.AddOption(
+            compilationCache,
+            "compilationCache",
+            "",
+            "Directory of compiled node functions and outputs to reuse across runs. Only the parts of the model that changed since an earlier run are compiled again",
+            "");
+
+        parser.AddOption(
+            numCompilerThreads,
+            "compilerThreads",
+            "",
+            "Number of threads to run LLVM's function optimization passes on (0 means one per hardware thread). The module passes and code generation, which take most of the compile time, always run on one thread",
+            1);
+
         parser.AddOption(
             skip_ellcode,
             "skip_ellcode",
@@ -241,12 +332,24 @@ namespace common
         settings.compilerSettings.useBlas = useBlas;
         settings.compilerSettings.allowVectorInstructions = enableVectorization;
         settings.compilerSettings.parallelize = parallelize;
+        settings.compilerSettings.useThreadPool = useThreadPool;
+        settings.compilerSettings.maxThreads = maxThreads;
+        settings.compilerSettings.useWorkStealing = useWorkStealing;
         settings.compilerSettings.vectorWidth = vectorWidth;
         settings.profile = profile;
+        settings.planPortMemory = planPortMemory;
+        settings.parallelizeBranches = parallelizeBranches;
+        settings.flattenForests = flattenForests;
+        settings.compilationCache = compilationCache;
+        settings.compilerSettings.numCompilerThreads = numCompilerThreads;
+        settings.compilerSettings.threadSafe = threadSafe;
+        settings.compilerSettings.externalWeights = externalWeights;
         settings.compilerSettings.profile = profile;
         settings.compilerSettings.positionIndependentCode = positionIndependentCode;
         settings.compilerSettings.globalValueAlignment = globalValueAlignment;
         settings.compilerSettings.skip_ellcode = skip_ellcode;
+        settings.compilerSettings.tuneSchedules = tuneSchedules;
+        settings.compilerSettings.scheduleTuningCache = scheduleTuningCache;
 
         if (target != "")
         {
@@ -294,6 +397,9 @@ namespace common
         options["fuseLinearFunctionNodes"] = fuseLinearOperations;
         options["optimizeReorderDataNodes"] = optimizeReorderDataNodes;
         options["preferredConvolutionMethod"] = convolutionMethod;
+        options["autotuneConvolutionMethod"] = autotuneConvolution;
+        options["convolutionTuningCache"] = convolutionTuningCache;
+        options["quantizeInt8"] = quantizeInt8;
 
         auto metadata = GetOptionsMetadata();
         if (metadata.HasEntry("model"))
@@ -20,6 +20,14 @@ namespace common
             "omf",
             "Path to the output map file (empty for standard out, 'null' for no output)",
             "");
+
+        parser.AddOption(
+            outputMapFormat,
+            "outputMapFormat",
+            "",
+            "Format of the output map file: json, or binary for faster loading",
+            { { "json", ArchiveFormat::json }, { "binary", ArchiveFormat::binary } },
+            "json");
     }
 
     utilities::CommandLineParseResult ParsedMapSaveArguments::PostProcess(const utilities::CommandLineParser& parser)
@@ -36,7 +44,7 @@ namespace common
         }
         else // treat argument as filename
         {
-            outputMapStream = utilities::OutputStreamImpostor(outputMapFilename);
+            outputMapStream = utilities::OutputStreamImpostor(outputMapFilename, outputMapFormat == ArchiveFormat::binary);
             hasOutputStream = true;
         }
 
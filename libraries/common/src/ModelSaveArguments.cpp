@@ -20,6 +20,14 @@ namespace common
             "omf",
             "Path to the output model file",
             "");
+
+        parser.AddOption(
+            outputModelFormat,
+            "outputModelFormat",
+            "",
+            "Format of the output model file: json, or binary for faster loading",
+            { { "json", ArchiveFormat::json }, { "binary", ArchiveFormat::binary } },
+            "json");
     }
 
     utilities::CommandLineParseResult ParsedModelSaveArguments::PostProcess(const utilities::CommandLineParser& parser)
@@ -34,7 +42,7 @@ namespace common
         }
         else // treat argument as filename
         {
-            outputModelStream = utilities::OutputStreamImpostor(outputModelFilename);
+            outputModelStream = utilities::OutputStreamImpostor(outputModelFilename, outputModelFormat == ArchiveFormat::binary);
         }
 
         std::vector<std::string> parseErrorMessages;
@@ -0,0 +1,29 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SweepingTrainerArguments.cpp (common)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SweepingTrainerArguments.h"
+
+namespace ell
+{
+namespace common
+{
+    void ParsedSweepingTrainerArguments::AddArgs(utilities::CommandLineParser& parser)
+    {
+        parser.AddOption(numThreads,
+                         "numThreads",
+                         "nt",
+                         "The number of configurations to train at the same time (0 means one per hardware thread)",
+                         1);
+
+        parser.AddOption(halvingFactor,
+                         "halvingFactor",
+                         "hf",
+                         "If greater than 1, keep only the best 1/halvingFactor of the configurations after each epoch",
+                         0);
+    }
+} // namespace common
+} // namespace ell
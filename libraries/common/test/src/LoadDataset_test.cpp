@@ -15,6 +15,7 @@
 #include <utilities/include/Files.h>
 
 #include <iostream>
+#include <sstream>
 
 namespace ell
 {
@@ -37,4 +38,39 @@ void TestLoadMappedDataset(const std::string& examplePath)
     auto dataset = common::GetDataset(stream);
     dataset = common::TransformDataset(dataset, map);
 }
+
+void TestParallelLoadDataset()
+{
+    // Enough text for several parse chunks, with a mix of dense and sparse rows
+    std::stringstream text;
+    for (int i = 0; i < 20000; ++i)
+    {
+        text << (i % 2 == 0 ? 1 : -1) << '\t';
+        if (i % 3 == 0)
+        {
+            text << i % 7 << ":" << i * 0.5 << '\t' << 10 + i % 5 << ":" << -i << '\n';
+        }
+        else
+        {
+            text << i << '\t' << 0.25 * i << '\t' << i % 11 << '\n';
+        }
+    }
+
+    std::stringstream sequentialStream(text.str());
+    auto sequentialDataset = common::GetDataset(sequentialStream);
+    for (size_t numThreads : { 1, 4, 7 })
+    {
+        std::stringstream parallelStream(text.str());
+        auto parallelDataset = common::GetDataset(parallelStream, numThreads);
+        bool ok = parallelDataset.NumExamples() == sequentialDataset.NumExamples();
+        for (size_t i = 0; ok && i < sequentialDataset.NumExamples(); ++i)
+        {
+            const auto& expected = sequentialDataset.GetExample(i);
+            const auto& actual = parallelDataset.GetExample(i);
+            ok = expected.GetMetadata().label == actual.GetMetadata().label &&
+                 testing::IsEqual(expected.GetDataVector().ToArray(), actual.GetDataVector().ToArray());
+        }
+        testing::ProcessTest("TestParallelLoadDataset with " + std::to_string(numThreads) + " threads", ok);
+    }
+}
 } // namespace ell
@@ -43,6 +43,7 @@ int main(int argc, char* argv[])
 
         TestLoadDataset(examplePath);
         TestLoadMappedDataset(examplePath);
+        TestParallelLoadDataset();
     }
     catch (const utilities::Exception& exception)
     {
@@ -0,0 +1,276 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryDataset.h (data)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "AutoDataVector.h"
+#include "DataVector.h"
+#include "Example.h"
+#include "ExampleIterator.h"
+#include "IndexValue.h"
+#include "SparseDataVector.h"
+#include "WeightClassIndex.h"
+#include "WeightLabel.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/MemoryMappedFile.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary>
+    /// The header at the start of a binary dataset file. The header is followed by the columns of the dataset, each
+    /// starting on a 64-byte boundary: the weights and labels (doubles, one per example), the offsets of each example
+    /// into the values and indices columns (uint64s, one per example plus one), the indices of the sparse examples'
+    /// values (uint32s) and the values (doubles). A dense example has no indices. All numbers are little-endian.
+    /// See doc/BinaryDatasetFormat.md.
+    /// </summary>
+    struct BinaryDatasetHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t numExamples;
+        uint64_t numValues;
+        uint64_t numIndices;
+        uint64_t maxPrefixLength;
+        uint64_t padding[2];
+    };
+
+    /// <summary>
+    /// Writes examples to a file in the binary dataset format (see `BinaryDatasetHeader`). Each column is streamed to a
+    /// temporary file next to the output as the examples are added, so memory use doesn't grow with the size of the
+    /// dataset. `Write` copies the columns into the output file, and the temporary files are deleted with the writer.
+    /// </summary>
+    class BinaryDatasetWriter
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="filepath"> The path of the file to write. The temporary files are named after it. </param>
+        explicit BinaryDatasetWriter(const std::string& filepath);
+
+        /// <summary> Adds an example. </summary>
+        ///
+        /// <param name="dataVector"> The example's data. </param>
+        /// <param name="metadata"> The example's weight and label. </param>
+        template <typename DataVectorType>
+        void AddExample(const DataVectorType& dataVector, const WeightLabel& metadata);
+
+        /// <summary> Adds an example, storing its class index as the label. </summary>
+        ///
+        /// <param name="dataVector"> The example's data. </param>
+        /// <param name="metadata"> The example's weight and class index. </param>
+        template <typename DataVectorType>
+        void AddExample(const DataVectorType& dataVector, const WeightClassIndex& metadata);
+
+        /// <summary> Gets the number of examples added so far. </summary>
+        size_t NumExamples() const { return _numExamples; }
+
+        /// <summary> Writes the dataset to the output file. No more examples can be added afterwards. </summary>
+        void Write();
+
+    private:
+        // A column of the dataset, appended to a temporary file, which is deleted with the column
+        class ColumnFile
+        {
+        public:
+            explicit ColumnFile(std::string filepath);
+            ColumnFile(const ColumnFile&) = delete;
+            ColumnFile& operator=(const ColumnFile&) = delete;
+            ~ColumnFile();
+
+            template <typename ValueType>
+            void Append(const ValueType* values, size_t count);
+
+            template <typename ValueType>
+            void Append(ValueType value);
+
+            // Copies the column to a stream, padded to the column alignment
+            void CopyTo(std::ostream& stream);
+
+        private:
+            std::string _filepath;
+            std::ofstream _stream;
+            uint64_t _size = 0; // in bytes
+        };
+
+        template <typename DataVectorType>
+        void AddDataVector(const DataVectorType& dataVector);
+        void CheckNotWritten() const;
+
+        std::string _filepath;
+        ColumnFile _weights;
+        ColumnFile _labels;
+        ColumnFile _valueOffsets;
+        ColumnFile _indexOffsets;
+        ColumnFile _indices;
+        ColumnFile _values;
+        uint64_t _numExamples = 0;
+        uint64_t _numValues = 0;
+        uint64_t _numIndices = 0;
+        size_t _maxPrefixLength = 0;
+        bool _written = false;
+    };
+
+    /// <summary>
+    /// A dataset in the binary format, read straight out of a memory-mapped file: nothing is parsed, and the pages of
+    /// the file are shared between all the processes reading it. Copies of a `BinaryDataset` share the same mapping.
+    /// </summary>
+    class BinaryDataset
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="filepath"> The path of the binary dataset file. </param>
+        explicit BinaryDataset(const std::string& filepath);
+
+        /// <summary> Gets the number of examples in the dataset. </summary>
+        size_t NumExamples() const { return _numExamples; }
+
+        /// <summary> Gets the length of the longest data vector in the dataset. </summary>
+        size_t NumFeatures() const { return _maxPrefixLength; }
+
+        /// <summary> Gets the data vector of an example. </summary>
+        ///
+        /// <param name="index"> The index of the example. </param>
+        AutoDataVector GetDataVector(size_t index) const;
+
+        /// <summary> Gets an example with a real-valued label. </summary>
+        ///
+        /// <param name="index"> The index of the example. </param>
+        AutoSupervisedExample GetExample(size_t index) const;
+
+        /// <summary> Gets an example with a class index. </summary>
+        ///
+        /// <param name="index"> The index of the example. </param>
+        AutoSupervisedMultiClassExample GetMultiClassExample(size_t index) const;
+
+        /// <summary> Gets an iterator over the examples, with real-valued labels. </summary>
+        ///
+        /// <param name="fromIndex"> The index of the first example to iterate over. </param>
+        AutoSupervisedExampleIterator GetExampleIterator(size_t fromIndex = 0) const;
+
+        /// <summary> Gets an iterator over the examples, with class indices. </summary>
+        ///
+        /// <param name="fromIndex"> The index of the first example to iterate over. </param>
+        AutoSupervisedMultiClassExampleIterator GetMultiClassExampleIterator(size_t fromIndex = 0) const;
+
+    private:
+        std::shared_ptr<const utilities::MemoryMappedFile> _file;
+        size_t _numExamples = 0;
+        size_t _maxPrefixLength = 0;
+        const double* _weights = nullptr;
+        const double* _labels = nullptr;
+        const uint64_t* _valueOffsets = nullptr;
+        const uint64_t* _indexOffsets = nullptr;
+        const uint32_t* _indices = nullptr;
+        const double* _values = nullptr;
+    };
+
+    /// <summary> Indicates if a file is a binary dataset, by checking the magic number at its start. </summary>
+    ///
+    /// <param name="filepath"> The path of the file. </param>
+    ///
+    /// <returns> `true` if the file exists and is a binary dataset. </returns>
+    bool IsBinaryDatasetFile(const std::string& filepath);
+} // namespace data
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace data
+{
+    template <typename ValueType>
+    void BinaryDatasetWriter::ColumnFile::Append(const ValueType* values, size_t count)
+    {
+        _stream.write(reinterpret_cast<const char*>(values), count * sizeof(ValueType));
+        _size += count * sizeof(ValueType);
+    }
+
+    template <typename ValueType>
+    void BinaryDatasetWriter::ColumnFile::Append(ValueType value)
+    {
+        Append(&value, 1);
+    }
+
+    template <typename DataVectorType>
+    void BinaryDatasetWriter::AddExample(const DataVectorType& dataVector, const WeightLabel& metadata)
+    {
+        CheckNotWritten();
+        AddDataVector(dataVector);
+        _weights.Append(metadata.weight);
+        _labels.Append(metadata.label);
+        ++_numExamples;
+    }
+
+    template <typename DataVectorType>
+    void BinaryDatasetWriter::AddExample(const DataVectorType& dataVector, const WeightClassIndex& metadata)
+    {
+        CheckNotWritten();
+        AddDataVector(dataVector);
+        _weights.Append(metadata.weight);
+        _labels.Append(static_cast<double>(metadata.classIndex));
+        ++_numExamples;
+    }
+
+    template <typename DataVectorType>
+    void BinaryDatasetWriter::AddDataVector(const DataVectorType& dataVector)
+    {
+        auto sparseVector = dataVector.template CopyAs<SparseDoubleDataVector>();
+        std::vector<IndexValue> nonzeros;
+        auto iterator = GetIterator<SparseDoubleDataVector, IterationPolicy::skipZeros>(sparseVector);
+        while (iterator.IsValid())
+        {
+            nonzeros.push_back(iterator.Get());
+            iterator.Next();
+        }
+
+        // Store the vector whichever way takes less space
+        const auto prefixLength = dataVector.PrefixLength();
+        _maxPrefixLength = std::max(_maxPrefixLength, prefixLength);
+        if (nonzeros.size() * (sizeof(uint32_t) + sizeof(double)) < prefixLength * sizeof(double))
+        {
+            if (prefixLength > std::numeric_limits<uint32_t>::max())
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Binary datasets only support 32-bit feature indices");
+            }
+
+            for (const auto& entry : nonzeros)
+            {
+                _indices.Append(static_cast<uint32_t>(entry.index));
+                _values.Append(entry.value);
+            }
+            _numIndices += nonzeros.size();
+            _numValues += nonzeros.size();
+        }
+        else
+        {
+            auto values = dataVector.ToArray();
+            _values.Append(values.data(), values.size());
+            _numValues += values.size();
+        }
+        _valueOffsets.Append(_numValues);
+        _indexOffsets.Append(_numIndices);
+    }
+} // namespace data
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,270 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ExampleShardReader.h (data)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Dataset.h"
+#include "ExampleIterator.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <future>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary>
+    /// Reads examples in shards of bounded size, for training on more examples than fit in memory. Each pass over the
+    /// examples gets a new iterator from a factory function. While the caller works on one shard, the next one is read
+    /// on a background thread, so at most two shards are in memory at a time.
+    ///
+    /// If the factory can start an iterator at any example, a pass started with `Reset(random)` visits the shards in a
+    /// random order, once the shard boundaries are known from a first pass. Otherwise the shards are always visited in
+    /// the order of the examples. Either way, a shard holds the same examples in every pass: callers that shuffle the
+    /// examples of each shard only ever mix examples that are near each other in the source.
+    /// </summary>
+    ///
+    /// <typeparam name="ExampleType"> Example type. </typeparam>
+    template <typename ExampleType>
+    class ExampleShardReader
+    {
+    public:
+        using ExampleIteratorFactory = std::function<ExampleIterator<ExampleType>()>;
+        using IndexedExampleIteratorFactory = std::function<ExampleIterator<ExampleType>(size_t fromIndex)>;
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="getExampleIterator"> A function that returns a new iterator over the examples. </param>
+        /// <param name="maxShardBytes"> The approximate maximum size of a shard, in bytes. </param>
+        ExampleShardReader(ExampleIteratorFactory getExampleIterator, size_t maxShardBytes);
+
+        /// <summary> Constructor for examples that can be read starting at any index, which lets passes visit the shards in a random order. </summary>
+        ///
+        /// <param name="getExampleIterator"> A function that returns a new iterator over the examples, starting at a given example. </param>
+        /// <param name="maxShardBytes"> The approximate maximum size of a shard, in bytes. </param>
+        ExampleShardReader(IndexedExampleIteratorFactory getExampleIterator, size_t maxShardBytes);
+
+        ExampleShardReader(const ExampleShardReader&) = delete;
+        ExampleShardReader& operator=(const ExampleShardReader&) = delete;
+
+        ~ExampleShardReader();
+
+        /// <summary> Starts a new pass over the shards, in the order of the examples. Call `Next()` to get the first shard. </summary>
+        void Reset();
+
+        /// <summary>
+        /// Starts a new pass over the shards, in a random order if the reader can start at any example and a previous
+        /// pass has run to the end. Otherwise the same as `Reset()`.
+        /// </summary>
+        ///
+        /// <param name="random"> The random engine used to order the shards. </param>
+        void Reset(std::default_random_engine& random);
+
+        /// <summary> Proceeds to the next shard of the current pass. </summary>
+        ///
+        /// <returns> `false` if the pass is over. </returns>
+        bool Next();
+
+        /// <summary> Gets the current shard. </summary>
+        Dataset<ExampleType>& GetShard() { return _shard; }
+
+        /// <summary> Gets the index of the current shard's first example, which doesn't depend on the order of the pass. </summary>
+        size_t GetShardOffset() const { return _shardOffset; }
+
+        /// <summary>
+        /// Gets an estimate of the memory an example takes. The estimate assumes the data vector is dense, which
+        /// is an upper bound on the size of its actual representation.
+        /// </summary>
+        ///
+        /// <param name="example"> The example. </param>
+        static size_t EstimateExampleSize(const ExampleType& example);
+
+    private:
+        struct ShardRange
+        {
+            size_t offset;
+            size_t size;
+        };
+
+        Dataset<ExampleType> ReadShard(size_t maxExamples);
+        void ReadNextShardInBackground();
+        void WaitForNextShard();
+
+        ExampleIteratorFactory _getExampleIterator;
+        IndexedExampleIteratorFactory _getIndexedExampleIterator;
+        size_t _maxShardBytes;
+        std::unique_ptr<ExampleIterator<ExampleType>> _exampleIterator;
+        std::future<Dataset<ExampleType>> _nextShard;
+        size_t _nextShardOffset = 0;
+        Dataset<ExampleType> _shard;
+        size_t _shardOffset = 0;
+
+        // the shards found by the last pass that ran to the end, and the order of the current pass if it's shuffled
+        std::vector<ShardRange> _shardRanges;
+        std::vector<ShardRange> _foundShardRanges;
+        bool _shardRangesAreComplete = false;
+        std::vector<ShardRange> _shuffledShardRanges;
+        size_t _nextShuffledShard = 0;
+    };
+} // namespace data
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace data
+{
+    template <typename ExampleType>
+    ExampleShardReader<ExampleType>::ExampleShardReader(ExampleIteratorFactory getExampleIterator, size_t maxShardBytes) :
+        _getExampleIterator(std::move(getExampleIterator)),
+        _maxShardBytes(maxShardBytes)
+    {
+    }
+
+    template <typename ExampleType>
+    ExampleShardReader<ExampleType>::ExampleShardReader(IndexedExampleIteratorFactory getExampleIterator, size_t maxShardBytes) :
+        _getIndexedExampleIterator(std::move(getExampleIterator)),
+        _maxShardBytes(maxShardBytes)
+    {
+        _getExampleIterator = [this]() { return _getIndexedExampleIterator(0); };
+    }
+
+    template <typename ExampleType>
+    ExampleShardReader<ExampleType>::~ExampleShardReader()
+    {
+        WaitForNextShard();
+    }
+
+    template <typename ExampleType>
+    void ExampleShardReader<ExampleType>::Reset()
+    {
+        WaitForNextShard();
+        _shard = Dataset<ExampleType>();
+        _shardOffset = 0;
+        _shuffledShardRanges.clear();
+        _foundShardRanges.clear();
+        _exampleIterator = std::make_unique<ExampleIterator<ExampleType>>(_getExampleIterator());
+        ReadNextShardInBackground();
+    }
+
+    template <typename ExampleType>
+    void ExampleShardReader<ExampleType>::Reset(std::default_random_engine& random)
+    {
+        if (!_getIndexedExampleIterator || !_shardRangesAreComplete)
+        {
+            Reset();
+            return;
+        }
+
+        WaitForNextShard();
+        _shard = Dataset<ExampleType>();
+        _shardOffset = 0;
+        _exampleIterator.reset();
+        _shuffledShardRanges = _shardRanges;
+        std::shuffle(_shuffledShardRanges.begin(), _shuffledShardRanges.end(), random);
+        _nextShuffledShard = 0;
+        ReadNextShardInBackground();
+    }
+
+    template <typename ExampleType>
+    bool ExampleShardReader<ExampleType>::Next()
+    {
+        if (!_nextShard.valid())
+        {
+            return false;
+        }
+
+        _shard = _nextShard.get();
+        _shardOffset = _nextShardOffset;
+        if (_shard.NumExamples() == 0)
+        {
+            // Shuffled passes reuse the ranges of the last full pass in order, so only an in-order pass records them
+            if (_shuffledShardRanges.empty())
+            {
+                _shardRanges = std::move(_foundShardRanges);
+                _shardRangesAreComplete = true;
+            }
+            _foundShardRanges.clear();
+            _exampleIterator.reset();
+            return false;
+        }
+
+        if (_shuffledShardRanges.empty())
+        {
+            _foundShardRanges.push_back({ _shardOffset, _shard.NumExamples() });
+        }
+
+        ReadNextShardInBackground();
+        return true;
+    }
+
+    template <typename ExampleType>
+    size_t ExampleShardReader<ExampleType>::EstimateExampleSize(const ExampleType& example)
+    {
+        return sizeof(ExampleType) + example.GetDataVector().PrefixLength() * sizeof(double);
+    }
+
+    template <typename ExampleType>
+    Dataset<ExampleType> ExampleShardReader<ExampleType>::ReadShard(size_t maxExamples)
+    {
+        // Every shard gets at least one example, even if that example is bigger than the limit
+        Dataset<ExampleType> shard;
+        size_t shardBytes = 0;
+        while (_exampleIterator->IsValid() && shard.NumExamples() < maxExamples && (shard.NumExamples() == 0 || shardBytes < _maxShardBytes))
+        {
+            auto example = _exampleIterator->Get();
+            shardBytes += EstimateExampleSize(example);
+            shard.AddExample(std::move(example));
+            _exampleIterator->Next();
+        }
+        return shard;
+    }
+
+    template <typename ExampleType>
+    void ExampleShardReader<ExampleType>::ReadNextShardInBackground()
+    {
+        // Only one read is in flight at a time, so the example iterator is never used by two threads at once
+        if (_shuffledShardRanges.empty())
+        {
+            _nextShardOffset = _shardOffset + _shard.NumExamples();
+            _nextShard = std::async(std::launch::async, [this]() { return ReadShard(std::numeric_limits<size_t>::max()); });
+        }
+        else if (_nextShuffledShard < _shuffledShardRanges.size())
+        {
+            auto range = _shuffledShardRanges[_nextShuffledShard++];
+            _nextShardOffset = range.offset;
+            _nextShard = std::async(std::launch::async, [this, range]() {
+                _exampleIterator = std::make_unique<ExampleIterator<ExampleType>>(_getIndexedExampleIterator(range.offset));
+                return ReadShard(range.size);
+            });
+        }
+        else
+        {
+            _nextShard = std::async(std::launch::deferred, []() { return Dataset<ExampleType>(); });
+        }
+    }
+
+    template <typename ExampleType>
+    void ExampleShardReader<ExampleType>::WaitForNextShard()
+    {
+        if (_nextShard.valid())
+        {
+            _nextShard.wait();
+            _nextShard = {};
+        }
+    }
+} // namespace data
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,295 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryDataset.cpp (data)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BinaryDataset.h"
+#include "StlIndexValueIterator.h"
+
+#include <utilities/include/Files.h>
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    namespace
+    {
+        const char c_binaryDatasetMagic[8] = { 'E', 'L', 'L', 'D', 'A', 'T', 'A', '\0' };
+        const uint32_t c_binaryDatasetVersion = 1;
+        const size_t c_binaryDatasetAlignment = 64;
+
+        size_t AlignedSize(size_t size)
+        {
+            return ((size + c_binaryDatasetAlignment - 1) / c_binaryDatasetAlignment) * c_binaryDatasetAlignment;
+        }
+
+        const size_t c_copyBufferSize = 1 << 20;
+
+        template <typename ValueType>
+        const ValueType* ReadColumn(const char*& position, const char* end, uint64_t count)
+        {
+            // Compare against the bytes that are left before doing any arithmetic that could overflow or move past the end
+            const auto remaining = static_cast<uint64_t>(end - position);
+            if (count > remaining / sizeof(ValueType) || AlignedSize(count * sizeof(ValueType)) > remaining)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::badData, "Binary dataset file is truncated");
+            }
+            auto column = reinterpret_cast<const ValueType*>(position);
+            position += AlignedSize(count * sizeof(ValueType));
+            return column;
+        }
+
+        // Checks that a column of offsets starts at 0, never decreases and ends within the column it indexes into
+        void CheckOffsets(const uint64_t* offsets, uint64_t numExamples, uint64_t columnSize)
+        {
+            if (offsets[0] != 0 || offsets[numExamples] > columnSize)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::badData, "Binary dataset file has offsets outside its data");
+            }
+            for (uint64_t index = 0; index < numExamples; ++index)
+            {
+                if (offsets[index + 1] < offsets[index])
+                {
+                    throw utilities::InputException(utilities::InputExceptionErrors::badData, "Binary dataset file has decreasing offsets");
+                }
+            }
+        }
+
+        // Iterates over the values of a sparse example, straight out of the index and value columns
+        class SparseColumnIndexValueIterator : public IIndexValueIterator
+        {
+        public:
+            SparseColumnIndexValueIterator(const uint32_t* indices, const double* values, size_t size) :
+                _indices(indices),
+                _values(values),
+                _size(size)
+            {
+            }
+
+            bool IsValid() const { return _current < _size; }
+            void Next() { ++_current; }
+            IndexValue Get() const { return { _indices[_current], _values[_current] }; }
+
+        private:
+            const uint32_t* _indices;
+            const double* _values;
+            size_t _size;
+            size_t _current = 0;
+        };
+
+        template <typename ExampleType>
+        class BinaryDatasetExampleIterator : public IExampleIterator<ExampleType>
+        {
+        public:
+            using GetExampleFunction = ExampleType (BinaryDataset::*)(size_t) const;
+
+            BinaryDatasetExampleIterator(BinaryDataset dataset, GetExampleFunction getExample, size_t fromIndex) :
+                _dataset(std::move(dataset)),
+                _getExample(getExample),
+                _current(fromIndex)
+            {
+            }
+
+            bool IsValid() const override { return _current < _dataset.NumExamples(); }
+            void Next() override { ++_current; }
+            ExampleType Get() const override { return (_dataset.*_getExample)(_current); }
+
+        private:
+            BinaryDataset _dataset;
+            GetExampleFunction _getExample;
+            size_t _current;
+        };
+    } // namespace
+
+    //
+    // BinaryDatasetWriter
+    //
+    BinaryDatasetWriter::ColumnFile::ColumnFile(std::string filepath) :
+        _filepath(std::move(filepath)),
+        _stream(utilities::OpenBinaryOfstream(_filepath))
+    {
+    }
+
+    BinaryDatasetWriter::ColumnFile::~ColumnFile()
+    {
+        _stream.close();
+        std::remove(_filepath.c_str());
+    }
+
+    void BinaryDatasetWriter::ColumnFile::CopyTo(std::ostream& stream)
+    {
+        _stream.close();
+        if (_stream.fail())
+        {
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotWritable, "Error writing temporary file " + _filepath);
+        }
+
+        auto input = utilities::OpenBinaryIfstream(_filepath);
+        std::vector<char> buffer(c_copyBufferSize);
+        while (input.read(buffer.data(), buffer.size()) || input.gcount() > 0)
+        {
+            stream.write(buffer.data(), input.gcount());
+        }
+
+        const std::vector<char> padding(AlignedSize(_size) - _size, 0);
+        stream.write(padding.data(), padding.size());
+    }
+
+    BinaryDatasetWriter::BinaryDatasetWriter(const std::string& filepath) :
+        _filepath(filepath),
+        _weights(filepath + ".weights.tmp"),
+        _labels(filepath + ".labels.tmp"),
+        _valueOffsets(filepath + ".valueOffsets.tmp"),
+        _indexOffsets(filepath + ".indexOffsets.tmp"),
+        _indices(filepath + ".indices.tmp"),
+        _values(filepath + ".values.tmp")
+    {
+        _valueOffsets.Append<uint64_t>(0);
+        _indexOffsets.Append<uint64_t>(0);
+    }
+
+    void BinaryDatasetWriter::CheckNotWritten() const
+    {
+        if (_written)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "The binary dataset has already been written");
+        }
+    }
+
+    void BinaryDatasetWriter::Write()
+    {
+        CheckNotWritten();
+        _written = true;
+
+        BinaryDatasetHeader header{};
+        std::memcpy(header.magic, c_binaryDatasetMagic, sizeof(header.magic));
+        header.version = c_binaryDatasetVersion;
+        header.numExamples = _numExamples;
+        header.numValues = _numValues;
+        header.numIndices = _numIndices;
+        header.maxPrefixLength = _maxPrefixLength;
+
+        auto stream = utilities::OpenBinaryOfstream(_filepath);
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        _weights.CopyTo(stream);
+        _labels.CopyTo(stream);
+        _valueOffsets.CopyTo(stream);
+        _indexOffsets.CopyTo(stream);
+        _indices.CopyTo(stream);
+        _values.CopyTo(stream);
+
+        stream.close();
+        if (stream.fail())
+        {
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotWritable, "Error writing " + _filepath);
+        }
+    }
+
+    //
+    // BinaryDataset
+    //
+    BinaryDataset::BinaryDataset(const std::string& filepath) :
+        _file(std::make_shared<utilities::MemoryMappedFile>(filepath))
+    {
+        const char* position = _file->GetData();
+        const char* end = position + _file->GetSize();
+        if (_file->GetSize() < sizeof(BinaryDatasetHeader) || std::memcmp(position, c_binaryDatasetMagic, sizeof(c_binaryDatasetMagic)) != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::badData, filepath + " isn't a binary dataset file");
+        }
+
+        const auto& header = *reinterpret_cast<const BinaryDatasetHeader*>(position);
+        if (header.version != c_binaryDatasetVersion)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::versionMismatch, "Unsupported binary dataset version in " + filepath);
+        }
+        position += AlignedSize(sizeof(BinaryDatasetHeader));
+
+        if (header.numExamples >= static_cast<uint64_t>(end - position) / sizeof(uint64_t))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::badData, "Binary dataset file is truncated");
+        }
+
+        _numExamples = header.numExamples;
+        _maxPrefixLength = header.maxPrefixLength;
+        _weights = ReadColumn<double>(position, end, _numExamples);
+        _labels = ReadColumn<double>(position, end, _numExamples);
+        _valueOffsets = ReadColumn<uint64_t>(position, end, _numExamples + 1);
+        _indexOffsets = ReadColumn<uint64_t>(position, end, _numExamples + 1);
+        _indices = ReadColumn<uint32_t>(position, end, header.numIndices);
+        _values = ReadColumn<double>(position, end, header.numValues);
+
+        // Validate the offsets once here, so looking up an example can't read outside the file
+        CheckOffsets(_valueOffsets, _numExamples, header.numValues);
+        CheckOffsets(_indexOffsets, _numExamples, header.numIndices);
+        for (size_t index = 0; index < _numExamples; ++index)
+        {
+            const auto numIndices = _indexOffsets[index + 1] - _indexOffsets[index];
+            if (numIndices != 0 && numIndices != _valueOffsets[index + 1] - _valueOffsets[index])
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::badData, "Binary dataset file has a sparse example whose index and value counts differ");
+            }
+        }
+    }
+
+    AutoDataVector BinaryDataset::GetDataVector(size_t index) const
+    {
+        if (index >= _numExamples)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Example index out of range");
+        }
+
+        const auto valueBegin = _valueOffsets[index];
+        const auto size = _valueOffsets[index + 1] - valueBegin;
+        const auto indexBegin = _indexOffsets[index];
+        if (_indexOffsets[index + 1] == indexBegin)
+        {
+            // A dense example
+            const auto values = _values + valueBegin;
+            return AutoDataVector(StlIndexValueIterator<IterationPolicy::skipZeros, const double*>(values, values + size, size));
+        }
+        return AutoDataVector(SparseColumnIndexValueIterator(_indices + indexBegin, _values + valueBegin, size));
+    }
+
+    AutoSupervisedExample BinaryDataset::GetExample(size_t index) const
+    {
+        auto dataVector = GetDataVector(index);
+        return AutoSupervisedExample(std::move(dataVector), WeightLabel{ _weights[index], _labels[index] });
+    }
+
+    AutoSupervisedMultiClassExample BinaryDataset::GetMultiClassExample(size_t index) const
+    {
+        auto dataVector = GetDataVector(index);
+        return AutoSupervisedMultiClassExample(std::move(dataVector), WeightClassIndex{ _weights[index], static_cast<size_t>(_labels[index]) });
+    }
+
+    AutoSupervisedExampleIterator BinaryDataset::GetExampleIterator(size_t fromIndex) const
+    {
+        return AutoSupervisedExampleIterator(std::make_unique<BinaryDatasetExampleIterator<AutoSupervisedExample>>(*this, &BinaryDataset::GetExample, fromIndex));
+    }
+
+    AutoSupervisedMultiClassExampleIterator BinaryDataset::GetMultiClassExampleIterator(size_t fromIndex) const
+    {
+        return AutoSupervisedMultiClassExampleIterator(std::make_unique<BinaryDatasetExampleIterator<AutoSupervisedMultiClassExample>>(*this, &BinaryDataset::GetMultiClassExample, fromIndex));
+    }
+
+    bool IsBinaryDatasetFile(const std::string& filepath)
+    {
+        if (!utilities::IsFileReadable(filepath))
+        {
+            return false;
+        }
+
+        auto stream = utilities::OpenBinaryIfstream(filepath);
+        char magic[sizeof(c_binaryDatasetMagic)] = {};
+        stream.read(magic, sizeof(magic));
+        return stream.gcount() == sizeof(magic) && std::memcmp(magic, c_binaryDatasetMagic, sizeof(magic)) == 0;
+    }
+} // namespace data
+} // namespace ell
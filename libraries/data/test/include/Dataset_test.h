@@ -12,4 +12,6 @@ namespace ell
 {
 void DatasetCastingTests();
 void DatasetSerializationTests();
+void BinaryDatasetTests();
+void ExampleShardReaderTests();
 } // namespace ell
\ No newline at end of file
@@ -10,14 +10,24 @@
 
 #include <common/include/DataLoaders.h>
 
+#include <data/include/BinaryDataset.h>
 #include <data/include/Dataset.h>
+#include <data/include/ExampleShardReader.h>
 
+#include <utilities/include/Exception.h>
 #include <utilities/include/Files.h>
 #include <utilities/include/StringUtil.h>
 
 #include <testing/include/testing.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <random>
 #include <sstream>
+#include <vector>
 
 namespace ell
 {
@@ -119,4 +129,175 @@ void DatasetSerializationTests()
     }
     testing::ProcessTest(utilities::FormatString("DatasetSerializationTest data %d errors", errors), errors == 0);
 }
+
+void BinaryDatasetTests()
+{
+    // A sparse example, a dense example and an empty one
+    data::Dataset<data::AutoSupervisedExample> dataset1;
+    dataset1.AddExample(data::AutoSupervisedExample(data::AutoDataVector(std::vector<data::IndexValue>{ { 3, 1.5 }, { 1000, -2.0 } }), data::WeightLabel{ 0.5, -1 }));
+    dataset1.AddExample(data::AutoSupervisedExample(data::AutoDataVector(std::vector<double>{ 1, 2, 0, 4.25, 5 }), data::WeightLabel{ 1, 1 }));
+    dataset1.AddExample(data::AutoSupervisedExample(data::AutoDataVector(std::vector<double>{}), data::WeightLabel{ 2, 3 }));
+
+    const std::string filename("dataset1.elldata");
+    {
+        data::BinaryDatasetWriter writer(filename);
+        for (size_t i = 0; i < dataset1.NumExamples(); ++i)
+        {
+            const auto& example = dataset1.GetExample(i);
+            writer.AddExample(example.GetDataVector(), example.GetMetadata());
+        }
+        writer.Write();
+    }
+    testing::ProcessTest("BinaryDatasetTest magic number", data::IsBinaryDatasetFile(filename));
+    testing::ProcessTest("BinaryDatasetTest temporary files deleted", !utilities::FileExists(filename + ".values.tmp") && !utilities::FileExists(filename + ".weights.tmp"));
+
+    {
+        data::BinaryDataset binaryDataset(filename);
+        auto dataset2 = data::MakeDataset(binaryDataset.GetExampleIterator());
+        testing::ProcessTest("BinaryDatasetTest size", dataset1.NumExamples() == dataset2.NumExamples());
+        testing::ProcessTest("BinaryDatasetTest features", binaryDataset.NumFeatures() == 1001 && dataset1.NumFeatures() == dataset2.NumFeatures());
+        int errors = 0;
+        if (dataset1.NumExamples() == dataset2.NumExamples())
+        {
+            for (size_t i = 0; i < dataset1.NumExamples(); i++)
+            {
+                auto e1 = dataset1.GetExample(i);
+                auto e2 = dataset2.GetExample(i);
+
+                auto sameVector = testing::IsEqual(e1.GetDataVector().ToArray(), e2.GetDataVector().ToArray());
+                auto sameLabel = e1.GetMetadata().label == e2.GetMetadata().label;
+                auto sameWeight = e1.GetMetadata().weight == e2.GetMetadata().weight;
+                if (!(sameVector && sameLabel && sameWeight))
+                {
+                    errors++;
+                }
+            }
+        }
+        testing::ProcessTest(utilities::FormatString("BinaryDatasetTest data %d errors", errors), errors == 0);
+        testing::ProcessTest("BinaryDatasetTest class index", binaryDataset.GetMultiClassExample(2).GetMetadata().classIndex == 3);
+    }
+
+    // Corrupt files are rejected when they're opened, rather than read out of bounds later
+    {
+        std::string contents;
+        {
+            auto inputStream = utilities::OpenBinaryIfstream(filename);
+            contents.assign(std::istreambuf_iterator<char>(inputStream), std::istreambuf_iterator<char>());
+        }
+
+        auto isRejected = [](const std::string& corruptFilename, const std::string& corruptContents) {
+            {
+                auto outputStream = utilities::OpenBinaryOfstream(corruptFilename);
+                outputStream.write(corruptContents.data(), corruptContents.size());
+            }
+            bool threw = false;
+            try
+            {
+                data::BinaryDataset corruptDataset(corruptFilename);
+            }
+            catch (const utilities::InputException&)
+            {
+                threw = true;
+            }
+            std::remove(corruptFilename.c_str());
+            return threw;
+        };
+
+        // The last value offset of the 3 examples comes after the header and the weight and label columns (64 bytes each)
+        const size_t lastValueOffsetPosition = 3 * 64 + 3 * sizeof(uint64_t);
+        auto badOffset = contents;
+        const uint64_t hugeOffset = uint64_t{ 1 } << 60;
+        std::memcpy(&badOffset[lastValueOffsetPosition], &hugeOffset, sizeof(hugeOffset));
+
+        auto badCount = contents;
+        const uint64_t hugeCount = ~uint64_t{ 0 } / 2;
+        std::memcpy(&badCount[offsetof(data::BinaryDatasetHeader, numValues)], &hugeCount, sizeof(hugeCount));
+
+        testing::ProcessTest("BinaryDatasetTest truncated file", isRejected("dataset1_truncated.elldata", contents.substr(0, contents.size() - 64)));
+        testing::ProcessTest("BinaryDatasetTest bad offset", isRejected("dataset1_bad_offset.elldata", badOffset));
+        testing::ProcessTest("BinaryDatasetTest bad count", isRejected("dataset1_bad_count.elldata", badCount));
+    }
+
+    // Text files aren't mistaken for binary ones
+    auto stream = utilities::OpenOfstream("dataset1.txt");
+    dataset1.Print(stream);
+    stream.close();
+    testing::ProcessTest("BinaryDatasetTest text file", !data::IsBinaryDatasetFile("dataset1.txt"));
+
+    std::remove(filename.c_str());
+}
+
+// Every pass must read each example once, in shards that start where `GetShardOffset()` says, and a reader that can
+// start at any example must visit the shards in a random order once it has seen them all
+void ExampleShardReaderTests()
+{
+    const size_t numExamples = 10;
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < numExamples; ++i)
+    {
+        dataset.AddExample({ { 1.0, 2.0 }, { 1.0, static_cast<double>(i) } });
+    }
+
+    // Room for 3 examples per shard, so the shards hold 3, 3, 3 and 1 examples
+    const size_t maxShardBytes = 3 * data::ExampleShardReader<data::AutoSupervisedExample>::EstimateExampleSize(dataset[0]);
+
+    // Reads a pass and returns the offsets of its shards, or an empty vector if the pass isn't valid
+    auto readPass = [numExamples](data::ExampleShardReader<data::AutoSupervisedExample>& reader) {
+        std::vector<size_t> offsets;
+        std::vector<int> timesRead(numExamples, 0);
+        while (reader.Next())
+        {
+            const auto& shard = reader.GetShard();
+            for (size_t i = 0; i < shard.NumExamples(); ++i)
+            {
+                auto index = reader.GetShardOffset() + i;
+                if (index >= numExamples || shard[i].GetMetadata().label != static_cast<double>(index))
+                {
+                    return std::vector<size_t>{};
+                }
+                ++timesRead[index];
+            }
+            offsets.push_back(reader.GetShardOffset());
+        }
+        for (auto count : timesRead)
+        {
+            if (count != 1)
+            {
+                return std::vector<size_t>{};
+            }
+        }
+        return offsets;
+    };
+
+    const std::vector<size_t> inOrder = { 0, 3, 6, 9 };
+    std::default_random_engine random(1234);
+
+    data::ExampleShardReader<data::AutoSupervisedExample> sequentialReader([&dataset]() { return dataset.GetExampleIterator(); }, maxShardBytes);
+    sequentialReader.Reset();
+    auto firstSequentialPass = readPass(sequentialReader);
+    sequentialReader.Reset(random);
+    auto secondSequentialPass = readPass(sequentialReader);
+    testing::ProcessTest("ExampleShardReaderTest sequential", firstSequentialPass == inOrder && secondSequentialPass == inOrder);
+
+    data::ExampleShardReader<data::AutoSupervisedExample> indexedReader([&dataset](size_t fromIndex) { return dataset.GetExampleIterator(fromIndex); }, maxShardBytes);
+    indexedReader.Reset(random);
+    auto firstIndexedPass = readPass(indexedReader);
+    testing::ProcessTest("ExampleShardReaderTest first pass in order", firstIndexedPass == inOrder);
+
+    bool allPassesValid = true;
+    bool anyPassShuffled = false;
+    for (int pass = 0; pass < 5; ++pass)
+    {
+        indexedReader.Reset(random);
+        auto offsets = readPass(indexedReader);
+        auto sortedOffsets = offsets;
+        std::sort(sortedOffsets.begin(), sortedOffsets.end());
+        allPassesValid = allPassesValid && sortedOffsets == inOrder;
+        anyPassShuffled = anyPassShuffled || offsets != inOrder;
+    }
+    testing::ProcessTest("ExampleShardReaderTest shuffled passes", allPassesValid && anyPassShuffled);
+
+    indexedReader.Reset();
+    testing::ProcessTest("ExampleShardReaderTest in-order pass", readPass(indexedReader) == inOrder);
+}
 } // namespace ell
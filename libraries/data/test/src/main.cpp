@@ -27,6 +27,8 @@ int main()
     ExampleCopyAsTests();
     DatasetCastingTests();
     DatasetSerializationTests();
+    BinaryDatasetTests();
+    ExampleShardReaderTests();
     DataVectorParseTest();
     AutoDataVectorParseTest();
     SingleFileParseTest();
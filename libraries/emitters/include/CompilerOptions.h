@@ -61,6 +61,15 @@ namespace emitters
         /// <summary> Maximum num of parallel threads. </summary>
         int maxThreads = 4;
 
+        /// <summary> Give each thread pool worker its own task deque and let idle workers steal tasks from busy ones,
+        /// instead of handing out tasks from a single shared queue. </summary>
+        bool useWorkStealing = false;
+
+        /// <summary> Keep the model's mutable state (node state, port buffers and scratch arrays) in a context that
+        /// the caller allocates with `<module>_CreateContext`, so the same code can be run concurrently from multiple
+        /// threads, each with its own context. Can't be used with `parallelize`. </summary>
+        bool threadSafe = false;
+
         /// <summary> Allow emitting more efficient code that isn't necessarily IEEE-754 compatible. </summary>
         bool useFastMath = true;
 
@@ -98,6 +107,22 @@ namespace emitters
         /// <summary> Skip ELLCode optimization. </summary>
         bool skip_ellcode = false;
 
+        /// <summary> File that holds the tuned schedule parameters (e.g., GEMM tile sizes) for each loop nest problem. </summary>
+        std::string scheduleTuningCache;
+
+        /// <summary> Time the candidate schedules of loop nests missing from the schedule tuning cache, and add the fastest to it (only for host targets). </summary>
+        bool tuneSchedules = false;
+
+        /// <summary> Store large constant arrays (e.g., weights) in a separate binary file instead of in the module, and emit a
+        /// `<module>_SetWeights` function that points the code at a copy of it loaded at runtime. </summary>
+        bool externalWeights = false;
+
+        /// <summary> Number of threads to run LLVM's function optimization passes on (0 means one per hardware thread).
+        /// The generated code is the same for any number of threads. The function passes are only a small part of the
+        /// compile time (the module passes and code generation always run on one thread), and splitting the module
+        /// between threads and linking it back costs more than that, so this is off (1) unless asked for. </summary>
+        int numCompilerThreads = 1;
+
     private:
         void AddOptions(const utilities::PropertyBag& properties);
     };
@@ -90,6 +90,15 @@ namespace emitters
         /// <returns> Pointer to the llvm::BasicBlock that represents the for loop. </returns>
         llvm::BasicBlock* Begin(LLVMValue iStartAt, LLVMValue iMaxValue, LLVMValue stepSize);
 
+        /// <summary>
+        /// Marks the loop to be vectorized with the given number of lanes. When the module is optimized, the loop is emitted
+        /// as vector loads, arithmetic and stores if its iterations are provably independent (see `CreateLoopVectorizerPass`),
+        /// and is otherwise left to LLVM's loop vectorizer. Must be called after the body is emitted and before `End()`.
+        /// </summary>
+        ///
+        /// <param name="vectorWidth"> The number of iterations to execute with each vector instruction. </param>
+        void SetVectorized(int vectorWidth);
+
         /// <summary> Emits the end of this for loop. </summary>
         void End();
 
@@ -105,6 +114,7 @@ namespace emitters
         llvm::BasicBlock* _pBodyBlock = nullptr; // The body of the for loop
         llvm::BasicBlock* _pIncrementBlock = nullptr; // Here we increment the iteration variable
         llvm::BasicBlock* _pAfterBlock = nullptr; // When the loop is done, we branch to this block
+        llvm::BranchInst* _pConditionBranch = nullptr; // The branch that carries the loop's metadata
         LLVMValue _pIterationVariable = nullptr;
         std::string _tag;
     };
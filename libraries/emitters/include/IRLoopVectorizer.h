@@ -0,0 +1,34 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRLoopVectorizer.h (emitters)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <llvm/Pass.h>
+
+namespace ell
+{
+namespace emitters
+{
+    /// <summary> The loop property `IRForLoopEmitter::SetVectorized` uses to mark a loop, with the number of lanes as its value. </summary>
+    extern const char* const c_vectorizeWidthLoopProperty;
+
+    /// <summary>
+    /// Creates a function pass that rewrites the loops marked with `c_vectorizeWidthLoopProperty` as vector code: each
+    /// iteration of the new loop does the work of one iteration per lane, with vector loads, arithmetic (and fused
+    /// multiply-adds) and stores. A loop is only rewritten if it is a single block with a trip count that's a multiple of
+    /// the width, and scalar evolution and alias analysis show that its iterations are independent: every store writes
+    /// consecutive elements, no value is carried from one iteration to the next other than the induction variables, and
+    /// no access touches an element another lane stores to. Other marked loops are left to LLVM's loop vectorizer.
+    /// </summary>
+    ///
+    /// <param name="fuseMultiplyAdd"> Whether a multiply followed by an add may be emitted as a fused multiply-add,
+    /// which skips the rounding of the product. </param>
+    ///
+    /// <returns> The new pass. </returns>
+    llvm::FunctionPass* CreateLoopVectorizerPass(bool fuseMultiplyAdd);
+} // namespace emitters
+} // namespace ell
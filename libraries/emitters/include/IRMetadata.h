@@ -56,6 +56,18 @@ namespace emitters
     /// </remarks>
     static const std::string c_stepTimeFunctionTagName = "ell.fn.stepTime";
 
+    /// <summary> Indicates a global variable that holds a pointer into the external weights rather than the array itself. </summary>
+    /// <remarks>
+    /// Set a global-level tag, see `CompilerOptions::externalWeights`.
+    /// </remarks>
+    static const std::string c_externalWeightsTagName = "ell.global.externalWeights";
+
+    /// <summary> Indicates a mutable global that's part of the model's state, which is moved into a caller-owned context. </summary>
+    /// <remarks>
+    /// Set a global-level tag, see `CompilerOptions::threadSafe`.
+    /// </remarks>
+    static const std::string c_contextStateTagName = "ell.global.contextState";
+
     /// <summary> Gets tag to Indicate the names of a struct's fields. </summary>
     /// <remarks>
     /// Returns a module-level tag, with the type name encoded in the name and field names as the value.
@@ -39,6 +39,7 @@
 #include <memory>
 #include <stack>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -127,6 +128,9 @@ namespace emitters
         /// <summary> End your reset function created with BeginResetFunction. </summary>
         void EndResetFunction() { EndFunction(); }
 
+        /// <summary> Gets the number of functions created with BeginResetFunction. </summary>
+        size_t NumResetFunctions() const { return _resetFunctions.size(); }
+
         /// <summary> Begins an IR function with no arguments and directs subsequent commands to it. </summary>
         ///
         /// <param name="functionName"> The name of the function. </param>
@@ -233,6 +237,10 @@ namespace emitters
         /// <param name="value"> The array constant value. </param>
         ///
         /// <returns> Pointer to the llvm::GlobalVariable that represents the constant. </returns>
+        /// <remarks>
+        /// If the `externalWeights` compiler option is set and the array is large, its contents go to the external weights
+        /// instead, and the global holds a pointer to them (see `IsExternalWeightsPointer`).
+        /// </remarks>
         template <typename ValueType>
         llvm::GlobalVariable* ConstantArray(const std::string& name, const std::vector<ValueType>& value);
 
@@ -541,6 +549,54 @@ namespace emitters
         /// <param name="options"> Options to control how machine code is generated during output. </params>
         void WriteToStream(std::ostream& stream, ModuleOutputFormat format, const MachineCodeOutputOptions& options);
 
+        //
+        // External weights
+        //
+
+        /// <summary> Indicates if any constant arrays were stored in the external weights (see `CompilerOptions::externalWeights`). </summary>
+        bool HasExternalWeights() const { return !_externalWeightsOffsets.empty(); }
+
+        /// <summary> Gets the contents of the external weights file. </summary>
+        const std::vector<char>& GetExternalWeights() const { return _externalWeights; }
+
+        /// <summary> Writes the external weights to a file, to be loaded at runtime and passed to `<module>_SetWeights`. </summary>
+        ///
+        /// <param name="filePath"> The path of the file to write to. </param>
+        void WriteExternalWeights(const std::string& filePath) const;
+
+        /// <summary> Emits the `void <module>_SetWeights(char* weights)` function, which points the code at a copy of
+        /// the external weights that's been loaded (or memory-mapped) at an address aligned to `c_externalWeightsAlignment`. </summary>
+        void EmitSetWeightsFunction();
+
+        /// <summary> Indicates if a value is a global that holds a pointer into the external weights, rather than an array. </summary>
+        static bool IsExternalWeightsPointer(LLVMValue value);
+
+        /// <summary> The alignment of each array in the external weights, relative to the start of the file. </summary>
+        static constexpr size_t c_externalWeightsAlignment = 64;
+
+        //
+        // Caller-owned model state
+        //
+
+        /// <summary>
+        /// Moves the model's mutable globals (see `CompilerOptions::threadSafe`) into one struct, and emits
+        /// `<module>_CreateContext` and `<module>_DestroyContext` to allocate and free a copy of it. New contexts are
+        /// initialized from a constant copy of the initial state. The code reaches
+        /// the state through a thread-local pointer, which points at a default copy unless a function emitted by
+        /// `EmitWithContextFunction` is running on the thread.
+        /// </summary>
+        /// <remarks> Call this once, after all the code that uses the model's globals has been emitted. </remarks>
+        void EmitContextFunctions();
+
+        /// <summary> Emits `<functionName>WithContext`, which takes a context from `<module>_CreateContext` followed by
+        /// the arguments of `functionName`, and calls `functionName` using the state in that context. </summary>
+        ///
+        /// <param name="functionName"> The name of the function to wrap. </param>
+        /// <param name="includeInHeader"> Whether to declare the new function in the generated header. </param>
+        ///
+        /// <returns> The name of the new function. </returns>
+        std::string EmitWithContextFunction(const std::string& functionName, bool includeInHeader);
+
         /// <summary> Load LLVM IR text into this module. </summary>
         ///
         /// <param name="text"> The IR text. </param>
@@ -556,6 +612,24 @@ namespace emitters
         /// <param name="filename"> The name of the file containing the IR </param>
         void LoadIRFromFile(const std::string& filename);
 
+        /// <summary>
+        /// Gets the bitcode for a function as a standalone module that can be linked into another module with
+        /// `LinkBitcode`. The module contains the function and the internal functions and globals it uses, and
+        /// declarations for everything else it refers to.
+        /// </summary>
+        ///
+        /// <param name="functionName"> The name of the function. </param>
+        /// <param name="bitcode"> [out] The bitcode. </param>
+        ///
+        /// <returns> `true` if the function was extracted, `false` if it isn't defined in this module or it uses a
+        /// definition that another module wouldn't have, like a non-internal global or the external weights. </returns>
+        bool TryGetFunctionBitcode(const std::string& functionName, std::string& bitcode) const;
+
+        /// <summary> Links a module of LLVM bitcode into this module, resolving its declarations against this module's definitions. </summary>
+        ///
+        /// <param name="bitcode"> The bitcode. </param>
+        void LinkBitcode(const std::string& bitcode);
+
         /// <summary> Load Assembler text into this module. </summary>
         ///
         /// <param name="text"> The IR text. </param>
@@ -778,6 +852,10 @@ namespace emitters
         template <typename T>
         LLVMValue EmitRef(VectorElementVariable<T>& var);
 
+        /// Emit IR for a global vector that is a view into another global vector.
+        template <typename T>
+        LLVMValue EmitGlobalVectorView(VectorViewVariable<T>& var);
+
         IRFunctionEmitter Function(const std::string& name, VariableType returnType, bool isPublic = false);
         IRFunctionEmitter Function(const std::string& name, VariableType returnType, const VariableTypeList& arguments, bool isPublic = false);
         IRFunctionEmitter Function(const std::string& name, VariableType returnType, const NamedVariableTypeList& arguments, bool isPublic = false);
@@ -803,6 +881,8 @@ namespace emitters
         //
         void SetCompilerOptions(const CompilerOptions& parameters) override;
         llvm::GlobalVariable* AddGlobal(const std::string& name, LLVMType pType, llvm::Constant* pInitial, bool isConst, bool isThreadLocal = false);
+        bool ShouldStoreExternally(size_t sizeInBytes) const;
+        llvm::GlobalVariable* AddExternalConstantArray(const std::string& name, LLVMType pElementType, const char* data, size_t sizeInBytes);
         IRFunctionEmitter Function(const std::string& name, VariableType returnType, const VariableTypeList* pArguments, bool isPublic);
         llvm::Function::LinkageTypes Linkage(bool isPublic);
         llvm::ConstantAggregateZero* ZeroInitializer(LLVMType pType);
@@ -831,6 +911,10 @@ namespace emitters
         std::vector<std::string> _resetFunctions;
         std::map<std::string, FunctionDeclaration> _functions;
 
+        // Constant arrays stored outside the module, and the offset of each one's global in them
+        std::vector<char> _externalWeights;
+        std::vector<std::pair<llvm::GlobalVariable*, size_t>> _externalWeightsOffsets;
+
         ell::utilities::CallbackRegistry<float> _floatCallbacks;
         ell::utilities::CallbackRegistry<double> _doubleCallbacks;
         ell::utilities::CallbackRegistry<int> _intCallbacks;
@@ -871,6 +955,14 @@ namespace emitters
     template <typename ValueType>
     llvm::GlobalVariable* IRModuleEmitter::ConstantArray(const std::string& name, const std::vector<ValueType>& value)
     {
+        // Strings and bit vectors stay in the module
+        if constexpr (!std::is_same_v<ValueType, char> && !std::is_same_v<ValueType, bool>)
+        {
+            if (ShouldStoreExternally(value.size() * sizeof(ValueType)))
+            {
+                return AddExternalConstantArray(name, GetIREmitter().Type(GetVariableType<ValueType>()), reinterpret_cast<const char*>(value.data()), value.size() * sizeof(ValueType));
+            }
+        }
         return AddGlobal(name, GetIREmitter().ArrayType(GetVariableType<ValueType>(), value.size()), GetIREmitter().Literal(value), true);
     }
 
@@ -956,7 +1048,11 @@ namespace emitters
             break;
 
         case VariableScope::global:
-            if (var.HasInitValue())
+            if (var.IsVectorRef())
+            {
+                pVal = EmitGlobalVectorView<T>(static_cast<VectorViewVariable<T>&>(var));
+            }
+            else if (var.HasInitValue())
             {
                 pVal = EmitGlobalVector<T>(static_cast<InitializedVectorVariable<T>&>(var));
             }
@@ -1040,6 +1136,19 @@ namespace emitters
         LLVMValue pSrcVar = EnsureEmitted(var.Src());
         return currentFunction.PtrOffsetA(pSrcVar, currentFunction.Literal(var.Offset()), var.EmittedName());
     }
+
+    template <typename T>
+    LLVMValue IRModuleEmitter::EmitGlobalVectorView(VectorViewVariable<T>& var)
+    {
+        // The view is a constant expression (not an instruction), so it can be used from any function in the module
+        auto pSrcVar = llvm::cast<llvm::Constant>(EnsureEmitted(var.Src()));
+        auto& context = GetLLVMContext();
+        auto int8Type = llvm::Type::getInt8Ty(context);
+        auto pBytes = llvm::ConstantExpr::getBitCast(pSrcVar, int8Type->getPointerTo());
+        auto pOffset = llvm::ConstantInt::get(llvm::Type::getInt64Ty(context), var.ByteOffset());
+        auto pView = llvm::ConstantExpr::getGetElementPtr(int8Type, pBytes, pOffset);
+        return llvm::ConstantExpr::getBitCast(pView, GetIREmitter().PointerType(GetVariableType<T>()));
+    }
 } // namespace emitters
 } // namespace ell
 
@@ -11,6 +11,8 @@
 
 #include <llvm/IR/LegacyPassManager.h>
 
+#include <cstddef>
+
 namespace ell
 {
 namespace emitters
@@ -38,6 +40,16 @@ namespace emitters
         void OptimizeFunction(LLVMFunction pFunction);
         void EndOptimizeFunctions();
 
+        /// <summary> Runs the function optimization passes on every function in the module, on several threads.
+        /// Each thread works on a copy of some of the functions in a context of its own, and the optimized functions
+        /// are then linked back into the module. The passes only look at one function at a time, so the result
+        /// is the same as optimizing each function with `OptimizeFunction`, apart from the order of the functions in the module.
+        /// With one thread (or one function) the functions are optimized in place, without copying them. </summary>
+        ///
+        /// <param name="pModule"> The module. </param>
+        /// <param name="numThreads"> The number of threads to use. </param>
+        void OptimizeFunctionsInParallel(llvm::Module* pModule, size_t numThreads);
+
         /// <summary> Optimize the module. </summary>
         void OptimizeModule(llvm::Module* pModule);
 
@@ -27,7 +27,7 @@ namespace emitters
     class IRThreadPoolTaskArray;
 
     //
-    // IRThreadPool: Simple thread pool class that schedules tasks in blocks, and associated classes:
+    // IRThreadPool: Simple thread pool class that schedules tasks in blocks (optionally with work stealing), and associated classes:
     //
     // IRThreadPoolTask
     // IRThreadPoolTaskArray
@@ -143,9 +143,15 @@ namespace emitters
         /// <summary> Pop a task off the task queue, waiting for one to become available if necessary. </summary>
         ///
         /// <param name="function"> The function currently being emitted into. </param>
+        /// <param name="workerIndex"> The index of the worker thread asking for a task. Only used when work stealing is enabled. </param>
         ///
-        /// <returns> The next task in the queue. </param>
-        IRThreadPoolTask PopNextTask(IRFunctionEmitter& function);
+        /// <returns> The next task in the queue, or a null task if the queue is shutting down. </param>
+        IRThreadPoolTask PopNextTask(IRFunctionEmitter& function, LLVMValue workerIndex);
+
+        /// <summary> Record that a task popped off the queue has finished, waking up any clients waiting on the tasks if it was the last one. </summary>
+        ///
+        /// <param name="function"> The function currently being emitted into. </param>
+        void FinishTask(IRFunctionEmitter& function);
 
         /// <summary> Wait for all tasks to finish. </summary>
         ///
@@ -160,8 +166,12 @@ namespace emitters
     private:
         friend class IRThreadPool;
         IRThreadPoolTaskQueue(); // create an empty queue
-        void Initialize(IRFunctionEmitter& function); // initializes the task array
+        void Initialize(IRFunctionEmitter& function, int numWorkers, bool useWorkStealing); // initializes the task array
         LLVMValue GetDataStruct() { return _queueData; }
+        IRThreadPoolTask PopNextSharedTask(IRFunctionEmitter& function);
+        IRThreadPoolTask PopNextStolenTask(IRFunctionEmitter& function, LLVMValue workerIndex);
+        void DistributeTasks(IRFunctionEmitter& function, int numTasks);
+        LLVMValue TryClaimTask(IRFunctionEmitter& function, LLVMValue workerIndex);
         LLVMValue DecrementCountField(IRFunctionEmitter& function, LLVMValue fieldPtr);
         llvm::StructType* GetTaskQueueDataType(IRModuleEmitter& module) const;
 
@@ -196,6 +206,11 @@ namespace emitters
         };
         LLVMValue _queueData = nullptr; // a struct with the above fields
         IRThreadPoolTaskArray _tasks;
+
+        // work stealing
+        int _numWorkers = 0;
+        bool _useWorkStealing = false;
+        llvm::GlobalVariable* _taskDeques = nullptr; // global array with a packed [begin, end) range of task indices for each worker
     };
 
     //
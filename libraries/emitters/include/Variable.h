@@ -187,6 +187,9 @@ namespace emitters
         /// <summary> Add a reference to vector element </summary>
         Variable* AddVectorElementVariable(VariableType type, Variable& src, int offset);
 
+        /// <summary> Add a vector that is a view into another vector, starting at the given byte offset </summary>
+        Variable* AddVectorViewVariable(VariableType type, Variable& src, size_t byteOffset, int size);
+
     private:
         std::vector<std::shared_ptr<Variable>> _variables;
     };
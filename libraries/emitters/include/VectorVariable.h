@@ -75,6 +75,28 @@ namespace emitters
     private:
         std::vector<ElementType> _data;
     };
+
+    /// <summary>
+    /// A vector variable that refers to a region of another vector variable, starting at the given byte offset.
+    /// Used to place several logical vectors in one shared buffer.
+    /// </summary>
+    template <typename T>
+    class VectorViewVariable : public VectorVariable<T>
+    {
+    public:
+        /// <summary> Create a new view into the given variable </summary>
+        VectorViewVariable(Variable& src, size_t byteOffset, size_t size);
+
+        /// <summary> The variable this is a view into </summary>
+        Variable& Src() const { return _src; }
+
+        /// <summary> The offset of the view from the start of the source variable, in bytes </summary>
+        size_t ByteOffset() const { return _byteOffset; }
+
+    private:
+        Variable& _src;
+        size_t _byteOffset;
+    };
 } // namespace emitters
 } // namespace ell
 
@@ -124,6 +146,17 @@ namespace emitters
     {
         _data = VariableValueType<T>::ToVariableVector(data);
     }
+
+    //
+    // VectorViewVariable
+    //
+    template <typename T>
+    VectorViewVariable<T>::VectorViewVariable(Variable& src, size_t byteOffset, size_t size) :
+        VectorVariable<T>(src.Scope(), size, Variable::VariableFlags::isMutable | Variable::VariableFlags::isVectorRef),
+        _src(src),
+        _byteOffset(byteOffset)
+    {
+    }
 } // namespace emitters
 } // namespace ell
 
@@ -70,10 +70,16 @@ namespace emitters
         parallelize = properties.GetOrParseEntry<bool>("parallelize", parallelize);
         useThreadPool = properties.GetOrParseEntry<bool>("useThreadPool", useThreadPool);
         maxThreads = properties.GetOrParseEntry<int>("maxThreads", maxThreads);
+        useWorkStealing = properties.GetOrParseEntry<bool>("useWorkStealing", useWorkStealing);
+        threadSafe = properties.GetOrParseEntry<bool>("threadSafe", threadSafe);
         useFastMath = properties.GetOrParseEntry<bool>("useFastMath", useFastMath);
         debug = properties.GetOrParseEntry<bool>("debug", debug);
         globalValueAlignment = properties.GetOrParseEntry<int>("globalValueAlignment", globalValueAlignment);
         skip_ellcode = properties.GetOrParseEntry<bool>("skip_ellcode", skip_ellcode);
+        scheduleTuningCache = properties.GetOrParseEntry<std::string>("scheduleTuningCache", scheduleTuningCache);
+        tuneSchedules = properties.GetOrParseEntry<bool>("tuneSchedules", tuneSchedules);
+        externalWeights = properties.GetOrParseEntry<bool>("externalWeights", externalWeights);
+        numCompilerThreads = properties.GetOrParseEntry<int>("numCompilerThreads", numCompilerThreads);
 
         if (properties.HasEntry("deviceName"))
         {
@@ -955,6 +955,11 @@ namespace emitters
     LLVMValue IREmitter::DereferenceGlobalPointer(LLVMValue pArray)
     {
         assert(pArray != nullptr);
+        if (IRModuleEmitter::IsExternalWeightsPointer(pArray))
+        {
+            return _irBuilder.CreateLoad(pArray);
+        }
+
         LLVMValue derefArguments[1]{ Zero() };
 
         return _irBuilder.CreateGEP(pArray, derefArguments);
@@ -965,6 +970,12 @@ namespace emitters
         assert(pArray != nullptr);
         assert(pOffset != nullptr);
 
+        // Arrays in the external weights are reached through the pointer stored in the global
+        if (IRModuleEmitter::IsExternalWeightsPointer(pArray))
+        {
+            return _irBuilder.CreateGEP(_irBuilder.CreateLoad(pArray), pOffset);
+        }
+
         LLVMValue derefArguments[2]{ Zero(), pOffset };
 
         return _irBuilder.CreateGEP(pArray, derefArguments);
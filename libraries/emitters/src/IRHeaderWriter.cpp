@@ -237,6 +237,37 @@ namespace emitters
         }
     }
 
+    // Writes a helper that memory-maps the external weights file, so the pages are loaded on demand and
+    // shared between all the processes using the model
+    static void WriteExternalWeightsLoader(std::ostream& os, IRModuleEmitter& moduleEmitter)
+    {
+        std::string moduleName = moduleEmitter.GetModuleName();
+        os << "#if defined(__unix__) || defined(__APPLE__)\n";
+        os << "#include <fcntl.h>\n";
+        os << "#include <sys/mman.h>\n";
+        os << "#include <sys/stat.h>\n";
+        os << "#include <unistd.h>\n\n";
+        os << "// Maps the weights file written with this model into memory (read-only) and passes it to " << moduleName << "_SetWeights.\n";
+        os << "// The mapping stays in place for the lifetime of the process. Returns 0 on success.\n";
+        os << "static inline int " << moduleName << "_LoadWeights(const char* path)\n";
+        os << "{\n";
+        os << "    int fd = open(path, O_RDONLY);\n";
+        os << "    if (fd < 0) return -1;\n";
+        os << "    struct stat fileInfo;\n";
+        os << "    if (fstat(fd, &fileInfo) != 0 || (size_t)fileInfo.st_size != " << moduleEmitter.GetExternalWeights().size() << "u)\n";
+        os << "    {\n";
+        os << "        close(fd);\n";
+        os << "        return -1;\n";
+        os << "    }\n";
+        os << "    void* weights = fileInfo.st_size == 0 ? NULL : mmap(NULL, (size_t)fileInfo.st_size, PROT_READ, MAP_SHARED, fd, 0);\n";
+        os << "    close(fd);\n";
+        os << "    if (weights == MAP_FAILED) return -1;\n";
+        os << "    " << moduleName << "_SetWeights((char*)weights);\n";
+        os << "    return 0;\n";
+        os << "}\n";
+        os << "#endif // defined(__unix__) || defined(__APPLE__)\n";
+    }
+
     void WriteModuleHeader(std::ostream& os, IRModuleEmitter& moduleEmitter)
     {
         auto pModule = moduleEmitter.GetLLVMModule();
@@ -250,6 +281,10 @@ namespace emitters
         {
             os << "// Compiled from input model " << fileName << "\n";
         }
+        if (moduleEmitter.GetCompilerOptions().externalWeights)
+        {
+            os << "// The weights are in a separate file: load it with " << moduleName << "_LoadWeights (or " << moduleName << "_SetWeights) before calling the model\n";
+        }
         os << "//\n\n";
         os << "#pragma once\n\n";
         os << "#include <stdint.h>\n\n";
@@ -304,6 +339,12 @@ namespace emitters
                 os << "\n\n";
             }
         }
+
+        if (moduleEmitter.GetCompilerOptions().externalWeights)
+        {
+            os << "\n";
+            WriteExternalWeightsLoader(os, moduleEmitter);
+        }
     }
 
     std::string TrimPrefix(std::string s, std::string prefix)
@@ -8,6 +8,7 @@
 
 #include "IRLoopEmitter.h"
 #include "IRFunctionEmitter.h"
+#include "IRLoopVectorizer.h"
 
 namespace ell
 {
@@ -154,10 +155,11 @@ namespace emitters
         _functionEmitter.Branch(_pConditionBlock);
         _functionEmitter.SetCurrentBlock(_pConditionBlock);
         auto branchInst = _functionEmitter.Branch(comparison, _functionEmitter.Load(_pIterationVariable), pTestValue, _pBodyBlock, _pAfterBlock);
+        _pConditionBranch = branchInst;
 
         bool unroll = false;
         bool vectorize = true;
-        AddLoopMetadata(branchInst, unroll, vectorize);
+        AddLoopMetadata(_pConditionBranch, unroll, vectorize);
     }
 
     void IRForLoopEmitter::EmitIncrement(LLVMValue pIncrementValue)
@@ -176,6 +178,33 @@ namespace emitters
         return _pBodyBlock;
     }
 
+    void IRForLoopEmitter::SetVectorized(int vectorWidth)
+    {
+        if (_pConditionBranch == nullptr)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "SetVectorized() must be called between Begin() and End()");
+        }
+        if (vectorWidth < 1)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Vector width must be positive");
+        }
+
+        // Mark the loop for IRLoopVectorizer, which emits it as vector code if it can prove the iterations independent.
+        // Otherwise the vectorize hints leave it to LLVM's loop vectorizer, which does its own legality checks.
+        auto& context = _functionEmitter.GetEmitter().GetContext();
+        auto widthMetadata = llvm::ConstantAsMetadata::get(llvm::ConstantInt::get(llvm::Type::getInt32Ty(context), vectorWidth));
+        auto tempNode = llvm::MDNode::getTemporary(context, {});
+        std::vector<llvm::Metadata*> metadataElements = { tempNode.get() };
+        metadataElements.push_back(llvm::MDNode::get(context, GenerateVectorizeMetadata(context)));
+        metadataElements.push_back(llvm::MDNode::get(context, { llvm::MDString::get(context, "llvm.loop.vectorize.width"), widthMetadata }));
+        metadataElements.push_back(llvm::MDNode::get(context, { llvm::MDString::get(context, c_vectorizeWidthLoopProperty), widthMetadata }));
+        metadataElements.push_back(llvm::MDNode::get(context, { llvm::MDString::get(context, "llvm.loop.unroll.disable") }));
+
+        auto loopID = llvm::MDNode::get(context, metadataElements);
+        loopID->replaceOperandWith(0, loopID);
+        _pConditionBranch->setMetadata("llvm.loop", loopID);
+    }
+
     void IRForLoopEmitter::End()
     {
         if (_pIncrementBlock == nullptr)
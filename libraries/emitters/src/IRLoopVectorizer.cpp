@@ -0,0 +1,691 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRLoopVectorizer.cpp (emitters)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRLoopVectorizer.h"
+
+#include <llvm/Analysis/AliasAnalysis.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/Analysis/MemoryLocation.h>
+#include <llvm/Analysis/ScalarEvolution.h>
+#include <llvm/Analysis/ScalarEvolutionExpressions.h>
+#include <llvm/Analysis/VectorUtils.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DataLayout.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/Metadata.h>
+#include <llvm/Transforms/Utils/Local.h>
+
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+namespace ell
+{
+namespace emitters
+{
+    const char* const c_vectorizeWidthLoopProperty = "ell.loop.vectorize.width";
+
+    namespace
+    {
+        llvm::MDNode* GetLoopProperty(const llvm::Loop& loop, const std::string& name)
+        {
+            auto loopID = loop.getLoopID();
+            if (loopID == nullptr)
+            {
+                return nullptr;
+            }
+            for (unsigned index = 1; index < loopID->getNumOperands(); ++index)
+            {
+                auto property = llvm::dyn_cast<llvm::MDNode>(loopID->getOperand(index));
+                if (property != nullptr && property->getNumOperands() > 0)
+                {
+                    auto propertyName = llvm::dyn_cast<llvm::MDString>(property->getOperand(0));
+                    if (propertyName != nullptr && propertyName->getString() == name)
+                    {
+                        return property;
+                    }
+                }
+            }
+            return nullptr;
+        }
+
+        unsigned GetVectorWidth(const llvm::Loop& loop)
+        {
+            auto property = GetLoopProperty(loop, c_vectorizeWidthLoopProperty);
+            if (property == nullptr || property->getNumOperands() != 2)
+            {
+                return 0;
+            }
+            auto width = llvm::mdconst::dyn_extract<llvm::ConstantInt>(property->getOperand(1));
+            return width == nullptr ? 0 : static_cast<unsigned>(width->getZExtValue());
+        }
+
+        // Drops the vectorization request (and the properties that kept the loop intact for it) from a loop, and marks the
+        // loop as vectorized if it was rewritten
+        void FinishLoop(llvm::Loop& loop, bool vectorized)
+        {
+            auto loopID = loop.getLoopID();
+            auto& context = loopID->getContext();
+            auto tempNode = llvm::MDNode::getTemporary(context, {});
+            std::vector<llvm::Metadata*> properties = { tempNode.get() };
+            for (unsigned index = 1; index < loopID->getNumOperands(); ++index)
+            {
+                auto property = llvm::dyn_cast<llvm::MDNode>(loopID->getOperand(index));
+                auto propertyName = property != nullptr && property->getNumOperands() > 0 ? llvm::dyn_cast<llvm::MDString>(property->getOperand(0)) : nullptr;
+                if (propertyName != nullptr)
+                {
+                    auto name = propertyName->getString();
+                    if (name == c_vectorizeWidthLoopProperty || name == "llvm.loop.unroll.disable" || (vectorized && name.startswith("llvm.loop.vectorize.")))
+                    {
+                        continue;
+                    }
+                }
+                properties.push_back(loopID->getOperand(index));
+            }
+            if (vectorized)
+            {
+                properties.push_back(llvm::MDNode::get(context, { llvm::MDString::get(context, "llvm.loop.isvectorized"), llvm::ConstantAsMetadata::get(llvm::ConstantInt::get(llvm::Type::getInt32Ty(context), 1)) }));
+            }
+
+            auto newLoopID = llvm::MDNode::get(context, properties);
+            newLoopID->replaceOperandWith(0, newLoopID);
+            loop.setLoopID(newLoopID);
+        }
+
+        llvm::Value* GetPointerOperand(llvm::Instruction* instruction)
+        {
+            if (auto load = llvm::dyn_cast<llvm::LoadInst>(instruction))
+            {
+                return load->getPointerOperand();
+            }
+            return llvm::cast<llvm::StoreInst>(instruction)->getPointerOperand();
+        }
+
+        llvm::Type* GetAccessType(llvm::Instruction* instruction)
+        {
+            if (auto load = llvm::dyn_cast<llvm::LoadInst>(instruction))
+            {
+                return load->getType();
+            }
+            return llvm::cast<llvm::StoreInst>(instruction)->getValueOperand()->getType();
+        }
+
+        // An induction variable of the loop, and the instruction that computes its value for the next iteration
+        struct Induction
+        {
+            llvm::PHINode* phi;
+            llvm::BinaryOperator* increment;
+            int64_t step;
+        };
+
+        // Rewrites one loop so each iteration runs `width` iterations of the original loop as vector lanes
+        class LoopWidener
+        {
+        public:
+            LoopWidener(llvm::Loop& loop, unsigned width, bool fuseMultiplyAdd, llvm::ScalarEvolution& scalarEvolution, llvm::AAResults& aliasAnalysis) :
+                _loop(loop),
+                _width(width),
+                _fuseMultiplyAdd(fuseMultiplyAdd),
+                _scalarEvolution(scalarEvolution),
+                _aliasAnalysis(aliasAnalysis),
+                _block(loop.getHeader()),
+                _dataLayout(loop.getHeader()->getModule()->getDataLayout())
+            {
+            }
+
+            bool Run()
+            {
+                if (!CanWiden())
+                {
+                    return false;
+                }
+                Widen();
+                return true;
+            }
+
+        private:
+            enum class AccessKind
+            {
+                uniform,
+                consecutive,
+                other
+            };
+
+            bool CanWiden()
+            {
+                // A rotated loop with a single block, which runs a whole number of vectors
+                if (_width < 2 || _loop.getNumBlocks() != 1 || _loop.getLoopLatch() != _block || _loop.getLoopPreheader() == nullptr || _loop.getExitBlock() == nullptr)
+                {
+                    return false;
+                }
+                auto tripCount = _scalarEvolution.getSmallConstantTripCount(&_loop);
+                if (tripCount == 0 || tripCount % _width != 0)
+                {
+                    return false;
+                }
+
+                // The only values carried between iterations are induction variables with a constant step
+                for (auto& phi : _block->phis())
+                {
+                    if (!FindInduction(phi))
+                    {
+                        return false;
+                    }
+                }
+                if (!CanRewriteExitCondition())
+                {
+                    return false;
+                }
+
+                for (auto& instruction : *_block)
+                {
+                    if (llvm::isa<llvm::PHINode>(instruction) || instruction.isTerminator() || llvm::isa<llvm::DbgInfoIntrinsic>(instruction))
+                    {
+                        continue;
+                    }
+
+                    // Values that leave the loop would get the last vector's first lane instead of the last iteration's value
+                    if (!IsIncrement(&instruction) && IsUsedOutsideLoop(&instruction))
+                    {
+                        return false;
+                    }
+
+                    if (auto store = llvm::dyn_cast<llvm::StoreInst>(&instruction))
+                    {
+                        // A store to the same element in every iteration is a reduction, so the lanes aren't independent
+                        if (!store->isSimple() || GetAccessKind(store) != AccessKind::consecutive || !CanVectorize(store->getValueOperand()))
+                        {
+                            return false;
+                        }
+                        _stores.push_back(store);
+                        _accesses.push_back(store);
+                    }
+                    else if (auto load = llvm::dyn_cast<llvm::LoadInst>(&instruction))
+                    {
+                        if (!load->isSimple() || GetAccessKind(load) == AccessKind::other)
+                        {
+                            return false;
+                        }
+                        _accesses.push_back(load);
+                    }
+                    else if (instruction.mayReadOrWriteMemory() || instruction.mayHaveSideEffects())
+                    {
+                        return false;
+                    }
+                }
+
+                for (auto store : _stores)
+                {
+                    for (auto access : _accesses)
+                    {
+                        if (access != store && !AreIndependent(store, access))
+                        {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            }
+
+            bool FindInduction(llvm::PHINode& phi)
+            {
+                auto addRecurrence = llvm::dyn_cast<llvm::SCEVAddRecExpr>(_scalarEvolution.getSCEV(&phi));
+                if (!phi.getType()->isIntegerTy() || addRecurrence == nullptr || addRecurrence->getLoop() != &_loop || !addRecurrence->isAffine())
+                {
+                    return false;
+                }
+                auto step = llvm::dyn_cast<llvm::SCEVConstant>(addRecurrence->getStepRecurrence(_scalarEvolution));
+                auto increment = llvm::dyn_cast<llvm::BinaryOperator>(phi.getIncomingValueForBlock(_block));
+                if (step == nullptr || increment == nullptr || increment->getOpcode() != llvm::Instruction::Add || increment->getParent() != _block ||
+                    (increment->getOperand(0) != &phi && increment->getOperand(1) != &phi))
+                {
+                    return false;
+                }
+
+                // The phi's own value at the exit would be the first lane of the last vector
+                if (IsUsedOutsideLoop(&phi))
+                {
+                    return false;
+                }
+                _inductions.push_back({ &phi, increment, step->getAPInt().getSExtValue() });
+                return true;
+            }
+
+            bool CanRewriteExitCondition()
+            {
+                auto branch = llvm::dyn_cast<llvm::BranchInst>(_block->getTerminator());
+                if (branch == nullptr || !branch->isConditional())
+                {
+                    return false;
+                }
+                auto compare = llvm::dyn_cast<llvm::ICmpInst>(branch->getCondition());
+                if (compare == nullptr || compare->getParent() != _block || !compare->hasOneUse())
+                {
+                    return false;
+                }
+
+                // The loop must exit by comparing an induction variable, or its next value, with a bound. Comparing the
+                // last lane's value instead exits after the same iteration, because the trip count is a multiple of `width`.
+                for (unsigned operandIndex = 0; operandIndex < 2; ++operandIndex)
+                {
+                    auto operand = compare->getOperand(operandIndex);
+                    if ((IsIncrement(operand) || IsInductionPhi(operand)) && _loop.isLoopInvariant(compare->getOperand(1 - operandIndex)))
+                    {
+                        _exitCompare = compare;
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            bool IsIncrement(const llvm::Value* value) const
+            {
+                for (const auto& induction : _inductions)
+                {
+                    if (induction.increment == value)
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            bool IsInductionPhi(const llvm::Value* value) const
+            {
+                for (const auto& induction : _inductions)
+                {
+                    if (induction.phi == value)
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            bool IsUsedOutsideLoop(const llvm::Instruction* instruction) const
+            {
+                for (auto user : instruction->users())
+                {
+                    if (!_loop.contains(llvm::cast<llvm::Instruction>(user)))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            bool IsUniform(llvm::Value* value) const
+            {
+                auto instruction = llvm::dyn_cast<llvm::Instruction>(value);
+                if (instruction == nullptr || !_loop.contains(instruction))
+                {
+                    return true;
+                }
+                return _scalarEvolution.isSCEVable(value->getType()) && _scalarEvolution.isLoopInvariant(_scalarEvolution.getSCEV(value), &_loop);
+            }
+
+            // Returns the constant step of an integer value that changes by the same amount in every iteration, or 0
+            int64_t GetAffineStep(llvm::Value* value) const
+            {
+                if (!value->getType()->isIntegerTy() || !_scalarEvolution.isSCEVable(value->getType()))
+                {
+                    return 0;
+                }
+                auto addRecurrence = llvm::dyn_cast<llvm::SCEVAddRecExpr>(_scalarEvolution.getSCEV(value));
+                if (addRecurrence == nullptr || addRecurrence->getLoop() != &_loop || !addRecurrence->isAffine())
+                {
+                    return 0;
+                }
+                auto step = llvm::dyn_cast<llvm::SCEVConstant>(addRecurrence->getStepRecurrence(_scalarEvolution));
+                return step == nullptr ? 0 : step->getAPInt().getSExtValue();
+            }
+
+            // Whether consecutive elements of the type in memory can be loaded and stored as a vector
+            bool IsVectorElementType(llvm::Type* type) const
+            {
+                return (type->isFloatTy() || type->isDoubleTy() || (type->isIntegerTy() && type->getIntegerBitWidth() % 8 == 0)) && _dataLayout.getTypeStoreSize(type) == _dataLayout.getTypeAllocSize(type);
+            }
+
+            AccessKind GetAccessKind(llvm::Instruction* access) const
+            {
+                auto pointer = GetPointerOperand(access);
+                if (IsUniform(pointer))
+                {
+                    return AccessKind::uniform;
+                }
+
+                auto addRecurrence = llvm::dyn_cast<llvm::SCEVAddRecExpr>(_scalarEvolution.getSCEV(pointer));
+                if (addRecurrence == nullptr || addRecurrence->getLoop() != &_loop || !addRecurrence->isAffine() || !IsVectorElementType(GetAccessType(access)))
+                {
+                    return AccessKind::other;
+                }
+                auto step = llvm::dyn_cast<llvm::SCEVConstant>(addRecurrence->getStepRecurrence(_scalarEvolution));
+                auto elementSize = static_cast<int64_t>(_dataLayout.getTypeAllocSize(GetAccessType(access)));
+                return step != nullptr && step->getAPInt().getSExtValue() == elementSize ? AccessKind::consecutive : AccessKind::other;
+            }
+
+            // Checks that no lane of `access` touches memory that another lane of `store` writes within the same vector
+            bool AreIndependent(llvm::StoreInst* store, llvm::Instruction* access) const
+            {
+                auto storePointer = store->getPointerOperand();
+                auto accessPointer = GetPointerOperand(access);
+                auto storeSize = static_cast<int64_t>(_dataLayout.getTypeAllocSize(store->getValueOperand()->getType()));
+                auto accessSize = static_cast<int64_t>(_dataLayout.getTypeAllocSize(GetAccessType(access)));
+
+                auto distance = llvm::dyn_cast<llvm::SCEVConstant>(_scalarEvolution.getMinusSCEV(_scalarEvolution.getSCEV(accessPointer), _scalarEvolution.getSCEV(storePointer)));
+                if (distance != nullptr && GetAccessKind(access) == AccessKind::consecutive)
+                {
+                    // Either each lane reads or writes the element its own lane stores, or the two ranges of a vector don't
+                    // overlap (and then the iterations that touch the same element are in different vectors, in their original order)
+                    auto bytes = distance->getAPInt().getSExtValue();
+                    if (bytes == 0)
+                    {
+                        return storeSize == accessSize;
+                    }
+                    return bytes > 0 ? bytes >= storeSize * _width : -bytes >= accessSize * _width;
+                }
+
+                return _aliasAnalysis.alias(llvm::MemoryLocation(storePointer, llvm::MemoryLocation::UnknownSize), llvm::MemoryLocation(accessPointer, llvm::MemoryLocation::UnknownSize)) == llvm::NoAlias;
+            }
+
+            bool CanVectorize(llvm::Value* value)
+            {
+                auto it = _canVectorize.find(value);
+                if (it != _canVectorize.end())
+                {
+                    return it->second;
+                }
+                _canVectorize[value] = false; // Guards against cycles, which only go through phis that aren't inductions
+                auto result = CanVectorizeUncached(value);
+                _canVectorize[value] = result;
+                return result;
+            }
+
+            bool CanVectorizeUncached(llvm::Value* value)
+            {
+                auto type = value->getType();
+                if (!type->isFloatTy() && !type->isDoubleTy() && !type->isIntegerTy())
+                {
+                    return false;
+                }
+                if (IsUniform(value) || GetAffineStep(value) != 0)
+                {
+                    return true;
+                }
+
+                auto instruction = llvm::cast<llvm::Instruction>(value);
+                if (auto load = llvm::dyn_cast<llvm::LoadInst>(instruction))
+                {
+                    return load->isSimple() && GetAccessKind(load) != AccessKind::other;
+                }
+                if (llvm::isa<llvm::BinaryOperator>(instruction) || llvm::isa<llvm::CmpInst>(instruction) || llvm::isa<llvm::SelectInst>(instruction) ||
+                    (llvm::isa<llvm::CastInst>(instruction) && !instruction->getOperand(0)->getType()->isPointerTy()) ||
+                    instruction->getOpcode() == llvm::Instruction::FNeg)
+                {
+                    return CanVectorizeOperands(instruction, instruction->getNumOperands());
+                }
+                if (auto call = llvm::dyn_cast<llvm::IntrinsicInst>(instruction))
+                {
+                    auto id = call->getIntrinsicID();
+                    if (!llvm::isTriviallyVectorizable(id) || call->mayReadOrWriteMemory())
+                    {
+                        return false;
+                    }
+                    for (unsigned index = 0; index < call->getNumArgOperands(); ++index)
+                    {
+                        if (llvm::hasVectorInstrinsicScalarOpd(id, index))
+                        {
+                            return false;
+                        }
+                    }
+                    return CanVectorizeOperands(instruction, call->getNumArgOperands());
+                }
+                return false;
+            }
+
+            bool CanVectorizeOperands(llvm::Instruction* instruction, unsigned numOperands)
+            {
+                for (unsigned index = 0; index < numOperands; ++index)
+                {
+                    if (!CanVectorize(instruction->getOperand(index)))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            void Widen()
+            {
+                for (auto store : _stores)
+                {
+                    llvm::IRBuilder<> builder(store);
+                    auto value = GetVectorValue(store->getValueOperand());
+                    auto pointer = builder.CreateBitCast(store->getPointerOperand(), value->getType()->getPointerTo(store->getPointerAddressSpace()));
+                    auto vectorStore = builder.CreateAlignedStore(value, pointer, GetAlignment(store->getAlignment(), store->getValueOperand()->getType()));
+                    vectorStore->copyMetadata(*store, { llvm::LLVMContext::MD_tbaa, llvm::LLVMContext::MD_noalias, llvm::LLVMContext::MD_alias_scope });
+                }
+                for (auto store : _stores)
+                {
+                    store->eraseFromParent();
+                }
+
+                // Step over `width` iterations at a time, and exit based on the last lane. The other uses of the scalar
+                // increments are the next iteration's first lane, which is what they still compute.
+                for (const auto& induction : _inductions)
+                {
+                    llvm::IRBuilder<> builder(_exitCompare);
+                    auto type = induction.phi->getType();
+                    auto vectorIncrement = builder.CreateAdd(induction.phi, llvm::ConstantInt::get(type, induction.step * static_cast<int64_t>(_width), true), induction.phi->getName() + ".vector.next");
+                    induction.phi->setIncomingValue(induction.phi->getBasicBlockIndex(_block), vectorIncrement);
+                    _exitCompare->replaceUsesOfWith(induction.increment, vectorIncrement);
+                    induction.increment->replaceUsesOutsideBlock(vectorIncrement, _block);
+                    if (llvm::is_contained(_exitCompare->operands(), induction.phi))
+                    {
+                        auto lastLane = builder.CreateAdd(induction.phi, llvm::ConstantInt::get(type, induction.step * static_cast<int64_t>(_width - 1), true), induction.phi->getName() + ".vector.last");
+                        _exitCompare->replaceUsesOfWith(induction.phi, lastLane);
+                    }
+                }
+
+                for (auto it = _block->rbegin(); it != _block->rend();)
+                {
+                    auto& instruction = *it++;
+                    if (llvm::isInstructionTriviallyDead(&instruction))
+                    {
+                        instruction.eraseFromParent();
+                    }
+                }
+            }
+
+            unsigned GetAlignment(unsigned alignment, llvm::Type* elementType) const
+            {
+                // An alignment of 0 means the type's ABI alignment, which is larger for the vector type
+                return alignment != 0 ? alignment : _dataLayout.getABITypeAlignment(elementType);
+            }
+
+            llvm::Value* GetVectorValue(llvm::Value* value)
+            {
+                auto& vectorValue = _vectorValues[value];
+                if (vectorValue == nullptr)
+                {
+                    vectorValue = CreateVectorValue(value);
+                }
+                return vectorValue;
+            }
+
+            llvm::Value* CreateVectorValue(llvm::Value* value)
+            {
+                if (auto constant = llvm::dyn_cast<llvm::Constant>(value))
+                {
+                    return llvm::ConstantVector::getSplat(_width, constant);
+                }
+
+                auto instruction = llvm::dyn_cast<llvm::Instruction>(value);
+                if (instruction == nullptr || !_loop.contains(instruction))
+                {
+                    llvm::IRBuilder<> builder(_loop.getLoopPreheader()->getTerminator());
+                    return builder.CreateVectorSplat(_width, value);
+                }
+
+                // New instructions go right after the one they replace, which keeps the loads and stores in their original order
+                llvm::IRBuilder<> builder(llvm::isa<llvm::PHINode>(instruction) ? &*_block->getFirstInsertionPt() : instruction->getNextNode());
+                if (auto step = GetAffineStep(value); step != 0)
+                {
+                    // Lane i gets the first lane's value plus i steps
+                    std::vector<llvm::Constant*> offsets;
+                    for (unsigned lane = 0; lane < _width; ++lane)
+                    {
+                        offsets.push_back(llvm::ConstantInt::get(value->getType(), step * static_cast<int64_t>(lane), true));
+                    }
+                    return builder.CreateAdd(builder.CreateVectorSplat(_width, value), llvm::ConstantVector::get(offsets));
+                }
+
+                auto load = llvm::dyn_cast<llvm::LoadInst>(instruction);
+                if (IsUniform(value) || (load != nullptr && GetAccessKind(load) == AccessKind::uniform))
+                {
+                    return builder.CreateVectorSplat(_width, value);
+                }
+
+                auto vectorType = llvm::VectorType::get(value->getType(), _width);
+                if (load != nullptr)
+                {
+                    auto pointer = builder.CreateBitCast(load->getPointerOperand(), vectorType->getPointerTo(load->getPointerAddressSpace()));
+                    auto vectorLoad = builder.CreateAlignedLoad(pointer, GetAlignment(load->getAlignment(), load->getType()));
+                    vectorLoad->copyMetadata(*load, { llvm::LLVMContext::MD_tbaa, llvm::LLVMContext::MD_noalias, llvm::LLVMContext::MD_alias_scope });
+                    return vectorLoad;
+                }
+
+                if (auto binaryOperator = llvm::dyn_cast<llvm::BinaryOperator>(instruction))
+                {
+                    if (auto product = GetFusableProduct(binaryOperator))
+                    {
+                        auto addend = binaryOperator->getOperand(0) == product ? binaryOperator->getOperand(1) : binaryOperator->getOperand(0);
+                        auto function = llvm::Intrinsic::getDeclaration(_block->getModule(), llvm::Intrinsic::fmuladd, { vectorType });
+                        return builder.CreateCall(function, { GetVectorValue(product->getOperand(0)), GetVectorValue(product->getOperand(1)), GetVectorValue(addend) });
+                    }
+                    auto result = builder.CreateBinOp(binaryOperator->getOpcode(), GetVectorValue(binaryOperator->getOperand(0)), GetVectorValue(binaryOperator->getOperand(1)));
+                    if (auto resultInstruction = llvm::dyn_cast<llvm::Instruction>(result))
+                    {
+                        resultInstruction->copyIRFlags(binaryOperator);
+                    }
+                    return result;
+                }
+
+                auto widened = instruction->clone();
+                widened->mutateType(instruction->getType()->isVoidTy() ? instruction->getType() : llvm::VectorType::get(instruction->getType(), _width));
+                unsigned numOperands = llvm::isa<llvm::CallInst>(instruction) ? llvm::cast<llvm::CallInst>(instruction)->getNumArgOperands() : instruction->getNumOperands();
+                for (unsigned index = 0; index < numOperands; ++index)
+                {
+                    widened->setOperand(index, GetVectorValue(instruction->getOperand(index)));
+                }
+                if (auto call = llvm::dyn_cast<llvm::IntrinsicInst>(instruction))
+                {
+                    llvm::cast<llvm::CallInst>(widened)->setCalledFunction(llvm::Intrinsic::getDeclaration(_block->getModule(), call->getIntrinsicID(), { widened->getType() }));
+                }
+                builder.Insert(widened);
+                return widened;
+            }
+
+            // Returns the multiply of `a * b + c`, if the two can be emitted as one fused multiply-add
+            llvm::BinaryOperator* GetFusableProduct(llvm::BinaryOperator* sum) const
+            {
+                if (sum->getOpcode() != llvm::Instruction::FAdd || !(_fuseMultiplyAdd || sum->hasAllowContract()))
+                {
+                    return nullptr;
+                }
+                for (auto& operand : sum->operands())
+                {
+                    auto product = llvm::dyn_cast<llvm::BinaryOperator>(operand.get());
+                    if (product != nullptr && product->getOpcode() == llvm::Instruction::FMul && product->hasOneUse() && _loop.contains(product) && !IsUniform(product))
+                    {
+                        return product;
+                    }
+                }
+                return nullptr;
+            }
+
+            llvm::Loop& _loop;
+            unsigned _width;
+            bool _fuseMultiplyAdd;
+            llvm::ScalarEvolution& _scalarEvolution;
+            llvm::AAResults& _aliasAnalysis;
+            llvm::BasicBlock* _block;
+            const llvm::DataLayout& _dataLayout;
+
+            std::vector<Induction> _inductions;
+            llvm::ICmpInst* _exitCompare = nullptr;
+            std::vector<llvm::StoreInst*> _stores;
+            std::vector<llvm::Instruction*> _accesses;
+            std::map<llvm::Value*, bool> _canVectorize;
+            std::map<llvm::Value*, llvm::Value*> _vectorValues;
+        };
+
+        class LoopVectorizerPass : public llvm::FunctionPass
+        {
+        public:
+            static char ID;
+
+            LoopVectorizerPass(bool fuseMultiplyAdd) :
+                llvm::FunctionPass(ID),
+                _fuseMultiplyAdd(fuseMultiplyAdd)
+            {
+            }
+
+            void getAnalysisUsage(llvm::AnalysisUsage& analysisUsage) const override
+            {
+                analysisUsage.addRequired<llvm::LoopInfoWrapperPass>();
+                analysisUsage.addRequired<llvm::ScalarEvolutionWrapperPass>();
+                analysisUsage.addRequired<llvm::AAResultsWrapperPass>();
+                analysisUsage.addPreserved<llvm::LoopInfoWrapperPass>();
+                analysisUsage.setPreservesCFG();
+            }
+
+            bool runOnFunction(llvm::Function& function) override
+            {
+                auto& loopInfo = getAnalysis<llvm::LoopInfoWrapperPass>().getLoopInfo();
+                auto& scalarEvolution = getAnalysis<llvm::ScalarEvolutionWrapperPass>().getSE();
+                auto& aliasAnalysis = getAnalysis<llvm::AAResultsWrapperPass>().getAAResults();
+
+                bool changed = false;
+                for (auto loop : loopInfo.getLoopsInPreorder())
+                {
+                    auto width = GetVectorWidth(*loop);
+                    if (width == 0)
+                    {
+                        continue;
+                    }
+
+                    LoopWidener widener(*loop, width, _fuseMultiplyAdd, scalarEvolution, aliasAnalysis);
+                    auto vectorized = widener.Run();
+                    if (vectorized)
+                    {
+                        scalarEvolution.forgetLoop(loop);
+                    }
+                    FinishLoop(*loop, vectorized);
+                    changed = true;
+                }
+                return changed;
+            }
+
+            llvm::StringRef getPassName() const override { return "ELL loop vectorizer"; }
+
+        private:
+            bool _fuseMultiplyAdd;
+        };
+
+        char LoopVectorizerPass::ID = 0;
+    } // namespace
+
+    llvm::FunctionPass* CreateLoopVectorizerPass(bool fuseMultiplyAdd)
+    {
+        return new LoopVectorizerPass(fuseMultiplyAdd);
+    }
+} // namespace emitters
+} // namespace ell
@@ -19,15 +19,23 @@
 
 #include <utilities/include/Files.h>
 #include <utilities/include/Logger.h>
+#include <utilities/include/ParallelFor.h>
 
 #include <llvm/AsmParser/Parser.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/IR/InstIterator.h>
 #include <llvm/IR/Verifier.h>
+#include <llvm/Linker/Linker.h>
 #include <llvm/Support/TargetRegistry.h>
 #include <llvm/Support/ToolOutputFile.h>
 #include <llvm/Support/raw_os_ostream.h>
+#include <llvm/Transforms/Utils/Cloning.h>
 #include <llvm/Transforms/Utils/ModuleUtils.h>
 
 #include <algorithm>
+#include <map>
+#include <set>
 #include <vector>
 
 namespace ell
@@ -490,10 +498,295 @@ namespace emitters
         global->setExternallyInitialized(false);
         global->setLinkage(llvm::GlobalValue::LinkageTypes::InternalLinkage);
         global->setThreadLocal(isThreadLocal);
+        if (options.threadSafe && !isConst && !isThreadLocal)
+        {
+            // Moved into the caller's context by EmitContextFunctions
+            global->setMetadata(c_contextStateTagName, llvm::MDNode::get(GetLLVMContext(), {}));
+        }
         assert(llvm::isa<llvm::GlobalVariable>(global));
         return llvm::cast<llvm::GlobalVariable>(global);
     }
 
+    bool IRModuleEmitter::ShouldStoreExternally(size_t sizeInBytes) const
+    {
+        // Small arrays aren't worth the indirection
+        const size_t minimumExternalSize = 1024;
+        return GetCompilerOptions().externalWeights && sizeInBytes >= minimumExternalSize;
+    }
+
+    llvm::GlobalVariable* IRModuleEmitter::AddExternalConstantArray(const std::string& name, LLVMType pElementType, const char* data, size_t sizeInBytes)
+    {
+        auto offset = ((_externalWeights.size() + c_externalWeightsAlignment - 1) / c_externalWeightsAlignment) * c_externalWeightsAlignment;
+        _externalWeights.resize(offset);
+        _externalWeights.insert(_externalWeights.end(), data, data + sizeInBytes);
+
+        // The pointer is set once per process by <module>_SetWeights, so it's never part of the model's state
+        llvm::PointerType* pointerType = pElementType->getPointerTo();
+        auto global = AddGlobal(name, pointerType, GetIREmitter().NullPointer(pointerType), false);
+        global->setMetadata(c_contextStateTagName, nullptr);
+        global->setMetadata(c_externalWeightsTagName, llvm::MDNode::get(GetLLVMContext(), {}));
+        _externalWeightsOffsets.emplace_back(global, offset);
+        return global;
+    }
+
+    bool IRModuleEmitter::IsExternalWeightsPointer(LLVMValue value)
+    {
+        auto global = llvm::dyn_cast_or_null<llvm::GlobalVariable>(value);
+        return global != nullptr && global->getMetadata(c_externalWeightsTagName) != nullptr;
+    }
+
+    void IRModuleEmitter::EmitSetWeightsFunction()
+    {
+        const NamedVariableTypeList parameters = { { "weights", VariableType::Char8Pointer } };
+        auto& function = BeginFunction(GetModuleName() + "_SetWeights", VariableType::Void, parameters);
+        function.IncludeInHeader();
+        GetFunctionDeclaration(GetModuleName() + "_SetWeights").GetComments().push_back("Points the model at its weights, which must stay loaded while the model is in use");
+
+        auto weights = function.GetFunctionArgument("weights");
+        for (const auto& [global, offset] : _externalWeightsOffsets)
+        {
+            auto pointer = function.PointerOffset(weights, function.Literal(static_cast<int64_t>(offset)));
+            function.Store(global, function.CastPointer(pointer, global->getValueType()));
+        }
+        EndFunction();
+    }
+
+    void IRModuleEmitter::WriteExternalWeights(const std::string& filePath) const
+    {
+        auto stream = utilities::OpenBinaryOfstream(filePath);
+        stream.write(_externalWeights.data(), _externalWeights.size());
+    }
+
+    //
+    // Caller-owned model state
+    //
+
+    namespace
+    {
+        // Turns each use of a constant expression into an instruction just before its user, so that the global it
+        // refers to can be replaced with a value that isn't a constant
+        void ExpandConstantExpression(llvm::ConstantExpr* expression)
+        {
+            auto isExpression = [](llvm::User* user) { return llvm::isa<llvm::ConstantExpr>(user); };
+            for (auto user = std::find_if(expression->user_begin(), expression->user_end(), isExpression); user != expression->user_end(); user = std::find_if(expression->user_begin(), expression->user_end(), isExpression))
+            {
+                ExpandConstantExpression(llvm::cast<llvm::ConstantExpr>(*user));
+            }
+
+            while (!expression->use_empty())
+            {
+                auto& use = *expression->use_begin();
+                auto user = llvm::dyn_cast<llvm::Instruction>(use.getUser());
+                if (user == nullptr)
+                {
+                    throw EmitterException(EmitterError::notSupported, "The model's state can't be referred to from the initial value of another global in thread-safe mode");
+                }
+
+                auto instruction = expression->getAsInstruction();
+                if (auto phi = llvm::dyn_cast<llvm::PHINode>(user))
+                {
+                    instruction->insertBefore(phi->getIncomingBlock(use)->getTerminator());
+                }
+                else
+                {
+                    instruction->insertBefore(user);
+                }
+                use.set(instruction);
+            }
+            expression->destroyConstant();
+        }
+    } // namespace
+
+    void IRModuleEmitter::EmitContextFunctions()
+    {
+        auto& context = GetLLVMContext();
+        auto module = GetLLVMModule();
+        const auto& dataLayout = module->getDataLayout();
+        auto& irBuilder = GetIREmitter().GetIRBuilder();
+        auto bytePointerType = llvm::Type::getInt8PtrTy(context);
+
+        std::vector<llvm::GlobalVariable*> stateGlobals;
+        for (auto& global : module->globals())
+        {
+            if (global.getMetadata(c_contextStateTagName) != nullptr)
+            {
+                stateGlobals.push_back(&global);
+            }
+        }
+
+        // Lay the globals out in a packed struct, padding each one to its original alignment
+        std::vector<LLVMType> fieldTypes;
+        std::vector<llvm::Constant*> initialValues;
+        std::vector<unsigned> fieldIndices;
+        uint64_t offset = 0;
+        uint64_t alignment = std::max<uint64_t>(2 * dataLayout.getPointerSize(), 16);
+        for (auto global : stateGlobals)
+        {
+            auto type = global->getValueType();
+            uint64_t fieldAlignment = std::max<uint64_t>(global->getAlignment(), dataLayout.getABITypeAlignment(type));
+            auto padding = (fieldAlignment - offset % fieldAlignment) % fieldAlignment;
+            if (padding > 0)
+            {
+                auto paddingType = llvm::ArrayType::get(llvm::Type::getInt8Ty(context), padding);
+                fieldTypes.push_back(paddingType);
+                initialValues.push_back(llvm::Constant::getNullValue(paddingType));
+                offset += padding;
+            }
+
+            fieldIndices.push_back(static_cast<unsigned>(fieldTypes.size()));
+            fieldTypes.push_back(type);
+            initialValues.push_back(global->getInitializer());
+            offset += dataLayout.getTypeAllocSize(type);
+            alignment = std::max(alignment, fieldAlignment);
+        }
+        auto stateType = llvm::StructType::create(context, fieldTypes, GetModuleName() + "_Context", true);
+        auto statePointerType = stateType->getPointerTo();
+
+        // Unless a `WithContext` function is running on this thread, the code uses a default copy shared by all threads
+        auto initialState = llvm::ConstantStruct::get(stateType, initialValues);
+        auto defaultState = new llvm::GlobalVariable(*module, stateType, false, llvm::GlobalValue::InternalLinkage, initialState, GetModuleName() + "_defaultContext");
+        defaultState->setAlignment(alignment);
+
+        // New contexts start from the initial state, not from whatever the default copy holds by then
+        auto initialStateGlobal = new llvm::GlobalVariable(*module, stateType, true, llvm::GlobalValue::PrivateLinkage, initialState, GetModuleName() + "_initialContext");
+        initialStateGlobal->setAlignment(alignment);
+        auto currentState = new llvm::GlobalVariable(*module, bytePointerType, false, llvm::GlobalValue::InternalLinkage, llvm::ConstantExpr::getBitCast(defaultState, bytePointerType), GetModuleName() + "_currentContext", nullptr, llvm::GlobalValue::GeneralDynamicTLSModel);
+
+        // Each function that uses a global gets the address of its field in the current context on entry
+        {
+            llvm::IRBuilderBase::InsertPointGuard guard(irBuilder);
+            std::map<llvm::Function*, llvm::Instruction*> functionStates;
+            std::map<std::pair<llvm::Function*, unsigned>, llvm::Value*> fieldAddresses;
+            auto getFieldAddress = [&](llvm::Function* function, unsigned fieldIndex) {
+                auto& address = fieldAddresses[{ function, fieldIndex }];
+                if (address == nullptr)
+                {
+                    auto& state = functionStates[function];
+                    if (state == nullptr)
+                    {
+                        auto& entryBlock = function->getEntryBlock();
+                        irBuilder.SetInsertPoint(&entryBlock, entryBlock.getFirstInsertionPt());
+                        state = llvm::cast<llvm::Instruction>(irBuilder.CreatePointerCast(irBuilder.CreateLoad(currentState), statePointerType));
+                    }
+                    irBuilder.SetInsertPoint(state->getNextNode());
+                    address = irBuilder.CreateConstInBoundsGEP2_32(stateType, state, 0, fieldIndex);
+                }
+                return address;
+            };
+
+            for (size_t index = 0; index < stateGlobals.size(); ++index)
+            {
+                auto global = stateGlobals[index];
+                auto isExpression = [](llvm::User* user) { return llvm::isa<llvm::ConstantExpr>(user); };
+                for (auto user = std::find_if(global->user_begin(), global->user_end(), isExpression); user != global->user_end(); user = std::find_if(global->user_begin(), global->user_end(), isExpression))
+                {
+                    ExpandConstantExpression(llvm::cast<llvm::ConstantExpr>(*user));
+                }
+
+                while (!global->use_empty())
+                {
+                    auto& use = *global->use_begin();
+                    auto user = llvm::dyn_cast<llvm::Instruction>(use.getUser());
+                    if (user == nullptr)
+                    {
+                        throw EmitterException(EmitterError::notSupported, "The model's state can't be referred to from the initial value of another global in thread-safe mode");
+                    }
+                    use.set(getFieldAddress(user->getFunction(), fieldIndices[index]));
+                }
+                global->eraseFromParent();
+            }
+        }
+
+        // The state is over-allocated so it can be aligned, and the pointer from malloc is kept just before it
+        auto stateSize = static_cast<int64_t>(dataLayout.getTypeAllocSize(stateType));
+        auto pointerSize = static_cast<int>(dataLayout.getPointerSize());
+        auto int64Type = llvm::Type::getInt64Ty(context);
+
+        auto createFunctionName = GetModuleName() + "_CreateContext";
+        auto& createFunction = BeginFunction(createFunctionName, VariableType::BytePointer);
+        createFunction.IncludeInHeader();
+        GetFunctionDeclaration(createFunctionName).GetComments().push_back("Allocates a copy of the model's initial state for the WithContext functions, or returns null if out of memory. Free it with " + GetModuleName() + "_DestroyContext");
+        {
+            auto memory = createFunction.Malloc(VariableType::BytePointer, stateSize + static_cast<int64_t>(alignment));
+            auto address = createFunction.LocalScalar(createFunction.CastPointerToInt(memory, int64Type));
+            auto alignedAddress = (address + static_cast<int64_t>(alignment)) & createFunction.LocalScalar(~static_cast<int64_t>(alignment - 1));
+            auto state = createFunction.CastIntToPointer(alignedAddress, bytePointerType);
+            createFunction.If(address != static_cast<int64_t>(0), [&](IRFunctionEmitter& function) {
+                function.MemoryCopy<char>(function.CastPointer(initialStateGlobal, bytePointerType), state, static_cast<int>(stateSize));
+                auto slot = function.CastPointer(function.PointerOffset(state, -pointerSize), bytePointerType->getPointerTo());
+                function.Store(slot, memory);
+            });
+            createFunction.Return(createFunction.Select(address != static_cast<int64_t>(0), state, createFunction.NullPointer(bytePointerType)));
+        }
+        EndFunction();
+
+        auto destroyFunctionName = GetModuleName() + "_DestroyContext";
+        auto& destroyFunction = BeginFunction(destroyFunctionName, VariableType::Void, NamedVariableTypeList{ { "modelContext", VariableType::BytePointer } });
+        destroyFunction.IncludeInHeader();
+        GetFunctionDeclaration(destroyFunctionName).GetComments().push_back("Frees a context allocated with " + createFunctionName);
+        {
+            auto state = destroyFunction.GetFunctionArgument("modelContext");
+            auto address = destroyFunction.LocalScalar(destroyFunction.CastPointerToInt(state, int64Type));
+            destroyFunction.If(address != static_cast<int64_t>(0), [&](IRFunctionEmitter& function) {
+                auto slot = function.CastPointer(function.PointerOffset(state, -pointerSize), bytePointerType->getPointerTo());
+                function.Free(function.Load(slot));
+            });
+        }
+        EndFunction();
+    }
+
+    std::string IRModuleEmitter::EmitWithContextFunction(const std::string& functionName, bool includeInHeader)
+    {
+        auto currentState = GetLLVMModule()->getNamedGlobal(GetModuleName() + "_currentContext");
+        if (currentState == nullptr)
+        {
+            throw EmitterException(EmitterError::badFunctionDefinition, "EmitContextFunctions must be called before EmitWithContextFunction");
+        }
+
+        auto targetFunction = GetFunction(functionName);
+        if (targetFunction == nullptr)
+        {
+            throw EmitterException(EmitterError::functionNotFound, "Can't find function " + functionName);
+        }
+
+        NamedLLVMTypeList args = { { "modelContext", llvm::Type::getInt8PtrTy(GetLLVMContext()) } };
+        for (auto& arg : targetFunction->args())
+        {
+            args.push_back({ arg.getName(), arg.getType() });
+        }
+
+        auto name = functionName + "WithContext";
+        auto& function = BeginFunction(name, targetFunction->getReturnType(), args);
+        function.GetFunction()->setLinkage(llvm::GlobalValue::LinkageTypes::ExternalLinkage);
+        if (includeInHeader)
+        {
+            function.IncludeInHeader();
+        }
+
+        // Restore the previous context afterwards, so the functions can be nested
+        IRValueList arguments;
+        auto arg = function.GetFunction()->arg_begin();
+        auto state = &*arg++;
+        for (auto end = function.GetFunction()->arg_end(); arg != end; ++arg)
+        {
+            arguments.push_back(&*arg);
+        }
+        auto previousState = function.Load(currentState);
+        function.Store(currentState, state);
+        auto result = function.Call(targetFunction, arguments);
+        function.Store(currentState, previousState);
+        if (targetFunction->getReturnType()->isVoidTy())
+        {
+            function.Return();
+        }
+        else
+        {
+            function.Return(result);
+        }
+        EndFunction();
+        return name;
+    }
+
     //
     // Functions
     //
@@ -881,6 +1174,116 @@ namespace emitters
         }
     }
 
+    bool IRModuleEmitter::TryGetFunctionBitcode(const std::string& functionName, std::string& bitcode) const
+    {
+        auto function = GetFunction(functionName);
+        if (function == nullptr || function->isDeclaration())
+        {
+            return false;
+        }
+
+        // Find the internal definitions the function uses, directly or through the functions and globals it uses
+        std::set<const llvm::GlobalValue*> definitions;
+        std::vector<const llvm::GlobalValue*> pending = { function };
+        while (!pending.empty())
+        {
+            auto definition = pending.back();
+            pending.pop_back();
+            if (!definitions.insert(definition).second)
+            {
+                continue;
+            }
+
+            std::vector<const llvm::User*> users;
+            if (auto pFunction = llvm::dyn_cast<llvm::Function>(definition))
+            {
+                for (const auto& instruction : llvm::instructions(pFunction))
+                {
+                    users.push_back(&instruction);
+                }
+            }
+            else if (auto pGlobal = llvm::dyn_cast<llvm::GlobalVariable>(definition); pGlobal != nullptr && pGlobal->hasInitializer())
+            {
+                users.push_back(pGlobal->getInitializer());
+            }
+
+            while (!users.empty())
+            {
+                auto user = users.back();
+                users.pop_back();
+                for (const auto& operand : user->operands())
+                {
+                    if (auto global = llvm::dyn_cast<llvm::GlobalValue>(operand.get()))
+                    {
+                        if (definitions.count(global) != 0 || global->isDeclaration())
+                        {
+                            continue;
+                        }
+                        if (!global->hasLocalLinkage() || IsExternalWeightsPointer(const_cast<llvm::GlobalValue*>(global)))
+                        {
+                            return false;
+                        }
+                        pending.push_back(global);
+                    }
+                    else if (auto constant = llvm::dyn_cast<llvm::Constant>(operand.get()))
+                    {
+                        users.push_back(constant);
+                    }
+                }
+            }
+        }
+
+        llvm::ValueToValueMapTy valueMap;
+        auto clone = llvm::CloneModule(*GetLLVMModule(), valueMap, [&definitions](const llvm::GlobalValue* value) { return definitions.count(value) != 0; });
+
+        // Drop the declarations of everything else in this module, along with its module-level metadata, which
+        // would otherwise be duplicated when the IR is linked into another module
+        for (auto it = clone->begin(); it != clone->end();)
+        {
+            auto& cloneFunction = *it++;
+            if (cloneFunction.isDeclaration() && cloneFunction.use_empty())
+            {
+                cloneFunction.eraseFromParent();
+            }
+        }
+        for (auto it = clone->global_begin(); it != clone->global_end();)
+        {
+            auto& cloneGlobal = *it++;
+            if (cloneGlobal.isDeclaration() && cloneGlobal.use_empty())
+            {
+                cloneGlobal.eraseFromParent();
+            }
+        }
+        for (auto it = clone->named_metadata_begin(); it != clone->named_metadata_end();)
+        {
+            auto& metadata = *it++;
+            clone->eraseNamedMetadata(&metadata);
+        }
+
+        bitcode.clear();
+        llvm::raw_string_ostream out(bitcode);
+        llvm::WriteBitcodeToFile(*clone, out);
+        out.flush();
+        return true;
+    }
+
+    void IRModuleEmitter::LinkBitcode(const std::string& bitcode)
+    {
+        auto result = llvm::parseBitcodeFile(llvm::MemoryBufferRef(bitcode, GetModuleName()), GetLLVMContext());
+        if (!result)
+        {
+            throw EmitterException(EmitterError::parserError, "Unable to read bitcode: " + llvm::toString(result.takeError()));
+        }
+
+        auto module = std::move(result.get());
+        module->setDataLayout(GetLLVMModule()->getDataLayout());
+        module->setTargetTriple(GetLLVMModule()->getTargetTriple());
+        if (llvm::Linker::linkModules(*GetLLVMModule(), std::move(module)))
+        {
+            throw EmitterException(EmitterError::duplicateSymbol, "Unable to link bitcode into module " + GetModuleName());
+        }
+    }
+
     void IRModuleEmitter::LoadAsm(const std::string& text)
     {
         GetLLVMModule()->appendModuleInlineAsm(text);
@@ -920,14 +1323,9 @@ namespace emitters
                 throw EmitterException(EmitterError::unexpected, "Module verification failed.\n\n" + errorString);
             }
 
-            optimizer.BeginOptimizeFunctions();
+            // With the default of one compiler thread, the functions are optimized in place without splitting the module
             auto module = GetLLVMModule();
-            for (auto& function : *module)
-            {
-                optimizer.OptimizeFunction(&function);
-            }
-            optimizer.EndOptimizeFunctions();
-
+            optimizer.OptimizeFunctionsInParallel(module, utilities::GetNumThreads(static_cast<size_t>(std::max(compilerOptions.numCompilerThreads, 0))));
             optimizer.OptimizeModule(module);
         }
     }
@@ -7,21 +7,34 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "IROptimizer.h"
+#include "IRLoopVectorizer.h"
 #include "IRModuleEmitter.h"
 #include "LLVMInclude.h"
 
+#include <utilities/include/ParallelFor.h>
+
 #include <llvm/Analysis/TargetLibraryInfo.h>
 #include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/CodeGen/TargetPassConfig.h>
 #include <llvm/IR/IRPrintingPasses.h>
+#include <llvm/IR/InstIterator.h>
 #include <llvm/IR/Module.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Support/raw_ostream.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Transforms/IPO.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 #include <llvm/Transforms/Scalar.h>
 #include <llvm/Transforms/Scalar/GVN.h>
+#include <llvm/Transforms/Utils/Cloning.h>
 
+#include <algorithm>
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
 namespace ell
 {
@@ -29,6 +42,166 @@ namespace emitters
 {
     using namespace llvm;
 
+    namespace
+    {
+        void InitializePassManagerBuilder(llvm::PassManagerBuilder& builder, llvm::TargetMachine* targetMachine)
+        {
+            builder.OptLevel = 3;
+            builder.SizeLevel = 0;
+            builder.LoopVectorize = true;
+            builder.SLPVectorize = true;
+            builder.DisableUnrollLoops = false;
+
+            // Emit the loops marked by IRForLoopEmitter::SetVectorized as vector code before LLVM's loop vectorizer runs
+            auto fuseMultiplyAdd = targetMachine && (targetMachine->Options.AllowFPOpFusion == llvm::FPOpFusion::Fast || targetMachine->Options.UnsafeFPMath);
+            builder.addExtension(llvm::PassManagerBuilder::EP_VectorizerStart, [fuseMultiplyAdd](const llvm::PassManagerBuilder&, llvm::legacy::PassManagerBase& passes) {
+                passes.add(CreateLoopVectorizerPass(fuseMultiplyAdd));
+            });
+
+            if (targetMachine)
+            {
+                targetMachine->adjustPassManager(builder);
+            }
+        }
+
+        // The passes run on each function before the module passes. None of them look outside the function they're
+        // run on, so they can be run on separate copies of the functions in parallel.
+        void AddFunctionPasses(llvm::legacy::FunctionPassManager& functionPasses, llvm::TargetMachine* targetMachine)
+        {
+            functionPasses.add(llvm::createTargetTransformInfoWrapperPass(targetMachine ? targetMachine->getTargetIRAnalysis() : llvm::TargetIRAnalysis()));
+            functionPasses.add(llvm::createVerifierPass());
+
+            llvm::PassManagerBuilder builder;
+            InitializePassManagerBuilder(builder, targetMachine);
+            builder.populateFunctionPassManager(functionPasses);
+        }
+
+        std::string WriteBitcode(const llvm::Module& module)
+        {
+            std::string bitcode;
+            llvm::raw_string_ostream out(bitcode);
+            llvm::WriteBitcodeToFile(module, out);
+            out.flush();
+            return bitcode;
+        }
+
+        std::unique_ptr<llvm::Module> ReadBitcode(const std::string& bitcode, llvm::LLVMContext& context)
+        {
+            auto module = llvm::parseBitcodeFile(llvm::MemoryBufferRef(bitcode, "partition"), context);
+            if (!module)
+            {
+                throw EmitterException(EmitterError::parserError, llvm::toString(module.takeError()));
+            }
+            return std::move(module.get());
+        }
+
+        // Adds the global variables a function uses (directly, or through constant expressions) to a set
+        void AddGlobalVariablesUsedBy(const llvm::Function& function, std::set<const llvm::GlobalValue*>& globals)
+        {
+            std::vector<const llvm::User*> users;
+            for (const auto& instruction : llvm::instructions(function))
+            {
+                users.push_back(&instruction);
+            }
+
+            std::set<const llvm::User*> visited;
+            while (!users.empty())
+            {
+                auto user = users.back();
+                users.pop_back();
+                for (const auto& operand : user->operands())
+                {
+                    if (auto global = llvm::dyn_cast<llvm::GlobalVariable>(operand.get()))
+                    {
+                        globals.insert(global);
+                    }
+                    else if (auto constant = llvm::dyn_cast<llvm::Constant>(operand.get()); constant != nullptr && !llvm::isa<llvm::GlobalValue>(constant) && visited.insert(constant).second)
+                    {
+                        users.push_back(constant);
+                    }
+                }
+            }
+        }
+
+        // An internal global of a module, renamed while the module is split into partitions
+        struct RenamedGlobal
+        {
+            std::string uniqueName;
+            std::string originalName;
+            llvm::GlobalValue::LinkageTypes linkage;
+        };
+
+        // Gives the internal globals of a module unique names and external linkage. The linker only resolves symbols
+        // with external linkage, by name, and the names of internal globals don't identify them: they may be unnamed,
+        // or share their name with a global a pass adds to a partition.
+        std::vector<RenamedGlobal> RenameInternalGlobals(llvm::Module& module)
+        {
+            std::vector<RenamedGlobal> renamedGlobals;
+            for (auto& global : module.global_values())
+            {
+                if (global.hasLocalLinkage())
+                {
+                    auto uniqueName = "ell.partition.global." + std::to_string(renamedGlobals.size());
+                    renamedGlobals.push_back({ uniqueName, global.getName().str(), global.getLinkage() });
+                    global.setName(uniqueName);
+                    global.setLinkage(llvm::GlobalValue::ExternalLinkage);
+                }
+            }
+            return renamedGlobals;
+        }
+
+        void RestoreInternalGlobals(llvm::Module& module, const std::vector<RenamedGlobal>& renamedGlobals)
+        {
+            for (const auto& renamedGlobal : renamedGlobals)
+            {
+                auto global = module.getNamedValue(renamedGlobal.uniqueName);
+                global->setLinkage(renamedGlobal.linkage);
+                global->setName(renamedGlobal.originalName);
+            }
+        }
+
+        // Replaces the definitions of the functions in `module` with the ones in `partition`, which is a copy of some
+        // of `module`'s functions (along with declarations of everything else they use). The globals the partition
+        // shares with the module must have unique names and external linkage (see `RenameInternalGlobals`).
+        void LinkPartition(llvm::Module& module, std::unique_ptr<llvm::Module> partition)
+        {
+            // The copies in the module become declarations that the linker resolves to the partition's definitions,
+            // and the partition's copies of global variables become declarations resolved to the module's
+            for (auto& global : partition->global_values())
+            {
+                auto moduleGlobal = global.hasName() ? module.getNamedValue(global.getName()) : nullptr;
+                if (moduleGlobal == nullptr || global.hasLocalLinkage())
+                {
+                    continue; // Something a pass added, like a string constant or an intrinsic
+                }
+
+                if (auto function = llvm::dyn_cast<llvm::Function>(&global); function != nullptr && !function->isDeclaration())
+                {
+                    llvm::cast<llvm::Function>(moduleGlobal)->deleteBody();
+                }
+                else if (auto variable = llvm::dyn_cast<llvm::GlobalVariable>(&global); variable != nullptr && !variable->isDeclaration())
+                {
+                    variable->setInitializer(nullptr);
+                }
+            }
+
+            // The module already has its own copy of the module-level metadata
+            for (auto it = partition->named_metadata_begin(); it != partition->named_metadata_end();)
+            {
+                auto& metadata = *it++;
+                if (metadata.getName() != "llvm.module.flags")
+                {
+                    partition->eraseNamedMetadata(&metadata);
+                }
+            }
+
+            if (llvm::Linker::linkModules(module, std::move(partition)))
+            {
+                throw EmitterException(EmitterError::unexpected, "Unable to link optimized functions into module " + module.getName().str());
+            }
+        }
+    } // namespace
+
     IROptimizer::IROptimizer(IRModuleEmitter& module) :
         _module(module),
         _functionPasses(module.GetLLVMModule())
@@ -47,7 +220,7 @@ namespace emitters
         {
             throw EmitterException(EmitterError::unexpected, "Unable to allocate target machine");
         }
-        
+
         auto& llvmTargetMachine = static_cast<LLVMTargetMachine&>(*targetMachine);
         auto config = static_cast<llvm::Pass*>(llvmTargetMachine.createPassConfig(_modulePasses));
         _modulePasses.add(config);
@@ -59,25 +232,11 @@ namespace emitters
         _modulePasses.add(llvm::createTargetTransformInfoWrapperPass(targetMachine ? targetMachine->getTargetIRAnalysis()
                                                                                    : llvm::TargetIRAnalysis()));
 
-        _functionPasses.add(llvm::createTargetTransformInfoWrapperPass(
-            targetMachine ? targetMachine->getTargetIRAnalysis() : llvm::TargetIRAnalysis()));
-
-        _functionPasses.add(llvm::createVerifierPass());
+        AddFunctionPasses(_functionPasses, targetMachine);
 
         llvm::PassManagerBuilder builder;
-        builder.OptLevel = 3;
-        builder.SizeLevel = 0;
+        InitializePassManagerBuilder(builder, targetMachine);
         builder.Inliner = llvm::createFunctionInliningPass(builder.OptLevel, builder.SizeLevel, false);
-        builder.LoopVectorize = true;
-        builder.SLPVectorize = true;
-        builder.DisableUnrollLoops = false;
-
-        if (targetMachine)
-        {
-            targetMachine->adjustPassManager(builder);
-        }
-
-        builder.populateFunctionPassManager(_functionPasses);
         builder.populateModulePassManager(_modulePasses);
     }
 
@@ -97,6 +256,83 @@ namespace emitters
         (void)_functionPasses.doFinalization();
     }
 
+    void IROptimizer::OptimizeFunctionsInParallel(llvm::Module* pModule, size_t numThreads)
+    {
+        std::vector<llvm::Function*> functions;
+        for (auto& function : *pModule)
+        {
+            if (!function.isDeclaration())
+            {
+                functions.push_back(&function);
+            }
+        }
+
+        auto numPartitions = std::min(numThreads, functions.size());
+        if (numPartitions <= 1)
+        {
+            BeginOptimizeFunctions();
+            for (auto function : functions)
+            {
+                OptimizeFunction(function);
+            }
+            EndOptimizeFunctions();
+            return;
+        }
+
+        // Split the functions into partitions with about the same number of instructions, largest functions first.
+        // Each partition also gets copies of the global variables its functions use, so loads of constants can be folded.
+        std::stable_sort(functions.begin(), functions.end(), [](const llvm::Function* a, const llvm::Function* b) {
+            return a->getInstructionCount() > b->getInstructionCount();
+        });
+        std::vector<std::set<const llvm::GlobalValue*>> partitions(numPartitions);
+        std::vector<size_t> partitionSizes(numPartitions, 0);
+        for (auto function : functions)
+        {
+            auto partition = std::min_element(partitionSizes.begin(), partitionSizes.end()) - partitionSizes.begin();
+            partitions[partition].insert(function);
+            AddGlobalVariablesUsedBy(*function, partitions[partition]);
+            partitionSizes[partition] += function->getInstructionCount();
+        }
+
+        // A context can only be used by one thread at a time, so each partition is passed to its thread (and back) as bitcode
+        auto renamedGlobals = RenameInternalGlobals(*pModule);
+        std::vector<std::string> bitcode(numPartitions);
+        std::vector<std::unique_ptr<llvm::TargetMachine>> targetMachines;
+        for (size_t partition = 0; partition < numPartitions; ++partition)
+        {
+            llvm::ValueToValueMapTy valueMap;
+            auto partitionModule = llvm::CloneModule(*pModule, valueMap, [&](const llvm::GlobalValue* value) { return partitions[partition].count(value) != 0; });
+            bitcode[partition] = WriteBitcode(*partitionModule);
+            targetMachines.emplace_back(_module.GetTargetMachine());
+        }
+
+        utilities::ParallelFor(numPartitions, numPartitions, [&](size_t, size_t, size_t partition) {
+            llvm::LLVMContext context;
+            auto partitionModule = ReadBitcode(bitcode[partition], context);
+
+            llvm::legacy::FunctionPassManager functionPasses(partitionModule.get());
+            AddFunctionPasses(functionPasses, targetMachines[partition].get());
+            (void)functionPasses.doInitialization();
+            for (auto& function : *partitionModule)
+            {
+                if (!function.isDeclaration())
+                {
+                    functionPasses.run(function);
+                }
+            }
+            (void)functionPasses.doFinalization();
+
+            bitcode[partition] = WriteBitcode(*partitionModule);
+        });
+
+        // Link the partitions back in a fixed order, so the result doesn't depend on which thread finishes first
+        for (size_t partition = 0; partition < numPartitions; ++partition)
+        {
+            LinkPartition(*pModule, ReadBitcode(bitcode[partition], pModule->getContext()));
+        }
+        RestoreInternalGlobals(*pModule, renamedGlobals);
+    }
+
     void IROptimizer::OptimizeModule(llvm::Module* pModule)
     {
         _modulePasses.run(*pModule);
@@ -18,6 +18,19 @@ namespace ell
 {
 namespace emitters
 {
+    namespace
+    {
+        // With work stealing, split loops into more tasks than threads, so threads that finish early can take over
+        // part of the remaining work
+        const int c_workStealingTasksPerThread = 4;
+
+        int GetDefaultNumTasks(const CompilerOptions& compilerSettings)
+        {
+            const bool useWorkStealing = compilerSettings.useThreadPool && compilerSettings.useWorkStealing;
+            return useWorkStealing ? compilerSettings.maxThreads * c_workStealingTasksPerThread : compilerSettings.maxThreads;
+        }
+    } // namespace
+
     IRParallelForLoopEmitter::IRParallelForLoopEmitter(IRFunctionEmitter& functionEmitter) :
         _functionEmitter(functionEmitter) {}
 
@@ -31,7 +44,7 @@ namespace emitters
         ParallelLoopOptions newOptions = options;
         if (newOptions.numTasks == 0)
         {
-            newOptions.numTasks = std::min(numIterations, compilerSettings.maxThreads);
+            newOptions.numTasks = std::min(numIterations, GetDefaultNumTasks(compilerSettings));
         }
         EmitLoop(_functionEmitter.LocalScalar<int32_t>(begin), _functionEmitter.LocalScalar<int32_t>(end), _functionEmitter.LocalScalar<int32_t>(increment), newOptions, capturedValues, body);
     }
@@ -39,7 +52,7 @@ namespace emitters
     void IRParallelForLoopEmitter::EmitLoop(IRLocalScalar begin, IRLocalScalar end, IRLocalScalar increment, const ParallelLoopOptions& options, const std::vector<LLVMValue>& capturedValues, BodyFunction body)
     {
         auto compilerSettings = _functionEmitter.GetCompilerOptions();
-        const int numTasks = options.numTasks == 0 ? compilerSettings.maxThreads : options.numTasks;
+        const int numTasks = options.numTasks == 0 ? GetDefaultNumTasks(compilerSettings) : options.numTasks;
         auto span = end - begin;
         auto numIterations = (span - 1) / increment + 1;
         // TODO: explicitly check for empty loop?
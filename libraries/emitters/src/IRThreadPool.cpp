@@ -17,12 +17,74 @@
 #include <utilities/include/Exception.h>
 #include <utilities/include/Unused.h>
 
+#include <cstdint>
 #include <vector>
 
 namespace ell
 {
 namespace emitters
 {
+    namespace
+    {
+        // Number of 64-bit entries between two workers' task deques, so that each deque sits on its own cache line
+        const int c_taskDequeStride = 8;
+
+        LLVMValue AtomicLoad(IRFunctionEmitter& function, LLVMValue pointer)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            const auto& dataLayout = function.GetModule().GetTargetDataLayout();
+            auto load = irBuilder.CreateLoad(pointer);
+            load->setAtomic(llvm::AtomicOrdering::SequentiallyConsistent);
+            load->setAlignment(static_cast<unsigned>(dataLayout.getTypeStoreSize(load->getType())));
+            return load;
+        }
+
+        void AtomicStore(IRFunctionEmitter& function, LLVMValue pointer, LLVMValue value)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            const auto& dataLayout = function.GetModule().GetTargetDataLayout();
+            auto store = irBuilder.CreateStore(value, pointer);
+            store->setAtomic(llvm::AtomicOrdering::SequentiallyConsistent);
+            store->setAlignment(static_cast<unsigned>(dataLayout.getTypeStoreSize(value->getType())));
+        }
+
+        // Returns the value stored before the subtraction
+        LLVMValue AtomicSubtract(IRFunctionEmitter& function, LLVMValue pointer, LLVMValue value)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            return irBuilder.CreateAtomicRMW(llvm::AtomicRMWInst::Sub, pointer, value, llvm::AtomicOrdering::SequentiallyConsistent);
+        }
+
+        // Returns `true` if `pointer` held `expected` and was replaced by `newValue`
+        LLVMValue AtomicCompareExchange(IRFunctionEmitter& function, LLVMValue pointer, LLVMValue expected, LLVMValue newValue)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            auto result = irBuilder.CreateAtomicCmpXchg(pointer, expected, newValue, llvm::AtomicOrdering::SequentiallyConsistent, llvm::AtomicOrdering::SequentiallyConsistent);
+            return irBuilder.CreateExtractValue(result, 1);
+        }
+
+        // A task range [begin, end) is packed into a single 64-bit value, with `begin` in the low 32 bits,
+        // so both ends can be updated with one compare-and-swap
+        int64_t PackTaskRange(int begin, int end)
+        {
+            return static_cast<int64_t>((static_cast<uint64_t>(static_cast<uint32_t>(end)) << 32) | static_cast<uint32_t>(begin));
+        }
+
+        LLVMValue PackTaskRange(IRFunctionEmitter& function, LLVMValue begin, LLVMValue end)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            auto int64Type = llvm::Type::getInt64Ty(function.GetLLVMContext());
+            return irBuilder.CreateOr(irBuilder.CreateZExt(begin, int64Type), irBuilder.CreateShl(irBuilder.CreateZExt(end, int64Type), 32));
+        }
+
+        std::pair<LLVMValue, LLVMValue> UnpackTaskRange(IRFunctionEmitter& function, LLVMValue range)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            auto int32Type = llvm::Type::getInt32Ty(function.GetLLVMContext());
+            return { irBuilder.CreateTrunc(range, int32Type), irBuilder.CreateTrunc(irBuilder.CreateLShr(range, 32), int32Type) };
+        }
+    } // namespace
+
     //
     // IRThreadPool
     //
@@ -58,13 +120,16 @@ namespace emitters
             auto notInited = initThreadPoolFunction.LogicalNot(initThreadPoolFunction.Load(isInitedVar));
             initThreadPoolFunction.If(notInited, [this, int8PtrType, &isInitedVar](auto& initThreadPoolFunction) {
                 initThreadPoolFunction.Store(isInitedVar, initThreadPoolFunction.TrueBit());
-                _taskQueue.Initialize(initThreadPoolFunction);
+                _taskQueue.Initialize(initThreadPoolFunction, static_cast<int>(_maxThreads), _module.GetCompilerOptions().useWorkStealing);
 
                 auto workerThreadFunction = this->GetWorkerThreadFunction(); // STYLE gcc bug requires `this->` inside generic lambda (https://gcc.gnu.org/bugzilla/show_bug.cgi?id=67274)
                 llvm::ConstantPointerNull* nullAttr = initThreadPoolFunction.NullPointer(int8PtrType);
                 initThreadPoolFunction.For(_maxThreads, [this, int8PtrType, nullAttr, workerThreadFunction](auto& initThreadPoolFunction, LLVMValue index) {
                     auto threadPtr = initThreadPoolFunction.PointerOffset(_threads, index);
-                    initThreadPoolFunction.PthreadCreate(threadPtr, nullAttr, workerThreadFunction, initThreadPoolFunction.CastPointer(_taskQueue.GetDataStruct(), int8PtrType));
+
+                    // The thread's argument is its worker index
+                    auto workerIndex = initThreadPoolFunction.GetEmitter().GetIRBuilder().CreateIntToPtr(index, int8PtrType);
+                    initThreadPoolFunction.PthreadCreate(threadPtr, nullAttr, workerThreadFunction, workerIndex);
                 });
             });
         }
@@ -115,13 +180,15 @@ namespace emitters
         auto& context = _module.GetLLVMContext();
         auto boolType = llvm::Type::getInt1Ty(context);
         auto int8PtrType = llvm::Type::getInt8PtrTy(context);
+        auto int32Type = llvm::Type::getInt32Ty(context);
 
         auto workerThreadFunction = _module.BeginFunction("WorkerThreadFunction", int8PtrType, { int8PtrType });
         {
+            auto workerIndex = workerThreadFunction.GetEmitter().GetIRBuilder().CreatePtrToInt(&(*workerThreadFunction.GetFunction()->arg_begin()), int32Type);
             auto notDoneVar = workerThreadFunction.Variable(boolType, "notDone");
             workerThreadFunction.Store(notDoneVar, workerThreadFunction.TrueBit());
-            workerThreadFunction.While(notDoneVar, [this, notDoneVar](IRFunctionEmitter& workerThreadFunction) {
-                auto task = _taskQueue.PopNextTask(workerThreadFunction);
+            workerThreadFunction.While(notDoneVar, [this, notDoneVar, workerIndex](IRFunctionEmitter& workerThreadFunction) {
+                auto task = _taskQueue.PopNextTask(workerThreadFunction, workerIndex);
                 // check for a poison "null" task, indicating we should break out of the loop and terminate the thread
                 workerThreadFunction.If(
                                         workerThreadFunction.Operator(TypedOperator::logicalOr, task.IsNull(workerThreadFunction), _taskQueue.GetShutdownFlag(workerThreadFunction)),
@@ -130,16 +197,7 @@ namespace emitters
                                         })
                     .Else([this, &task](IRFunctionEmitter& workerThreadFunction) {
                         task.Run(workerThreadFunction);
-
-                        // Decrement count of unfinished tasks
-                        _taskQueue.LockQueueMutex(workerThreadFunction);
-                        auto unfinishedCount = _taskQueue.DecrementUnfinishedTasks(workerThreadFunction);
-                        _taskQueue.UnlockQueueMutex(workerThreadFunction);
-
-                        // if zero, signal client cond var
-                        workerThreadFunction.If(workerThreadFunction.Comparison(TypedComparison::equals, unfinishedCount, workerThreadFunction.Literal<int>(0)), [this](auto& workerThreadFunction) {
-                            _taskQueue.NotifyWaitingClients(workerThreadFunction);
-                        });
+                        _taskQueue.FinishTask(workerThreadFunction);
                     });
             });
 
@@ -164,7 +222,7 @@ namespace emitters
         // Note: we can't initialize ourselves here, for ordering reasons.
     }
 
-    void IRThreadPoolTaskQueue::Initialize(IRFunctionEmitter& function)
+    void IRThreadPoolTaskQueue::Initialize(IRFunctionEmitter& function, int numWorkers, bool useWorkStealing)
     {
         if (_queueData != nullptr)
         {
@@ -175,11 +233,20 @@ namespace emitters
         // Get types
         auto& context = module.GetLLVMContext();
         auto int8PtrType = llvm::Type::getInt8PtrTy(context);
+        auto int64Type = llvm::Type::getInt64Ty(context);
         auto taskQueueDataType = GetTaskQueueDataType(module);
 
         // Allocate a data struct
         _queueData = module.Global(taskQueueDataType, "taskQueueData");
 
+        _numWorkers = numWorkers;
+        _useWorkStealing = useWorkStealing;
+        if (_useWorkStealing)
+        {
+            // Allocate the workers' task deques (initialized to empty ranges)
+            _taskDeques = module.GlobalArray("taskDeques", int64Type, _numWorkers * c_taskDequeStride);
+        }
+
         // Get pointers to the fields
         auto queueMutex = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::queueMutex));
         auto workAvailableCondVar = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::workAvailableCondVar));
@@ -212,6 +279,11 @@ namespace emitters
         LockQueueMutex(function);
         _tasks.SetTasks(function, taskFunction, arguments);
         SetInitialCount(function, function.Literal<int>(numTasks));
+        if (_useWorkStealing)
+        {
+            // Workers may claim tasks as soon as they're in a deque, so the counts have to be set first
+            DistributeTasks(function, static_cast<int>(numTasks));
+        }
         function.PthreadCondBroadcast(GetWorkAvailableConditionVariablePointer(function));
         UnlockQueueMutex(function);
         return GetTaskArray();
@@ -222,7 +294,41 @@ namespace emitters
         function.PthreadCondBroadcast(GetWorkFinishedConditionVariablePointer(function));
     }
 
-    IRThreadPoolTask IRThreadPoolTaskQueue::PopNextTask(IRFunctionEmitter& function)
+    IRThreadPoolTask IRThreadPoolTaskQueue::PopNextTask(IRFunctionEmitter& function, LLVMValue workerIndex)
+    {
+        return _useWorkStealing ? PopNextStolenTask(function, workerIndex) : PopNextSharedTask(function);
+    }
+
+    void IRThreadPoolTaskQueue::FinishTask(IRFunctionEmitter& function)
+    {
+        assert(IsInitialized());
+
+        if (_useWorkStealing)
+        {
+            // Decrement count of unfinished tasks without taking the lock, and only take it to signal the client cond var
+            auto unfinishedCountPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unfinishedCount));
+            auto oldCount = AtomicSubtract(function, unfinishedCountPtr, function.Literal<int>(1));
+            function.If(function.Comparison(TypedComparison::equals, oldCount, function.Literal<int>(1)), [this](IRFunctionEmitter& function) {
+                this->LockQueueMutex(function);
+                this->NotifyWaitingClients(function);
+                this->UnlockQueueMutex(function);
+            });
+        }
+        else
+        {
+            // Decrement count of unfinished tasks
+            LockQueueMutex(function);
+            auto unfinishedCount = DecrementUnfinishedTasks(function);
+            UnlockQueueMutex(function);
+
+            // if zero, signal client cond var
+            function.If(function.Comparison(TypedComparison::equals, unfinishedCount, function.Literal<int>(0)), [this](IRFunctionEmitter& function) {
+                this->NotifyWaitingClients(function);
+            });
+        }
+    }
+
+    IRThreadPoolTask IRThreadPoolTaskQueue::PopNextSharedTask(IRFunctionEmitter& function)
     {
         assert(IsInitialized());
 
@@ -252,6 +358,123 @@ namespace emitters
         return _tasks.GetTask(function, newCount);
     }
 
+    IRThreadPoolTask IRThreadPoolTaskQueue::PopNextStolenTask(IRFunctionEmitter& function, LLVMValue workerIndex)
+    {
+        assert(IsInitialized());
+
+        auto& module = function.GetModule();
+        auto& context = module.GetLLVMContext();
+        auto boolType = llvm::Type::getInt1Ty(context);
+        auto int32Type = llvm::Type::getInt32Ty(context);
+
+        auto taskIndexVar = function.Variable(int32Type, "taskIndex");
+        auto notDoneVar = function.Variable(boolType, "notDone");
+        auto isEmptyVar = function.Variable(boolType, "isEmpty");
+        auto queueMutex = GetQueueMutexPointer(function);
+        auto workAvailableCondVar = GetWorkAvailableConditionVariablePointer(function);
+
+        function.Store(taskIndexVar, function.Literal<int>(-1));
+        function.Store(notDoneVar, function.TrueBit());
+        function.While(notDoneVar, [=](IRFunctionEmitter& function) {
+            // Sleep until there are unscheduled tasks. The lock is only needed to wait on the condition variable;
+            // the tasks themselves are claimed without it
+            this->LockQueueMutex(function);
+            function.Store(isEmptyVar, function.Operator(TypedOperator::logicalAnd, this->IsEmpty(function), function.Operator(UnaryOperatorType::logicalNot, this->GetShutdownFlag(function))));
+            function.While(isEmptyVar, [=](IRFunctionEmitter& function) {
+                function.PthreadCondWait(workAvailableCondVar, queueMutex);
+                function.Store(isEmptyVar, function.Operator(TypedOperator::logicalAnd, this->IsEmpty(function), function.Operator(UnaryOperatorType::logicalNot, this->GetShutdownFlag(function))));
+            });
+            this->UnlockQueueMutex(function);
+
+            function.If(this->GetShutdownFlag(function), [=](IRFunctionEmitter& function) {
+                        function.Store(notDoneVar, function.FalseBit());
+                    })
+                .Else([=](IRFunctionEmitter& function) {
+                    // If another worker claims the last unscheduled task between our check and our claim, we come back and wait again
+                    auto taskIndex = this->TryClaimTask(function, workerIndex);
+                    function.If(function.Comparison(TypedComparison::greaterThanOrEquals, taskIndex, function.Literal<int>(0)), [=](IRFunctionEmitter& function) {
+                        function.Store(taskIndexVar, taskIndex);
+                        function.Store(notDoneVar, function.FalseBit());
+                        auto unscheduledCountPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unscheduledCount));
+                        AtomicSubtract(function, unscheduledCountPtr, function.Literal<int>(1));
+                    });
+                });
+        });
+
+        // A negative task index (which is what happens when shutting down) returns a null task
+        return _tasks.GetTask(function, function.Load(taskIndexVar));
+    }
+
+    void IRThreadPoolTaskQueue::DistributeTasks(IRFunctionEmitter& function, int numTasks)
+    {
+        assert(_taskDeques != nullptr);
+
+        // Give each worker a contiguous block of tasks. Stores are atomic because idle workers may still be
+        // inspecting the deques left empty by the previous set of tasks.
+        for (int workerIndex = 0; workerIndex < _numWorkers; ++workerIndex)
+        {
+            auto begin = (workerIndex * numTasks) / _numWorkers;
+            auto end = ((workerIndex + 1) * numTasks) / _numWorkers;
+            auto dequePtr = function.PointerOffset(_taskDeques, workerIndex * c_taskDequeStride);
+            AtomicStore(function, dequePtr, function.Literal<int64_t>(PackTaskRange(begin, end)));
+        }
+    }
+
+    LLVMValue IRThreadPoolTaskQueue::TryClaimTask(IRFunctionEmitter& function, LLVMValue workerIndex)
+    {
+        assert(_taskDeques != nullptr);
+
+        auto& context = function.GetLLVMContext();
+        auto boolType = llvm::Type::getInt1Ty(context);
+        auto int32Type = llvm::Type::getInt32Ty(context);
+        const auto numWorkers = _numWorkers;
+
+        auto taskIndexVar = function.Variable(int32Type, "claimedTaskIndex");
+        auto victimOffsetVar = function.Variable(int32Type, "victimOffset");
+        auto retryVar = function.Variable(boolType, "retryClaim");
+        function.Store(taskIndexVar, function.Literal<int>(-1));
+        function.Store(victimOffsetVar, function.Literal<int>(0));
+
+        // Look in our own deque first, then in the other workers' deques, in round-robin order
+        auto keepLooking = [=](IRFunctionEmitter& function) {
+            auto notFound = function.Comparison(TypedComparison::lessThan, function.Load(taskIndexVar), function.Literal<int>(0));
+            auto victimsLeft = function.Comparison(TypedComparison::lessThan, function.Load(victimOffsetVar), function.Literal<int>(numWorkers));
+            return function.Operator(TypedOperator::logicalAnd, notFound, victimsLeft);
+        };
+        function.While(keepLooking, [=](IRFunctionEmitter& function) {
+            auto victimOffset = function.LocalScalar(function.Load(victimOffsetVar));
+            auto victimIndex = (function.LocalScalar(workerIndex) + victimOffset) % numWorkers;
+            auto isOwnDeque = victimOffset == 0;
+            auto dequePtr = function.PointerOffset(_taskDeques, victimIndex * c_taskDequeStride);
+
+            function.Store(retryVar, function.TrueBit());
+            function.While(retryVar, [=](IRFunctionEmitter& function) {
+                auto range = AtomicLoad(function, dequePtr);
+                auto beginEnd = UnpackTaskRange(function, range);
+                auto begin = function.LocalScalar(beginEnd.first);
+                auto end = function.LocalScalar(beginEnd.second);
+                function.If(begin < end, [=](IRFunctionEmitter& function) {
+                            // The owner takes tasks from the front of its deque, thieves take them from the back
+                            auto newBegin = function.Select(isOwnDeque, begin + 1, begin);
+                            auto newEnd = function.Select(isOwnDeque, end, end - 1);
+                            auto claimed = AtomicCompareExchange(function, dequePtr, range, PackTaskRange(function, newBegin, newEnd));
+                            function.If(claimed, [=](IRFunctionEmitter& function) {
+                                function.Store(taskIndexVar, function.Select(isOwnDeque, begin, end - 1));
+                                function.Store(retryVar, function.FalseBit());
+                            });
+                            // Otherwise, another worker changed the deque under us: reload it and try again
+                        })
+                    .Else([=](IRFunctionEmitter& function) {
+                        function.Store(retryVar, function.FalseBit());
+                    });
+            });
+
+            function.Store(victimOffsetVar, victimOffset + 1);
+        });
+
+        return function.Load(taskIndexVar);
+    }
+
     bool IRThreadPoolTaskQueue::IsInitialized() const
     {
         return _queueData != nullptr;
@@ -327,25 +550,26 @@ namespace emitters
         return function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::workFinishedCondVar));
     }
 
+    // Note: the counts are accessed atomically, because in work-stealing mode they're decremented without holding the queue mutex
     LLVMValue IRThreadPoolTaskQueue::GetUnscheduledCount(IRFunctionEmitter& function) const
     {
         assert(IsInitialized());
         auto fieldPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unscheduledCount));
-        return function.Load(fieldPtr);
+        return AtomicLoad(function, fieldPtr);
     }
 
     LLVMValue IRThreadPoolTaskQueue::GetUnfinishedCount(IRFunctionEmitter& function) const
     {
         assert(IsInitialized());
         auto fieldPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unfinishedCount));
-        return function.Load(fieldPtr);
+        return AtomicLoad(function, fieldPtr);
     }
 
     void IRThreadPoolTaskQueue::SetInitialCount(IRFunctionEmitter& function, LLVMValue numTasks)
     {
         assert(IsInitialized());
-        function.Store(function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unscheduledCount)), numTasks);
-        function.Store(function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unfinishedCount)), numTasks);
+        AtomicStore(function, function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unfinishedCount)), numTasks);
+        AtomicStore(function, function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unscheduledCount)), numTasks);
     }
 
     LLVMValue IRThreadPoolTaskQueue::DecrementCountField(IRFunctionEmitter& function, LLVMValue fieldPtr)
@@ -136,5 +136,24 @@ namespace emitters
             throw EmitterException(EmitterError::valueTypeNotSupported);
         }
     }
+
+    Variable* VariableAllocator::AddVectorViewVariable(VariableType type, Variable& src, size_t byteOffset, int size)
+    {
+        switch (type)
+        {
+        case VariableType::Double:
+            return AddVariable<VectorViewVariable<double>>(src, byteOffset, size);
+        case VariableType::Float:
+            return AddVariable<VectorViewVariable<float>>(src, byteOffset, size);
+        case VariableType::Int32:
+            return AddVariable<VectorViewVariable<int>>(src, byteOffset, size);
+        case VariableType::Int64:
+            return AddVariable<VectorViewVariable<int64_t>>(src, byteOffset, size);
+        case VariableType::Byte:
+            return AddVariable<VectorViewVariable<uint8_t>>(src, byteOffset, size);
+        default:
+            throw EmitterException(EmitterError::valueTypeNotSupported);
+        }
+    }
 } // namespace emitters
 } // namespace ell
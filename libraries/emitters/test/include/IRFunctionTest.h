@@ -11,3 +11,4 @@ void TestIRAddFunction();
 void TestCompilableFunction();
 void TestStringCompareFunction();
 void TestAllocaPlacement();
+void TestVectorizedLoop();
@@ -212,13 +212,14 @@ void TestParallelTasks(bool parallel, bool useThreadPool)
 //
 // TestParallelFor
 //
-void TestParallelFor(int begin, int end, int increment, bool parallel)
+void TestParallelFor(int begin, int end, int increment, bool parallel, bool useWorkStealing)
 {
     CompilerOptions options;
     options.optimize = false;
     options.targetDevice.deviceName = "host";
     options.parallelize = parallel;
     options.useThreadPool = true;
+    options.useWorkStealing = useWorkStealing;
     IRModuleEmitter module("ParallelForTest", options);
 
     // Function to run test
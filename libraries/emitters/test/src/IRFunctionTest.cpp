@@ -17,15 +17,22 @@
 #include <emitters/include/IRExecutionEngine.h>
 #include <emitters/include/IRFunctionEmitter.h>
 #include <emitters/include/IRLocalScalar.h>
+#include <emitters/include/IRLoopEmitter.h>
 #include <emitters/include/IRModuleEmitter.h>
+#include <emitters/include/IROptimizer.h>
 #include <emitters/include/Variable.h>
 
 #include <testing/include/testing.h>
 
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/IntrinsicInst.h>
+
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <ostream>
 #include <string>
+#include <vector>
 
 using namespace ell;
 using namespace ell::emitters;
@@ -49,6 +56,16 @@ public:
     std::string GetRuntimeTypeName() const override { return "PlusFive"; }
 };
 
+// Emits `body` in a loop from 0 to `size` that's marked to be vectorized with `vectorWidth` lanes
+void EmitVectorizedLoop(IRFunctionEmitter& function, int size, int vectorWidth, std::function<void(IRLocalScalar)> body)
+{
+    IRForLoopEmitter loop(function);
+    loop.Begin(size);
+    body(function.LocalScalar(loop.LoadIterationVariable()));
+    loop.SetVectorized(vectorWidth);
+    loop.End();
+}
+
 using UnaryScalarDoubleFunction = double (*)(double);
 using BinaryScalarDoubleFunction = double (*)(double, double);
 
@@ -214,4 +231,98 @@ void TestAllocaPlacement()
         }
     }
     testing::ProcessTest("Testing alloca placement", ok);
-}
\ No newline at end of file
+}
+
+void TestVectorizedLoop()
+{
+    const int size = 32;
+    const int vectorWidth = 8;
+
+    CompilerOptions options;
+    IRModuleEmitter module("VectorizedLoop", options);
+
+    // Independent iterations: c[i] += a[i] * b[i]
+    auto multiplyAdd = module.BeginFunction("MultiplyAdd", VariableType::Void, NamedVariableTypeList{ { "a", VariableType::FloatPointer }, { "b", VariableType::FloatPointer }, { "c", VariableType::FloatPointer } });
+    multiplyAdd.SetAttributeForArguments(IRFunctionEmitter::Attributes::NoAlias);
+    {
+        auto a = multiplyAdd.GetFunctionArgument("a");
+        auto b = multiplyAdd.GetFunctionArgument("b");
+        auto c = multiplyAdd.GetFunctionArgument("c");
+        EmitVectorizedLoop(multiplyAdd, size, vectorWidth, [&](IRLocalScalar i) {
+            auto product = multiplyAdd.LocalScalar(multiplyAdd.ValueAt(a, i)) * multiplyAdd.LocalScalar(multiplyAdd.ValueAt(b, i));
+            multiplyAdd.SetValueAt(c, i, multiplyAdd.LocalScalar(multiplyAdd.ValueAt(c, i)) + product);
+        });
+    }
+    multiplyAdd.Return();
+    module.EndFunction();
+
+    // Each iteration reads the element the previous one wrote: x[i + 1] = x[i] + 1
+    auto recurrence = module.BeginFunction("Recurrence", VariableType::Void, NamedVariableTypeList{ { "x", VariableType::Int32Pointer } });
+    {
+        auto x = recurrence.GetFunctionArgument("x");
+        EmitVectorizedLoop(recurrence, size, vectorWidth, [&](IRLocalScalar i) {
+            recurrence.SetValueAt(x, i + 1, recurrence.LocalScalar(recurrence.ValueAt(x, i)) + 1);
+        });
+    }
+    recurrence.Return();
+    module.EndFunction();
+
+    // Each iteration adds to the same element: x[0] += y[i]
+    auto reduction = module.BeginFunction("Reduction", VariableType::Void, NamedVariableTypeList{ { "x", VariableType::Int32Pointer }, { "y", VariableType::Int32Pointer } });
+    {
+        auto x = reduction.GetFunctionArgument("x");
+        auto y = reduction.GetFunctionArgument("y");
+        EmitVectorizedLoop(reduction, size, vectorWidth, [&](IRLocalScalar i) {
+            reduction.SetValueAt(x, 0, reduction.LocalScalar(reduction.ValueAt(x, 0)) + reduction.LocalScalar(reduction.ValueAt(y, i)));
+        });
+    }
+    reduction.Return();
+    module.EndFunction();
+
+    IROptimizer optimizer(module);
+    optimizer.AddStandardPasses();
+    module.Optimize(optimizer);
+
+    bool hasVectorMultiplyAdd = false;
+    for (auto& instruction : llvm::instructions(*module.GetFunction("MultiplyAdd")))
+    {
+        auto intrinsic = llvm::dyn_cast<llvm::IntrinsicInst>(&instruction);
+        if (intrinsic != nullptr && intrinsic->getIntrinsicID() == llvm::Intrinsic::fmuladd && intrinsic->getType()->isVectorTy())
+        {
+            hasVectorMultiplyAdd = true;
+        }
+    }
+    testing::ProcessTest("Testing vectorized loop emits vector multiply-adds", hasVectorMultiplyAdd);
+
+    IRExecutionEngine executionEngine(std::move(module));
+    auto compiledMultiplyAdd = executionEngine.GetFunction<void(float*, float*, float*)>("MultiplyAdd");
+    auto compiledRecurrence = executionEngine.GetFunction<void(int*)>("Recurrence");
+    auto compiledReduction = executionEngine.GetFunction<void(int*, int*)>("Reduction");
+
+    std::vector<float> a(size), b(size), c(size), expectedC(size);
+    std::vector<int> x(size + 1, 0), expectedX(size + 1), y(size);
+    int expectedSum = 0;
+    for (int i = 0; i < size; ++i)
+    {
+        a[i] = static_cast<float>(i) / 4;
+        b[i] = static_cast<float>(size - i);
+        c[i] = static_cast<float>(i % 3);
+        expectedC[i] = c[i] + a[i] * b[i];
+        y[i] = i * i;
+        expectedSum += y[i];
+    }
+    for (int i = 0; i <= size; ++i)
+    {
+        expectedX[i] = i;
+    }
+
+    compiledMultiplyAdd(a.data(), b.data(), c.data());
+    testing::ProcessTest("Testing vectorized loop with independent iterations", testing::IsEqual(c, expectedC, 1.0e-5f));
+
+    compiledRecurrence(x.data());
+    testing::ProcessTest("Testing vectorized loop with a loop-carried dependence", testing::IsEqual(x, expectedX));
+
+    std::vector<int> sum = { 0 };
+    compiledReduction(sum.data(), y.data());
+    testing::ProcessTest("Testing vectorized loop with a reduction", testing::IsEqual(sum[0], expectedSum));
+}
@@ -62,6 +62,7 @@ void TestIRFunction()
     TestCompilableFunction();
     TestStringCompareFunction();
     TestAllocaPlacement();
+    TestVectorizedLoop();
 }
 
 void TestAsyncEmitter()
@@ -86,6 +87,9 @@ void TestAsyncEmitter()
     TestParallelFor(10, 90, 2, true);
     TestParallelFor(10, 90, 3, true);
     TestParallelFor(30, 40, 11, true);
+    TestParallelFor(0, 100, 1, true, true);
+    TestParallelFor(10, 90, 3, true, true);
+    TestParallelFor(30, 40, 11, true, true);
 }
 
 void TestPosixEmitter()
@@ -9,10 +9,12 @@
 
 #include "Vector.h"
 
+#include <utilities/include/ArrayView.h>
 #include <utilities/include/IArchivable.h>
 
 #include <cstddef>
 #include <limits>
+#include <memory>
 
 namespace ell
 {
@@ -559,6 +561,15 @@ namespace math
         /// <param name="list"> A list of elements. These elements are expected to be in the layout order of this matrix's layout type. </param>
         Matrix(size_t numRows, size_t numColumns, std::vector<ElementType>&& data);
 
+        /// <summary> Constructs a matrix that uses the elements of an array view in place, instead of copying them.
+        /// Since the matrix can modify its elements, the view's storage must be writable and not used by any other
+        /// object, like an array in a copy-on-write mapping of a binary archive. Copies of the matrix copy the elements. </summary>
+        ///
+        /// <param name="numRows"> Number of rows in the matrix. </param>
+        /// <param name="numColumns"> Number of columns in the matrix. </param>
+        /// <param name="data"> The (numRows * numColumns) elements, in the layout order of this matrix's layout type. </param>
+        Matrix(size_t numRows, size_t numColumns, const utilities::ArrayView<ElementType>& data);
+
         /// <summary> Move Constructor. </summary>
         ///
         /// <param name="other"> [in,out] The matrix being moved. </param>
@@ -592,7 +603,7 @@ namespace math
         /// <summary> Returns a copy of the contents of the Matrix. </summary>
         ///
         /// <returns> A std::vector with a copy of the contents of the Matrix. </returns>
-        std::vector<ElementType> ToArray() const { return _data; }
+        std::vector<ElementType> ToArray() const { return { this->_pData, this->_pData + this->NumRows() * this->NumColumns() }; }
 
         /// <summary> Swaps the contents of this matrix with the contents of another matrix. </summary>
         ///
@@ -603,6 +614,7 @@ namespace math
 
     private:
         std::vector<ElementType> _data;
+        std::shared_ptr<const void> _dataStorage; // owns the elements instead of _data, if they're used in place
     };
 
     /// <summary> A class that implements helper functions for archiving/unarchiving Matrix instances. </summary>
@@ -1098,18 +1110,30 @@ namespace math
         this->_pData = _data.data();
     }
 
+    template <typename ElementType, MatrixLayout layout>
+    Matrix<ElementType, layout>::Matrix(size_t numRows, size_t numColumns, const utilities::ArrayView<ElementType>& data) :
+        MatrixReference<ElementType, layout>(const_cast<ElementType*>(data.GetData()), numRows, numColumns),
+        _dataStorage(data.GetStorage())
+    {
+        if (data.Size() != numRows * numColumns)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Matrix size doesn't match the size of its data");
+        }
+    }
+
     template <typename ElementType, MatrixLayout layout>
     Matrix<ElementType, layout>::Matrix(Matrix<ElementType, layout>&& other) :
         MatrixReference<ElementType, layout>(nullptr, other.NumRows(), other.NumColumns()),
-        _data(std::move(other._data))
+        _data(std::move(other._data)),
+        _dataStorage(std::move(other._dataStorage))
     {
-        this->_pData = _data.data();
+        this->_pData = _dataStorage ? other._pData : _data.data();
     }
 
     template <typename ElementType, MatrixLayout layout>
     Matrix<ElementType, layout>::Matrix(const Matrix<ElementType, layout>& other) :
         MatrixReference<ElementType, layout>(nullptr, other.NumRows(), other.NumColumns()),
-        _data(other._data)
+        _data(other.ToArray())
     {
         this->_pData = _data.data();
     }
@@ -1156,6 +1180,7 @@ namespace math
     {
         MatrixReference<ElementType, layout>::Swap(other);
         std::swap(_data, other._data);
+        std::swap(_dataStorage, other._dataStorage);
     }
 
     template <typename ElementType, MatrixLayout layout>
@@ -1175,6 +1200,15 @@ namespace math
 
         archiver[GetRowsName(name)] >> rows;
         archiver[GetColumnsName(name)] >> columns;
+
+        // use the values in place, if the archive allows it
+        utilities::ArrayView<ElementType> view;
+        if (archiver.TryUnarchiveArrayView(GetValuesName(name), view))
+        {
+            matrix = Matrix<ElementType, layout>(rows, columns, view);
+            return;
+        }
+
         archiver[GetValuesName(name)] >> values;
 
         Matrix<ElementType, layout> value(rows, columns, std::move(values));
@@ -10,6 +10,7 @@
 #include "Matrix.h"
 #include "Vector.h"
 
+#include <utilities/include/ArrayView.h>
 #include <utilities/include/Debug.h>
 #include <utilities/include/Exception.h>
 #include <utilities/include/IArchivable.h>
@@ -17,6 +18,7 @@
 #include <array>
 #include <cmath>
 #include <initializer_list>
+#include <memory>
 #include <ostream>
 #include <tuple>
 #include <vector>
@@ -837,6 +839,16 @@ namespace math
         /// <param name="data"> Vector of data elements that will be moved to this Tensor. </param>
         Tensor(size_t numRows, size_t numColumns, size_t numChannels, std::vector<ElementType>&& data);
 
+        /// <summary> Constructs a tensor that uses the elements of an array view in place, instead of copying them.
+        /// Since the tensor can modify its elements, the view's storage must be writable and not used by any other
+        /// object, like an array in a copy-on-write mapping of a binary archive. Copies of the tensor copy the elements. </summary>
+        ///
+        /// <param name="numRows"> Number of rows. </param>
+        /// <param name="numColumns"> Number of columns. </param>
+        /// <param name="numChannels"> Number of channels. </param>
+        /// <param name="data"> The data elements, in the memory order of this tensor's layout. </param>
+        Tensor(size_t numRows, size_t numColumns, size_t numChannels, const utilities::ArrayView<ElementType>& data);
+
         /// <summary> Constructs a the zero tensor of given shape. </summary>
         ///
         /// <param name="shape"> The tensor shape (given in logical coordinates: rows, columns, channels). </param>
@@ -847,6 +859,11 @@ namespace math
         /// <param name="other"> The other tensor. </param>
         Tensor(const Tensor<ElementType, dimension0, dimension1, dimension2>& other);
 
+        /// <summary> Move Constructor. </summary>
+        ///
+        /// <param name="other"> [in,out] The other tensor. </param>
+        Tensor(Tensor<ElementType, dimension0, dimension1, dimension2>&& other);
+
         /// <summary> Copies a tensor of a different layout. </summary>
         ///
         /// <param name="other"> The other tensor. </param>
@@ -871,7 +888,7 @@ namespace math
         /// <summary> Returns a copy of the contents of the Tensor. </summary>
         ///
         /// <returns> A std::vector with a copy of the contents of the Tensor. </returns>
-        std::vector<ElementType> ToArray() const { return _data; }
+        std::vector<ElementType> ToArray() const { return { this->_pData, this->_pData + this->Size() }; }
 
         /// <summary> Swaps the contents of this tensor with the contents of another tensor. </summary>
         ///
@@ -883,6 +900,7 @@ namespace math
     private:
         using ConstTensorRef = ConstTensorReference<ElementType, dimension0, dimension1, dimension2>;
         std::vector<ElementType> _data;
+        std::shared_ptr<const void> _dataStorage; // owns the elements instead of _data, if they're used in place
     };
 
     /// <summary> A class that implements helper functions for archiving/unarchiving Tensor instances. </summary>
@@ -1680,6 +1698,18 @@ namespace math
         this->_pData = _data.data();
     }
 
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    Tensor<ElementType, dimension0, dimension1, dimension2>::Tensor(size_t numRows, size_t numColumns, size_t numChannels, const utilities::ArrayView<ElementType>& data) :
+        TensorRef(TensorShape{ numRows, numColumns, numChannels }),
+        _dataStorage(data.GetStorage())
+    {
+        if (data.Size() != this->Size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Tensor size doesn't match the size of its data");
+        }
+        this->_pData = const_cast<ElementType*>(data.GetData());
+    }
+
     template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
     Tensor<ElementType, dimension0, dimension1, dimension2>::Tensor(TensorShape shape) :
         TensorRef(shape),
@@ -1691,11 +1721,20 @@ namespace math
     template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
     Tensor<ElementType, dimension0, dimension1, dimension2>::Tensor(const Tensor<ElementType, dimension0, dimension1, dimension2>& other) :
         TensorRef(other),
-        _data(other._data)
+        _data(other.ToArray())
     {
         this->_pData = _data.data();
     }
 
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    Tensor<ElementType, dimension0, dimension1, dimension2>::Tensor(Tensor<ElementType, dimension0, dimension1, dimension2>&& other) :
+        TensorRef(other),
+        _data(std::move(other._data)),
+        _dataStorage(std::move(other._dataStorage))
+    {
+        this->_pData = _dataStorage ? other._pData : _data.data();
+    }
+
     template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
     template <Dimension otherDimension0, Dimension otherDimension1, Dimension otherDimension2>
     Tensor<ElementType, dimension0, dimension1, dimension2>::Tensor(ConstTensorReference<ElementType, otherDimension0, otherDimension1, otherDimension2> other) :
@@ -1750,6 +1789,7 @@ namespace math
     {
         TensorRef::Swap(other);
         std::swap(_data, other._data);
+        std::swap(_dataStorage, other._dataStorage);
     }
 
     template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
@@ -1772,6 +1812,15 @@ namespace math
         archiver[GetRowsName(name)] >> rows;
         archiver[GetColumnsName(name)] >> columns;
         archiver[GetChannelsName(name)] >> channels;
+
+        // use the values in place, if the archive allows it
+        utilities::ArrayView<ElementType> view;
+        if (archiver.TryUnarchiveArrayView(GetValuesName(name), view))
+        {
+            tensor = Tensor<ElementType, dimension0, dimension1, dimension2>(rows, columns, channels, view);
+            return;
+        }
+
         archiver[GetValuesName(name)] >> values;
 
         Tensor<ElementType, dimension0, dimension1, dimension2> value(rows, columns, channels, std::move(values));
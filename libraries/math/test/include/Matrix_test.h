@@ -208,6 +208,9 @@ void TestMatrixColumnwiseConsecutiveDifferenceUpdate();
 template <typename ElementType, math::MatrixLayout layout>
 void TestMatrixArchiver();
 
+template <typename ElementType, math::MatrixLayout layout>
+void TestMatrixArrayViewCtor();
+
 #pragma region implementation
 
 template <typename ElementType, math::MatrixLayout layout>
@@ -1639,4 +1642,19 @@ void TestMatrixArchiver()
     testing::ProcessTest("MatrixArchiver", Ma == M);
 }
 
+template <typename ElementType, math::MatrixLayout layout>
+void TestMatrixArrayViewCtor()
+{
+    utilities::ArrayView<ElementType> view(std::vector<ElementType>{ 1, 2, 3, 4, 5, 6 });
+    math::Matrix<ElementType, layout> M(2, 3, view);
+    auto N = M;
+    N(0, 0) = 7;
+    math::Matrix<ElementType, layout> P(std::move(M));
+
+    math::Matrix<ElementType, layout> R(2, 3, std::vector<ElementType>{ 1, 2, 3, 4, 5, 6 });
+    testing::ProcessTest("Matrix(ArrayView) uses the data in place", P.GetConstDataPointer() == view.GetData() && P == R);
+    testing::ProcessTest("Matrix(ArrayView) copies own their data", N.GetConstDataPointer() != view.GetData() && N(0, 0) == 7 && P(0, 0) == 1);
+    testing::ProcessTest("Matrix(ArrayView) ToArray", P.ToArray() == R.ToArray());
+}
+
 #pragma endregion implementation
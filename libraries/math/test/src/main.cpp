@@ -198,6 +198,7 @@ void RunLayoutMatrixTests()
     TestMatrixRowwiseConsecutiveDifferenceUpdate<ElementType, layout>();
     TestMatrixColumnwiseConsecutiveDifferenceUpdate<ElementType, layout>();
     TestMatrixArchiver<ElementType, layout>();
+    TestMatrixArrayViewCtor<ElementType, layout>();
 
     RunDoubleLayoutMatrixTests<ElementType, layout, layout>();
     RunDoubleLayoutMatrixTests<ElementType, layout, math::TransposeMatrixLayout<layout>::value>();
@@ -105,7 +105,14 @@ namespace model
         // for the node's compute function.
         virtual void CallNodeFunction(IRMapCompiler& compiler, emitters::IRFunctionEmitter& currentFunction);
 
+        // Indicates if the function emitted for this node can be stored in the compilation cache and reused instead of
+        // calling `Compile`. Nodes whose `Compile` has effects beyond their function, like declaring callbacks or
+        // emitting module-level functions, must return false, since a cache hit would skip them.
+        virtual bool CanCacheCompiledFunction(IRMapCompiler& compiler) const;
+
     private:
+        std::string GetCompilationCacheDescription(IRMapCompiler& compiler) const;
+
         const std::string _nodeFunctionPrefix = "_Node__";
         const char _badIdentifierChars[3] = { '<', '>', ',' };
     };
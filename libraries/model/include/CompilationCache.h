@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     CompilationCache.h (model)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MapCompilerOptions.h"
+
+#include <cstddef>
+#include <string>
+
+namespace ell
+{
+namespace model
+{
+    /// <summary>
+    /// A directory of compiled code that is reused across compiler runs. Each entry is a file named by a hash of a
+    /// description of everything its contents depend on (for a node function: the node's type, parameters and port
+    /// layouts, and the compiler options), so an entry is only found again if none of those have changed.
+    /// </summary>
+    class CompilationCache
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="directory"> The directory that holds the entries. It's created if it doesn't exist. </param>
+        explicit CompilationCache(const std::string& directory);
+
+        /// <summary> Gets the key of the entry for the given description. </summary>
+        ///
+        /// <param name="description"> A description of everything the entry's contents depend on. </param>
+        ///
+        /// <returns> A hash of the description, along with the versions of the cache format, of ELL (and its source revision) and of LLVM. </returns>
+        static std::string GetKey(const std::string& description);
+
+        /// <summary> Looks up an entry. The lookup isn't counted until the caller records whether it could use the entry. </summary>
+        ///
+        /// <param name="key"> The key of the entry. </param>
+        /// <param name="contents"> [out] The contents of the entry, if it's found. </param>
+        ///
+        /// <returns> `true` if the entry was found. </returns>
+        bool TryGetEntry(const std::string& key, std::string& contents);
+
+        /// <summary> Adds or replaces an entry. The entry is written to a temporary file that's then renamed, so
+        /// a compiler running at the same time never reads part of an entry. </summary>
+        ///
+        /// <param name="key"> The key of the entry. </param>
+        /// <param name="contents"> The contents of the entry. </param>
+        void SetEntry(const std::string& key, const std::string& contents);
+
+        /// <summary> Counts a lookup whose entry was found and used. </summary>
+        void RecordHit();
+
+        /// <summary> Counts a lookup that didn't find an entry, or found one that couldn't be used. </summary>
+        void RecordMiss();
+
+        /// <summary> Gets the number of lookups that found an entry that was used. </summary>
+        size_t NumHits() const { return _numHits; }
+
+        /// <summary> Gets the number of lookups that didn't find a usable entry. </summary>
+        size_t NumMisses() const { return _numMisses; }
+
+        /// <summary> Gets the fraction of lookups that found a usable entry, or 0 if there weren't any. </summary>
+        double GetHitRate() const;
+
+    private:
+        std::string GetEntryPath(const std::string& key) const;
+
+        std::string _directory;
+        size_t _numHits = 0;
+        size_t _numMisses = 0;
+    };
+
+    /// <summary> Gets a description of the options that affect the code emitted for a node, for use in compilation cache keys. </summary>
+    ///
+    /// <param name="options"> The options used to compile the node. </param>
+    ///
+    /// <returns> A description of the options. </returns>
+    std::string GetCompilationCacheDescription(const MapCompilerOptions& options);
+} // namespace model
+} // namespace ell
@@ -23,10 +23,14 @@
 #include <utilities/include/Boolean.h>
 #include <utilities/include/TypeName.h>
 
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <ostream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
@@ -203,6 +207,33 @@ namespace model
         /// <summary> Reset any model state. </summary>
         void Reset() override;
 
+        //
+        // Caller-owned model state, for maps compiled with the `threadSafe` option
+        //
+
+        /// <summary> Allocates a copy of the model's state, so the map can be called from several threads at once,
+        /// each with its own context. The other compute functions use a default copy shared by all threads. </summary>
+        ///
+        /// <returns> The context, to pass to `ComputeMultiple` and `Reset`, and to free with `DestroyModelContext`. </returns>
+        void* CreateModelContext();
+
+        /// <summary> Frees a context allocated with `CreateModelContext`. </summary>
+        ///
+        /// <param name="modelContext"> The context to free. </param>
+        void DestroyModelContext(void* modelContext);
+
+        /// <summary> Computes the map's outputs using the model state in the given context. </summary>
+        ///
+        /// <param name="modelContext"> A context allocated with `CreateModelContext`. </param>
+        /// <param name="inputs"> A vector containing all the input buffers. </param>
+        /// <param name="outputs"> A vector containing all the output buffers. </param>
+        void ComputeMultiple(void* modelContext, const std::vector<void*>& inputs, const std::vector<void*>& outputs);
+
+        /// <summary> Resets the model state in the given context. </summary>
+        ///
+        /// <param name="modelContext"> A context allocated with `CreateModelContext`. </param>
+        void Reset(void* modelContext);
+
     protected:
         void WriteCode(const std::string& filePath, emitters::ModuleOutputFormat format, emitters::MachineCodeOutputOptions options) const;
         void WriteCode(std::ostream& stream, emitters::ModuleOutputFormat format, emitters::MachineCodeOutputOptions options) const;
@@ -225,6 +256,7 @@ namespace model
         IRCompiledMap(Map map, const std::string& functionName, const MapCompilerOptions& options, emitters::IRModuleEmitter& module, bool verifyJittedModule);
 
         void EnsureExecutionEngine();
+        void SetExternalWeights();
         void SetComputeFunction();
         template <typename InputType>
         void SetComputeFunctionForInputType();
@@ -236,6 +268,7 @@ namespace model
         std::string _moduleName;
 
         std::unique_ptr<emitters::IRExecutionEngine> _executionEngine;
+        std::vector<char> _externalWeights; // the jitted code's copy of the module's external weights
         bool _verifyJittedModule = true;
         void* _context = nullptr;
 
@@ -244,12 +277,24 @@ namespace model
 
         template <typename T>
         using Vector = std::vector<std::conditional_t<std::is_same_v<bool, T>, Boolean, T>>;
+        using OutputBuffer = std::variant<Vector<bool>, Vector<int>, Vector<int64_t>, Vector<float>, Vector<double>>;
+
+        // The output of SetNodeInput is read back by the following Compute*Output call on the same thread
+        template <typename VectorType>
+        VectorType& GetOutputBuffer();
 
-        bool _computeFunctionDefined = false;
+        std::mutex _jitMutex;
+        std::atomic<bool> _computeFunctionDefined{ false };
         std::variant<ComputeFunction<bool>, ComputeFunction<int>, ComputeFunction<int64_t>, ComputeFunction<float>, ComputeFunction<double>> _computeInputFunction;
-        std::variant<Vector<bool>, Vector<int>, Vector<int64_t>, Vector<float>, Vector<double>> _cachedOutput;
+        std::mutex _outputBuffersMutex;
+        std::unordered_map<std::thread::id, OutputBuffer> _outputBuffers;
         std::function<void(void*, void* const*, void* const*)> _computeDispatchFunction;
         std::function<void()> _resetFunction;
+
+        std::function<void*()> _createContextFunction;
+        std::function<void(void*)> _destroyContextFunction;
+        std::function<void(void*, void*, void* const*, void* const*)> _computeWithContextDispatchFunction;
+        std::function<void(void*)> _resetWithContextFunction;
     };
 } // namespace model
 } // namespace ell
@@ -265,58 +310,51 @@ namespace model
     {
         if (!_computeFunctionDefined)
         {
-            _computeFunctionDefined = true;
-            auto outputSize = GetOutput(0).Size();
             auto functionPointer = _executionEngine->ResolveFunctionAddress(_functionName);
             ComputeFunction<InputType> computeFunction;
             switch (GetOutput(0).GetType()) // Switch on output type
             {
             case model::Port::PortType::boolean:
             {
-                _cachedOutput = Vector<bool>(outputSize);
                 auto fn = reinterpret_cast<void (*)(void*, const InputType*, bool*)>(functionPointer);
                 computeFunction = [this, fn](void* context, const InputType* input) {
-                    fn(context, input, (bool*)std::get<Vector<bool>>(_cachedOutput).data());
+                    fn(context, input, (bool*)GetOutputBuffer<Vector<bool>>().data());
                 };
             }
             break;
 
             case model::Port::PortType::integer:
             {
-                _cachedOutput = Vector<int>(outputSize);
                 auto fn = reinterpret_cast<void (*)(void*, const InputType*, int*)>(functionPointer);
                 computeFunction = [this, fn](void* context, const InputType* input) {
-                    fn(context, input, std::get<Vector<int>>(_cachedOutput).data());
+                    fn(context, input, GetOutputBuffer<Vector<int>>().data());
                 };
             }
             break;
 
             case model::Port::PortType::bigInt:
             {
-                _cachedOutput = Vector<int64_t>(outputSize);
                 auto fn = reinterpret_cast<void (*)(void*, const InputType*, int64_t*)>(functionPointer);
                 computeFunction = [this, fn](void* context, const InputType* input) {
-                    fn(context, input, std::get<Vector<int64_t>>(_cachedOutput).data());
+                    fn(context, input, GetOutputBuffer<Vector<int64_t>>().data());
                 };
             }
             break;
 
             case model::Port::PortType::smallReal:
             {
-                _cachedOutput = Vector<float>(outputSize);
                 auto fn = reinterpret_cast<void (*)(void*, const InputType*, float*)>(functionPointer);
                 computeFunction = [this, fn](void* context, const InputType* input) {
-                    fn(context, input, std::get<Vector<float>>(_cachedOutput).data());
+                    fn(context, input, GetOutputBuffer<Vector<float>>().data());
                 };
             }
             break;
 
             case model::Port::PortType::real:
             {
-                _cachedOutput = Vector<double>(outputSize);
                 auto fn = reinterpret_cast<void (*)(void*, const InputType*, double*)>(functionPointer);
                 computeFunction = [this, fn](void* context, const InputType* input) {
-                    fn(context, input, std::get<Vector<double>>(_cachedOutput).data());
+                    fn(context, input, GetOutputBuffer<Vector<double>>().data());
                 };
             }
             break;
@@ -331,7 +369,38 @@ namespace model
 
             functionPointer = _executionEngine->ResolveFunctionAddress(_moduleName + "_Reset");
             _resetFunction = reinterpret_cast<void(*)()>(functionPointer);
+
+            if (GetMapCompilerOptions().compilerSettings.threadSafe)
+            {
+                functionPointer = _executionEngine->ResolveFunctionAddress(_moduleName + "_CreateContext");
+                _createContextFunction = reinterpret_cast<void* (*)()>(functionPointer);
+
+                functionPointer = _executionEngine->ResolveFunctionAddress(_moduleName + "_DestroyContext");
+                _destroyContextFunction = reinterpret_cast<void (*)(void*)>(functionPointer);
+
+                functionPointer = _executionEngine->ResolveFunctionAddress(_functionName + "_dispatchWithContext");
+                _computeWithContextDispatchFunction = reinterpret_cast<void (*)(void*, void*, void* const*, void* const*)>(functionPointer);
+
+                functionPointer = _executionEngine->ResolveFunctionAddress(_moduleName + "_ResetWithContext");
+                _resetWithContextFunction = reinterpret_cast<void (*)(void*)>(functionPointer);
+            }
+
+            // Set last, so other threads don't use the functions before they're all resolved
+            _computeFunctionDefined = true;
+        }
+    }
+
+    template <typename VectorType>
+    VectorType& IRCompiledMap::GetOutputBuffer()
+    {
+        std::lock_guard<std::mutex> lock(_outputBuffersMutex);
+        auto& buffer = _outputBuffers[std::this_thread::get_id()];
+        auto outputSize = GetOutput(0).Size();
+        if (!std::holds_alternative<VectorType>(buffer) || std::get<VectorType>(buffer).size() != outputSize)
+        {
+            buffer = VectorType(outputSize);
         }
+        return std::get<VectorType>(buffer);
     }
 
     template <typename ElementType>
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "CompilationCache.h"
 #include "IRCompiledMap.h"
 #include "InputPort.h"
 #include "MapCompiler.h"
@@ -20,6 +21,7 @@
 
 #include <utilities/include/Logger.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -147,6 +149,16 @@ namespace model
         /// <returns> The generated name. </returns>
         std::string GetGlobalName(const Node& node, const std::string& baseName) const;
 
+        /// <summary> Gets the cache of compiled node functions, if the `compilationCache` option names a directory. </summary>
+        ///
+        /// <returns> A pointer to the compilation cache, or `nullptr` if caching is disabled. </returns>
+        CompilationCache* GetCompilationCache() { return _compilationCache.get(); }
+
+        /// <summary> Gets the cache of compiled node functions, if the `compilationCache` option names a directory. </summary>
+        ///
+        /// <returns> A pointer to the compilation cache, or `nullptr` if caching is disabled. </returns>
+        const CompilationCache* GetCompilationCache() const { return _compilationCache.get(); }
+
     protected:
         void OnBeginCompileModel(const Model& model) override;
         void OnEndCompileModel(const Model& model) override;
@@ -154,6 +166,7 @@ namespace model
         void OnEndCompileNode(const Node& node) override;
         void PushScope() override;
         void PopScope() override;
+        void CompileParallelStage(const NodeStage& stage) override;
         emitters::ModuleEmitter* GetModuleEmitter() override { return &_moduleEmitter; }
         virtual std::string GetPredictFunctionName() const;
         virtual void EmitModelAPIFunctions(const Map& map);
@@ -165,9 +178,11 @@ namespace model
         NodeMap<emitters::IRBlockRegion*>& GetCurrentNodeBlocks();
         const Node* GetUniqueParent(const Node& node);
         void RefineAndOptimize(Map& map);
+        void EmitPortMemoryArena();
         bool TryMergeNodeIntoRegion(emitters::IRBlockRegion* pDestination, const Node& src);
 
         void EmitPredictDispatchFunction(const Map& map);
+        void EmitContextFunctions();
         void EmitGetInputSizeFunction(const Map& map);
         void EmitGetOutputSizeFunction(const Map& map);
         void EmitGetSinkOutputSizeFunction(const Map& map);
@@ -185,6 +200,10 @@ namespace model
 
         // stack of node regions
         std::vector<NodeMap<emitters::IRBlockRegion*>> _nodeRegions;
+
+        std::unique_ptr<CompilationCache> _compilationCache;
+
+        int _numParallelStages = 0;
     };
 } // namespace model
 } // namespace ell
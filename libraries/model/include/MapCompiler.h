@@ -11,7 +11,9 @@
 #include "CompilableNodeUtilities.h"
 #include "MapCompilerOptions.h"
 #include "ModelOptimizerOptions.h"
+#include "NodeScheduler.h"
 #include "OutputPort.h"
+#include "PortMemoryPlanner.h"
 
 #include <emitters/include/CompilerOptions.h>
 #include <emitters/include/EmitterTypes.h>
@@ -21,6 +23,7 @@
 #include <utilities/include/UniqueNameList.h>
 
 #include <cassert>
+#include <memory>
 #include <stack>
 #include <string>
 #include <unordered_map>
@@ -108,6 +111,11 @@ namespace model
         /// <summary> Associate the given variable with the output port. </summary>
         void SetVariableForPort(const Port& port, emitters::Variable* pVar);
 
+        /// <summary> Gets the planner used to share storage between output ports, if port memory planning is enabled. </summary>
+        ///
+        /// <returns> A pointer to the port memory planner, or `nullptr` if port memory planning is disabled. </returns>
+        const PortMemoryPlanner* GetPortMemoryPlanner() const { return _portMemoryPlanner.get(); }
+
     protected:
         MapCompiler(const MapCompilerOptions& settings, const ModelOptimizerOptions& optimizerOptions);
 
@@ -128,6 +136,15 @@ namespace model
         /// </summary>
         emitters::FunctionArgumentList AllocateMapFunctionArguments(Map& map, emitters::ModuleEmitter& emitter);
 
+        /// <summary> Indicates if output ports are being allocated from a shared, planned memory arena. </summary>
+        bool IsPlanningPortMemory() const { return _portMemoryPlanner != nullptr; }
+
+        /// <summary>
+        /// Gets the byte vector variable that holds the shared port memory arena, or `nullptr` if no port has been
+        /// allocated from it. Its final size is only known once all the nodes have been compiled.
+        /// </summary>
+        emitters::Variable* GetPortMemoryArenaVariable() const { return _pPortMemoryArenaVar; }
+
         //
         // These methods may be implemented by specific compilers
         //
@@ -139,11 +156,31 @@ namespace model
         virtual void PopScope();
         virtual emitters::ModuleEmitter* GetModuleEmitter() = 0;
 
+        /// <summary>
+        /// Compiles a stage of branches that don't depend on each other. The default implementation compiles the
+        /// branches one after the other; compilers that can emit concurrent tasks override it to run them in parallel.
+        /// </summary>
+        ///
+        /// <param name="stage"> The stage to compile. </param>
+        virtual void CompileParallelStage(const NodeStage& stage);
+
+        /// <summary>
+        /// Compiles the nodes of one branch of a parallel stage into the current function. Nodes in the branch
+        /// don't parallelize their own code, since the branch is already running alongside the other branches.
+        /// </summary>
+        ///
+        /// <param name="branch"> The branch to compile. </param>
+        void CompileParallelBranch(const NodeBranch& branch);
+
     private:
 
         friend class CompilableNode;
 
         void CompileNodes(Model& model);
+        void CompileNode(const Node& node);
+        bool ShouldParallelizeBranches() const;
+        bool CanAllocatePortFromArena(const OutputPortBase& port) const;
+        emitters::Variable* AllocatePortVariableFromArena(const OutputPortBase& port);
         emitters::Variable* AllocatePortFunctionArgument(emitters::ModuleEmitter& emitter, const OutputPortBase& port, emitters::ArgumentFlags argDirection, ell::utilities::UniqueNameList& uniqueNameScope);
         emitters::Variable* AllocatePortFunctionArgument(emitters::ModuleEmitter& emitter, const PortElementBase& element, emitters::ArgumentFlags argDirection, ell::utilities::UniqueNameList& uniqueNameScope);
 
@@ -153,6 +190,13 @@ namespace model
         // map from ports to runtime variables, for all ports in the model
         // stored as a stack, with the top of the stack being the innermost scope
         std::vector<std::unordered_map<const Port*, emitters::Variable*>> _portToVarMaps; // Do we need separate elementToVarMaps?
+
+        // storage sharing between output ports in the top-level scope
+        std::unique_ptr<PortMemoryPlanner> _portMemoryPlanner;
+        emitters::Variable* _pPortMemoryArenaVar = nullptr;
+        std::unordered_map<const emitters::Variable*, const OutputPortBase*> _portMemoryArenaOwners;
+
+        bool _isCompilingParallelBranch = false;
     };
 } // namespace model
 } // namespace ell
@@ -36,9 +36,13 @@ namespace model
         std::string sinkFunctionName;
         bool verifyJittedModule = true;
         bool profile = false;
+        bool planPortMemory = false; // share storage between output ports whose lifetimes don't overlap
+        bool parallelizeBranches = false; // compute independent branches of the model concurrently (nodes in those branches are compiled without parallelize)
+        std::string compilationCache; // directory of compiled node functions to reuse across compiler runs
 
         // per-node options
         bool inlineNodes = false;
+        bool flattenForests = true; // compile simple forests as a loop over a flat array of trees instead of a node per split
 
         // lower-level emitters settings
         emitters::CompilerOptions compilerSettings;
@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     NodeScheduler.h (model)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    class Model;
+    class Node;
+
+    /// <summary> A sequence of nodes to be computed one after the other, on the same thread. </summary>
+    struct NodeBranch
+    {
+        std::vector<const Node*> nodes;
+        size_t cost = 0;
+    };
+
+    /// <summary> A set of branches that don't depend on each other, so they can be computed concurrently. </summary>
+    struct NodeStage
+    {
+        std::vector<NodeBranch> branches;
+
+        /// <summary> Indicates if the stage has more than one branch, and so can be run in parallel. </summary>
+        bool IsParallel() const { return branches.size() > 1; }
+    };
+
+    /// <summary>
+    /// Splits the nodes of a model into a sequence of stages, where each stage holds branches that only depend on the
+    /// stages before it. Consecutive stages are joined at the nodes that merge their branches. Branches whose estimated
+    /// cost is too small to be worth running on another thread are moved to stages of their own.
+    /// Also computes the model's critical path: the most expensive chain of dependent nodes.
+    /// </summary>
+    class NodeScheduler
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="model"> The model to schedule. </param>
+        /// <param name="minParallelBranchCost"> The estimated cost a branch needs to be run concurrently with other branches. </param>
+        NodeScheduler(const Model& model, size_t minParallelBranchCost = 1024);
+
+        /// <summary> Gets the stages, in the order they need to be computed. </summary>
+        ///
+        /// <returns> The stages. </returns>
+        const std::vector<NodeStage>& GetStages() const { return _stages; }
+
+        /// <summary> Gets the number of stages with more than one branch. </summary>
+        ///
+        /// <returns> The number of parallel stages. </returns>
+        size_t NumParallelStages() const;
+
+        /// <summary> Gets the nodes on the critical path, in the order they're computed. </summary>
+        ///
+        /// <returns> The nodes on the critical path. </returns>
+        const std::vector<const Node*>& GetCriticalPath() const { return _criticalPath; }
+
+        /// <summary> Gets the estimated cost of the critical path. </summary>
+        ///
+        /// <returns> The sum of the estimated costs of the nodes on the critical path. </returns>
+        size_t GetCriticalPathCost() const { return _criticalPathCost; }
+
+        /// <summary> Gets the estimated cost of computing all the nodes in the model. </summary>
+        ///
+        /// <returns> The sum of the estimated costs of all the nodes. </returns>
+        size_t GetTotalCost() const { return _totalCost; }
+
+        /// <summary> Gets the number of nodes in the model. </summary>
+        ///
+        /// <returns> The number of nodes. </returns>
+        size_t NumNodes() const { return _numNodes; }
+
+    private:
+        void ComputeCriticalPath(const std::vector<const Node*>& nodes, const std::unordered_map<const Node*, std::vector<const Node*>>& producers);
+
+        std::vector<NodeStage> _stages;
+        std::vector<const Node*> _criticalPath;
+        size_t _criticalPathCost = 0;
+        size_t _totalCost = 0;
+        size_t _numNodes = 0;
+    };
+
+    /// <summary>
+    /// Gets a rough estimate of the cost of computing a node: the number of output values it computes.
+    /// Nodes without inputs (like constants) don't compute anything at run time, and have a cost of 0.
+    /// </summary>
+    ///
+    /// <param name="node"> The node. </param>
+    ///
+    /// <returns> The estimated cost of the node. </returns>
+    size_t GetNodeCostEstimate(const Node& node);
+} // namespace model
+} // namespace ell
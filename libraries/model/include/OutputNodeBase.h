@@ -93,6 +93,9 @@ namespace model
         {
         }
 
+        // Compiling the node declares its callback, which a cached function wouldn't do
+        bool CanCacheCompiledFunction(IRMapCompiler& compiler) const override { return false; }
+
     private:
         std::string _callbackName;
     };
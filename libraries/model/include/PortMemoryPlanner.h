@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PortMemoryPlanner.h (model)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "OutputPort.h"
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    class Model;
+    class Node;
+
+    /// <summary>
+    /// Plans the storage for the output ports of a model so that ports whose lifetimes don't overlap share
+    /// the same region of a single memory arena. The lifetime of a port starts when its node is compiled and
+    /// ends after the last node (in the model's topological visit order) that reads from it has been compiled.
+    /// </summary>
+    class PortMemoryPlanner
+    {
+    public:
+        PortMemoryPlanner() = default;
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="model"> The model whose port lifetimes will be computed. </param>
+        /// <param name="alignment"> The byte alignment of each buffer allocated from the arena. </param>
+        PortMemoryPlanner(const Model& model, size_t alignment);
+
+        /// <summary> Indicates if the given port can be placed in the shared arena. </summary>
+        ///
+        /// <param name="port"> The port to query. </param>
+        ///
+        /// <returns> `true` if the port is part of the model and doesn't need its own persistent storage. </returns>
+        bool CanAllocate(const OutputPortBase& port) const;
+
+        /// <summary> Allocates a buffer in the arena for the given port. </summary>
+        ///
+        /// <param name="port"> The port to allocate storage for. </param>
+        ///
+        /// <returns> The byte offset of the port's buffer from the start of the arena. </returns>
+        size_t Allocate(const OutputPortBase& port);
+
+        /// <summary> Indicates if the given port has a buffer in the arena. </summary>
+        ///
+        /// <param name="port"> The port to query. </param>
+        ///
+        /// <returns> `true` if the port (or a port it aliases) has been allocated. </returns>
+        bool IsAllocated(const OutputPortBase& port) const;
+
+        /// <summary>
+        /// Records that `alias` shares the buffer allocated for `port`. The buffer is kept alive until
+        /// the last reader of either port has been compiled.
+        /// </summary>
+        ///
+        /// <param name="alias"> The port that reuses the buffer. </param>
+        /// <param name="port"> The port that owns the buffer. </param>
+        void AddAlias(const OutputPortBase& alias, const OutputPortBase& port);
+
+        /// <summary> Releases the buffers whose lifetimes end with the given node. </summary>
+        ///
+        /// <param name="node"> The node that was just compiled. </param>
+        void EndNode(const Node& node);
+
+        /// <summary> Gets the peak size of the arena, in bytes. </summary>
+        ///
+        /// <returns> The number of bytes needed to hold all the buffers allocated so far. </returns>
+        size_t GetArenaSize() const { return _arenaSize; }
+
+        /// <summary> Gets the total size of all the allocated buffers, in bytes. </summary>
+        ///
+        /// <returns> The number of bytes the buffers would take if each port had its own storage. </returns>
+        size_t GetUnsharedSize() const { return _unsharedSize; }
+
+        /// <summary> Gets the number of buffers allocated from the arena. </summary>
+        ///
+        /// <returns> The number of buffers allocated. </returns>
+        size_t NumBuffers() const { return _numBuffers; }
+
+    private:
+        struct Block
+        {
+            size_t offset;
+            size_t size;
+        };
+
+        const OutputPortBase* GetOwner(const OutputPortBase& port) const;
+        int GetLastUse(const OutputPortBase& port) const;
+        void Free(const Block& block);
+
+        size_t _alignment = 1;
+        int _currentNodeIndex = 0;
+        std::unordered_map<const Node*, int> _nodeIndices;
+        std::unordered_map<const OutputPortBase*, int> _lastUse;
+        std::unordered_map<const OutputPortBase*, const OutputPortBase*> _aliases;
+        std::unordered_map<const OutputPortBase*, Block> _liveBlocks;
+        std::vector<Block> _freeBlocks; // sorted by offset, adjacent blocks coalesced
+
+        size_t _arenaSize = 0;
+        size_t _unsharedSize = 0;
+        size_t _numBuffers = 0;
+    };
+
+    /// <summary> Gets the size, in bytes, of one element of a port with the given type. </summary>
+    ///
+    /// <param name="type"> The port type. </param>
+    ///
+    /// <returns> The size of an element, in bytes. </returns>
+    size_t GetPortElementSize(Port::PortType type);
+} // namespace model
+} // namespace ell
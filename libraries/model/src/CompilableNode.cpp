@@ -8,12 +8,14 @@
 
 #include "CompilableNode.h"
 #include "CompilableNodeUtilities.h"
+#include "CompilationCache.h"
 #include "IRMapCompiler.h"
 #include "MapCompiler.h"
 
 #include <emitters/include/EmitterException.h>
 #include <emitters/include/LLVMUtilities.h>
 
+#include <utilities/include/BinaryArchiver.h>
 #include <utilities/include/Logger.h>
 #include <utilities/include/UniqueId.h>
 #include <utilities/include/UniqueNameList.h>
@@ -22,6 +24,7 @@
 #include <functional>
 #include <iterator>
 #include <numeric>
+#include <sstream>
 #include <string>
 
 namespace ell
@@ -55,12 +58,44 @@ namespace model
         {
             Log() << "Not inlining code for node " << DiagnosticString(*this) << EOL;
 
-            // Emit code for function if it doesn't exist yet
             auto functionName = GetCompiledFunctionName();
+            auto cache = irCompiler->GetCompilationCache();
+            std::string cacheKey;
+            if (cache != nullptr && !moduleEmitter.HasFunction(functionName) && CanCacheCompiledFunction(*irCompiler))
+            {
+                // Reuse the function emitted by an earlier compiler run, if nothing it depends on has changed
+                cacheKey = CompilationCache::GetKey(GetCompilationCacheDescription(*irCompiler));
+                std::string functionBitcode;
+                if (cache->TryGetEntry(cacheKey, functionBitcode))
+                {
+                    Log() << "Using cached function for " << DiagnosticString(*this) << EOL;
+                    try
+                    {
+                        moduleEmitter.LinkBitcode(functionBitcode);
+                    }
+                    catch (const emitters::EmitterException& exception)
+                    {
+                        // Emit the function again, and replace the bad entry
+                        Log() << "Unable to use cached function: " << exception.GetMessage() << EOL;
+                    }
+                }
+
+                if (moduleEmitter.HasFunction(functionName))
+                {
+                    cache->RecordHit();
+                }
+                else
+                {
+                    cache->RecordMiss();
+                }
+            }
+
+            // Emit code for function if it doesn't exist yet
             if (!moduleEmitter.HasFunction(functionName))
             {
                 Log() << "Creating new function for " << DiagnosticString(*this) << EOL;
 
+                auto numResetFunctions = moduleEmitter.NumResetFunctions();
                 compiler.PushScope();
                 emitters::NamedVariableTypeList args = GetNodeFunctionParameterList(*irCompiler);
 
@@ -91,6 +126,13 @@ namespace model
                     moduleEmitter.EndFunction();
                 }
                 compiler.PopScope();
+
+                // A node that adds a reset function can't be cached, since a cache hit wouldn't add it
+                std::string functionBitcode;
+                if (!cacheKey.empty() && moduleEmitter.NumResetFunctions() == numResetFunctions && moduleEmitter.TryGetFunctionBitcode(functionName, functionBitcode))
+                {
+                    cache->SetEntry(cacheKey, functionBitcode);
+                }
             }
             else
             {
@@ -142,6 +184,40 @@ namespace model
         return false;
     }
 
+    bool CompilableNode::CanCacheCompiledFunction(IRMapCompiler& compiler) const
+    {
+        // Precompiled IR is already cheap to load, and a cached function wouldn't bring along the module-level
+        // profiling and debug information emitted with it
+        auto options = compiler.GetMapCompilerOptions(*this);
+        return !HasPrecompiledIR() && !options.profile && !options.compilerSettings.profile && !options.compilerSettings.includeDiagnosticInfo;
+    }
+
+    std::string CompilableNode::GetCompilationCacheDescription(IRMapCompiler& compiler) const
+    {
+        std::stringstream description;
+        description << GetRuntimeTypeName() << '\n'
+                    << GetCompiledFunctionName() << '\n'
+                    << model::GetCompilationCacheDescription(compiler.GetMapCompilerOptions(*this));
+
+        // The function's code also depends on the port layouts and, for nodes with state, on the node's parameters
+        {
+            utilities::BinaryArchiver archiver(description);
+            for (size_t index = 0; index < GetInputPorts().size(); ++index)
+            {
+                archiver["input" + std::to_string(index)] << GetInputPorts()[index]->GetMemoryLayout();
+            }
+            for (size_t index = 0; index < GetOutputPorts().size(); ++index)
+            {
+                archiver["output" + std::to_string(index)] << GetOutputPorts()[index]->GetMemoryLayout();
+            }
+            if (HasState())
+            {
+                archiver["node"] << *this;
+            }
+        }
+        return description.str();
+    }
+
     void CompilableNode::EmitNodeFunction(IRMapCompiler& compiler)
     {
         throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     CompilationCache.cpp (model)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "CompilationCache.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+
+#include <llvm/Config/llvm-config.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <iterator>
+#include <random>
+#include <sstream>
+
+// Set by the build, so that entries written by a build with different code generation aren't reused
+#ifndef ELL_VERSION_STRING
+#define ELL_VERSION_STRING "unknown"
+#endif
+
+#ifndef ELL_SOURCE_REVISION
+#define ELL_SOURCE_REVISION "unknown"
+#endif
+
+namespace ell
+{
+namespace model
+{
+    namespace
+    {
+        // Bump this when the contents of the entries change in a way their keys don't capture
+        const int c_compilationCacheVersion = 2;
+
+        // FNV-1a, which (unlike std::hash) gives the same result in every build
+        uint64_t HashString(const std::string& str, uint64_t seed)
+        {
+            uint64_t hash = seed;
+            for (auto ch : str)
+            {
+                hash ^= static_cast<uint8_t>(ch);
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        std::string ReadFile(const std::string& filepath)
+        {
+            auto stream = utilities::OpenBinaryIfstream(filepath);
+            return { std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+        }
+    } // namespace
+
+    CompilationCache::CompilationCache(const std::string& directory) :
+        _directory(directory)
+    {
+        utilities::EnsureDirectoryExists(_directory);
+    }
+
+    std::string CompilationCache::GetKey(const std::string& description)
+    {
+        std::stringstream versionedDescription;
+        versionedDescription << "ELL compilation cache " << c_compilationCacheVersion << ", ELL " << ELL_VERSION_STRING << " (" << ELL_SOURCE_REVISION << "), LLVM " << LLVM_VERSION_STRING << '\n'
+                             << description;
+        auto str = versionedDescription.str();
+
+        // Two 64-bit hashes with different seeds, to make collisions between entries unlikely
+        std::stringstream key;
+        key << std::hex << std::setfill('0') << std::setw(16) << HashString(str, 14695981039346656037ull) << std::setw(16) << HashString(str, 0x84222325cbf29ce4ull);
+        return key.str();
+    }
+
+    bool CompilationCache::TryGetEntry(const std::string& key, std::string& contents)
+    {
+        auto path = GetEntryPath(key);
+        if (!utilities::FileExists(path))
+        {
+            return false;
+        }
+
+        contents = ReadFile(path);
+        return true;
+    }
+
+    void CompilationCache::SetEntry(const std::string& key, const std::string& contents)
+    {
+        auto path = GetEntryPath(key);
+        auto temporaryPath = path + ".tmp" + std::to_string(std::random_device()());
+        {
+            auto stream = utilities::OpenBinaryOfstream(temporaryPath);
+            stream.write(contents.data(), contents.size());
+        }
+
+        std::remove(path.c_str());
+        if (std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+        {
+            std::remove(temporaryPath.c_str());
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotWritable, "Unable to add entry " + path + " to the compilation cache");
+        }
+    }
+
+    void CompilationCache::RecordHit()
+    {
+        ++_numHits;
+    }
+
+    void CompilationCache::RecordMiss()
+    {
+        ++_numMisses;
+    }
+
+    double CompilationCache::GetHitRate() const
+    {
+        auto numLookups = _numHits + _numMisses;
+        return numLookups == 0 ? 0.0 : static_cast<double>(_numHits) / numLookups;
+    }
+
+    std::string CompilationCache::GetEntryPath(const std::string& key) const
+    {
+        return utilities::JoinPaths(_directory, key);
+    }
+
+    std::string GetCompilationCacheDescription(const MapCompilerOptions& options)
+    {
+        const auto& settings = options.compilerSettings;
+        const auto& target = settings.targetDevice;
+
+        std::stringstream description;
+        description << "module: " << options.moduleName << '\n'
+                    << "mapFunctionName: " << options.mapFunctionName << '\n'
+                    << "sourceFunctionName: " << options.sourceFunctionName << '\n'
+                    << "sinkFunctionName: " << options.sinkFunctionName << '\n'
+                    << "planPortMemory: " << options.planPortMemory << '\n'
+                    << "parallelizeBranches: " << options.parallelizeBranches << '\n'
+                    << "flattenForests: " << options.flattenForests << '\n'
+                    << "profile: " << options.profile << '\n'
+                    << "inlineNodes: " << options.inlineNodes << '\n'
+                    << "optimize: " << settings.optimize << '\n'
+                    << "blasType: " << static_cast<int>(settings.blasType) << '\n'
+                    << "positionIndependentCode: " << (settings.positionIndependentCode.HasValue() ? static_cast<int>(settings.positionIndependentCode.GetValue()) : -1) << '\n'
+                    << "compilerProfile: " << settings.profile << '\n'
+                    << "parallelize: " << settings.parallelize << '\n'
+                    << "useThreadPool: " << settings.useThreadPool << '\n'
+                    << "maxThreads: " << settings.maxThreads << '\n'
+                    << "useWorkStealing: " << settings.useWorkStealing << '\n'
+                    << "threadSafe: " << settings.threadSafe << '\n'
+                    << "useFastMath: " << settings.useFastMath << '\n'
+                    << "includeDiagnosticInfo: " << settings.includeDiagnosticInfo << '\n'
+                    << "target: " << target.deviceName << ';' << target.triple << ';' << target.architecture << ';' << target.dataLayout << ';' << target.cpu << ';' << target.features << ';' << target.numBits << '\n'
+                    << "useBlas: " << settings.useBlas << '\n'
+                    << "unrollLoops: " << settings.unrollLoops << '\n'
+                    << "inlineOperators: " << settings.inlineOperators << '\n'
+                    << "allowVectorInstructions: " << settings.allowVectorInstructions << '\n'
+                    << "vectorWidth: " << settings.vectorWidth << '\n'
+                    << "debug: " << settings.debug << '\n'
+                    << "globalValueAlignment: " << settings.globalValueAlignment << '\n'
+                    << "skipEllcode: " << settings.skip_ellcode << '\n'
+                    << "tuneSchedules: " << settings.tuneSchedules << '\n'
+                    << "externalWeights: " << settings.externalWeights << '\n';
+
+        // The tuned schedules change the emitted code without changing the options
+        if (!settings.scheduleTuningCache.empty() && utilities::FileExists(settings.scheduleTuningCache))
+        {
+            description << "scheduleTuningCache: " << ReadFile(settings.scheduleTuningCache) << '\n';
+        }
+        return description.str();
+    }
+} // namespace model
+} // namespace ell
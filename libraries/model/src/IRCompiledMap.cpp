@@ -22,6 +22,9 @@
 
 #include <llvm/Transforms/Utils/Cloning.h>
 
+#include <algorithm>
+#include <memory>
+#include <new>
 #include <sstream>
 #include <iostream>
 
@@ -46,6 +49,7 @@ namespace model
         _module(other._module),
         _moduleName(std::move(other._moduleName)),
         _executionEngine(std::move(other._executionEngine)),
+        _externalWeights(std::move(other._externalWeights)),
         _verifyJittedModule(other._verifyJittedModule),
         _context(other._context),
         _computeFunctionDefined(false)
@@ -101,11 +105,44 @@ namespace model
 
     void IRCompiledMap::FinishJitting()
     {
+        // Once jitted, the compute functions are only read, so the map can be shared between threads
+        if (_computeFunctionDefined)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_jitMutex);
+        if (_computeFunctionDefined)
+        {
+            return;
+        }
+
         EnsureExecutionEngine();
         ResolveCallbacks();
+        SetExternalWeights();
         SetComputeFunction();
     }
 
+    void IRCompiledMap::SetExternalWeights()
+    {
+        if (!_module.HasExternalWeights() || !_externalWeights.empty())
+        {
+            return;
+        }
+
+        // The jitted code reads its weights from an aligned copy owned by this map
+        const auto& weights = _module.GetExternalWeights();
+        const auto alignment = emitters::IRModuleEmitter::c_externalWeightsAlignment;
+        _externalWeights.resize(weights.size() + alignment);
+        void* alignedWeights = _externalWeights.data();
+        auto space = _externalWeights.size();
+        std::align(alignment, weights.size(), alignedWeights, space);
+        std::copy(weights.begin(), weights.end(), static_cast<char*>(alignedWeights));
+
+        auto setWeights = reinterpret_cast<void (*)(char*)>(GetJitter().GetFunctionAddress(_moduleName + "_SetWeights"));
+        setWeights(static_cast<char*>(alignedWeights));
+    }
+
     void IRCompiledMap::ComputeMultiple(const std::vector<void*>& inputs, const std::vector<void*>& outputs)
     {
         FinishJitting();
@@ -118,6 +155,52 @@ namespace model
         _resetFunction();
     }
 
+    void* IRCompiledMap::CreateModelContext()
+    {
+        FinishJitting();
+        if (!_createContextFunction)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Model contexts can only be used with a map compiled with the threadSafe option");
+        }
+
+        auto modelContext = _createContextFunction();
+        if (modelContext == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return modelContext;
+    }
+
+    void IRCompiledMap::DestroyModelContext(void* modelContext)
+    {
+        FinishJitting();
+        if (!_destroyContextFunction)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Model contexts can only be used with a map compiled with the threadSafe option");
+        }
+        _destroyContextFunction(modelContext);
+    }
+
+    void IRCompiledMap::ComputeMultiple(void* modelContext, const std::vector<void*>& inputs, const std::vector<void*>& outputs)
+    {
+        FinishJitting();
+        if (!_computeWithContextDispatchFunction)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Model contexts can only be used with a map compiled with the threadSafe option");
+        }
+        _computeWithContextDispatchFunction(modelContext, InternalGetContext(), inputs.data(), outputs.data());
+    }
+
+    void IRCompiledMap::Reset(void* modelContext)
+    {
+        FinishJitting();
+        if (!_resetWithContextFunction)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Model contexts can only be used with a map compiled with the threadSafe option");
+        }
+        _resetWithContextFunction(modelContext);
+    }
+
     void IRCompiledMap::SetComputeFunction()
     {
         switch (GetInput(0)->GetOutputPort().GetType())
@@ -244,7 +327,7 @@ namespace model
         }
 
         // Terrible hack to create a std::vector<bool>
-        auto& vector = std::get<Vector<bool>>(_cachedOutput);
+        auto& vector = GetOutputBuffer<Vector<bool>>();
         return { vector.begin(), vector.end() };
     }
 
@@ -256,7 +339,7 @@ namespace model
             throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
         }
 
-        return std::get<Vector<int>>(_cachedOutput);
+        return GetOutputBuffer<Vector<int>>();
     }
 
     std::vector<int64_t> IRCompiledMap::ComputeInt64Output(const model::PortElementsBase& outputs)
@@ -267,7 +350,7 @@ namespace model
             throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
         }
 
-        return std::get<Vector<int64_t>>(_cachedOutput);
+        return GetOutputBuffer<Vector<int64_t>>();
     }
 
     std::vector<float> IRCompiledMap::ComputeFloatOutput(const model::PortElementsBase& outputs)
@@ -278,7 +361,7 @@ namespace model
             throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
         }
 
-        return std::get<Vector<float>>(_cachedOutput);
+        return GetOutputBuffer<Vector<float>>();
     }
 
     std::vector<double> IRCompiledMap::ComputeDoubleOutput(const model::PortElementsBase& outputs)
@@ -289,7 +372,7 @@ namespace model
             throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
         }
 
-        return std::get<Vector<double>>(_cachedOutput);
+        return GetOutputBuffer<Vector<double>>();
     }
 
     void IRCompiledMap::WriteCode(const std::string& filePath) const
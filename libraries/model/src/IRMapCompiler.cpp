@@ -28,6 +28,7 @@
 
 #include <value/include/LLVMContext.h>
 
+#include <algorithm>
 #include <memory>
 #include <tuple>
 #include <vector>
@@ -51,6 +52,11 @@ namespace model
     {
         Log() << "Initializing IR map compiler" << EOL;
         _nodeRegions.emplace_back();
+
+        if (!settings.compilationCache.empty())
+        {
+            _compilationCache = std::make_unique<CompilationCache>(settings.compilationCache);
+        }
     }
 
     std::string IRMapCompiler::GetNamespacePrefix() const
@@ -100,6 +106,10 @@ namespace model
 
         // Emit runtime model APIs
         EmitModelAPIFunctions(map);
+        if (GetMapCompilerOptions().compilerSettings.threadSafe)
+        {
+            EmitContextFunctions();
+        }
 
         if (GetMapCompilerOptions().compilerSettings.optimize)
         {
@@ -218,10 +228,25 @@ namespace model
         EmitGetMetadataFunction(map);
         EmitPredictDispatchFunction(map);
 
+        if (GetMapCompilerOptions().compilerSettings.externalWeights)
+        {
+            _moduleEmitter.EmitSetWeightsFunction();
+        }
+
         // Finish any profiling stuff we need to do and emit functions
         _profiler.EmitModelProfilerFunctions();
     }
 
+    void IRMapCompiler::EmitContextFunctions()
+    {
+        // Moves the model's state into a context that each calling thread allocates, and emits a WithContext
+        // version of each entry point
+        _moduleEmitter.EmitContextFunctions();
+        _moduleEmitter.EmitWithContextFunction(GetPredictFunctionName(), true);
+        _moduleEmitter.EmitWithContextFunction(GetNamespacePrefix() + "_Reset", true);
+        _moduleEmitter.EmitWithContextFunction(GetPredictFunctionName() + "_dispatch", false);
+    }
+
     void IRMapCompiler::EmitGetInputSizeFunction(const Map& map)
     {
         const emitters::NamedVariableTypeList parameters = { { "index", emitters::VariableType::Int32 } };
@@ -645,7 +670,14 @@ namespace model
             throw emitters::EmitterException(emitters::EmitterError::unexpected,
                                              utilities::FormatString("Error: missing port variable for '%s' port on node %s(%s)", port.GetName().c_str(), node->GetRuntimeTypeName().c_str(), node->GetId().ToString().c_str()));
         }
-        return GetModule().EnsureEmitted(*pVar);
+
+        auto pValue = GetModule().EnsureEmitted(*pVar);
+        if (emitters::IRModuleEmitter::IsExternalWeightsPointer(pValue))
+        {
+            // Nodes expect a pointer to the data, not to the global that points to it
+            return GetModule().GetCurrentFunction().Load(pValue);
+        }
+        return pValue;
     }
 
     emitters::LLVMValue IRMapCompiler::EnsurePortEmitted(const OutputPortBase& port)
@@ -674,6 +706,26 @@ namespace model
     {
         auto& currentFunction = GetModule().GetCurrentFunction();
         _profiler.EndModel(currentFunction);
+
+        EmitPortMemoryArena();
+    }
+
+    void IRMapCompiler::EmitPortMemoryArena()
+    {
+        auto pArenaVar = GetPortMemoryArenaVariable();
+        if (pArenaVar == nullptr)
+        {
+            return;
+        }
+
+        // The port buffers were emitted as views into a zero-sized placeholder, because the arena's size
+        // wasn't known until now. Replace the placeholder with a global of the final size.
+        auto arenaSize = GetPortMemoryPlanner()->GetArenaSize();
+        Log() << "Emitting port memory arena of " << arenaSize << " bytes (" << GetPortMemoryPlanner()->GetUnsharedSize() << " bytes unshared)" << EOL;
+
+        auto pPlaceholder = llvm::cast<llvm::GlobalVariable>(GetModule().EnsureEmitted(*pArenaVar));
+        auto pArena = GetModule().GlobalArray(emitters::VariableType::Byte, GetNamespacePrefix() + "_PortMemoryArena", std::max<size_t>(arenaSize, 1));
+        pPlaceholder->replaceAllUsesWith(llvm::ConstantExpr::getBitCast(pArena, pPlaceholder->getType()));
     }
 
     void IRMapCompiler::OnBeginCompileNode(const Node& node)
@@ -720,6 +772,83 @@ namespace model
         _nodeRegions.pop_back();
     }
 
+    void IRMapCompiler::CompileParallelStage(const NodeStage& stage)
+    {
+        auto& emitter = _moduleEmitter.GetIREmitter();
+        auto& predictFunction = _moduleEmitter.GetCurrentFunction();
+        auto stageName = predictFunction.GetFunctionName() + "_stage_" + std::to_string(_numParallelStages++);
+        Log() << "Compiling " << stage.branches.size() << " branches of " << stageName << " in parallel" << EOL;
+
+        // Each branch gets its own function with the same arguments as predict, so the nodes in it
+        // find the map's input and output buffers the same way they would in predict
+        emitters::NamedLLVMTypeList args;
+        std::vector<emitters::LLVMValue> predictArgs;
+        for (auto& arg : predictFunction.GetFunction()->args())
+        {
+            args.push_back({ arg.getName(), arg.getType() });
+            predictArgs.push_back(&arg);
+        }
+
+        std::vector<emitters::LLVMFunction> branchFunctions;
+        for (size_t branchIndex = 0; branchIndex < stage.branches.size(); ++branchIndex)
+        {
+            auto& branchFunction = _moduleEmitter.BeginFunction(stageName + "_branch_" + std::to_string(branchIndex), emitter.Type(emitters::VariableType::Void), args);
+            branchFunction.AddRegion(branchFunction.GetCurrentBlock());
+
+            // Node regions can't be merged across functions
+            _nodeRegions.emplace_back();
+            CompileParallelBranch(stage.branches[branchIndex]);
+            _nodeRegions.pop_back();
+
+            branchFunction.Return();
+            branchFunctions.push_back(branchFunction.GetFunction());
+            _moduleEmitter.EndFunction();
+        }
+
+        // The thread pool runs many invocations of a single function, so dispatch to the branches on the task index
+        auto taskArgs = args;
+        taskArgs.push_back({ "branchIndex", emitter.Type(emitters::VariableType::Int32) });
+        auto& taskFunction = _moduleEmitter.BeginFunction(stageName, emitter.Type(emitters::VariableType::Void), taskArgs);
+        {
+            std::vector<emitters::LLVMValue> branchArgs;
+            for (auto& arg : taskFunction.GetFunction()->args())
+            {
+                branchArgs.push_back(&arg);
+            }
+            auto branchIndexArg = branchArgs.back();
+            branchArgs.pop_back();
+
+            for (size_t branchIndex = 0; branchIndex < branchFunctions.size(); ++branchIndex)
+            {
+                auto branchFunction = branchFunctions[branchIndex];
+                taskFunction.If(emitters::TypedComparison::equals, branchIndexArg, taskFunction.Literal(static_cast<int>(branchIndex)), [branchFunction, &branchArgs](emitters::IRFunctionEmitter& function) {
+                    function.Call(branchFunction, branchArgs);
+                });
+            }
+            taskFunction.Return();
+        }
+        auto taskLLVMFunction = taskFunction.GetFunction();
+        _moduleEmitter.EndFunction();
+
+        // Start the branches from predict, in a region of their own, and wait for them all to finish before going on
+        auto pBlock = predictFunction.BeginBlock(stageName, true);
+        predictFunction.AddRegion(pBlock);
+
+        std::vector<std::vector<emitters::LLVMValue>> tasks;
+        for (size_t branchIndex = 0; branchIndex < branchFunctions.size(); ++branchIndex)
+        {
+            auto arguments = predictArgs;
+            arguments.push_back(predictFunction.Literal(static_cast<int>(branchIndex)));
+            tasks.push_back(arguments);
+        }
+        auto taskArray = predictFunction.StartTasks(taskLLVMFunction, tasks);
+        taskArray.WaitAll(predictFunction);
+        predictFunction.GetCurrentRegion()->SetEnd(predictFunction.GetCurrentBlock());
+
+        // Nodes after the stage must not be merged into a region that runs before it
+        GetCurrentNodeBlocks().Clear();
+    }
+
     NodeMap<emitters::IRBlockRegion*>& IRMapCompiler::GetCurrentNodeBlocks()
     {
         assert(_nodeRegions.size() > 0);
@@ -793,6 +922,13 @@ namespace model
     {
         Log() << "Trying to merge code regions for " << DiagnosticString(node) << EOL;
 
+        if (IsPlanningPortMemory())
+        {
+            // Moving a node's code would invalidate the port lifetimes the arena was planned with
+            Log() << "Not merging code regions, because port memory is being planned" << EOL;
+            return false;
+        }
+
         auto pRegion = GetCurrentNodeBlocks().Get(node);
         if (pRegion == nullptr)
         {
@@ -814,6 +950,12 @@ namespace model
     {
         Log() << "Trying to merge parent node " << DiagnosticString(dest) << " with child node " << DiagnosticString(src) << EOL;
 
+        if (IsPlanningPortMemory())
+        {
+            Log() << "Not merging code regions, because port memory is being planned" << EOL;
+            return false;
+        }
+
         emitters::IRBlockRegion* pDestRegion = GetCurrentNodeBlocks().Get(dest);
         if (pDestRegion == nullptr)
         {
@@ -846,7 +988,7 @@ namespace model
     emitters::IRBlockRegion* IRMapCompiler::GetMergeableNodeRegion(const PortElementBase& element)
     {
         const Node* pNode = nullptr;
-        if (HasSingleDescendant(element))
+        if (HasSingleDescendant(element) && !IsPlanningPortMemory())
         {
             emitters::Variable* pVar = GetVariableForPort(*element.ReferencedPort());
             if (pVar != nullptr && !pVar->IsLiteral())
@@ -15,6 +15,7 @@
 
 #include <emitters/include/EmitterException.h>
 
+#include <utilities/include/Exception.h>
 #include <utilities/include/Logger.h>
 #include <utilities/include/PropertyBag.h>
 
@@ -28,6 +29,10 @@ namespace model
         _parameters(settings),
         _optimizerOptions(optimizerOptions)
     {
+        if (_parameters.compilerSettings.threadSafe && _parameters.compilerSettings.parallelize)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The threadSafe and parallelize compiler options can't be used together");
+        }
         PushScope();
     }
 
@@ -51,7 +56,19 @@ namespace model
         auto result = GetMapCompilerOptions(*node.GetModel());
         if (node.GetMetadata().HasEntry("compileOptions"))
         {
-            return result.AppendOptions(node.GetMetadata().GetEntry<utilities::PropertyBag>("compileOptions"));
+            result = result.AppendOptions(node.GetMetadata().GetEntry<utilities::PropertyBag>("compileOptions"));
+        }
+
+        // Worker threads don't see the calling thread's model context
+        if (result.compilerSettings.threadSafe && result.compilerSettings.parallelize)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The threadSafe and parallelize compiler options can't be used together");
+        }
+
+        if (_isCompilingParallelBranch)
+        {
+            // The thread pool runs one set of tasks at a time, so nodes in a concurrent branch can't start their own
+            result.compilerSettings.parallelize = false;
         }
         return result;
     }
@@ -108,6 +125,12 @@ namespace model
 
         pModuleEmitter->GetFunctionDeclaration(functionName).GetComments() = comments;
 
+        if (GetMapCompilerOptions().planPortMemory)
+        {
+            Log() << "Planning port memory" << EOL;
+            _portMemoryPlanner = std::make_unique<PortMemoryPlanner>(map.GetModel(), GetMapCompilerOptions().compilerSettings.globalValueAlignment);
+        }
+
         OnBeginCompileModel(map.GetModel());
         CompileNodes(map.GetModel());
         OnEndCompileModel(map.GetModel());
@@ -118,6 +141,30 @@ namespace model
 
     void MapCompiler::CompileNodes(Model& model)
     {
+        if (ShouldParallelizeBranches())
+        {
+            NodeScheduler scheduler(model);
+            if (scheduler.NumParallelStages() > 0)
+            {
+                Log() << "Compiling " << scheduler.GetStages().size() << " stages, " << scheduler.NumParallelStages() << " of them in parallel" << EOL;
+                for (const auto& stage : scheduler.GetStages())
+                {
+                    if (stage.IsParallel())
+                    {
+                        CompileParallelStage(stage);
+                    }
+                    else
+                    {
+                        for (auto node : stage.branches.front().nodes)
+                        {
+                            CompileNode(*node);
+                        }
+                    }
+                }
+                return;
+            }
+        }
+
         std::unordered_set<const Node*> visitedNodes;
         model.Visit([this, &visitedNodes](const Node& node) {
             for (const auto* inputPort : node.GetInputPorts())
@@ -128,28 +175,72 @@ namespace model
                     throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Visited node before all its descendants!");
                 }
             }
-            if (!node.IsCompilable(this))
-            {
-                std::string typeName = node.GetRuntimeTypeName();
-                throw emitters::EmitterException(emitters::EmitterError::notSupported, std::string("Uncompilable node type: " + typeName));
-            }
 
-            auto compilableNode = const_cast<CompilableNode*>(dynamic_cast<const CompilableNode*>(&node));
-            if (!compilableNode)
+            visitedNodes.insert(&node);
+            CompileNode(node);
+        });
+    }
+
+    void MapCompiler::CompileNode(const Node& node)
+    {
+        if (!node.IsCompilable(this))
+        {
+            std::string typeName = node.GetRuntimeTypeName();
+            throw emitters::EmitterException(emitters::EmitterError::notSupported, std::string("Uncompilable node type: " + typeName));
+        }
+
+        auto compilableNode = const_cast<CompilableNode*>(dynamic_cast<const CompilableNode*>(&node));
+        if (!compilableNode)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Encountered null compilable node");
+        }
+
+        Log() << "Now compiling node " << DiagnosticString(node) << EOL;
+        OnBeginCompileNode(node);
+        compilableNode->CompileNode(*this);
+        OnEndCompileNode(node);
+
+        if (_portMemoryPlanner)
+        {
+            _portMemoryPlanner->EndNode(node);
+        }
+    }
+
+    bool MapCompiler::ShouldParallelizeBranches() const
+    {
+        // Profiling and port memory planning both assume the nodes run one after the other, in visit order
+        const auto& options = GetMapCompilerOptions();
+        return options.parallelizeBranches && options.compilerSettings.parallelize && !options.profile && !IsPlanningPortMemory();
+    }
+
+    void MapCompiler::CompileParallelStage(const NodeStage& stage)
+    {
+        for (const auto& branch : stage.branches)
+        {
+            for (auto node : branch.nodes)
             {
-                throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Encountered null compilable node");
+                CompileNode(*node);
             }
+        }
+    }
 
-            visitedNodes.insert(&node);
-            Log() << "Now compiling node " << DiagnosticString(node) << EOL;
-            OnBeginCompileNode(node);
-            compilableNode->CompileNode(*this);
-            OnEndCompileNode(node);
-        });
+    void MapCompiler::CompileParallelBranch(const NodeBranch& branch)
+    {
+        _isCompilingParallelBranch = true;
+        for (auto node : branch.nodes)
+        {
+            CompileNode(*node);
+        }
+        _isCompilingParallelBranch = false;
     }
 
     emitters::Variable* MapCompiler::AllocatePortVariable(const OutputPortBase& port)
     {
+        if (CanAllocatePortFromArena(port))
+        {
+            return AllocatePortVariableFromArena(port);
+        }
+
         auto pModuleEmitter = GetModuleEmitter();
         assert(port.Size() != 0);
 
@@ -171,6 +262,35 @@ namespace model
         return pVar;
     }
 
+    bool MapCompiler::CanAllocatePortFromArena(const OutputPortBase& port) const
+    {
+        // Only ports in the top-level scope are planned: node functions receive their ports as arguments
+        return _portMemoryPlanner && _portToVarMaps.size() == 1 && _portMemoryPlanner->CanAllocate(port);
+    }
+
+    emitters::Variable* MapCompiler::AllocatePortVariableFromArena(const OutputPortBase& port)
+    {
+        auto pModuleEmitter = GetModuleEmitter();
+        assert(port.Size() != 0);
+
+        if (_pPortMemoryArenaVar == nullptr)
+        {
+            // The arena's real size is filled in by the derived compiler after all the nodes are compiled
+            _pPortMemoryArenaVar = pModuleEmitter->Variables().AddVectorVariable(emitters::VariableScope::global, emitters::VariableType::Byte, 0);
+            pModuleEmitter->AllocateVariable(*_pPortMemoryArenaVar);
+        }
+
+        auto offset = _portMemoryPlanner->Allocate(port);
+        Log() << "Allocating " << port.Size() << " elements for port " << port.GetName() << " of node " << DiagnosticString(*port.GetNode()) << " at arena offset " << offset << EOL;
+
+        emitters::VariableType varType = PortTypeToVariableType(port.GetType());
+        auto pVar = pModuleEmitter->Variables().AddVectorViewVariable(varType, *_pPortMemoryArenaVar, offset, port.Size());
+        pModuleEmitter->AllocateVariable(*pVar);
+        _portMemoryArenaOwners[pVar] = &port;
+        SetVariableForPort(port, pVar);
+        return pVar;
+    }
+
     //
     // Allocating variables for function arguments
     //
@@ -247,6 +367,16 @@ namespace model
 
     void MapCompiler::SetVariableForPort(const Port& port, emitters::Variable* pVar)
     {
+        if (_portMemoryPlanner && _portToVarMaps.size() == 1)
+        {
+            // If a node reuses another port's arena buffer for its output, keep that buffer alive for the new port's readers too
+            auto ownerIt = _portMemoryArenaOwners.find(pVar);
+            auto outputPort = dynamic_cast<const OutputPortBase*>(&port);
+            if (ownerIt != _portMemoryArenaOwners.end() && outputPort != nullptr && ownerIt->second != outputPort)
+            {
+                _portMemoryPlanner->AddAlias(*outputPort, *ownerIt->second);
+            }
+        }
         _portToVarMaps.back()[&port] = pVar;
     }
 } // namespace model
@@ -33,7 +33,11 @@ namespace model
         sinkFunctionName = properties.GetOrParseEntry("sinkFunctionName", sinkFunctionName);
         verifyJittedModule = properties.GetOrParseEntry("verifyJittedModule", verifyJittedModule);
         profile = properties.GetOrParseEntry("profile", profile);
+        planPortMemory = properties.GetOrParseEntry("planPortMemory", planPortMemory);
+        parallelizeBranches = properties.GetOrParseEntry("parallelizeBranches", parallelizeBranches);
+        compilationCache = properties.GetOrParseEntry("compilationCache", compilationCache);
         inlineNodes = properties.GetOrParseEntry("inlineNodes", inlineNodes);
+        flattenForests = properties.GetOrParseEntry("flattenForests", flattenForests);
     }
 } // namespace model
 } // namespace ell
@@ -0,0 +1,220 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     NodeScheduler.cpp (model)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "NodeScheduler.h"
+#include "InputPort.h"
+#include "Model.h"
+#include "Node.h"
+#include "OutputPort.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace ell
+{
+namespace model
+{
+    namespace
+    {
+        // A run of nodes where each node is the only consumer of the one before it
+        struct NodeChain
+        {
+            std::vector<const Node*> nodes;
+            std::vector<int> dependencies; // indices of the chains this chain reads from
+            size_t cost = 0;
+        };
+
+        // Gets the nodes a node reads from, in the order its inputs reference them
+        std::vector<const Node*> GetProducers(const Node& node)
+        {
+            std::vector<const Node*> result;
+            for (auto input : node.GetInputPorts())
+            {
+                for (auto parent : input->GetParentNodes())
+                {
+                    if (std::find(result.begin(), result.end(), parent) == result.end())
+                    {
+                        result.push_back(parent);
+                    }
+                }
+            }
+            return result;
+        }
+
+        void AppendBranch(std::vector<NodeStage>& stages, const NodeBranch& branch)
+        {
+            // Consecutive sequential work is folded into a single branch
+            if (stages.empty() || stages.back().IsParallel())
+            {
+                stages.push_back({});
+                stages.back().branches.push_back({});
+            }
+
+            auto& sequentialBranch = stages.back().branches.front();
+            sequentialBranch.nodes.insert(sequentialBranch.nodes.end(), branch.nodes.begin(), branch.nodes.end());
+            sequentialBranch.cost += branch.cost;
+        }
+    } // namespace
+
+    size_t GetNodeCostEstimate(const Node& node)
+    {
+        if (node.NumInputPorts() == 0)
+        {
+            return 0;
+        }
+
+        size_t result = 0;
+        for (auto output : node.GetOutputPorts())
+        {
+            result += output->Size();
+        }
+        return result;
+    }
+
+    NodeScheduler::NodeScheduler(const Model& model, size_t minParallelBranchCost)
+    {
+        std::vector<const Node*> nodes;
+        std::unordered_map<const Node*, std::vector<const Node*>> producers;
+        std::unordered_map<const Node*, int> numConsumers;
+        model.Visit([&](const Node& node) {
+            nodes.push_back(&node);
+            auto& nodeProducers = producers[&node];
+            nodeProducers = GetProducers(node);
+            for (auto producer : nodeProducers)
+            {
+                ++numConsumers[producer];
+            }
+        });
+
+        _numNodes = nodes.size();
+
+        // Group the nodes into chains. Nodes without inputs (like constants) are computed before anything else
+        // needs them, so reading from one doesn't stop a node from joining its producer's chain.
+        std::vector<NodeChain> chains;
+        std::unordered_map<const Node*, int> nodeChain;
+        for (auto node : nodes)
+        {
+            const auto& nodeProducers = producers[node];
+            auto cost = GetNodeCostEstimate(*node);
+            _totalCost += cost;
+
+            std::vector<const Node*> computedProducers;
+            std::copy_if(nodeProducers.begin(), nodeProducers.end(), std::back_inserter(computedProducers), [](const Node* producer) { return producer->NumInputPorts() > 0; });
+
+            int chainIndex = -1;
+            if (computedProducers.size() == 1 && numConsumers[computedProducers[0]] == 1 && chains[nodeChain[computedProducers[0]]].nodes.back() == computedProducers[0])
+            {
+                chainIndex = nodeChain[computedProducers[0]];
+            }
+            else
+            {
+                chainIndex = static_cast<int>(chains.size());
+                chains.push_back({});
+            }
+
+            auto& chain = chains[chainIndex];
+            chain.nodes.push_back(node);
+            chain.cost += cost;
+            nodeChain[node] = chainIndex;
+            for (auto producer : nodeProducers)
+            {
+                auto dependency = nodeChain[producer];
+                if (dependency != chainIndex && std::find(chain.dependencies.begin(), chain.dependencies.end(), dependency) == chain.dependencies.end())
+                {
+                    chain.dependencies.push_back(dependency);
+                }
+            }
+        }
+
+        // Schedule the chains in waves: each wave holds every chain whose dependencies have all been scheduled
+        std::vector<bool> scheduled(chains.size(), false);
+        size_t numScheduled = 0;
+        while (numScheduled < chains.size())
+        {
+            std::vector<int> ready;
+            for (int chainIndex = 0; chainIndex < static_cast<int>(chains.size()); ++chainIndex)
+            {
+                const auto& dependencies = chains[chainIndex].dependencies;
+                if (!scheduled[chainIndex] && std::all_of(dependencies.begin(), dependencies.end(), [&](int dependency) { return scheduled[dependency]; }))
+                {
+                    ready.push_back(chainIndex);
+                }
+            }
+
+            NodeStage parallelStage;
+            for (auto chainIndex : ready)
+            {
+                const auto& chain = chains[chainIndex];
+                NodeBranch branch{ chain.nodes, chain.cost };
+                if (chain.cost < minParallelBranchCost)
+                {
+                    AppendBranch(_stages, branch);
+                }
+                else
+                {
+                    parallelStage.branches.push_back(std::move(branch));
+                }
+                scheduled[chainIndex] = true;
+            }
+            numScheduled += ready.size();
+
+            if (parallelStage.IsParallel())
+            {
+                _stages.push_back(std::move(parallelStage));
+            }
+            else if (!parallelStage.branches.empty())
+            {
+                AppendBranch(_stages, parallelStage.branches.front());
+            }
+        }
+
+        ComputeCriticalPath(nodes, producers);
+    }
+
+    size_t NodeScheduler::NumParallelStages() const
+    {
+        return static_cast<size_t>(std::count_if(_stages.begin(), _stages.end(), [](const NodeStage& stage) { return stage.IsParallel(); }));
+    }
+
+    void NodeScheduler::ComputeCriticalPath(const std::vector<const Node*>& nodes, const std::unordered_map<const Node*, std::vector<const Node*>>& producers)
+    {
+        // The nodes are in topological order, so each node's producers have already been processed
+        std::unordered_map<const Node*, size_t> pathCost;
+        std::unordered_map<const Node*, const Node*> previous;
+        const Node* lastNode = nullptr;
+        for (auto node : nodes)
+        {
+            size_t longestProducerPath = 0;
+            const Node* longestProducer = nullptr;
+            for (auto producer : producers.at(node))
+            {
+                if (longestProducer == nullptr || pathCost[producer] > longestProducerPath)
+                {
+                    longestProducerPath = pathCost[producer];
+                    longestProducer = producer;
+                }
+            }
+
+            auto cost = longestProducerPath + GetNodeCostEstimate(*node);
+            pathCost[node] = cost;
+            previous[node] = longestProducer;
+            if (lastNode == nullptr || cost > pathCost[lastNode])
+            {
+                lastNode = node;
+            }
+        }
+
+        _criticalPath.clear();
+        _criticalPathCost = lastNode == nullptr ? 0 : pathCost[lastNode];
+        for (auto node = lastNode; node != nullptr; node = previous[node])
+        {
+            _criticalPath.push_back(node);
+        }
+        std::reverse(_criticalPath.begin(), _criticalPath.end());
+    }
+} // namespace model
+} // namespace ell
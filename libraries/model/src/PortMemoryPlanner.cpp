@@ -0,0 +1,216 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PortMemoryPlanner.cpp (model)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PortMemoryPlanner.h"
+#include "InputPort.h"
+#include "Model.h"
+#include "Node.h"
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace ell
+{
+namespace model
+{
+    namespace
+    {
+        size_t RoundUp(size_t size, size_t alignment)
+        {
+            return ((size + alignment - 1) / alignment) * alignment;
+        }
+    } // namespace
+
+    size_t GetPortElementSize(Port::PortType type)
+    {
+        switch (type)
+        {
+        case Port::PortType::boolean:
+            return sizeof(uint8_t); // booleans are emitted as bytes
+        case Port::PortType::integer:
+            return sizeof(int32_t);
+        case Port::PortType::bigInt:
+            return sizeof(int64_t);
+        case Port::PortType::smallReal:
+            return sizeof(float);
+        case Port::PortType::real:
+            return sizeof(double);
+        default:
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Port type not supported");
+        }
+    }
+
+    PortMemoryPlanner::PortMemoryPlanner(const Model& model, size_t alignment) :
+        _alignment(std::max<size_t>(alignment, 1))
+    {
+        int index = 0;
+        model.Visit([this, &index](const Node& node) {
+            _nodeIndices[&node] = index;
+            for (auto output : node.GetOutputPorts())
+            {
+                _lastUse[output] = index;
+            }
+
+            for (auto input : node.GetInputPorts())
+            {
+                const auto* referencedPort = &input->GetReferencedPort();
+                auto it = _lastUse.find(referencedPort);
+                if (it != _lastUse.end())
+                {
+                    it->second = std::max(it->second, index);
+                }
+            }
+            ++index;
+        });
+    }
+
+    bool PortMemoryPlanner::CanAllocate(const OutputPortBase& port) const
+    {
+        // Padded buffers rely on their padding values persisting between calls, so they can't be shared
+        return _lastUse.find(&port) != _lastUse.end() && !port.GetMemoryLayout().HasPadding();
+    }
+
+    size_t PortMemoryPlanner::Allocate(const OutputPortBase& port)
+    {
+        if (!CanAllocate(port))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Port can't be allocated from the shared arena");
+        }
+
+        if (IsAllocated(port))
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Port already has a buffer in the shared arena");
+        }
+
+        auto size = RoundUp(std::max<size_t>(port.Size() * GetPortElementSize(port.GetType()), 1), _alignment);
+
+        // Find the smallest free block that fits
+        auto bestFit = _freeBlocks.end();
+        for (auto it = _freeBlocks.begin(); it != _freeBlocks.end(); ++it)
+        {
+            if (it->size >= size && (bestFit == _freeBlocks.end() || it->size < bestFit->size))
+            {
+                bestFit = it;
+            }
+        }
+
+        Block block{ 0, size };
+        if (bestFit != _freeBlocks.end())
+        {
+            block.offset = bestFit->offset;
+            bestFit->offset += size;
+            bestFit->size -= size;
+            if (bestFit->size == 0)
+            {
+                _freeBlocks.erase(bestFit);
+            }
+        }
+        else if (!_freeBlocks.empty() && _freeBlocks.back().offset + _freeBlocks.back().size == _arenaSize)
+        {
+            // Grow the arena, reusing the free block at its end
+            block.offset = _freeBlocks.back().offset;
+            _freeBlocks.pop_back();
+            _arenaSize = block.offset + size;
+        }
+        else
+        {
+            block.offset = _arenaSize;
+            _arenaSize += size;
+        }
+
+        // A port can't die before the node that computes it has been compiled
+        auto& lastUse = _lastUse[&port];
+        lastUse = std::max(lastUse, _currentNodeIndex);
+
+        _liveBlocks[&port] = block;
+        _unsharedSize += size;
+        ++_numBuffers;
+        return block.offset;
+    }
+
+    bool PortMemoryPlanner::IsAllocated(const OutputPortBase& port) const
+    {
+        return _liveBlocks.find(GetOwner(port)) != _liveBlocks.end();
+    }
+
+    void PortMemoryPlanner::AddAlias(const OutputPortBase& alias, const OutputPortBase& port)
+    {
+        const auto* owner = GetOwner(port);
+        if (_liveBlocks.find(owner) == _liveBlocks.end())
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Aliasing a port that has no buffer in the shared arena");
+        }
+
+        _aliases[&alias] = owner;
+        auto& lastUse = _lastUse[owner];
+        lastUse = std::max(lastUse, GetLastUse(alias));
+    }
+
+    void PortMemoryPlanner::EndNode(const Node& node)
+    {
+        auto it = _nodeIndices.find(&node);
+        if (it == _nodeIndices.end())
+        {
+            return;
+        }
+
+        auto nodeIndex = it->second;
+        for (auto blockIt = _liveBlocks.begin(); blockIt != _liveBlocks.end();)
+        {
+            if (GetLastUse(*blockIt->first) <= nodeIndex)
+            {
+                Free(blockIt->second);
+                blockIt = _liveBlocks.erase(blockIt);
+            }
+            else
+            {
+                ++blockIt;
+            }
+        }
+        _currentNodeIndex = nodeIndex + 1;
+    }
+
+    const OutputPortBase* PortMemoryPlanner::GetOwner(const OutputPortBase& port) const
+    {
+        auto it = _aliases.find(&port);
+        return it == _aliases.end() ? &port : it->second;
+    }
+
+    int PortMemoryPlanner::GetLastUse(const OutputPortBase& port) const
+    {
+        auto it = _lastUse.find(&port);
+        return it == _lastUse.end() ? _currentNodeIndex : std::max(it->second, _currentNodeIndex);
+    }
+
+    void PortMemoryPlanner::Free(const Block& block)
+    {
+        auto it = std::lower_bound(_freeBlocks.begin(), _freeBlocks.end(), block, [](const Block& a, const Block& b) { return a.offset < b.offset; });
+        it = _freeBlocks.insert(it, block);
+
+        // Coalesce with the following block
+        auto next = it + 1;
+        if (next != _freeBlocks.end() && it->offset + it->size == next->offset)
+        {
+            it->size += next->size;
+            _freeBlocks.erase(next);
+        }
+
+        // Coalesce with the preceding block
+        if (it != _freeBlocks.begin())
+        {
+            auto prev = it - 1;
+            if (prev->offset + prev->size == it->offset)
+            {
+                prev->size += it->size;
+                _freeBlocks.erase(it);
+            }
+        }
+    }
+} // namespace model
+} // namespace ell
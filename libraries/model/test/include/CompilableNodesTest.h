@@ -34,7 +34,11 @@ void TestCompilableVectorOutputNode();
 void TestCompilableAccumulatorNode();
 void TestCompilableDotProductNode();
 void TestCompilableDelayNode();
+void TestCompilableMovingAverageNode();
+void TestCompilableMovingVarianceNode();
 void TestCompilableDTWDistanceNode();
+void TestCompilableDTWDistanceNodeWithBand();
+void TestCompilableDTWDistanceNodeWithNarrowBand();
 void TestCompilableMulticlassDTW();
 void TestCompilableScalarSumNode();
 void TestCompilableSumNode();
@@ -73,7 +77,7 @@ void TestBufferNode();
 // mathy nodes
 //
 void TestMatrixVectorMultiplyNode(int m, int n, bool useBlas);
-void TestMatrixMatrixMultiplyNode(int m, int n, int k, bool useBlas);
+void TestMatrixMatrixMultiplyNode(int m, int n, int k, bool useBlas, bool parallelize = false);
 void TestOrderedMatrixMatrixMultiplyNode(int m, int n, int k, bool transposeA, bool transposeB, bool transposeC, bool useBlas);
 void TestMatrixMatrixMultiplyCodeNode(int m, int n, int k, int panelM, int panelN, int panelK, int kernelM, int kernelN, int kernelK, nodes::MatrixMatrixMultiplyImplementation gemmImpl);
 
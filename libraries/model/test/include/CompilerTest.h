@@ -56,6 +56,13 @@ void TestMultiSourceSinkMap();
 void TestCompiledMapMove();
 void TestCompiledMapClone();
 void TestCompiledMapParallelClone();
+void TestPortMemoryPlanning(bool optimize);
+void TestForestFlattening(bool flattenForests);
+void TestCompiledMapThreadSafe();
+void TestParallelBranches(bool optimize);
+void TestExternalWeights(bool optimize);
+void TestCompilationCache();
+void TestParallelOptimization();
 
 #pragma region implementation
 
@@ -53,6 +53,8 @@
 #include <nodes/include/MatrixMatrixMultiplyNode.h>
 #include <nodes/include/MatrixVectorMultiplyNode.h>
 #include <nodes/include/MatrixVectorProductNode.h>
+#include <nodes/include/MovingAverageNode.h>
+#include <nodes/include/MovingVarianceNode.h>
 #include <nodes/include/MultiplexerNode.h>
 #include <nodes/include/NeuralNetworkPredictorNode.h>
 #include <nodes/include/NodeOperations.h>
@@ -98,6 +100,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <numeric>
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
@@ -248,6 +251,108 @@ void TestCompilableDelayNode()
     });
 }
 
+// Computes the mean and variance of the last `windowSize` samples of the signal at each step, treating the samples before the start as zero
+static void GetMovingStatistics(const std::vector<std::vector<double>>& signal, size_t windowSize, std::vector<std::vector<double>>& means, std::vector<std::vector<double>>& variances)
+{
+    auto dimension = signal[0].size();
+    for (size_t t = 0; t < signal.size(); ++t)
+    {
+        std::vector<double> mean(dimension);
+        std::vector<double> variance(dimension);
+        for (size_t index = 0; index < dimension; ++index)
+        {
+            std::vector<double> window(windowSize);
+            for (size_t k = 0; k < windowSize && k <= t; ++k)
+            {
+                window[k] = signal[t - k][index];
+            }
+            mean[index] = std::accumulate(window.begin(), window.end(), 0.0) / windowSize;
+            for (auto x : window)
+            {
+                variance[index] += (x - mean[index]) * (x - mean[index]) / windowSize;
+            }
+        }
+        means.push_back(mean);
+        variances.push_back(variance);
+    }
+}
+
+void TestCompilableMovingAverageNode()
+{
+    const size_t windowSize = 4;
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(3);
+    auto movingAverageNode = model.AddNode<MovingAverageNode<double>>(inputNode->output, windowSize);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", movingAverageNode->output } });
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 3, 4, 5 }, { 2, 3, 2 }, { 1, 5, 3 }, { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 7, 4, 2 }, { 5, 2, 1 } };
+    std::vector<std::vector<double>> expected;
+    std::vector<std::vector<double>> variances;
+    GetMovingStatistics(signal, windowSize, expected, variances);
+
+    std::string name = "MovingAverageNode";
+    TestWithSerialization(map, name, [&](model::Map& map, int iteration) {
+        model::IRMapCompiler compiler;
+        auto compiledMap = compiler.Compile(map);
+
+        // compare output
+        VerifyCompiledOutputAndResult(map, compiledMap, signal, expected, utilities::FormatString("%s iteration %d", name.c_str(), iteration));
+
+        // after a reset, the window starts out empty again
+        map.Reset();
+        compiledMap.Reset();
+        VerifyCompiledOutputAndResult(map, compiledMap, signal, expected, utilities::FormatString("%s after reset iteration %d", name.c_str(), iteration));
+    });
+}
+
+void TestCompilableMovingVarianceNode()
+{
+    const size_t windowSize = 4;
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(3);
+    auto movingVarianceNode = model.AddNode<MovingVarianceNode<double>>(inputNode->output, windowSize);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", movingVarianceNode->output } });
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 3, 4, 5 }, { 2, 3, 2 }, { 1, 5, 3 }, { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 7, 4, 2 }, { 5, 2, 1 } };
+    std::vector<std::vector<double>> means;
+    std::vector<std::vector<double>> expected;
+    GetMovingStatistics(signal, windowSize, means, expected);
+
+    std::string name = "MovingVarianceNode";
+    TestWithSerialization(map, name, [&](model::Map& map, int iteration) {
+        model::IRMapCompiler compiler;
+        auto compiledMap = compiler.Compile(map);
+
+        // compare output
+        VerifyCompiledOutputAndResult(map, compiledMap, signal, expected, utilities::FormatString("%s iteration %d", name.c_str(), iteration));
+
+        // after a reset, the window starts out empty again
+        map.Reset();
+        compiledMap.Reset();
+        VerifyCompiledOutputAndResult(map, compiledMap, signal, expected, utilities::FormatString("%s after reset iteration %d", name.c_str(), iteration));
+
+        // a constant signal has no variance, and rounding mustn't make it negative
+        map.Reset();
+        compiledMap.Reset();
+        bool nonNegative = true;
+        for (int i = 0; i < 20; ++i)
+        {
+            std::vector<double> sample = { 0.1, 1.0 / 3, 1e6 + 0.1 };
+            map.SetInputValue(0, sample);
+            compiledMap.SetInputValue(0, sample);
+            for (auto variance : map.ComputeOutput<double>(0))
+            {
+                nonNegative = nonNegative && variance >= 0;
+            }
+            for (auto variance : compiledMap.ComputeOutput<double>(0))
+            {
+                nonNegative = nonNegative && variance >= 0;
+            }
+        }
+        testing::ProcessTest(utilities::FormatString("%s of constant signal is non-negative iteration %d", name.c_str(), iteration), nonNegative);
+    });
+}
+
 void TestCompilableDTWDistanceNode()
 {
     model::Model model;
@@ -263,11 +368,48 @@ void TestCompilableDTWDistanceNode()
 
         // compare output
         std::vector<std::vector<double>> signal = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 3, 4, 5 }, { 2, 3, 2 }, { 1, 5, 3 }, { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 7, 4, 2 }, { 5, 2, 1 } };
-        std::vector<std::vector<double>> expected = { { 2.7 }, { 1.35 }, { 0 }, { 1.8 }, { 2.55 }, { 2.25 }, { 2.7 }, { 1.35 }, { 0 }, { 1.65 }, { 2.4 } };
-        VerifyCompiledOutput(map, compiledMap, signal, utilities::FormatString("%s iteration %d", name.c_str(), iteration));
+        std::vector<std::vector<double>> expected = { { 4.05 }, { 1.35 }, { 0 }, { 1.8 }, { 3.9 }, { 3.6 }, { 4.05 }, { 1.35 }, { 0 }, { 1.65 }, { 4.05 } };
+        VerifyCompiledOutputAndResult(map, compiledMap, signal, expected, utilities::FormatString("%s iteration %d", name.c_str(), iteration));
+    });
+}
+
+void TestCompilableDTWDistanceNodeWithBand()
+{
+    model::Model model;
+    std::vector<std::vector<double>> prototype = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 } };
+    auto inputNode = model.AddNode<model::InputNode<double>>(3);
+    auto dtwNode = model.AddNode<DTWDistanceNode<double>>(inputNode->output, prototype, 2);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", dtwNode->output } });
+
+    std::string name = "DTWDistanceNode with band";
+    TestWithSerialization(map, name, [&](model::Map& map, int iteration) {
+        model::IRMapCompiler compiler;
+        auto compiledMap = compiler.Compile(map);
+
+        // The last match stretches the prototype's second row over 4 samples, which is outside the band
+        std::vector<std::vector<double>> signal = { { 1, 2, 3 }, { 1, 2, 3 }, { 1, 2, 3 }, { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 1, 2, 3 }, { 4, 5, 6 }, { 4, 5, 6 }, { 4, 5, 6 }, { 4, 5, 6 }, { 7, 8, 9 } };
+        std::vector<std::vector<double>> expected = { { 4.05 }, { 4.05 }, { 4.05 }, { 4.05 }, { 1.35 }, { 0 }, { 2.7 }, { 1.35 }, { 1.35 }, { 1.35 }, { 1.35 }, { 1.35 } };
+        VerifyCompiledOutputAndResult(map, compiledMap, signal, expected, utilities::FormatString("%s iteration %d", name.c_str(), iteration));
     });
 }
 
+// With a band of 1, the rows a match can't reach yet keep the maximum distance. The first sample is far enough from
+// the prototype that adding its distance to the maximum would overflow to infinity.
+void TestCompilableDTWDistanceNodeWithNarrowBand()
+{
+    model::Model model;
+    std::vector<std::vector<float>> prototype = { { 0, 0 }, { 2, 2 }, { 0, 0 }, { 2, 2 } };
+    auto inputNode = model.AddNode<model::InputNode<float>>(2);
+    auto dtwNode = model.AddNode<DTWDistanceNode<float>>(inputNode->output, prototype, 1);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", dtwNode->output } });
+
+    model::IRMapCompiler compiler;
+    auto compiledMap = compiler.Compile(map);
+
+    std::vector<std::vector<float>> signal = { { 1e38f, 1e38f }, { 0, 0 }, { 2, 2 }, { 2, 2 }, { 0, 0 }, { 2, 2 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 2, 2 }, { 0, 0 }, { 2, 2 } };
+    VerifyCompiledOutput(map, compiledMap, signal, "DTWDistanceNode with narrow band");
+}
+
 class LabeledPrototype
 {
 public:
@@ -1699,7 +1841,7 @@ void TestMatrixVectorMultiplyNode(int m, int n, bool useBlas)
     });
 }
 
-void TestMatrixMatrixMultiplyNode(int m, int n, int k, bool useBlas)
+void TestMatrixMatrixMultiplyNode(int m, int n, int k, bool useBlas, bool parallelize)
 {
     using ValueType = float;
     std::vector<ValueType> matrixBVals(k * n);
@@ -1726,11 +1868,12 @@ void TestMatrixMatrixMultiplyNode(int m, int n, int k, bool useBlas)
 
         model::MapCompilerOptions settings;
         settings.compilerSettings.useBlas = useBlas;
+        settings.compilerSettings.parallelize = parallelize;
         model::ModelOptimizerOptions optimizerOptions;
         model::IRMapCompiler compiler(settings, optimizerOptions);
         auto compiledMap = compiler.Compile(map);
 
-        VerifyCompiledOutput(map, compiledMap, signal, utilities::FormatString("%s iteration %d", name.c_str(), iteration));
+        VerifyCompiledOutput(map, compiledMap, signal, utilities::FormatString("%s%s iteration %d", name.c_str(), parallelize ? " (parallel)" : "", iteration));
     });
 }
 
@@ -11,17 +11,21 @@
 #include <model_testing/include/ModelTestUtilities.h>
 
 #include <model/include/CompilableNode.h>
+#include <model/include/CompilationCache.h>
 #include <model/include/IRCompiledMap.h>
 #include <model/include/IRMapCompiler.h>
 #include <model/include/InputNode.h>
 #include <model/include/Map.h>
 #include <model/include/Model.h>
+#include <model/include/NodeScheduler.h>
 
 #include <nodes/include/AccumulatorNode.h>
+#include <nodes/include/BinaryOperationNode.h>
 #include <nodes/include/ClockNode.h>
 #include <nodes/include/ConstantNode.h>
 #include <nodes/include/DelayNode.h>
 #include <nodes/include/DotProductNode.h>
+#include <nodes/include/FlatForestPredictorNode.h>
 #include <nodes/include/ForestPredictorNode.h>
 #include <nodes/include/L2NormSquaredNode.h>
 #include <nodes/include/LinearPredictorNode.h>
@@ -43,6 +47,8 @@
 #include <predictors/include/LinearPredictor.h>
 #include <predictors/include/ProtoNNPredictor.h>
 
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
 #include <utilities/include/Logger.h>
 #include <utilities/include/RandomEngines.h>
 
@@ -55,6 +61,7 @@
 #include <memory>
 #include <ostream>
 #include <random>
+#include <sstream>
 #include <string>
 #include <thread>
 #include <vector>
@@ -325,6 +332,316 @@ void TestMultiOutputMap()
     testing::ProcessTest("Testing TestMultiOutputMap clone and prune", map.GetModel().Size() == 5);
 }
 
+void TestPortMemoryPlanning(bool optimize)
+{
+    std::vector<double> data = { 2, 3, 4, 5 };
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(4);
+    const auto& c = nodes::Constant(model, data);
+    const auto& sum1 = nodes::Add(inputNode->output, c);
+    const auto& product1 = nodes::Multiply(sum1, c);
+    const auto& sum2 = nodes::Add(product1, c);
+    const auto& product2 = nodes::Multiply(sum2, c);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", product2 } });
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = optimize;
+    settings.planPortMemory = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+    PrintIR(compiledMap);
+
+    auto planner = compiler.GetPortMemoryPlanner();
+    testing::ProcessTest("Testing port memory planner exists", planner != nullptr);
+    testing::ProcessTest("Testing port memory arena is shared", planner->NumBuffers() > 0 && planner->GetArenaSize() < planner->GetUnsharedSize());
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4 }, { 4, 5, 6, 7 }, { 7, 8, 9, 10 }, { 3, 4, 5, 6 }, { 2, 3, 2, 1 } };
+    VerifyCompiledOutput(map, compiledMap, signal, optimize ? " planned port memory (optimized)" : " planned port memory");
+}
+
+void TestForestFlattening(bool flattenForests)
+{
+    auto map = MakeForestMap();
+
+    model::MapCompilerOptions settings;
+    settings.flattenForests = flattenForests;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+
+    int numFlatForestNodes = 0;
+    compiledMap.GetModel().Visit([&numFlatForestNodes](const model::Node& node) {
+        if (node.GetRuntimeTypeName() == nodes::FlatForestPredictorNode::GetTypeName())
+        {
+            ++numFlatForestNodes;
+        }
+    });
+    const std::string suffix = flattenForests ? " (flattened)" : " (not flattened)";
+    testing::ProcessTest("Testing forest refinement" + suffix, numFlatForestNodes == (flattenForests ? 1 : 0));
+
+    std::vector<std::vector<double>> signal = { { 0.2, 0.5, 0.0 }, { 0.1, 0.65, 1.0 }, { 0.5, 0.3, 0.95 }, { 0.25, 0.75, 0.5 } };
+    VerifyCompiledOutput(map, compiledMap, signal, "forest" + suffix);
+}
+
+void TestParallelBranches(bool optimize)
+{
+    // Two independent branches, each big enough to be worth running on its own thread, joined by a final add
+    const int size = 2048;
+    std::vector<double> data(size);
+    for (int index = 0; index < size; ++index)
+    {
+        data[index] = (index % 7) - 3;
+    }
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(size);
+    const auto& c = nodes::Constant(model, data);
+    const auto& sum1 = nodes::Add(inputNode->output, c);
+    const auto& product1 = nodes::Multiply(sum1, c);
+    const auto& product2 = nodes::Multiply(inputNode->output, c);
+    const auto& sum2 = nodes::Add(product2, inputNode->output);
+    const auto& result = nodes::Add(product1, sum2);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", result } });
+
+    model::NodeScheduler scheduler(map.GetModel());
+    testing::ProcessTest("Testing node scheduler finds parallel branches", scheduler.NumParallelStages() == 1);
+    testing::ProcessTest("Testing critical path length", scheduler.GetCriticalPath().size() == 4 && scheduler.GetCriticalPathCost() == 3 * size);
+    testing::ProcessTest("Testing critical path cost", scheduler.GetCriticalPathCost() < scheduler.GetTotalCost());
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = optimize;
+    settings.compilerSettings.parallelize = true;
+    settings.parallelizeBranches = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+    PrintIR(compiledMap);
+
+    std::vector<std::vector<double>> signal;
+    for (int example = 0; example < 5; ++example)
+    {
+        std::vector<double> input(size);
+        for (int index = 0; index < size; ++index)
+        {
+            input[index] = ((index + example) % 5) - 2;
+        }
+        signal.push_back(input);
+    }
+    VerifyCompiledOutput(map, compiledMap, signal, optimize ? " parallel branches (optimized)" : " parallel branches");
+}
+
+void TestExternalWeights(bool optimize)
+{
+    // Big enough to be stored in the external weights
+    const int size = 512;
+    std::vector<double> data(size);
+    for (int index = 0; index < size; ++index)
+    {
+        data[index] = (index % 5) - 2;
+    }
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(size);
+    const auto& c = nodes::Constant(model, data);
+    const auto& product = nodes::Multiply(inputNode->output, c);
+    const auto& sum = nodes::Add(product, c);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", sum } });
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = optimize;
+    settings.compilerSettings.externalWeights = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+    PrintIR(compiledMap);
+
+    const auto& weights = compiledMap.GetModule().GetExternalWeights();
+    testing::ProcessTest("Testing constant is stored in the external weights", compiledMap.GetModule().HasExternalWeights() && weights.size() == size * sizeof(double));
+
+    std::stringstream header;
+    compiledMap.WriteCodeHeader(header, emitters::ModuleOutputFormat::cHeader);
+    testing::ProcessTest("Testing header declares the weights functions", header.str().find("_SetWeights(char* weights)") != std::string::npos && header.str().find("_LoadWeights(const char* path)") != std::string::npos);
+
+    std::vector<std::vector<double>> signal;
+    for (int example = 0; example < 5; ++example)
+    {
+        std::vector<double> input(size);
+        for (int index = 0; index < size; ++index)
+        {
+            input[index] = ((index + example) % 7) - 3;
+        }
+        signal.push_back(input);
+    }
+    VerifyCompiledOutput(map, compiledMap, signal, optimize ? " external weights (optimized)" : " external weights");
+}
+
+void TestCompilationCache()
+{
+    auto makeMap = [](bool subtract) {
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<double>>(4);
+        const auto& c = nodes::Constant(model, std::vector<double>{ 1.0, -2.0, 3.0, 0.5 });
+        const auto& product = nodes::Multiply(inputNode->output, c);
+        const auto& result = subtract ? nodes::Subtract(product, c) : nodes::Add(product, c);
+        return model::Map(model, { { "input", inputNode } }, { { "output", result } });
+    };
+    auto map = makeMap(false);
+
+    const std::string cacheDirectory = "compilation_cache_test";
+    utilities::DeleteDirectory(cacheDirectory);
+
+    model::MapCompilerOptions settings;
+    settings.compilationCache = cacheDirectory;
+    settings.inlineNodes = false;
+    model::ModelOptimizerOptions optimizerOptions;
+
+    // The first compilation fills the cache
+    model::IRMapCompiler compiler1(settings, optimizerOptions);
+    auto compiledMap1 = compiler1.Compile(map);
+    auto cache1 = compiler1.GetCompilationCache();
+    testing::ProcessTest("Testing compilation cache misses on first compile", cache1 != nullptr && cache1->NumHits() == 0 && cache1->NumMisses() > 0);
+
+    // The second one finds all its node functions there
+    model::IRMapCompiler compiler2(settings, optimizerOptions);
+    auto compiledMap2 = compiler2.Compile(map);
+    auto cache2 = compiler2.GetCompilationCache();
+    testing::ProcessTest("Testing compilation cache hits on recompile", cache2 != nullptr && cache2->NumHits() > 0 && cache2->NumMisses() == 0);
+    PrintIR(compiledMap2);
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4 }, { -1, 0, 2, 5 }, { 3, 3, -3, 1 } };
+    VerifyCompiledOutput(map, compiledMap2, signal, " with compilation cache");
+
+    // Changing an option that affects the emitted code invalidates the entries
+    auto changedSettings = settings;
+    changedSettings.compilerSettings.useFastMath = !settings.compilerSettings.useFastMath;
+    model::IRMapCompiler compiler3(changedSettings, optimizerOptions);
+    auto compiledMap3 = compiler3.Compile(map);
+    auto cache3 = compiler3.GetCompilationCache();
+    testing::ProcessTest("Testing compilation cache misses after changing options", cache3 != nullptr && cache3->NumHits() == 0 && cache3->NumMisses() > 0);
+
+    // So does changing the parameters of a node with state
+    auto changedMap = makeMap(true);
+    model::IRMapCompiler compiler4(settings, optimizerOptions);
+    auto compiledMap4 = compiler4.Compile(changedMap);
+    auto cache4 = compiler4.GetCompilationCache();
+    testing::ProcessTest("Testing compilation cache misses after changing node parameters", cache4 != nullptr && cache4->NumMisses() > 0);
+    VerifyCompiledOutput(changedMap, compiledMap4, signal, " with compilation cache and changed node parameters");
+
+    utilities::DeleteDirectory(cacheDirectory);
+}
+
+void TestParallelOptimization()
+{
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(4);
+    const auto& c = nodes::Constant(model, std::vector<double>{ 1.0, -2.0, 3.0, 0.5 });
+    const auto& product = nodes::Multiply(inputNode->output, c);
+    const auto& sum = nodes::Add(product, c);
+    const auto& difference = nodes::Subtract(sum, inputNode->output);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", difference } });
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = true;
+    settings.compilerSettings.numCompilerThreads = 4;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+    PrintIR(compiledMap);
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4 }, { -1, 0, 2, 5 }, { 3, 3, -3, 1 } };
+    VerifyCompiledOutput(map, compiledMap, signal, " with parallel optimization");
+}
+
+void TestCompiledMapThreadSafe()
+{
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(3);
+    auto accumNode = model.AddNode<nodes::AccumulatorNode<double>>(inputNode->output);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", accumNode->output } });
+    std::vector<std::vector<double>> signal = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 3, 4, 5 }, { 2, 3, 2 }, { 1, 5, 3 }, { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 7, 4, 2 }, { 5, 2, 1 } };
+
+    // get original map output as gold standard
+    std::vector<std::vector<double>> expected;
+    for (const auto& input : signal)
+    {
+        map.SetInputValue(0, input);
+        expected.push_back(map.ComputeOutput<double>(0));
+    }
+
+    // Every thread shares the same jitted code, but uses its own context with a copy of the accumulator state
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.threadSafe = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+    compiledMap.FinishJitting();
+
+    const int numThreads = 16;
+    const int numRepetitions = 100;
+    std::vector<std::future<bool>> futures;
+    for (int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+    {
+        futures.push_back(std::async(std::launch::async, [&]() {
+            bool ok = true;
+            auto modelContext = compiledMap.CreateModelContext();
+            for (int repetition = 0; repetition < numRepetitions; ++repetition)
+            {
+                compiledMap.Reset(modelContext);
+                for (size_t i = 0; i < signal.size(); ++i)
+                {
+                    std::vector<double> output(expected[i].size());
+                    compiledMap.ComputeMultiple(modelContext, { const_cast<double*>(signal[i].data()) }, { output.data() });
+                    ok = ok && testing::IsEqual(output, expected[i]);
+                }
+            }
+            compiledMap.DestroyModelContext(modelContext);
+            return ok;
+        }));
+    }
+
+    bool ok = true;
+    for (auto& fut : futures)
+    {
+        ok = fut.get() && ok;
+    }
+    testing::ProcessTest("Testing thread-safe compiled map called from multiple threads", ok);
+
+    // The default state, used without a context, isn't affected by the threads' contexts
+    compiledMap.Reset();
+    std::vector<double> output(expected[0].size());
+    compiledMap.ComputeMultiple({ const_cast<double*>(signal[0].data()) }, { output.data() });
+    testing::ProcessTest("Testing thread-safe compiled map default context", testing::IsEqual(output, expected[0]));
+
+    // A new context starts from the initial state, even after the default state has moved on
+    for (size_t i = 1; i < signal.size(); ++i)
+    {
+        compiledMap.ComputeMultiple({ const_cast<double*>(signal[i].data()) }, { output.data() });
+    }
+    auto freshContext = compiledMap.CreateModelContext();
+    bool freshOk = true;
+    for (size_t i = 0; i < signal.size(); ++i)
+    {
+        compiledMap.ComputeMultiple(freshContext, { const_cast<double*>(signal[i].data()) }, { output.data() });
+        freshOk = freshOk && testing::IsEqual(output, expected[i]);
+    }
+    compiledMap.DestroyModelContext(freshContext);
+    testing::ProcessTest("Testing thread-safe compiled map new context starts from the initial state", freshOk);
+
+    bool threw = false;
+    try
+    {
+        settings.compilerSettings.parallelize = true;
+        model::IRMapCompiler parallelCompiler(settings, optimizerOptions);
+    }
+    catch (const utilities::InputException&)
+    {
+        threw = true;
+    }
+    testing::ProcessTest("Testing threadSafe can't be combined with parallelize", threw);
+}
+
 void TestCompiledMapMove()
 {
     model::Model model;
@@ -71,6 +71,17 @@ void TestIRCompiler()
     TestCompiledMapMove();
     TestCompiledMapClone();
     TestCompiledMapParallelClone();
+    TestPortMemoryPlanning(false);
+    TestPortMemoryPlanning(true);
+    TestForestFlattening(false);
+    TestForestFlattening(true);
+    TestCompiledMapThreadSafe();
+    TestParallelBranches(false);
+    TestParallelBranches(true);
+    TestExternalWeights(false);
+    TestExternalWeights(true);
+    TestCompilationCache();
+    TestParallelOptimization();
 
     TestBinaryScalar();
     TestBinaryVector(true);
@@ -94,6 +105,8 @@ void TestIRCompiler()
     TestMatrixVectorMultiplyNode(10, 5, false);
     TestMatrixMatrixMultiplyNode(4, 5, 6, true);
     TestMatrixMatrixMultiplyNode(4, 5, 6, false);
+    TestMatrixMatrixMultiplyNode(4, 5, 6, false, true);
+    TestMatrixMatrixMultiplyNode(37, 5, 6, false, true);
 
     // Using BLAS
     TestOrderedMatrixMatrixMultiplyNode(4, 5, 6, false, false, false, true);
@@ -124,7 +137,11 @@ void TestIRCompiler()
     TestCompilableAccumulatorNode();
     TestCompilableDotProductNode();
     TestCompilableDelayNode();
+    TestCompilableMovingAverageNode();
+    TestCompilableMovingVarianceNode();
     TestCompilableDTWDistanceNode();
+    TestCompilableDTWDistanceNodeWithBand();
+    TestCompilableDTWDistanceNodeWithNarrowBand();
     TestCompilableMulticlassDTW();
     TestCompilableScalarSumNode();
     TestCompilableSumNode();
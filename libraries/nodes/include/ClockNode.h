@@ -84,6 +84,7 @@ namespace nodes
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
 
         bool HasState() const override { return true; } // stored state: interval, lag threshold, lag function name
+        bool CanCacheCompiledFunction(model::IRMapCompiler& compiler) const override { return false; } // compiling emits module-level functions and declares the lag callback
 
     private:
         void Copy(model::ModelTransformer& transformer) const override;
@@ -20,6 +20,7 @@
 
 #include <predictors/include/ConstantPredictor.h>
 
+#include <utilities/include/ArrayView.h>
 #include <utilities/include/IArchivable.h>
 #include <utilities/include/TypeName.h>
 #include <utilities/include/TypeTraits.h>
@@ -67,10 +68,16 @@ namespace nodes
         /// <param name="layout"> The memory layout of the output data </param>
         ConstantNode(const std::vector<ValueType>& value, const model::PortMemoryLayout& layout);
 
+        /// Constructor for an arbitrary-shaped array constant that shares its values with another node or an archive
+        ///
+        /// <param name="value"> The view of the values </param>
+        /// <param name="layout"> The memory layout of the output data </param>
+        ConstantNode(const utilities::ArrayView<ValueType>& value, const model::PortMemoryLayout& layout);
+
         /// <summary> Gets the values contained in this node </summary>
         ///
-        /// <returns> The values contained in this node </returns>
-        const std::vector<ValueType>& GetValues() const { return _values; }
+        /// <returns> A view of the values contained in this node, which may point into a memory-mapped archive </returns>
+        const utilities::ArrayView<ValueType>& GetValues() const { return _values; }
 
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
@@ -98,8 +105,8 @@ namespace nodes
         // Output
         model::OutputPort<ValueType> _output;
 
-        // Constant value
-        std::vector<ValueType> _values;
+        // Constant value, which may refer to an array in a memory-mapped archive
+        utilities::ArrayView<ValueType> _values;
     };
 
     /// <summary> Convenience function for adding a ConstantNode to a model. </summary>
@@ -170,7 +177,7 @@ namespace nodes
     ConstantNode<ValueType>::ConstantNode(ValueType value) :
         CompilableNode({}, { &_output }),
         _output(this, defaultOutputPortName, 1),
-        _values({ value }){};
+        _values(std::vector<ValueType>{ value }){};
 
     // Constructor for a vector constant
     template <typename ValueType>
@@ -191,6 +198,12 @@ namespace nodes
         _output(this, defaultOutputPortName, layout),
         _values(values){};
 
+    template <typename ValueType>
+    ConstantNode<ValueType>::ConstantNode(const utilities::ArrayView<ValueType>& values, const model::PortMemoryLayout& layout) :
+        CompilableNode({}, { &_output }),
+        _output(this, defaultOutputPortName, layout),
+        _values(values){};
+
     template <typename ValueType>
     void ConstantNode<ValueType>::Compute() const
     {
@@ -207,9 +220,8 @@ namespace nodes
     template <typename ValueType>
     void ConstantNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
-        auto values = this->GetValues();
         emitters::Variable* pVar = nullptr;
-        pVar = function.GetModule().Variables().AddVariable<emitters::LiteralVectorVariable<ValueType>>(values);
+        pVar = function.GetModule().Variables().AddVariable<emitters::LiteralVectorVariable<ValueType>>(_values.ToVector());
         compiler.SetVariableForPort(output, pVar); // Just set the variable corresponding to the output port to be the global variable we created
     }
 
@@ -229,7 +241,7 @@ namespace nodes
     void ConstantNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
     {
         Node::WriteToArchive(archiver);
-        archiver["values"] << _values;
+        archiver["values"] << _values.ToVector();
         archiver["layout"] << _output.GetMemoryLayout();
     }
 
@@ -237,10 +249,15 @@ namespace nodes
     void ConstantNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
     {
         Node::ReadFromArchive(archiver);
-        archiver["values"] >> _values;
+        if (!archiver.TryUnarchiveArrayView("values", _values))
+        {
+            std::vector<ValueType> values;
+            archiver["values"] >> values;
+            _values = utilities::ArrayView<ValueType>(std::move(values));
+        }
         model::PortMemoryLayout layout;
         archiver["layout"] >> layout;
-        _output.SetMemoryLayout(layout);        
+        _output.SetMemoryLayout(layout);
     }
 
     template <typename ValueType, typename ModelLikeType>
@@ -49,7 +49,9 @@ namespace nodes
         ///
         /// <param name="input"> The signals to compare to the prototype </param>
         /// <param name="prototype"> The prototype </param>
-        DTWDistanceNode(const model::OutputPort<ValueType>& input, const std::vector<std::vector<ValueType>>& prototype);
+        /// <param name="bandWidth"> The width of the Sakoe-Chiba band: the most that the number of input samples a match has used
+        /// may differ from the number of prototype samples it has used. Zero (the default) means the warping isn't constrained. </param>
+        DTWDistanceNode(const model::OutputPort<ValueType>& input, const std::vector<std::vector<ValueType>>& prototype, size_t bandWidth = 0);
 
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
@@ -64,6 +66,9 @@ namespace nodes
         /// <summary></summary>
         std::vector<std::vector<ValueType>> GetPrototype() const { return _prototype; }
 
+        /// <summary> Gets the width of the Sakoe-Chiba band, or zero if the warping isn't constrained </summary>
+        size_t GetBandWidth() const { return _bandWidth; }
+
         /// <summary> Reset the state of the node </summary>
         void Reset() override;
 
@@ -85,6 +90,7 @@ namespace nodes
         size_t _sampleDimension;
         size_t _prototypeLength;
         std::vector<std::vector<ValueType>> _prototype;
+        size_t _bandWidth = 0;
         // double _threshold;
         double _prototypeVariance;
 
@@ -99,6 +105,7 @@ namespace nodes
 
 #include <emitters/include/IRLocalScalar.h>
 
+#include <cstdlib>
 #include <limits>
 
 namespace ell
@@ -138,11 +145,12 @@ namespace nodes
     }
 
     template <typename ValueType>
-    DTWDistanceNode<ValueType>::DTWDistanceNode(const model::OutputPort<ValueType>& input, const std::vector<std::vector<ValueType>>& prototype) :
+    DTWDistanceNode<ValueType>::DTWDistanceNode(const model::OutputPort<ValueType>& input, const std::vector<std::vector<ValueType>>& prototype, size_t bandWidth) :
         CompilableNode({ &_input }, { &_output }),
         _input(this, input, defaultInputPortName),
         _output(this, defaultOutputPortName, 1),
-        _prototype(prototype)
+        _prototype(prototype),
+        _bandWidth(bandWidth)
     {
         // _threshold = std::sqrt(-2 * std::log(confidenceThreshold)) * _prototypeVariance;
         Reset();
@@ -179,9 +187,17 @@ namespace nodes
     {
         std::vector<ValueType> input = _input.GetValue();
         auto t = ++_currentTime;
+        // The previous column's values for row 0: a match can start at any time
         auto dLast = _d[0] = 0;
         auto sLast = _s[0] = t;
 
+        // A match started at time `start` can only be extended to prototype row `index` if the number of input samples
+        // it then uses is within the band around `index`
+        const auto bandWidth = static_cast<int>(_bandWidth);
+        auto isInBand = [t, bandWidth](int start, size_t index) {
+            return bandWidth == 0 || std::abs(t - start + 1 - static_cast<int>(index)) <= bandWidth;
+        };
+
         ValueType bestDist = 0;
         int bestStart = 0;
         for (size_t index = 1; index < _prototypeLength + 1; ++index)
@@ -192,20 +208,32 @@ namespace nodes
             auto s_iMinus1 = _s[index - 1];
             auto sPrev_iMinus1 = sLast;
             auto sPrev_i = _s[index];
+            dLast = dPrev_i;
+            sLast = sPrev_i;
 
-            bestDist = d_iMinus1;
-            bestStart = s_iMinus1;
-            if (dPrev_i < bestDist)
+            bestDist = std::numeric_limits<ValueType>::max();
+            bestStart = t;
+            if (d_iMinus1 < bestDist && isInBand(s_iMinus1, index))
+            {
+                bestDist = d_iMinus1;
+                bestStart = s_iMinus1;
+            }
+            if (dPrev_i < bestDist && isInBand(sPrev_i, index))
             {
                 bestDist = dPrev_i;
                 bestStart = sPrev_i;
             }
-            if (dPrev_iMinus1 < bestDist)
+            if (dPrev_iMinus1 < bestDist && isInBand(sPrev_iMinus1, index))
             {
                 bestDist = dPrev_iMinus1;
                 bestStart = sPrev_iMinus1;
             }
-            bestDist += distance(_prototype[index - 1], input);
+
+            // No match reaches this cell, so there's no need to compute its distance
+            if (bestDist != std::numeric_limits<ValueType>::max())
+            {
+                bestDist += distance(_prototype[index - 1], input);
+            }
 
             _d[index] = bestDist;
             _s[index] = bestStart;
@@ -228,7 +256,7 @@ namespace nodes
     void DTWDistanceNode<ValueType>::Copy(model::ModelTransformer& transformer) const
     {
         const auto& newinput = transformer.GetCorrespondingInputs(_input);
-        auto newNode = transformer.AddNode<DTWDistanceNode<ValueType>>(newinput, _prototype);
+        auto newNode = transformer.AddNode<DTWDistanceNode<ValueType>>(newinput, _prototype, _bandWidth);
         transformer.MapNodeOutput(output, newNode->output);
     }
 
@@ -260,52 +288,111 @@ namespace nodes
         // The prototype (constant)
         emitters::Variable* pVarPrototype = function.GetModule().Variables().AddVariable<emitters::LiteralVectorVariable<ValueType>>(GetPrototypeData());
 
-        // Global variables for the dynamic programming memory
-        emitters::Variable* pVarD = function.GetModule().Variables().AddVariable<emitters::InitializedVectorVariable<ValueType>>(emitters::VariableScope::global, _prototypeLength + 1);
+        // Global variables for the dynamic programming memory, starting in the same state as after Reset()
+        auto& module = function.GetModule();
+        std::vector<ValueType> initialD(_prototypeLength + 1, std::numeric_limits<ValueType>::max());
+        initialD[0] = 0;
+        emitters::Variable* pVarD = module.Variables().AddVariable<emitters::InitializedVectorVariable<ValueType>>(emitters::VariableScope::global, initialD);
 
         // get global state vars
-        auto prototypeVector = function.LocalArray(function.GetModule().EnsureEmitted(*pVarPrototype));
-        auto pD = function.LocalArray(function.GetModule().EnsureEmitted(*pVarD));
+        auto prototypeVector = function.LocalArray(module.EnsureEmitted(*pVarPrototype));
+        auto pD = function.LocalArray(module.EnsureEmitted(*pVarD));
+
+        // The distances from the input to each prototype row don't depend on each other, so they're computed up front
+        // in a loop nest that can be vectorized, which leaves only the minimum over the predecessors in the sequential loop
+        auto sampleDimension = static_cast<int>(_sampleDimension);
+        auto distances = function.LocalArray(function.Variable(inputType, static_cast<int>(_prototypeLength)));
+        function.For(_prototypeLength, [distances, input, prototypeVector, sampleDimension](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar i) {
+            auto rowOffset = i * sampleDimension;
+            distances[i] = function.LocalScalar<ValueType>(0);
+            function.For(sampleDimension, [distances, input, prototypeVector, i, rowOffset](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar j) {
+                auto absDiff = emitters::Abs(input[j] - prototypeVector[rowOffset + j]);
+                distances[i] = static_cast<emitters::IRLocalScalar>(distances[i]) + absDiff;
+            });
+        });
 
         // incorrect usage of function.Variable --- should use IRModuleEmitter::EmitX(variable)
-        auto dist = function.Variable(inputType, "dist");
-        auto protoIndex = function.Variable(emitters::VariableType::Int32, "i");
         auto dLast = function.Variable(inputType, "dLast");
         auto bestDist = function.Variable(inputType, "bestDist");
 
         // initialize variables
-        function.StoreZero(protoIndex);
         function.StoreZero(dLast);
 
-        function.For(_prototypeLength, [pD, dLast, bestDist, dist, protoIndex, input, prototypeVector, this](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar iMinusOne) {
-            auto i = iMinusOne + 1;
-            auto d_iMinus1 = pD[iMinusOne];
-            auto dPrev_iMinus1 = function.LocalScalar(function.Load(dLast));
-            auto dPrev_i = pD[i];
-
-            function.Store(bestDist, static_cast<emitters::IRLocalScalar>(d_iMinus1));
-
-            function.If(dPrev_i < d_iMinus1, [bestDist, dPrev_i](auto& function) {
-                function.Store(bestDist, static_cast<emitters::IRLocalScalar>(dPrev_i));
-            });
-
-            function.If(dPrev_iMinus1 < function.Load(bestDist), [bestDist, dPrev_iMinus1](auto& function) {
-                function.Store(bestDist, dPrev_iMinus1);
+        if (_bandWidth == 0)
+        {
+            function.For(_prototypeLength, [pD, dLast, bestDist, distances](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar iMinusOne) {
+                auto i = iMinusOne + 1;
+                auto d_iMinus1 = static_cast<emitters::IRLocalScalar>(pD[iMinusOne]);
+                auto dPrev_iMinus1 = function.LocalScalar(function.Load(dLast));
+                auto dPrev_i = static_cast<emitters::IRLocalScalar>(pD[i]);
+                function.Store(dLast, dPrev_i);
+
+                function.Store(bestDist, d_iMinus1);
+                function.If(dPrev_i < function.Load(bestDist), [bestDist, dPrev_i](auto& function) {
+                    function.Store(bestDist, dPrev_i);
+                });
+                function.If(dPrev_iMinus1 < function.Load(bestDist), [bestDist, dPrev_iMinus1](auto& function) {
+                    function.Store(bestDist, dPrev_iMinus1);
+                });
+
+                auto newDist = function.LocalScalar(function.Load(bestDist)) + distances[iMinusOne];
+                function.Store(bestDist, newDist); // x += dist;
+                pD[i] = newDist; // d[i] = x;
             });
-
-            // Get dist
-            function.StoreZero(dist);
-            function.For(_sampleDimension, [dist, protoIndex, input, prototypeVector](emitters::IRFunctionEmitter& function, auto j) {
-                auto inputValue = input[j];
-                auto protoValue = prototypeVector[function.LocalScalar(function.Load(protoIndex))];
-                auto absDiff = emitters::Abs(inputValue - protoValue);
-                function.OperationAndUpdate(dist, emitters::GetAddForValueType<ValueType>(), absDiff);
-                function.OperationAndUpdate(protoIndex, emitters::TypedOperator::add, function.Literal(1));
+        }
+        else
+        {
+            // The start times of the matches, and the current time, which are needed to check the band
+            emitters::Variable* pVarS = module.Variables().AddVariable<emitters::InitializedVectorVariable<int>>(emitters::VariableScope::global, _prototypeLength + 1);
+            auto pS = function.LocalArray(module.EnsureEmitted(*pVarS));
+            auto currentTime = module.Global<int>(compiler.GetGlobalName(*this, "currentTime"), 0);
+
+            auto t = function.LocalScalar(function.Load(currentTime)) + 1;
+            function.Store(currentTime, t);
+            pS[0] = t;
+
+            auto sLast = function.Variable(emitters::VariableType::Int32, "sLast");
+            auto bestStart = function.Variable(emitters::VariableType::Int32, "bestStart");
+            function.Store(sLast, t);
+
+            auto bandWidth = static_cast<int>(_bandWidth);
+            function.For(_prototypeLength, [pD, pS, dLast, sLast, bestDist, bestStart, distances, t, bandWidth](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar iMinusOne) {
+                auto i = iMinusOne + 1;
+                auto d_iMinus1 = static_cast<emitters::IRLocalScalar>(pD[iMinusOne]);
+                auto s_iMinus1 = static_cast<emitters::IRLocalScalar>(pS[iMinusOne]);
+                auto dPrev_iMinus1 = function.LocalScalar(function.Load(dLast));
+                auto sPrev_iMinus1 = function.LocalScalar(function.Load(sLast));
+                auto dPrev_i = static_cast<emitters::IRLocalScalar>(pD[i]);
+                auto sPrev_i = static_cast<emitters::IRLocalScalar>(pS[i]);
+                function.Store(dLast, dPrev_i);
+                function.Store(sLast, sPrev_i);
+
+                // The starts of the matches that can be extended to row i
+                auto bandCenter = t + 1 - i;
+                auto bandBegin = bandCenter - bandWidth;
+                auto bandEnd = bandCenter + bandWidth;
+
+                function.Store(bestDist, function.Literal(std::numeric_limits<ValueType>::max()));
+                function.Store(bestStart, t);
+                auto extend = [bestDist, bestStart, bandBegin, bandEnd](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar d, emitters::IRLocalScalar s) {
+                    function.If(d < function.Load(bestDist) && s >= bandBegin && s <= bandEnd, [bestDist, bestStart, d, s](auto& function) {
+                        function.Store(bestDist, d);
+                        function.Store(bestStart, s);
+                    });
+                };
+                extend(function, d_iMinus1, s_iMinus1);
+                extend(function, dPrev_i, sPrev_i);
+                extend(function, dPrev_iMinus1, sPrev_iMinus1);
+
+                // If no match reaches this cell, its distance stays at the maximum value, as in Compute()
+                auto predecessorDist = function.LocalScalar(function.Load(bestDist));
+                auto isReached = predecessorDist != std::numeric_limits<ValueType>::max();
+                auto newDist = function.LocalScalar(function.Select(isReached, predecessorDist + distances[iMinusOne], predecessorDist));
+                function.Store(bestDist, newDist);
+                pD[i] = newDist;
+                pS[i] = function.Load(bestStart);
             });
-
-            function.OperationAndUpdate(bestDist, emitters::GetAddForValueType<ValueType>(), function.Load(dist)); // x += dist;
-            pD[i] = function.Load(bestDist); // d[i] = x;
-        });
+        }
 
         function.Store(result, function.Load(bestDist) / function.LocalScalar<ValueType>(_prototypeVariance));
     }
@@ -330,6 +417,7 @@ namespace nodes
         archiver["prototype_columns"] << numColumns;
         math::Matrix<double, math::MatrixLayout::columnMajor> temp(numRows, numColumns, elements);
         math::MatrixArchiver::Write(temp, "prototype", archiver);
+        archiver["bandWidth"] << _bandWidth;
     }
 
     template <typename ValueType>
@@ -348,6 +436,7 @@ namespace nodes
         {
             _prototype.emplace_back(temp.GetRow(i).ToArray());
         }
+        archiver.OptionalProperty("bandWidth", size_t(0)) >> _bandWidth;
         Reset();
     }
 } // namespace nodes
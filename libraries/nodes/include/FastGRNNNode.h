@@ -75,6 +75,8 @@ namespace nodes
         /// <param name="nu"> The second learnable scalar added to the zeta(1-zt) term. </param>
         /// <param name="gateActivation"> The activation function applied to the gate. </param>
         /// <param name="updateActivation"> The activation function applied to the state update. </param>
+        /// <param name="sequenceLength"> The number of timesteps in the input. The input holds a row of features for each
+        /// timestep, and the output holds the hidden state after each one. </param>
         FastGRNNNode(const model::OutputPort<ElementType>& input,
                      const model::OutputPortBase& resetTrigger,
                      size_t hiddenUnits,
@@ -89,7 +91,8 @@ namespace nodes
                      const model::OutputPort<ElementType>& zeta,
                      const model::OutputPort<ElementType>& nu,
                      const ActivationType& gateActivation,
-                     const ActivationType& updateActivation);
+                     const ActivationType& updateActivation,
+                     size_t sequenceLength = 1);
 
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
@@ -101,6 +104,9 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Gets the number of timesteps in the input. </summary>
+        size_t GetSequenceLength() const { return _sequenceLength; }
+
     protected:
         void Define(ell::value::FunctionDeclaration& fn) override;
         void DefineReset(ell::value::FunctionDeclaration& fn) override;
@@ -127,6 +133,7 @@ namespace nodes
         model::OutputPort<ElementType> _output;
         ActivationType _gateActivation;
         ActivationType _updateActivation;
+        size_t _sequenceLength;
 
     private:
         value::Vector _hiddenState;
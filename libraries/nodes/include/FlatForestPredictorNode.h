@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FlatForestPredictorNode.h (nodes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputPort.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/OutputPort.h>
+
+#include <predictors/include/FlatForestPredictor.h>
+
+#include <string>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A node that evaluates a forest stored in the flat layout of `FlatForestPredictor`. It has the same outputs as
+    /// `SimpleForestPredictorNode`, which refines into this node when it is being compiled. The compiled code walks
+    /// each tree in a loop over constant arrays, instead of evaluating every split of the forest.
+    /// </summary>
+    class FlatForestPredictorNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        static constexpr const char* treeOutputsPortName = "treeOutputs";
+        static constexpr const char* edgeIndicatorVectorPortName = "edgeIndicatorVector";
+        const model::InputPort<double>& input = _input;
+        const model::OutputPort<double>& output = _output;
+        const model::OutputPort<double>& treeOutputs = _treeOutputs;
+        const model::OutputPort<bool>& edgeIndicatorVector = _edgeIndicatorVector;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        FlatForestPredictorNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The predictor's input. </param>
+        /// <param name="forest"> The flattened forest. </param>
+        FlatForestPredictorNode(const model::OutputPort<double>& input, const predictors::FlatForestPredictor& forest);
+
+        /// <summary> Gets the forest. </summary>
+        const predictors::FlatForestPredictor& GetForest() const { return _forest; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return "FlatForestPredictorNode"; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+
+        // Input
+        model::InputPort<double> _input;
+
+        // Outputs
+        model::OutputPort<double> _output;
+        model::OutputPort<double> _treeOutputs;
+        model::OutputPort<bool> _edgeIndicatorVector;
+
+        // Forest
+        predictors::FlatForestPredictor _forest;
+    };
+} // namespace nodes
+} // namespace ell
@@ -11,11 +11,12 @@
 #include "BinaryOperationNode.h"
 #include "ConstantNode.h"
 #include "DemultiplexerNode.h"
-#include "ForestPredictorNode.h"
+#include "FlatForestPredictorNode.h"
 #include "MultiplexerNode.h"
 #include "SingleElementThresholdNode.h"
 #include "SumNode.h"
 
+#include <model/include/MapCompiler.h>
 #include <model/include/Model.h>
 #include <model/include/ModelTransformer.h>
 #include <model/include/Node.h>
@@ -25,6 +26,7 @@
 
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace ell
@@ -169,6 +171,21 @@ namespace nodes
     bool ForestPredictorNode<SplitRuleType, EdgePredictorType>::Refine(model::ModelTransformer& transformer) const
     {
         const auto& newPortElements = transformer.GetCorrespondingInputs(_input);
+
+        // When compiling a simple forest, evaluate it with a loop over the flattened trees instead of a node per split
+        if constexpr (std::is_same_v<ForestPredictor, predictors::SimpleForestPredictor>)
+        {
+            const auto* compiler = transformer.GetContext().GetCompiler();
+            if (compiler != nullptr && compiler->GetMapCompilerOptions(*this).flattenForests)
+            {
+                auto flatNode = transformer.AddNode<FlatForestPredictorNode>(newPortElements, predictors::FlatForestPredictor(_forest));
+                transformer.MapNodeOutput(output, flatNode->output);
+                transformer.MapNodeOutput(treeOutputs, flatNode->treeOutputs);
+                transformer.MapNodeOutput(edgeIndicatorVector, flatNode->edgeIndicatorVector);
+                return true;
+            }
+        }
+
         const auto& interiorNodes = _forest.GetInteriorNodes();
 
         // create a place to store references to the output ports of the sub-models at each interior node
@@ -50,6 +50,8 @@ namespace nodes
         /// <param name="activation"> The activation function. </param>
         /// <param name="recurrentActivation"> The recurrent activation function. </param>
         /// <param name="validateWeights"> Whether to check the size of the weights. </param>
+        /// <param name="sequenceLength"> The number of timesteps in the input. The input holds a row of features for each
+        /// timestep, and the output holds the hidden state after each one. </param>
         LSTMNode(const model::OutputPort<ValueType>& input,
                  const model::OutputPortBase& resetTrigger,
                  size_t hiddenUnits,
@@ -59,7 +61,8 @@ namespace nodes
                  const model::OutputPort<ValueType>& hiddenBias,
                  const ActivationType& activation,
                  const ActivationType& recurrentActivation,
-                 bool validateWeights = true);
+                 bool validateWeights = true,
+                 size_t sequenceLength = 1);
 
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
@@ -29,6 +29,7 @@
 #include <value/include/Matrix.h>
 #include <value/include/Scalar.h>
 #include <value/include/ScalarOperations.h>
+#include <value/include/ScheduleTuner.h>
 #include <value/include/loopnests/CodeGenerator.h>
 #include <value/include/loopnests/Kernel.h>
 #include <value/include/loopnests/LoopNest.h>
@@ -227,6 +228,9 @@ namespace nodes
 
         void ForLoopGEMM(const value::Matrix matA, const value::Matrix matB, value::Matrix matC);
         void Gemm(const value::Matrix mat, const value::Matrix matB, value::Matrix matC);
+        static void GemmWithSchedule(const value::Matrix matA, const value::Matrix matB, value::Matrix matC, const value::ScheduleParameters& parameters);
+        static value::ScheduleParameters GetDefaultGemmSchedule(int n, int k);
+        static value::ScheduleParameters GetGemmSchedule(int m, int n, int k);
         void GemmFn(const value::Matrix mat, const value::Matrix matB, value::Matrix matC, int thread_num = 0);
         void ParallelizeGemmCol(const value::Matrix matA, const value::Matrix matB, value::Matrix matC, int numThreads = 2);
         void ParallelizeGemmRow(const value::Matrix matA, const value::Matrix matB, value::Matrix matC, int numThreads = 2);
@@ -10,16 +10,18 @@
 
 #include "AccumulatorNode.h"
 #include "BinaryOperationNode.h"
-#include "ConstantNode.h"
-#include "DelayNode.h"
 
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
 #include <model/include/InputPort.h>
+#include <model/include/MapCompiler.h>
 #include <model/include/ModelTransformer.h>
 #include <model/include/Node.h>
 #include <model/include/OutputPort.h>
 
 #include <utilities/include/TypeName.h>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -27,9 +29,10 @@ namespace ell
 {
 namespace nodes
 {
-    /// <summary> A node that takes a vector input and returns its mean over some window of time. </summary>
+    /// <summary> A node that takes a vector input and returns its mean over some window of time. The window is kept in
+    /// a ring buffer along with the running sum of its samples, so each new sample takes constant time. </summary>
     template <typename ValueType>
-    class MovingAverageNode : public model::Node
+    class MovingAverageNode : public model::CompilableNode
     {
     public:
         /// @name Input and Output Ports
@@ -56,11 +59,15 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
-        /// <summary> Refines this node in the model being constructed by the transformer </summary>
-        bool Refine(model::ModelTransformer& transformer) const override;
+        /// <summary>Return the window size</summary>
+        size_t GetWindowSize() const { return _windowSize; }
+
+        /// <summary> Clears the window of samples. </summary>
+        void Reset() override;
 
     protected:
         void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
         bool HasState() const override { return true; }
@@ -75,7 +82,8 @@ namespace nodes
         model::OutputPort<ValueType> _output;
 
         // Buffer
-        mutable std::vector<std::vector<ValueType>> _samples;
+        mutable std::vector<ValueType> _samples; // ring buffer of `_windowSize` samples
+        mutable size_t _position = 0; // index of the oldest sample in `_samples`
         mutable std::vector<ValueType> _runningSum;
         size_t _windowSize;
     };
@@ -99,7 +107,7 @@ namespace nodes
 {
     template <typename ValueType>
     MovingAverageNode<ValueType>::MovingAverageNode() :
-        Node({ &_input }, { &_output }),
+        CompilableNode({ &_input }, { &_output }),
         _input(this, {}, defaultInputPortName),
         _output(this, defaultOutputPortName, 0),
         _windowSize(0)
@@ -108,16 +116,13 @@ namespace nodes
 
     template <typename ValueType>
     MovingAverageNode<ValueType>::MovingAverageNode(const model::OutputPort<ValueType>& input, size_t windowSize) :
-        Node({ &_input }, { &_output }),
+        CompilableNode({ &_input }, { &_output }),
         _input(this, input, defaultInputPortName),
         _output(this, defaultOutputPortName, _input.Size()),
         _windowSize(windowSize)
     {
         auto dimension = _input.Size();
-        for (size_t index = 0; index < _windowSize; ++index)
-        {
-            _samples.push_back(std::vector<ValueType>(dimension));
-        }
+        _samples = std::vector<ValueType>(_windowSize * dimension);
         _runningSum = std::vector<ValueType>(dimension);
     }
 
@@ -125,19 +130,28 @@ namespace nodes
     void MovingAverageNode<ValueType>::Compute() const
     {
         auto inputSample = _input.GetValue();
-        auto lastBufferedSample = _samples[0];
-        _samples.push_back(inputSample);
-        _samples.erase(_samples.begin());
+        auto dimension = inputSample.size();
+        auto oldestSample = _samples.begin() + _position * dimension;
 
-        std::vector<ValueType> result(_input.Size());
-        for (size_t index = 0; index < inputSample.size(); ++index)
+        std::vector<ValueType> result(dimension);
+        for (size_t index = 0; index < dimension; ++index)
         {
-            _runningSum[index] += (inputSample[index] - lastBufferedSample[index]);
+            _runningSum[index] += (inputSample[index] - oldestSample[index]);
+            oldestSample[index] = inputSample[index];
             result[index] = _runningSum[index] / _windowSize;
         }
+        _position = (_position + 1) % _windowSize;
         _output.SetOutput(result);
     };
 
+    template <typename ValueType>
+    void MovingAverageNode<ValueType>::Reset()
+    {
+        std::fill(_samples.begin(), _samples.end(), static_cast<ValueType>(0));
+        std::fill(_runningSum.begin(), _runningSum.end(), static_cast<ValueType>(0));
+        _position = 0;
+    }
+
     template <typename ValueType>
     void MovingAverageNode<ValueType>::Copy(model::ModelTransformer& transformer) const
     {
@@ -147,17 +161,39 @@ namespace nodes
     }
 
     template <typename ValueType>
-    bool MovingAverageNode<ValueType>::Refine(model::ModelTransformer& transformer) const
+    void MovingAverageNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
-        const auto& newInputs = transformer.GetCorrespondingInputs(_input);
-        std::vector<ValueType> literalN(newInputs.Size(), (ValueType)_windowSize);
-        const auto& delay = Delay(newInputs, _windowSize);
-        const auto& difference = Subtract(newInputs, delay);
-        const auto& accum = Accumulate(difference);
-        const auto& denominator = Constant(transformer, literalN);
-        const auto& quotient = Divide(accum, denominator);
-        transformer.MapNodeOutput(output, quotient);
-        return true;
+        const int dimension = static_cast<int>(output.Size());
+        const int windowSize = static_cast<int>(GetWindowSize());
+
+        auto input = function.LocalArray(compiler.EnsurePortEmitted(this->input));
+        auto result = function.LocalArray(compiler.EnsurePortEmitted(output));
+
+        // The ring buffer of samples, the running sum of the samples in it, and the position of the oldest one
+        emitters::IRModuleEmitter& module = function.GetModule();
+        auto samplesVariable = module.Variables().AddVariable<emitters::InitializedVectorVariable<ValueType>>(emitters::VariableScope::global, windowSize * dimension);
+        auto samples = function.LocalArray(function.PointerOffset(module.EnsureEmitted(*samplesVariable), 0));
+        auto runningSumVariable = module.Variables().AddVariable<emitters::InitializedVectorVariable<ValueType>>(emitters::VariableScope::global, dimension);
+        auto runningSum = function.LocalArray(function.PointerOffset(module.EnsureEmitted(*runningSumVariable), 0));
+        auto positionVariable = module.Global<int>(compiler.GetGlobalName(*this, "position"), 0);
+
+        auto position = function.LocalScalar(function.Load(positionVariable));
+        auto oldestSample = function.LocalArray(function.PointerOffset(samples, position * dimension));
+        function.For(dimension, [=](emitters::IRFunctionEmitter&, emitters::IRLocalScalar i) {
+            auto sample = input[i];
+            auto sum = runningSum[i] + (sample - oldestSample[i]);
+            oldestSample[i] = sample;
+            runningSum[i] = sum;
+            result[i] = sum / static_cast<ValueType>(windowSize);
+        });
+        function.Store(positionVariable, (position + 1) % windowSize);
+
+        // Add the internal reset function, which empties the window
+        emitters::IRFunctionEmitter& resetFunction = module.BeginResetFunction(compiler.GetGlobalName(*this, "MovingAverageNodeReset"));
+        resetFunction.MemorySet<ValueType>(module.EnsureEmitted(*samplesVariable), 0, resetFunction.Literal<uint8_t>(0), windowSize * dimension);
+        resetFunction.MemorySet<ValueType>(module.EnsureEmitted(*runningSumVariable), 0, resetFunction.Literal<uint8_t>(0), dimension);
+        resetFunction.Store(positionVariable, resetFunction.Literal<int>(0));
+        module.EndResetFunction();
     }
 
     template <typename ValueType>
@@ -176,12 +212,8 @@ namespace nodes
         archiver["windowSize"] >> _windowSize;
 
         auto dimension = _input.Size();
-        _samples.clear();
-        _samples.reserve(_windowSize);
-        for (size_t index = 0; index < _windowSize; ++index)
-        {
-            _samples.push_back(std::vector<ValueType>(dimension));
-        }
+        _samples = std::vector<ValueType>(_windowSize * dimension);
+        _position = 0;
         _runningSum = std::vector<ValueType>(dimension);
         _output.SetSize(dimension);
     }
@@ -8,13 +8,19 @@
 
 #pragma once
 
+#include <emitters/include/IRMath.h>
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
 #include <model/include/InputPort.h>
+#include <model/include/MapCompiler.h>
 #include <model/include/ModelTransformer.h>
 #include <model/include/Node.h>
 #include <model/include/OutputPort.h>
 
 #include <utilities/include/TypeName.h>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -22,9 +28,12 @@ namespace ell
 {
 namespace nodes
 {
-    /// <summary> A node that takes a vector input and returns its variance over some window of time. </summary>
+    /// <summary> A node that takes a vector input and returns its variance over some window of time. The window is kept
+    /// in a ring buffer, and the mean and the sum of squared deviations of its samples are updated with Welford's method
+    /// as each new sample replaces the oldest one, which takes constant time and doesn't lose precision to cancellation
+    /// the way the difference of the running sums of squares does. </summary>
     template <typename ValueType>
-    class MovingVarianceNode : public model::Node
+    class MovingVarianceNode : public model::CompilableNode
     {
     public:
         /// @name Input and Output Ports
@@ -51,8 +60,15 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary>Return the window size</summary>
+        size_t GetWindowSize() const { return _windowSize; }
+
+        /// <summary> Clears the window of samples. </summary>
+        void Reset() override;
+
     protected:
         void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
         bool HasState() const override { return true; }
@@ -67,9 +83,10 @@ namespace nodes
         model::OutputPort<ValueType> _output;
 
         // Buffer
-        mutable std::vector<std::vector<ValueType>> _samples;
-        mutable std::vector<ValueType> _runningSum;
-        mutable std::vector<ValueType> _runningSquaredSum;
+        mutable std::vector<ValueType> _samples; // ring buffer of `_windowSize` samples
+        mutable size_t _position = 0; // index of the oldest sample in `_samples`
+        mutable std::vector<ValueType> _runningMean;
+        mutable std::vector<ValueType> _runningSquaredDeviation;
         size_t _windowSize;
     };
 
@@ -86,7 +103,7 @@ namespace nodes
 {
     template <typename ValueType>
     MovingVarianceNode<ValueType>::MovingVarianceNode() :
-        Node({ &_input }, { &_output }),
+        CompilableNode({ &_input }, { &_output }),
         _input(this, {}, defaultInputPortName),
         _output(this, defaultOutputPortName, 0),
         _windowSize(0)
@@ -95,40 +112,51 @@ namespace nodes
 
     template <typename ValueType>
     MovingVarianceNode<ValueType>::MovingVarianceNode(const model::OutputPort<ValueType>& input, size_t windowSize) :
-        Node({ &_input }, { &_output }),
+        CompilableNode({ &_input }, { &_output }),
         _input(this, input, defaultInputPortName),
         _output(this, defaultOutputPortName, _input.Size()),
         _windowSize(windowSize)
     {
         auto dimension = _input.Size();
-        for (size_t index = 0; index < _windowSize; ++index)
-        {
-            _samples.push_back(std::vector<ValueType>(dimension));
-        }
-        _runningSum = std::vector<ValueType>(dimension);
-        _runningSquaredSum = std::vector<ValueType>(dimension);
+        _samples = std::vector<ValueType>(_windowSize * dimension);
+        _runningMean = std::vector<ValueType>(dimension);
+        _runningSquaredDeviation = std::vector<ValueType>(dimension);
     }
 
     template <typename ValueType>
     void MovingVarianceNode<ValueType>::Compute() const
     {
-        static auto squared = [](const ValueType& x) { return x * x; };
-
         auto inputSample = _input.GetValue();
-        auto lastBufferedSample = _samples[0];
-        _samples.push_back(inputSample);
-        _samples.erase(_samples.begin());
+        auto dimension = inputSample.size();
+        auto oldestSample = _samples.begin() + _position * dimension;
 
-        std::vector<ValueType> result(_input.Size());
-        for (size_t index = 0; index < inputSample.size(); ++index)
+        std::vector<ValueType> result(dimension);
+        for (size_t index = 0; index < dimension; ++index)
         {
-            _runningSum[index] += (inputSample[index] - lastBufferedSample[index]);
-            _runningSquaredSum[index] += squared(inputSample[index]) - squared(lastBufferedSample[index]);
-            result[index] = (_runningSquaredSum[index] - (squared(_runningSum[index]) / _windowSize)) / _windowSize;
+            // Welford's update, for a new sample replacing the oldest one
+            auto newValue = inputSample[index];
+            auto oldValue = oldestSample[index];
+            auto oldMean = _runningMean[index];
+            auto newMean = oldMean + (newValue - oldValue) / _windowSize;
+            // Rounding can take the sum slightly below 0 when the samples are all about the same, so it's clamped
+            _runningSquaredDeviation[index] = std::max(_runningSquaredDeviation[index] + (newValue - oldValue) * (newValue - newMean + oldValue - oldMean), static_cast<ValueType>(0));
+            _runningMean[index] = newMean;
+            oldestSample[index] = newValue;
+            result[index] = _runningSquaredDeviation[index] / _windowSize;
         }
+        _position = (_position + 1) % _windowSize;
         _output.SetOutput(result);
     };
 
+    template <typename ValueType>
+    void MovingVarianceNode<ValueType>::Reset()
+    {
+        std::fill(_samples.begin(), _samples.end(), static_cast<ValueType>(0));
+        std::fill(_runningMean.begin(), _runningMean.end(), static_cast<ValueType>(0));
+        std::fill(_runningSquaredDeviation.begin(), _runningSquaredDeviation.end(), static_cast<ValueType>(0));
+        _position = 0;
+    }
+
     template <typename ValueType>
     void MovingVarianceNode<ValueType>::Copy(model::ModelTransformer& transformer) const
     {
@@ -137,6 +165,50 @@ namespace nodes
         transformer.MapNodeOutput(output, newNode->output);
     }
 
+    template <typename ValueType>
+    void MovingVarianceNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        const int dimension = static_cast<int>(output.Size());
+        const int windowSize = static_cast<int>(GetWindowSize());
+
+        auto input = function.LocalArray(compiler.EnsurePortEmitted(this->input));
+        auto result = function.LocalArray(compiler.EnsurePortEmitted(output));
+
+        // The ring buffer of samples, the running mean and sum of squared deviations of the samples in it, and the position of the oldest one
+        emitters::IRModuleEmitter& module = function.GetModule();
+        auto samplesVariable = module.Variables().AddVariable<emitters::InitializedVectorVariable<ValueType>>(emitters::VariableScope::global, windowSize * dimension);
+        auto samples = function.LocalArray(function.PointerOffset(module.EnsureEmitted(*samplesVariable), 0));
+        auto runningMeanVariable = module.Variables().AddVariable<emitters::InitializedVectorVariable<ValueType>>(emitters::VariableScope::global, dimension);
+        auto runningMean = function.LocalArray(function.PointerOffset(module.EnsureEmitted(*runningMeanVariable), 0));
+        auto runningSquaredDeviationVariable = module.Variables().AddVariable<emitters::InitializedVectorVariable<ValueType>>(emitters::VariableScope::global, dimension);
+        auto runningSquaredDeviation = function.LocalArray(function.PointerOffset(module.EnsureEmitted(*runningSquaredDeviationVariable), 0));
+        auto positionVariable = module.Global<int>(compiler.GetGlobalName(*this, "position"), 0);
+
+        auto position = function.LocalScalar(function.Load(positionVariable));
+        auto oldestSample = function.LocalArray(function.PointerOffset(samples, position * dimension));
+        function.For(dimension, [=](emitters::IRFunctionEmitter&, emitters::IRLocalScalar i) {
+            // Welford's update, for a new sample replacing the oldest one
+            auto newValue = input[i];
+            auto oldValue = oldestSample[i];
+            auto oldMean = runningMean[i];
+            auto newMean = oldMean + (newValue - oldValue) / static_cast<ValueType>(windowSize);
+            auto squaredDeviation = emitters::Max(runningSquaredDeviation[i] + (newValue - oldValue) * (newValue - newMean + oldValue - oldMean), static_cast<ValueType>(0));
+            runningMean[i] = newMean;
+            runningSquaredDeviation[i] = squaredDeviation;
+            oldestSample[i] = newValue;
+            result[i] = squaredDeviation / static_cast<ValueType>(windowSize);
+        });
+        function.Store(positionVariable, (position + 1) % windowSize);
+
+        // Add the internal reset function, which empties the window
+        emitters::IRFunctionEmitter& resetFunction = module.BeginResetFunction(compiler.GetGlobalName(*this, "MovingVarianceNodeReset"));
+        resetFunction.MemorySet<ValueType>(module.EnsureEmitted(*samplesVariable), 0, resetFunction.Literal<uint8_t>(0), windowSize * dimension);
+        resetFunction.MemorySet<ValueType>(module.EnsureEmitted(*runningMeanVariable), 0, resetFunction.Literal<uint8_t>(0), dimension);
+        resetFunction.MemorySet<ValueType>(module.EnsureEmitted(*runningSquaredDeviationVariable), 0, resetFunction.Literal<uint8_t>(0), dimension);
+        resetFunction.Store(positionVariable, resetFunction.Literal<int>(0));
+        module.EndResetFunction();
+    }
+
     template <typename ValueType>
     void MovingVarianceNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
     {
@@ -153,11 +225,10 @@ namespace nodes
         archiver["windowSize"] >> _windowSize;
 
         auto dimension = _input.Size();
-        _samples.clear();
-        _samples.reserve(_windowSize);
-        std::generate_n(std::back_inserter(_samples), _windowSize, [dimension] { return std::vector<ValueType>(dimension); });
-        _runningSum = std::vector<ValueType>(dimension);
-        _runningSquaredSum = std::vector<ValueType>(dimension);
+        _samples = std::vector<ValueType>(_windowSize * dimension);
+        _position = 0;
+        _runningMean = std::vector<ValueType>(dimension);
+        _runningSquaredDeviation = std::vector<ValueType>(dimension);
         _output.SetSize(dimension);
     }
 
@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizedMatrixMultiplyNode.h (nodes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/CompilableCodeNode.h>
+#include <model/include/InputPort.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/OutputPort.h>
+
+#include <utilities/include/ArchiveVersion.h>
+#include <utilities/include/IArchivable.h>
+#include <utilities/include/TypeName.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A node that multiplies a constant matrix of weights by an input matrix using 8-bit integer arithmetic.
+    /// The weights (an m x k row-major matrix) are quantized to int8 when the node is created. At run time,
+    /// the input (a k x n row-major matrix) is quantized to int8 using a scale derived from its expected range,
+    /// the products are accumulated in int32, and the result is rescaled back to the node's value type.
+    /// Both quantizations are symmetric and per-tensor: a value `x` is represented by `round(x / scale)`,
+    /// clamped to [-127, 127].
+    /// The node emits the multiply-accumulate as scalar code that widens each int8 product to int32. It doesn't emit
+    /// target-specific instructions such as `pmaddubsw` or `vpdpbusd`; vectorizing the widening multiply-accumulate is
+    /// left to LLVM's loop vectorizer, so how well it maps onto such instructions depends on the target and LLVM version.
+    /// </summary>
+    template <typename ValueType>
+    class QuantizedMatrixMultiplyNode : public model::CompilableCodeNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        QuantizedMatrixMultiplyNode();
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="input"> The right-hand input of the matrix multiplication, a row-major matrix of size k x n. </param>
+        /// <param name="weights"> The left-hand side of the matrix multiplication, a row-major matrix of size m x k. </param>
+        /// <param name="m"> The number of rows in the weights matrix and in the output matrix. </param>
+        /// <param name="n"> The number of columns in the input matrix and in the output matrix. </param>
+        /// <param name="k"> The number of columns in the weights matrix and the number of rows in the input matrix. </param>
+        /// <param name="inputRange"> The largest absolute value expected in the input, usually measured on a calibration dataset. </param>
+        /// <param name="transposeOutput"> If true, the output is written in column-major order (that is, as an n x m row-major matrix). </param>
+        QuantizedMatrixMultiplyNode(const model::OutputPort<ValueType>& input, const std::vector<ValueType>& weights, int m, int n, int k, ValueType inputRange, bool transposeOutput = false);
+
+        /// <summary> Constructor from weights that have already been quantized </summary>
+        ///
+        /// <param name="input"> The right-hand input of the matrix multiplication, a row-major matrix of size k x n. </param>
+        /// <param name="quantizedWeights"> The quantized weights, a row-major matrix of size m x k. </param>
+        /// <param name="weightScale"> The scale of the quantized weights. </param>
+        /// <param name="m"> The number of rows in the weights matrix and in the output matrix. </param>
+        /// <param name="n"> The number of columns in the input matrix and in the output matrix. </param>
+        /// <param name="k"> The number of columns in the weights matrix and the number of rows in the input matrix. </param>
+        /// <param name="inputScale"> The scale used to quantize the input. </param>
+        /// <param name="transposeOutput"> If true, the output is written in column-major order (that is, as an n x m row-major matrix). </param>
+        QuantizedMatrixMultiplyNode(const model::OutputPort<ValueType>& input, const std::vector<int8_t>& quantizedWeights, ValueType weightScale, int m, int n, int k, ValueType inputScale, bool transposeOutput = false);
+
+        /// <summary> Gets the quantized weights. </summary>
+        const std::vector<int8_t>& GetQuantizedWeights() const { return _weights; }
+
+        /// <summary> Gets the scale of the quantized weights. </summary>
+        ValueType GetWeightScale() const { return _weightScale; }
+
+        /// <summary> Gets the scale used to quantize the input. </summary>
+        ValueType GetInputScale() const { return _inputScale; }
+
+        /// <summary> Gets the scale that maps values with the given largest magnitude onto [-127, 127]. </summary>
+        ///
+        /// <param name="range"> The largest absolute value to be represented. </param>
+        ///
+        /// <returns> The quantization scale, or 1 if the range is zero. </returns>
+        static ValueType GetQuantizationScale(ValueType range);
+
+        /// <summary> Quantizes a value to int8. </summary>
+        ///
+        /// <param name="value"> The value to quantize. </param>
+        /// <param name="scale"> The quantization scale. </param>
+        ///
+        /// <returns> The value divided by the scale, rounded to the nearest integer and clamped to [-127, 127]. </returns>
+        static int8_t Quantize(ValueType value, ValueType scale);
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("QuantizedMatrixMultiplyNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Define(value::FunctionDeclaration& fn) override;
+        utilities::ArchiveVersion GetArchiveVersion() const override;
+        bool CanReadArchiveVersion(const utilities::ArchiveVersion& version) const override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: weights, scales, m, n, k, transposeOutput
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+
+        // Input
+        model::InputPort<ValueType> _input;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        // Weights are MxK, input is KxN, output is MxN
+        std::vector<int8_t> _weights;
+        ValueType _weightScale = 1;
+        ValueType _inputScale = 1;
+        int _m = 0, _n = 0, _k = 0;
+        bool _transposeOutput = false;
+    };
+
+    //
+    // Explicit instantiation declarations
+    //
+    extern template class QuantizedMatrixMultiplyNode<float>;
+    extern template class QuantizedMatrixMultiplyNode<double>;
+} // namespace nodes
+} // namespace ell
@@ -14,11 +14,14 @@
 
 #include <emitters/include/LLVMUtilities.h>
 
+#include <math/include/Matrix.h>
+
 #include <model/include/IRMapCompiler.h>
 #include <model/include/ModelTransformer.h>
 
 #include <utilities/include/StringUtil.h>
 
+#include <functional>
 #include <string>
 
 namespace ell
@@ -63,6 +66,8 @@ namespace nodes
         /// <param name="activation"> The activation function. </param>
         /// <param name="recurrentActivation"> The recurrent activation function. </param>
         /// <param name="validateWeights"> Whether to check the size of the weights. </param>
+        /// <param name="sequenceLength"> The number of timesteps in the input. The input holds a row of features for each
+        /// timestep, and the output holds the hidden state after each one. </param>
         RNNNode(const model::OutputPort<ValueType>& input,
                 const model::OutputPortBase& resetTrigger,
                 size_t hiddenUnits,
@@ -71,7 +76,8 @@ namespace nodes
                 const model::OutputPort<ValueType>& inputBias,
                 const model::OutputPort<ValueType>& hiddenBias,
                 const ActivationType& activation,
-                bool validateWeights = true);
+                bool validateWeights = true,
+                size_t sequenceLength = 1);
 
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
@@ -86,6 +92,9 @@ namespace nodes
         /// <summary> Resets any state on the node, if any </summary>
         void Reset() override;
 
+        /// <summary> Gets the number of timesteps the node computes in each call. </summary>
+        size_t GetSequenceLength() const { return _sequenceLength; }
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
@@ -110,6 +119,24 @@ namespace nodes
 
         void ApplyActivation(emitters::IRFunctionEmitter& function, const ActivationType& activation, emitters::LLVMValue data, size_t dataLength);
 
+        // The number of features in each timestep of the input
+        size_t GetInputSize() const { return _input.Size() / _sequenceLength; }
+
+        // Computes W_i x_t + b_i for all the timesteps t at once, as the rows of a matrix, so only the recurrent part
+        // of the node has to be computed one timestep at a time
+        math::RowMatrix<ValueType> ComputeInputStacks(size_t stackSize) const;
+
+        // Emits code that computes W_i x_t + b_i for all the timesteps t at once (with a single GEMM for a sequence) into
+        // `inputStacks`, which holds a row of `stackSize` values for each timestep
+        void EmitInputStacks(emitters::IRFunctionEmitter& function, emitters::LLVMValue input, emitters::LLVMValue inputWeights, emitters::LLVMValue inputBias, emitters::LLVMValue inputStacks, int stackSize);
+
+        // Emits the recurrent part of the node for each timestep, by calling `emitStep` with the timestep's row of the
+        // input stacks and of the output
+        using EmitStepFunction = std::function<void(emitters::IRFunctionEmitter& function, emitters::IRLocalArray inputStack, emitters::LLVMValue output)>;
+        void EmitSequence(emitters::IRFunctionEmitter& function, emitters::LLVMValue inputStacks, int stackSize, emitters::LLVMValue output, EmitStepFunction emitStep);
+
+        size_t _sequenceLength = 1;
+
         using VectorType = math::ColumnVector<ValueType>;
 
         // Hidden state for compute
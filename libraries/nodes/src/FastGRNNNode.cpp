@@ -27,6 +27,22 @@ namespace nodes
     using namespace utilities;
     using namespace value;
 
+    namespace
+    {
+        // Multiplies each row of `inputs` by `weights`, so result(t, r) = sum_c inputs(t, c) * weights(r, c)
+        template <typename ElementType>
+        Matrix ProjectRows(Matrix inputs, Matrix weights)
+        {
+            Matrix result = MakeMatrix<ElementType>(static_cast<int>(inputs.Rows()), static_cast<int>(weights.Rows()));
+            For(result, [&](Scalar row, Scalar column) {
+                For(Scalar(0), Scalar(static_cast<int>(inputs.Columns())), Scalar(1), [&](Scalar index) {
+                    result(row, column) += inputs(row, index) * weights(column, index);
+                });
+            });
+            return result;
+        }
+    } // namespace
+
     template <typename ElementType>
     FastGRNNNode<ElementType>::FastGRNNNode() :
         CompilableCodeNode("FastGRNNNode",
@@ -45,7 +61,8 @@ namespace nodes
         _biasUpdate(this, {}, biasUpdatePortName),
         _zeta(this, {}, zetaPortName),
         _nu(this, {}, nuPortName),
-        _output(this, defaultOutputPortName, 0)
+        _output(this, defaultOutputPortName, 0),
+        _sequenceLength(1)
     {
     }
 
@@ -64,7 +81,8 @@ namespace nodes
                                             const model::OutputPort<ElementType>& zeta,
                                             const model::OutputPort<ElementType>& nu,
                                             const ActivationType& gateActivation,
-                                            const ActivationType& updateActivation) :
+                                            const ActivationType& updateActivation,
+                                            size_t sequenceLength) :
         CompilableCodeNode("FastGRNNNode", { &_input, &_resetTrigger, &_inputWeights1, &_inputWeights2, &_updateWeights1, &_updateWeights2, &_biasGate, &_biasUpdate, &_zeta, &_nu }, { &_output }),
         _input(this, input, defaultInputPortName),
         _resetTrigger(this, resetTrigger, resetTriggerPortName),
@@ -79,9 +97,10 @@ namespace nodes
         _biasUpdate(this, biasUpdate, biasUpdatePortName),
         _zeta(this, zeta, zetaPortName),
         _nu(this, nu, nuPortName),
-        _output(this, defaultOutputPortName, hiddenUnits),
+        _output(this, defaultOutputPortName, hiddenUnits * sequenceLength),
         _gateActivation(gateActivation),
-        _updateActivation(updateActivation)
+        _updateActivation(updateActivation),
+        _sequenceLength(sequenceLength)
     {
         ValidateWeights();
     }
@@ -92,7 +111,12 @@ namespace nodes
         size_t numRows = _hiddenUnits;
         size_t wrank = _wRank;
         size_t urank = _uRank;
-        size_t numColumns = input.Size();
+        if (_sequenceLength == 0 || input.Size() % _sequenceLength != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument,
+                                            ell::utilities::FormatString("The FastGRNNNode input size %zu isn't a multiple of the sequence length %zu", input.Size(), _sequenceLength));
+        }
+        size_t numColumns = input.Size() / _sequenceLength;
         if (wrank == 0)
         {
             if (_inputWeights1.Size() != numRows * numColumns)
@@ -172,7 +196,7 @@ namespace nodes
         const auto& newbiasUpdate = transformer.GetCorrespondingInputs(this->_biasUpdate);
         const auto& newzeta = transformer.GetCorrespondingInputs(this->_zeta);
         const auto& newnu = transformer.GetCorrespondingInputs(this->_nu);
-        auto newNode = transformer.AddNode<FastGRNNNode>(newInput, newResetTrigger, this->_hiddenUnits, this->_wRank, this->_uRank, newInputWeights1, newInputWeights2, newUpdateWeights1, newUpdateWeights2, newbiasGate, newbiasUpdate, newzeta, newnu, this->_gateActivation, this->_updateActivation);
+        auto newNode = transformer.AddNode<FastGRNNNode>(newInput, newResetTrigger, this->_hiddenUnits, this->_wRank, this->_uRank, newInputWeights1, newInputWeights2, newUpdateWeights1, newUpdateWeights2, newbiasGate, newbiasUpdate, newzeta, newnu, this->_gateActivation, this->_updateActivation, this->_sequenceLength);
         transformer.MapNodeOutput(this->output, newNode->output);
     }
 
@@ -186,14 +210,15 @@ namespace nodes
             _hiddenState = StaticAllocate("hiddenState", GetValueType<ElementType>(), MemoryLayout({ hiddenUnits }));
             _lastResetValue = StaticAllocate("lastResetValue", ValueType::Int32, ScalarLayout);
 
-            int inputSize = static_cast<int>(input.Size());
+            int sequenceLength = static_cast<int>(this->_sequenceLength);
+            int inputSize = static_cast<int>(input.Size()) / sequenceLength;
 
             // zt = sigma( W x + U h + b_g)
             // ht1 = tanh( W x + U h + b_u )
             // ht = (sigma(zeta) (1 - zt) + sigma(nu)) ht1 + zt h
 
             // flatten the MemoryLayout so we can accept any shaped input data and produce any shape result.
-            Vector input = ToVector(data);
+            Matrix inputs = ToMatrix(data, sequenceLength, inputSize);
             Vector resetVector = ToVector(reset);
             Matrix W1, W2, U1, U2;
             if (wrank == 0)
@@ -220,47 +245,42 @@ namespace nodes
             Vector nuVector = ToVector(nuValue);
             Vector output = ToVector(result);
 
-            // W * x + U *h
+            Scalar zeta = zetaVector[0];
+            Scalar nu = nuVector[0];
+
+            // W * x doesn't depend on the hidden state, so it's computed for all the timesteps up front,
+            // one row per timestep, and only the recurrent part below runs once per timestep.
             // if we need to transpose W or U, we should do that in the importer so it is not done at runtime.
-            Vector wxuh;
-            if ((wrank != 0) && (urank != 0))
-            {
-                wxuh = GEMV(W2, GEMV(W1, input)) + GEMV(U2, GEMV(U1, _hiddenState));
-            }
-            else if ((wrank == 0) && (urank != 0))
-            {
-                wxuh = GEMV(W1, input) + GEMV(U2, GEMV(U1, _hiddenState));
-            }
-            else if ((wrank != 0) && (urank == 0))
-            {
-                wxuh = GEMV(W2, GEMV(W1, input)) + GEMV(U1, _hiddenState);
-            }
-            else
-            {
-                wxuh = GEMV(W1, input) + GEMV(U1, _hiddenState);
-            }
+            Matrix wx = (wrank == 0) ? ProjectRows<ElementType>(inputs, W1) : ProjectRows<ElementType>(ProjectRows<ElementType>(inputs, W1), W2);
 
-            Vector zt = wxuh + biasGateVector;
+            For(Scalar(0), Scalar(sequenceLength), Scalar(1), [&](Scalar t) {
+                // W * x + U *h
+                Vector uh = (urank == 0) ? GEMV(U1, _hiddenState) : GEMV(U2, GEMV(U1, _hiddenState));
+                Vector wxuh = wx.Row(t) + uh;
 
-            Vector ht1 = wxuh + biasUpdateVector;
+                Vector zt = wxuh + biasGateVector;
 
-            // Apply the activations.
-            this->_gateActivation.Apply(zt);
+                Vector ht1 = wxuh + biasUpdateVector;
 
-            this->_updateActivation.Apply(ht1);
+                // Apply the activations.
+                this->_gateActivation.Apply(zt);
 
-            Scalar zeta = zetaVector[0];
-            Scalar nu = nuVector[0];
+                this->_updateActivation.Apply(ht1);
+
+                // ht = (zeta.(1 - zt) + nu).ht1 + zt h
+                //    = zeta.(1 - zt).ht1 + nu.ht1 + zt.h
+                //    = (zeta.ht1) - (zeta.zt.ht1) + nu.ht1 + zt.h
+                //    = (zeta + nu) ht1 - (zeta.zt.ht1) + (zt.h)
+                Vector wu = zt * ht1;
+                Scalar znu = zeta.Copy() + nu;
+                Vector ht = (ht1 * znu) - (wu * zeta) + (zt * _hiddenState);
 
-            // ht = (zeta.(1 - zt) + nu).ht1 + zt h
-            //    = zeta.(1 - zt).ht1 + nu.ht1 + zt.h
-            //    = (zeta.ht1) - (zeta.zt.ht1) + nu.ht1 + zt.h
-            //    = (zeta + nu) ht1 - (zeta.zt.ht1) + (zt.h)
-            Vector wu = zt * ht1;
-            Scalar znu = zeta.Copy() + nu;
-            Vector ht = (ht1 * znu) - (wu * zeta) + (zt * _hiddenState);
+                this->_hiddenState = ht;
 
-            this->_hiddenState = ht;
+                // copy to output.
+                Vector stepOutput = output.SubVector(t * hiddenUnits, hiddenUnits);
+                stepOutput = ht;
+            });
 
             if (resetVector.Size() > 0)
             {
@@ -276,9 +296,6 @@ namespace nodes
                 });
                 _lastResetValue = triggerValue;
             }
-
-            // copy to output.
-            output = ht;
         });
     }
 
@@ -309,6 +326,7 @@ namespace nodes
         archiver["hiddenUnits"] << _hiddenUnits;
         archiver["wRank"] << _wRank;
         archiver["uRank"] << _uRank;
+        archiver["sequenceLength"] << _sequenceLength;
         archiver[W1PortName] << _inputWeights1;
         archiver[W2PortName] << _inputWeights2;
         archiver[U1PortName] << _updateWeights1;
@@ -331,6 +349,7 @@ namespace nodes
         archiver["hiddenUnits"] >> _hiddenUnits;
         archiver["wRank"] >> _wRank;
         archiver["uRank"] >> _uRank;
+        archiver.OptionalProperty("sequenceLength", size_t(1)) >> _sequenceLength;
         archiver[W1PortName] >> _inputWeights1;
         archiver[W2PortName] >> _inputWeights2;
         archiver[U1PortName] >> _updateWeights1;
@@ -343,7 +362,7 @@ namespace nodes
         _gateActivation.ReadFromArchive(archiver);
         _updateActivation.ReadFromArchive(archiver);
 
-        this->_output.SetSize(_hiddenUnits);
+        this->_output.SetSize(_hiddenUnits * _sequenceLength);
     }
 
     // Explicit instantiations
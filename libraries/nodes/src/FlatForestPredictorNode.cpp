@@ -0,0 +1,133 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FlatForestPredictorNode.cpp (nodes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FlatForestPredictorNode.h"
+
+#include <emitters/include/EmitterTypes.h>
+#include <emitters/include/IRLocalScalar.h>
+
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    FlatForestPredictorNode::FlatForestPredictorNode() :
+        CompilableNode({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 1),
+        _treeOutputs(this, treeOutputsPortName, 0),
+        _edgeIndicatorVector(this, edgeIndicatorVectorPortName, 0)
+    {
+    }
+
+    FlatForestPredictorNode::FlatForestPredictorNode(const model::OutputPort<double>& input, const predictors::FlatForestPredictor& forest) :
+        CompilableNode({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, 1),
+        _treeOutputs(this, treeOutputsPortName, forest.NumTrees()),
+        _edgeIndicatorVector(this, edgeIndicatorVectorPortName, forest.NumEdges()),
+        _forest(forest)
+    {
+    }
+
+    void FlatForestPredictorNode::Compute() const
+    {
+        auto inputDataVector = predictors::FlatForestPredictor::DataVectorType(_input.GetValue());
+        _output.SetOutput({ _forest.Predict(inputDataVector) });
+
+        std::vector<double> treeOutputs(_forest.NumTrees());
+        for (size_t i = 0; i < _forest.NumTrees(); ++i)
+        {
+            treeOutputs[i] = _forest.PredictTree(inputDataVector, i);
+        }
+        _treeOutputs.SetOutput(std::move(treeOutputs));
+
+        _edgeIndicatorVector.SetOutput(_forest.GetEdgeIndicatorVector(inputDataVector));
+    }
+
+    void FlatForestPredictorNode::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        using namespace std::string_literals;
+
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+        if (_forest.NumTrees() == 0)
+        {
+            function.Store(pOutput, function.Literal(_forest.GetBias()));
+            return;
+        }
+
+        emitters::LLVMValue pTreeOutputs = compiler.EnsurePortEmitted(treeOutputs);
+        emitters::LLVMValue pEdgeIndicator = compiler.EnsurePortEmitted(edgeIndicatorVector);
+
+        auto& module = function.GetModule();
+        auto featureIndices = module.ConstantArray("forestFeatureIndices_"s + GetInternalStateIdentifier(), _forest.GetFeatureIndices());
+        auto thresholds = module.ConstantArray("forestThresholds_"s + GetInternalStateIdentifier(), _forest.GetThresholds());
+        auto children = module.ConstantArray("forestChildren_"s + GetInternalStateIdentifier(), _forest.GetChildren());
+        auto firstEdgeIndices = module.ConstantArray("forestFirstEdgeIndices_"s + GetInternalStateIdentifier(), _forest.GetFirstEdgeIndices());
+        auto leafValues = module.ConstantArray("forestLeafValues_"s + GetInternalStateIdentifier(), _forest.GetLeafValues());
+        auto treeRoots = module.ConstantArray("forestTreeRoots_"s + GetInternalStateIdentifier(), _forest.GetTreeRoots());
+
+        function.For(_forest.NumEdges(), [pEdgeIndicator](emitters::IRFunctionEmitter& function, emitters::LLVMValue i) {
+            function.SetValueAt(pEdgeIndicator, i, function.Literal(false));
+        });
+
+        emitters::LLVMValue sumVar = function.Variable(emitters::VariableType::Double, "forestSum");
+        emitters::LLVMValue nodeVar = function.Variable(emitters::VariableType::Int32, "forestNode");
+        function.Store(sumVar, function.Literal(_forest.GetBias()));
+
+        // Walk each tree from its root until the node index turns negative, which means it refers to a leaf
+        function.For(_forest.NumTrees(), [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue treeIndex) {
+            function.Store(nodeVar, function.ValueAt(treeRoots, treeIndex));
+            function.While([nodeVar](emitters::IRFunctionEmitter& function) { return function.LocalScalar(function.Load(nodeVar)) >= 0; },
+                           [=](emitters::IRFunctionEmitter& function) {
+                               auto nodeIndex = function.LocalScalar(function.Load(nodeVar));
+                               auto value = function.LocalScalar(function.ValueAt(pInput, function.ValueAt(featureIndices, nodeIndex)));
+                               auto threshold = function.LocalScalar(function.ValueAt(thresholds, nodeIndex));
+                               auto edgePosition = function.LocalScalar(function.Select(value > threshold, function.Literal(1), function.Literal(0)));
+                               auto firstEdgeIndex = function.LocalScalar(function.ValueAt(firstEdgeIndices, nodeIndex));
+                               function.SetValueAt(pEdgeIndicator, firstEdgeIndex + edgePosition, function.Literal(true));
+                               function.Store(nodeVar, function.ValueAt(children, (nodeIndex * 2) + edgePosition));
+                           });
+
+            auto leafIndex = -function.LocalScalar(function.Load(nodeVar)) - 1;
+            auto leafValue = function.LocalScalar(function.ValueAt(leafValues, leafIndex));
+            function.SetValueAt(pTreeOutputs, treeIndex, leafValue);
+            function.Store(sumVar, function.LocalScalar(function.Load(sumVar)) + leafValue);
+        });
+
+        function.Store(pOutput, function.Load(sumVar));
+    }
+
+    void FlatForestPredictorNode::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInputs = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<FlatForestPredictorNode>(newInputs, _forest);
+        transformer.MapNodeOutput(output, newNode->output);
+        transformer.MapNodeOutput(treeOutputs, newNode->treeOutputs);
+        transformer.MapNodeOutput(edgeIndicatorVector, newNode->edgeIndicatorVector);
+    }
+
+    void FlatForestPredictorNode::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["forest"] << _forest;
+    }
+
+    void FlatForestPredictorNode::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["forest"] >> _forest;
+
+        _treeOutputs.SetSize(_forest.NumTrees());
+        _edgeIndicatorVector.SetSize(_forest.NumEdges());
+    }
+} // namespace nodes
+} // namespace ell
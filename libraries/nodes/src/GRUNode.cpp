@@ -35,14 +35,15 @@ namespace nodes
                                 const model::OutputPort<ValueType>& hiddenBias,
                                 const ActivationType& activation,
                                 const ActivationType& recurrentActivation,
-                                bool validateWeights) :
-        LSTMNode<ValueType>(input, resetTrigger, hiddenUnits, inputWeights, hiddenWeights, inputBias, hiddenBias, activation, recurrentActivation, false)
+                                bool validateWeights,
+                                size_t sequenceLength) :
+        LSTMNode<ValueType>(input, resetTrigger, hiddenUnits, inputWeights, hiddenWeights, inputBias, hiddenBias, activation, recurrentActivation, false, sequenceLength)
     {
         if (validateWeights)
         {
             size_t stackHeight = 3; // GRU has 3 stacked weights for (input, reset, hidden).
             size_t numRows = stackHeight * hiddenUnits;
-            size_t numColumns = input.Size();
+            size_t numColumns = this->GetInputSize();
 
             if (inputWeights.Size() != numRows * numColumns)
             {
@@ -80,7 +81,7 @@ namespace nodes
         const auto& newHiddenWeights = transformer.GetCorrespondingInputs(this->_hiddenWeights);
         const auto& newInputBias = transformer.GetCorrespondingInputs(this->_inputBias);
         const auto& newHiddenBias = transformer.GetCorrespondingInputs(this->_hiddenBias);
-        auto newNode = transformer.AddNode<GRUNode>(newInput, newResetTrigger, this->_hiddenUnits, newInputWeights, newHiddenWeights, newInputBias, newHiddenBias, this->_activation, this->_recurrentActivation);
+        auto newNode = transformer.AddNode<GRUNode>(newInput, newResetTrigger, this->_hiddenUnits, newInputWeights, newHiddenWeights, newInputBias, newHiddenBias, this->_activation, this->_recurrentActivation, true, this->_sequenceLength);
         transformer.MapNodeOutput(this->output, newNode->output);
     }
 
@@ -97,65 +98,70 @@ namespace nodes
         */
         size_t hiddenUnits = this->_hiddenUnits;
         size_t stackHeight = 3; // GRU has 3 stacked weights for (input, reset, hidden)
-        VectorType inputVector = this->_input.GetValue();
         size_t numRows = stackHeight * hiddenUnits;
-        size_t numColumns = inputVector.Size();
-        std::vector<ValueType> inputWeightsValue = this->_inputWeights.GetValue();
-        ConstMatrixReferenceType inputWeights(inputWeightsValue.data(), numRows, numColumns);
-        numColumns = hiddenUnits;
+        size_t numColumns = hiddenUnits;
         std::vector<ValueType> hiddenWeightsValue = this->_hiddenWeights.GetValue();
         ConstMatrixReferenceType hiddenWeights(hiddenWeightsValue.data(), numRows, numColumns);
-        VectorType inputBias(this->_inputBias.GetValue());
         VectorType hiddenBias(this->_hiddenBias.GetValue());
 
         auto alpha = static_cast<ValueType>(1); // GEMV scale multiplication
         auto beta = alpha; // GEMV scale bias
 
-        // W_i * x + b_i
-        VectorType istack(inputBias); // add input bias
-        math::MultiplyScaleAddUpdate(alpha, inputWeights, inputVector, beta, istack);
-
-        // W_h * h + b_h
-        VectorType hstack(hiddenBias); // add hidden bias
-        math::MultiplyScaleAddUpdate(alpha, hiddenWeights, this->_hiddenState, beta, hstack);
-
-        // the weights are stacked in 3 slices for (input, reset, hidden).
-        size_t slice1 = 0;
-        size_t slice2 = hiddenUnits;
-        size_t slice3 = 2 * hiddenUnits;
-
-        // input_gate = sigma(W_{ iz } x + b_{ iz } + W_{ hz } h + b_{ hz })
-        VectorType input_gate(hiddenUnits);
-        input_gate.CopyFrom(istack.GetSubVector(slice1, hiddenUnits));
-        input_gate += hstack.GetSubVector(slice1, hiddenUnits);
-        this->_recurrentActivation.Apply(input_gate);
-
-        // reset_gate = sigma(W_{ ir } x + b_{ ir } + W_{ hr } h + b_{ hr })
-        VectorType reset_gate(hiddenUnits);
-        reset_gate.CopyFrom(istack.GetSubVector(slice2, hiddenUnits));
-        reset_gate += hstack.GetSubVector(slice2, hiddenUnits);
-        this->_recurrentActivation.Apply(reset_gate);
-
-        // hidden_gate = tanh(W_{ in } x + b_{ in } + reset_gate * (W_{ hn } h + b_{ hn }))
-        VectorType hidden_gate(hiddenUnits);
-        hidden_gate.CopyFrom(hstack.GetSubVector(slice3, hiddenUnits));
-        ElementwiseMultiplySet(hidden_gate, reset_gate, hidden_gate);
-        hidden_gate += istack.GetSubVector(slice3, hiddenUnits);
-        this->_activation.Apply(hidden_gate);
-
-        // ht = (1 - input_gate) * hidden_gate + input_gate * h
-        //    = hidden_gate - input_gate * hidden_gate + input_gate * h
-        //    = hidden_gate + input_gate (h - hidden_gate )
-        this->_hiddenState -= hidden_gate;
-        ElementwiseMultiplySet(this->_hiddenState, input_gate, this->_hiddenState);
-        this->_hiddenState += hidden_gate;
+        // W_i * x + b_i, for all the timesteps
+        auto inputStacks = this->ComputeInputStacks(numRows);
+
+        std::vector<ValueType> outputValues;
+        outputValues.reserve(hiddenUnits * this->_sequenceLength);
+        for (size_t t = 0; t < this->_sequenceLength; ++t)
+        {
+            VectorType istack(numRows);
+            istack.CopyFrom(inputStacks.GetRow(t).Transpose());
+
+            // W_h * h + b_h
+            VectorType hstack(hiddenBias); // add hidden bias
+            math::MultiplyScaleAddUpdate(alpha, hiddenWeights, this->_hiddenState, beta, hstack);
+
+            // the weights are stacked in 3 slices for (input, reset, hidden).
+            size_t slice1 = 0;
+            size_t slice2 = hiddenUnits;
+            size_t slice3 = 2 * hiddenUnits;
+
+            // input_gate = sigma(W_{ iz } x + b_{ iz } + W_{ hz } h + b_{ hz })
+            VectorType input_gate(hiddenUnits);
+            input_gate.CopyFrom(istack.GetSubVector(slice1, hiddenUnits));
+            input_gate += hstack.GetSubVector(slice1, hiddenUnits);
+            this->_recurrentActivation.Apply(input_gate);
+
+            // reset_gate = sigma(W_{ ir } x + b_{ ir } + W_{ hr } h + b_{ hr })
+            VectorType reset_gate(hiddenUnits);
+            reset_gate.CopyFrom(istack.GetSubVector(slice2, hiddenUnits));
+            reset_gate += hstack.GetSubVector(slice2, hiddenUnits);
+            this->_recurrentActivation.Apply(reset_gate);
+
+            // hidden_gate = tanh(W_{ in } x + b_{ in } + reset_gate * (W_{ hn } h + b_{ hn }))
+            VectorType hidden_gate(hiddenUnits);
+            hidden_gate.CopyFrom(hstack.GetSubVector(slice3, hiddenUnits));
+            ElementwiseMultiplySet(hidden_gate, reset_gate, hidden_gate);
+            hidden_gate += istack.GetSubVector(slice3, hiddenUnits);
+            this->_activation.Apply(hidden_gate);
+
+            // ht = (1 - input_gate) * hidden_gate + input_gate * h
+            //    = hidden_gate - input_gate * hidden_gate + input_gate * h
+            //    = hidden_gate + input_gate (h - hidden_gate )
+            this->_hiddenState -= hidden_gate;
+            ElementwiseMultiplySet(this->_hiddenState, input_gate, this->_hiddenState);
+            this->_hiddenState += hidden_gate;
+            auto hiddenStateValues = this->_hiddenState.ToArray();
+            outputValues.insert(outputValues.end(), hiddenStateValues.begin(), hiddenStateValues.end());
+        }
 
         if (this->ShouldReset())
         {
             const_cast<GRUNode<ValueType>*>(this)->Reset();
+            std::fill(outputValues.end() - hiddenUnits, outputValues.end(), static_cast<ValueType>(0));
         }
 
-        this->_output.SetOutput(this->_hiddenState.ToArray());
+        this->_output.SetOutput(outputValues);
     }
 
     template <typename ValueType>
@@ -173,7 +179,7 @@ namespace nodes
     void GRUNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
         const int hiddenUnits = static_cast<int>(this->_hiddenUnits);
-        const int inputSize = static_cast<int>(this->input.Size());
+        const int sequenceLength = static_cast<int>(this->_sequenceLength);
         const int outputSize = static_cast<int>(this->_hiddenUnits);
 
         // Get LLVM references for all node inputs
@@ -184,7 +190,7 @@ namespace nodes
         auto hiddenBias = compiler.EnsurePortEmitted(this->hiddenBias);
 
         // Get LLVM reference for node output
-        auto output = function.LocalArray(compiler.EnsurePortEmitted(this->output));
+        auto output = compiler.EnsurePortEmitted(this->output);
 
         // Allocate global buffer for hidden state
         emitters::IRModuleEmitter& module = function.GetModule();
@@ -196,7 +202,7 @@ namespace nodes
 
         // Allocate local variables
         const size_t stackSize = hiddenUnits * 3;
-        auto istack = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), stackSize));
+        auto istacks = function.Variable(emitters::GetVariableType<ValueType>(), stackSize * sequenceLength);
         auto hstack = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), stackSize));
         auto inputGate = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), hiddenUnits));
         auto resetGate = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), hiddenUnits));
@@ -205,54 +211,54 @@ namespace nodes
         auto alpha = static_cast<ValueType>(1.0); // GEMV scaling of the matrix multipication
         auto beta = static_cast<ValueType>(1.0); // GEMV scaling of the bias addition
 
-        // W_i * x + b, one matrix multiplication for all 3 gates (input,reset,hidden)
-        function.MemoryCopy<ValueType>(inputBias, istack, stackSize); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(stackSize, inputSize, alpha, inputWeights, inputSize, input, 1, beta, istack, 1);
-
-        // W_h * h + b
-        function.MemoryCopy<ValueType>(hiddenBias, hstack, stackSize); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(stackSize, hiddenUnits, alpha, hiddenWeights, hiddenUnits, hiddenState, 1, beta, hstack, 1);
-
-        // the weights are stacked in 3 slices for (input, reset, hidden).
-        auto istack_slice0 = istack;
-        auto istack_slice1 = function.LocalArray(function.PointerOffset(istack, function.LocalScalar(hiddenUnits)));
-        auto istack_slice2 = function.LocalArray(function.PointerOffset(istack, function.LocalScalar(hiddenUnits * 2)));
-        auto hstack_slice0 = hstack;
-        auto hstack_slice1 = function.LocalArray(function.PointerOffset(hstack, function.LocalScalar(hiddenUnits)));
-        auto hstack_slice2 = function.LocalArray(function.PointerOffset(hstack, function.LocalScalar(hiddenUnits * 2)));
-
-        // input_gate = sigma(W_{ iz } x + b_{ iz } + W_{ hz } h + b_{ hz })
-        function.For(hiddenUnits, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar i) {
-            inputGate[i] = istack_slice0[i] + hstack_slice0[i];
-        });
-        this->ApplyActivation(function, this->_recurrentActivation, inputGate, hiddenUnits);
-
-        // reset_gate = sigma(W_{ ir } x + b_{ ir } + W_{ hr } h + b_{ hr })
-        function.For(hiddenUnits, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar i) {
-            resetGate[i] = istack_slice1[i] + hstack_slice1[i];
+        // W_i * x + b, one matrix multiplication for all 3 gates (input,reset,hidden) and all the timesteps
+        this->EmitInputStacks(function, input, inputWeights, inputBias, istacks, stackSize);
+
+        this->EmitSequence(function, istacks, stackSize, output, [&](emitters::IRFunctionEmitter& fn, emitters::IRLocalArray istack, emitters::LLVMValue stepOutput) {
+            // W_h * h + b
+            fn.MemoryCopy<ValueType>(hiddenBias, hstack, stackSize); // Copy bias values into output so GEMM call accumulates them
+            fn.CallGEMV(stackSize, hiddenUnits, alpha, hiddenWeights, hiddenUnits, hiddenState, 1, beta, hstack, 1);
+
+            // the weights are stacked in 3 slices for (input, reset, hidden).
+            auto istack_slice0 = istack;
+            auto istack_slice1 = fn.LocalArray(fn.PointerOffset(istack, fn.LocalScalar(hiddenUnits)));
+            auto istack_slice2 = fn.LocalArray(fn.PointerOffset(istack, fn.LocalScalar(hiddenUnits * 2)));
+            auto hstack_slice0 = hstack;
+            auto hstack_slice1 = fn.LocalArray(fn.PointerOffset(hstack, fn.LocalScalar(hiddenUnits)));
+            auto hstack_slice2 = fn.LocalArray(fn.PointerOffset(hstack, fn.LocalScalar(hiddenUnits * 2)));
+
+            // input_gate = sigma(W_{ iz } x + b_{ iz } + W_{ hz } h + b_{ hz })
+            fn.For(hiddenUnits, [=](emitters::IRFunctionEmitter&, emitters::IRLocalScalar i) {
+                inputGate[i] = istack_slice0[i] + hstack_slice0[i];
+            });
+            this->ApplyActivation(fn, this->_recurrentActivation, inputGate, hiddenUnits);
+
+            // reset_gate = sigma(W_{ ir } x + b_{ ir } + W_{ hr } h + b_{ hr })
+            fn.For(hiddenUnits, [=](emitters::IRFunctionEmitter&, emitters::IRLocalScalar i) {
+                resetGate[i] = istack_slice1[i] + hstack_slice1[i];
+            });
+            this->ApplyActivation(fn, this->_recurrentActivation, resetGate, hiddenUnits);
+
+            // hidden_gate = tanh(W_{ in } x + b_{ in } + reset_gate * (W_{ hn } h + b_{ hn }))
+            fn.For(hiddenUnits, [=](emitters::IRFunctionEmitter&, emitters::IRLocalScalar i) {
+                hiddenGate[i] = istack_slice2[i] + resetGate[i] * hstack_slice2[i];
+            });
+            this->ApplyActivation(fn, this->_activation, hiddenGate, hiddenUnits);
+
+            //ht = (1 - input_gate) * hidden_gate + input_gate * h
+            //   = hidden_gate - input_gate * hidden_gate + input_gate * h
+            //   = hidden_gate + input_gate (h - hidden_gate )
+            fn.For(outputSize, [=](emitters::IRFunctionEmitter&, emitters::IRLocalScalar i) {
+                auto z_i = inputGate[i];
+                auto n_i = hiddenGate[i];
+                auto h_i = prevHiddenState[i];
+                auto newValue = n_i + z_i * (h_i - n_i);
+                hiddenState[i] = newValue;
+            });
+
+            // Copy hidden state to the output.
+            fn.MemoryCopy<ValueType>(hiddenState, stepOutput, hiddenUnits);
         });
-        this->ApplyActivation(function, this->_recurrentActivation, resetGate, hiddenUnits);
-
-        // hidden_gate = tanh(W_{ in } x + b_{ in } + reset_gate * (W_{ hn } h + b_{ hn }))
-        function.For(hiddenUnits, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar i) {
-            hiddenGate[i] = istack_slice2[i] + resetGate[i] * hstack_slice2[i];
-        });
-        this->ApplyActivation(function, this->_activation, hiddenGate, hiddenUnits);
-
-        //ht = (1 - input_gate) * hidden_gate + input_gate * h
-        //   = hidden_gate - input_gate * hidden_gate + input_gate * h
-        //   = hidden_gate + input_gate (h - hidden_gate )
-
-        function.For(outputSize, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar i) {
-            auto z_i = inputGate[i];
-            auto n_i = hiddenGate[i];
-            auto h_i = prevHiddenState[i];
-            auto newValue = n_i + z_i * (h_i - n_i);
-            hiddenState[i] = newValue;
-        });
-
-        // Copy hidden state to the output.
-        function.MemoryCopy<ValueType>(hiddenState, output, hiddenUnits);
 
         // Add the internal reset function
         std::string resetFunctionName = compiler.GetGlobalName(*this, "GRUNodeReset");
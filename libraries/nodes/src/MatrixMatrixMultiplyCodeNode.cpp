@@ -26,8 +26,11 @@
 
 #include <value/include/CachingStrategies.h>
 #include <value/include/LLVMContext.h>
+#include <value/include/ScheduleTuner.h>
 #include <llvm/Analysis/TargetTransformInfo.h>
 
+#include <algorithm>
+
 //using namespace ell::utilities;
 using namespace ell::value;
 
@@ -35,6 +38,32 @@ namespace ell
 {
 namespace nodes
 {
+    namespace
+    {
+        // The number of timed runs of each GEMM schedule candidate, and the most candidates to time for one problem
+        const int numTuningIterations = 5;
+        const int maxTuningCandidates = 64;
+
+        // Gets the number of floats that fit in a vector register of the target being emitted for
+        int GetVectorSize()
+        {
+            int vectorSize = 4;
+            value::InvokeForContext<value::LLVMContext>([&](value::LLVMContext& context) {
+                auto targetMachine = context.GetModuleEmitter().GetTargetMachine();
+                auto fn = context.GetFunctionEmitter().GetFunction();
+                auto info = targetMachine->getTargetTransformInfo(*fn);
+                // See https://llvm.org/doxygen/classllvm_1_1TargetTransformInfo.html for the big list of amazing things you can get from this TargetMachineInfo object
+                vectorSize = static_cast<int>(info.getRegisterBitWidth(true)) / (8 * sizeof(float));
+                if (vectorSize > 8)
+                {
+                    // The vector width is 16 floats instead of 8 (e.g. in AVX-512)
+                    vectorSize = 16;
+                }
+            });
+            return vectorSize;
+        }
+    } // namespace
+
     template <typename ValueType>
     MatrixMatrixMultiplyCodeNode<ValueType>::MatrixMatrixMultiplyCodeNode() :
         CompilableCodeNode("MatrixMatrixMultiplyCodeNode", { &_input1, &_input2 }, { &_output }),
@@ -219,39 +248,106 @@ namespace nodes
     template <typename ValueType>
     void MatrixMatrixMultiplyCodeNode<ValueType>::Gemm(value::Matrix A, value::Matrix B, value::Matrix C)
     {
-        using namespace value;
+        GemmWithSchedule(A, B, C, GetGemmSchedule((int)A.Rows(), (int)B.Columns(), (int)A.Columns()));
+    }
+
+    template <typename ValueType>
+    value::ScheduleParameters MatrixMatrixMultiplyCodeNode<ValueType>::GetDefaultGemmSchedule(int n, int k)
+    {
+        int vectorSize = GetVectorSize();
+        int kernelRows = vectorSize > 8 ? 12 : 2;
+        int kernelColumnVectors = 2;
+        if (kernelColumnVectors * vectorSize > n)
+        {
+            kernelColumnVectors = 1;
+            kernelRows *= 2;
+        }
 
-        int vectorSize = 4;
-        int NumRowsInKernel = 2;
+        return { { "columnBlock", std::min(64, n) },
+                 { "innerDimensionBlock", std::min(256, k) },
+                 { "kUnroll", 4 },
+                 { "kernelRows", kernelRows },
+                 { "kernelColumnVectors", kernelColumnVectors } };
+    }
 
+    template <typename ValueType>
+    value::ScheduleParameters MatrixMatrixMultiplyCodeNode<ValueType>::GetGemmSchedule(int m, int n, int k)
+    {
+        auto result = GetDefaultGemmSchedule(n, k);
         InvokeForContext<LLVMContext>([&](LLVMContext& context) {
-            auto targetMachine = context.GetModuleEmitter().GetTargetMachine();
-            auto fn = context.GetFunctionEmitter().GetFunction();
-            auto info = targetMachine->getTargetTransformInfo(*fn);
-            // See https://llvm.org/doxygen/classllvm_1_1TargetTransformInfo.html for the big list of amazing things you can get from this TargetMachineInfo object
-            vectorSize = static_cast<int>(info.getRegisterBitWidth(true)) / (8 * sizeof(float));
-            if (vectorSize > 8)
+            const auto& compilerOptions = context.GetModuleEmitter().GetCompilerOptions();
+            const auto& cacheFilename = compilerOptions.scheduleTuningCache;
+            if (cacheFilename.empty())
+            {
+                return;
+            }
+
+            auto key = value::GetScheduleTuningKey("gemm_" + utilities::GetTypeName<ValueType>(), { m, n, k }, compilerOptions.targetDevice);
+            auto& cache = context.GetScheduleTuningCache();
+            if (cache.HasEntry(key))
+            {
+                for (const auto& [name, parameter] : cache.GetEntry(key))
+                {
+                    result[name] = parameter;
+                }
+                return;
+            }
+
+            if (!compilerOptions.tuneSchedules || !(compilerOptions.targetDevice.deviceName.empty() || compilerOptions.targetDevice.deviceName == "host"))
             {
-                // The vector width is 16 floats instead of 8 (e.g. in AVX-512), so double the sizes as needed
-                vectorSize = 16;
-                NumRowsInKernel = 12;
+                return;
             }
+
+            // The block sizes range over the powers of two up to the problem size, so large problems get large blocks to
+            // choose from. When there are more legal candidates than the tuner's budget, a sample of them is timed.
+            const int vectorSize = GetVectorSize();
+            const int maxKernelRegisters = vectorSize > 8 ? 28 : 12; // accumulators that fit in the register file, leaving room for the A and B values
+            value::ScheduleSearchSpace searchSpace;
+            searchSpace.AddParameter("columnBlock", value::ScheduleSearchSpace::PowersOfTwo(std::min(vectorSize, n), std::min(n, 512)));
+            searchSpace.AddParameter("innerDimensionBlock", value::ScheduleSearchSpace::PowersOfTwo(std::min(32, k), std::min(k, 1024)));
+            searchSpace.AddParameter("kUnroll", { 1, 2, 4, 8 });
+            searchSpace.AddParameter("kernelRows", { 1, 2, 4, 6, 8, 12, 16 });
+            searchSpace.AddParameter("kernelColumnVectors", { 1, 2, 3, 4 });
+            searchSpace.AddConstraint([=](const value::ScheduleParameters& candidate) {
+                return candidate.at("kernelColumnVectors") * vectorSize <= std::max(candidate.at("columnBlock"), vectorSize) &&
+                       candidate.at("kUnroll") <= candidate.at("innerDimensionBlock") &&
+                       candidate.at("kernelRows") <= std::max(m, 1) &&
+                       candidate.at("kernelRows") * candidate.at("kernelColumnVectors") <= maxKernelRegisters;
+            });
+
+            value::ScheduleTuner tuner(compilerOptions, numTuningIterations, maxTuningCandidates);
+            auto tuned = tuner.Tune(searchSpace, [=](const value::ScheduleParameters& candidate) {
+                auto A = value::MakeStaticMatrix(m, k, value::GetValueType<ValueType>(), "A");
+                auto B = value::MakeStaticMatrix(k, n, value::GetValueType<ValueType>(), "B");
+                auto C = value::MakeStaticMatrix(m, n, value::GetValueType<ValueType>(), "C");
+                GemmWithSchedule(A, B, C, candidate);
+            });
+
+            // Merge in entries another process may have saved while this node was being tuned before writing the file
+            cache.Load(cacheFilename);
+            cache.SetEntry(key, tuned.parameters);
+            cache.Save(cacheFilename);
+            result = tuned.parameters;
         });
+        return result;
+    }
 
-        int NumColumnsInKernel = 2 * vectorSize;
-        if (NumColumnsInKernel > (int)B.Columns())
-        {
-            NumColumnsInKernel = vectorSize;
-            NumRowsInKernel *= 2;
-        }
+    template <typename ValueType>
+    void MatrixMatrixMultiplyCodeNode<ValueType>::GemmWithSchedule(value::Matrix A, value::Matrix B, value::Matrix C, const value::ScheduleParameters& parameters)
+    {
+        using namespace value;
+
+        const int vectorSize = GetVectorSize();
+        const int NumRowsInKernel = parameters.at("kernelRows");
+        const int NumColumnsInKernel = parameters.at("kernelColumnVectors") * vectorSize;
 
         // Declare and/or calculate constants
         const int OutputRows = (int)(A.Rows());
         const int OutputColumns = (int)(B.Columns());
         const int InnerDimension = (int)(A.Columns());
-        const int kUnroll = 4;
-        int columnBlock = std::min(64, OutputColumns);
-        int innerDimensionBlock = std::min(256, InnerDimension);    
+        const int kUnroll = parameters.at("kUnroll");
+        int columnBlock = parameters.at("columnBlock");
+        int innerDimensionBlock = parameters.at("innerDimensionBlock");
 
         // Declare indexes
         loopnests::Index i("i"), j("j"), k("k");
@@ -299,10 +395,11 @@ namespace nodes
                                             utilities::RowMajorMatrixOrder,
                                             extraZeroInputReduceOutputParams);
 
-        // Set unrolling
+        // Set unrolling and vectorization
         schedule.Unroll(jKernelOuter);
         schedule.Unroll(i);
         schedule.Unroll(k);
+        schedule.Vectorize(j);
 
         // Run the generator
         nest.Run();
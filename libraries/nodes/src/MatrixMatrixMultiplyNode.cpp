@@ -238,10 +238,28 @@ namespace nodes
         emitters::LLVMValue pInput2 = compiler.EnsurePortEmitted(input2);
         emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
 
+        // Per-node options, so a node in a concurrently-computed branch doesn't start its own parallel loop
+        const auto compilerSettings = compiler.GetMapCompilerOptions(*this).compilerSettings;
         if (_transposeOutput)
         {
             function.CallGEMM<ValueType>(!_transpose2, !_transpose1, (int)_n, (int)_m, (int)_k, pInput2, (int)_ldb, pInput1, (int)_lda, pOutput, (int)_ldc);
         }
+        else if (compilerSettings.parallelize && !compilerSettings.useBlas && _m > 1)
+        {
+            // BLAS does its own threading, but the emitted GEMM doesn't: split the output rows across tasks
+            const bool transpose1 = _transpose1;
+            const bool transpose2 = _transpose2;
+            const int n = _n;
+            const int k = _k;
+            const int lda = _lda;
+            const int ldb = _ldb;
+            const int ldc = _ldc;
+            function.ParallelFor(_m, { pInput1, pInput2, pOutput }, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar row, const std::vector<emitters::LLVMValue>& capturedValues) {
+                auto input1Row = function.PointerOffset(capturedValues[0], transpose1 ? row : row * lda);
+                auto outputRow = function.PointerOffset(capturedValues[2], row * ldc);
+                function.CallGEMM<ValueType>(transpose1, transpose2, 1, n, k, input1Row, lda, capturedValues[1], ldb, outputRow, ldc);
+            });
+        }
         else
         {
             function.CallGEMM<ValueType>(_transpose1, _transpose2, (int)_m, (int)_n, (int)_k, pInput1, (int)_lda, pInput2, (int)_ldb, pOutput, (int)_ldc);
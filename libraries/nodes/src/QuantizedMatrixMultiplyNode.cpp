@@ -0,0 +1,229 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizedMatrixMultiplyNode.cpp (nodes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizedMatrixMultiplyNode.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/MemoryLayout.h>
+
+#include <value/include/EmitterContext.h>
+#include <value/include/Matrix.h>
+#include <value/include/Scalar.h>
+#include <value/include/Vector.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ell
+{
+namespace nodes
+{
+    namespace
+    {
+        const int maxQuantizedValue = 127;
+
+        // The value library stores 8-bit integer constants as `char` data. Its Char8 type is signed (in both emitted and
+        // computed code), so the bytes are copied as they are, regardless of whether `char` is signed on the host.
+        std::vector<char> GetWeightBytes(const std::vector<int8_t>& weights)
+        {
+            std::vector<char> result(weights.size());
+            std::memcpy(result.data(), weights.data(), weights.size());
+            return result;
+        }
+    } // namespace
+
+    template <typename ValueType>
+    QuantizedMatrixMultiplyNode<ValueType>::QuantizedMatrixMultiplyNode() :
+        CompilableCodeNode("QuantizedMatrixMultiplyNode", { &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    QuantizedMatrixMultiplyNode<ValueType>::QuantizedMatrixMultiplyNode(const model::OutputPort<ValueType>& input, const std::vector<ValueType>& weights, int m, int n, int k, ValueType inputRange, bool transposeOutput) :
+        QuantizedMatrixMultiplyNode<ValueType>(input, {}, 1, m, n, k, GetQuantizationScale(inputRange), transposeOutput)
+    {
+        if (static_cast<int>(weights.size()) != m * k)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Weights matrix must have m x k entries");
+        }
+
+        ValueType weightRange = 0;
+        for (auto weight : weights)
+        {
+            weightRange = std::max(weightRange, static_cast<ValueType>(std::abs(weight)));
+        }
+
+        _weightScale = GetQuantizationScale(weightRange);
+        _weights.resize(weights.size());
+        std::transform(weights.begin(), weights.end(), _weights.begin(), [this](ValueType weight) { return Quantize(weight, _weightScale); });
+    }
+
+    template <typename ValueType>
+    QuantizedMatrixMultiplyNode<ValueType>::QuantizedMatrixMultiplyNode(const model::OutputPort<ValueType>& input, const std::vector<int8_t>& quantizedWeights, ValueType weightScale, int m, int n, int k, ValueType inputScale, bool transposeOutput) :
+        CompilableCodeNode("QuantizedMatrixMultiplyNode", { &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, transposeOutput ? utilities::MemoryShape{ n, m } : utilities::MemoryShape{ m, n }),
+        _weights(quantizedWeights),
+        _weightScale(weightScale),
+        _inputScale(inputScale),
+        _m(m),
+        _n(n),
+        _k(k),
+        _transposeOutput(transposeOutput)
+    {
+        if (static_cast<int>(input.Size()) != k * n)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Input must be a k x n matrix");
+        }
+        if (weightScale <= 0 || inputScale <= 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Quantization scales must be positive");
+        }
+    }
+
+    template <typename ValueType>
+    ValueType QuantizedMatrixMultiplyNode<ValueType>::GetQuantizationScale(ValueType range)
+    {
+        return range > 0 ? range / maxQuantizedValue : ValueType{ 1 };
+    }
+
+    template <typename ValueType>
+    int8_t QuantizedMatrixMultiplyNode<ValueType>::Quantize(ValueType value, ValueType scale)
+    {
+        auto quantized = std::round(value / scale);
+        return static_cast<int8_t>(std::max<ValueType>(-maxQuantizedValue, std::min<ValueType>(maxQuantizedValue, quantized)));
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixMultiplyNode<ValueType>::Define(value::FunctionDeclaration& fn)
+    {
+        (void)fn.Define([this](const value::Value inputValue, value::Value outputValue) {
+            auto tempInput = inputValue;
+            tempInput.SetLayout(utilities::MemoryLayout({ _k, _n }));
+            auto tempOutput = outputValue;
+            if (_transposeOutput)
+            {
+                tempOutput.SetLayout(utilities::MemoryLayout({ _n, _m }, utilities::DimensionOrder{ 1, 0 }));
+            }
+            else
+            {
+                tempOutput.SetLayout(utilities::MemoryLayout({ _m, _n }));
+            }
+
+            auto X = value::Matrix(tempInput);
+            auto C = value::Matrix(tempOutput);
+            auto W = value::Matrix(value::StaticAllocate("quantizedWeights", GetWeightBytes(_weights), utilities::MemoryLayout({ _m, _k })));
+
+            // Quantize the input
+            const ValueType inverseInputScale = 1 / _inputScale;
+            // The scratch buffers are module globals rather than stack allocations, since k x n can be large. They're
+            // thread-local so that separate contexts can run the model concurrently.
+            auto quantizedX = value::Matrix(value::StaticAllocate("quantizedInput", value::GetValueType<int8_t>(), utilities::MemoryLayout({ _k, _n }), value::AllocateFlags::ThreadLocal));
+            value::ForRange(_k, [&](value::Scalar row) {
+                value::ForRange(_n, [&](value::Scalar column) {
+                    auto scaled = value::Round(X(row, column) * inverseInputScale);
+                    quantizedX(row, column) = value::Cast<int8_t>(value::Max(value::Min(scaled, static_cast<ValueType>(maxQuantizedValue)), static_cast<ValueType>(-maxQuantizedValue)));
+                });
+            });
+
+            // Multiply, widening the int8 values to int32 before accumulating, then rescale the int32 sums
+            const ValueType outputScale = _inputScale * _weightScale;
+            if (_n == 1)
+            {
+                // Each output is an int8 dot product, left to LLVM's loop vectorizer as a widening multiply-accumulate reduction
+                auto accumulator = value::MakeScalar<int>("accumulator");
+                value::ForRange(_m, [&](value::Scalar i) {
+                    accumulator = 0;
+                    value::ForRange(_k, [&](value::Scalar k) {
+                        accumulator += value::Cast<int>(W(i, k)) * value::Cast<int>(quantizedX(k, 0));
+                    });
+                    C(i, 0) = value::Cast<ValueType>(accumulator) * outputScale;
+                });
+            }
+            else
+            {
+                // Accumulate a row of the output at a time, so the innermost loop runs over contiguous int8 inputs
+                auto accumulators = value::Vector(value::StaticAllocate("accumulators", value::ValueType::Int32, utilities::MemoryLayout({ _n }), value::AllocateFlags::ThreadLocal));
+                value::ForRange(_m, [&](value::Scalar i) {
+                    value::ForRange(_n, [&](value::Scalar j) {
+                        accumulators[j] = 0;
+                    });
+                    value::ForRange(_k, [&](value::Scalar k) {
+                        auto weight = value::Cast<int>(W(i, k));
+                        value::ForRange(_n, [&](value::Scalar j) {
+                            accumulators[j] += weight * value::Cast<int>(quantizedX(k, j));
+                        });
+                    });
+                    value::ForRange(_n, [&](value::Scalar j) {
+                        C(i, j) = value::Cast<ValueType>(accumulators[j]) * outputScale;
+                    });
+                });
+            }
+        });
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixMultiplyNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<QuantizedMatrixMultiplyNode<ValueType>>(newInput, _weights, _weightScale, _m, _n, _k, _inputScale, _transposeOutput);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    utilities::ArchiveVersion QuantizedMatrixMultiplyNode<ValueType>::GetArchiveVersion() const
+    {
+        constexpr utilities::ArchiveVersion currentArchiveVersion = { utilities::ArchiveVersionNumbers::v2 };
+        return std::max(currentArchiveVersion, CompilableCodeNode::GetArchiveVersion());
+    }
+
+    template <typename ValueType>
+    bool QuantizedMatrixMultiplyNode<ValueType>::CanReadArchiveVersion(const utilities::ArchiveVersion& version) const
+    {
+        return CompilableCodeNode::CanReadArchiveVersion(version);
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixMultiplyNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver[defaultOutputPortName] << _output;
+        archiver["weights"] << _weights;
+        archiver["weightScale"] << _weightScale;
+        archiver["inputScale"] << _inputScale;
+        archiver["m"] << _m;
+        archiver["n"] << _n;
+        archiver["k"] << _k;
+        archiver["transposeOutput"] << _transposeOutput;
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixMultiplyNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver[defaultOutputPortName] >> _output;
+        archiver["weights"] >> _weights;
+        archiver["weightScale"] >> _weightScale;
+        archiver["inputScale"] >> _inputScale;
+        archiver["m"] >> _m;
+        archiver["n"] >> _n;
+        archiver["k"] >> _k;
+        archiver["transposeOutput"] >> _transposeOutput;
+    }
+
+    //
+    // Explicit instantiation definitions
+    //
+    template class QuantizedMatrixMultiplyNode<float>;
+    template class QuantizedMatrixMultiplyNode<double>;
+} // namespace nodes
+} // namespace ell
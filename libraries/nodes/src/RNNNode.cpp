@@ -44,7 +44,8 @@ namespace nodes
                                 const model::OutputPort<ValueType>& inputBias,
                                 const model::OutputPort<ValueType>& hiddenBias,
                                 const ActivationType& activation,
-                                bool validateWeights) :
+                                bool validateWeights,
+                                size_t sequenceLength) :
         CompilableNode({ &_input, &_resetTrigger, &_inputWeights, &_hiddenWeights, &_inputBias, &_hiddenBias },
                        { &_output }),
         _input(this, input, defaultInputPortName),
@@ -54,14 +55,21 @@ namespace nodes
         _hiddenWeights(this, hiddenWeights, hiddenWeightsPortName),
         _inputBias(this, inputBias, inputBiasPortName),
         _hiddenBias(this, hiddenBias, hiddenBiasPortName),
-        _output(this, defaultOutputPortName, hiddenUnits),
+        _output(this, defaultOutputPortName, hiddenUnits * sequenceLength),
         _activation(activation),
+        _sequenceLength(sequenceLength),
         _hiddenState(hiddenUnits)
     {
+        if (sequenceLength == 0 || input.Size() % sequenceLength != 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument,
+                                            ell::utilities::FormatString("The RNNNode input size %zu isn't a multiple of the sequence length %zu", input.Size(), sequenceLength));
+        }
+
         if (validateWeights)
         {
             size_t numRows = hiddenUnits;
-            size_t numColumns = input.Size();
+            size_t numColumns = GetInputSize();
 
             if (inputWeights.Size() != numRows * numColumns)
             {
@@ -99,7 +107,7 @@ namespace nodes
         const auto& newHiddenWeights = transformer.GetCorrespondingInputs(this->_hiddenWeights);
         const auto& newInputBias = transformer.GetCorrespondingInputs(this->_inputBias);
         const auto& newHiddenBias = transformer.GetCorrespondingInputs(this->_hiddenBias);
-        auto newNode = transformer.AddNode<RNNNode>(newInput, newResetTrigger, this->_hiddenUnits, newInputWeights, newHiddenWeights, newInputBias, newHiddenBias, this->_activation);
+        auto newNode = transformer.AddNode<RNNNode>(newInput, newResetTrigger, this->_hiddenUnits, newInputWeights, newHiddenWeights, newInputBias, newHiddenBias, this->_activation, true, this->_sequenceLength);
         transformer.MapNodeOutput(this->output, newNode->output);
     }
 
@@ -112,44 +120,69 @@ namespace nodes
         // h = tanh(it)
 
         size_t hiddenUnits = this->_hiddenUnits;
-        VectorType inputVector(this->_input.GetValue());
         size_t numRows = hiddenUnits;
-        size_t numColumns = inputVector.Size();
-        std::vector<ValueType> inputWeightsValue = this->_inputWeights.GetValue();
-        ConstMatrixReferenceType inputWeights(inputWeightsValue.data(), numRows, numColumns);
-        numColumns = hiddenUnits;
+        size_t numColumns = hiddenUnits;
         std::vector<ValueType> hiddenWeightsValue = this->_hiddenWeights.GetValue();
         ConstMatrixReferenceType hiddenWeights(hiddenWeightsValue.data(), numRows, numColumns);
-        VectorType inputBias(this->_inputBias.GetValue());
         VectorType hiddenBias(this->_hiddenBias.GetValue());
 
         auto alpha = static_cast<ValueType>(1); // GEMV scale multiplication
         auto beta = static_cast<ValueType>(1); // GEMV scale bias
 
-        // W_i * x + b_i
-        VectorType input_gate(inputBias); // add input bias
-        math::MultiplyScaleAddUpdate(alpha, inputWeights, inputVector, beta, input_gate);
+        // W_i * x + b_i, for all the timesteps
+        auto inputStacks = ComputeInputStacks(hiddenUnits);
 
-        // Wh * h + b_h
-        VectorType hidden_gate(hiddenBias); // add hidden bias
-        math::MultiplyScaleAddUpdate(alpha, hiddenWeights, this->_hiddenState, beta, hidden_gate);
+        std::vector<ValueType> outputValues;
+        outputValues.reserve(hiddenUnits * this->_sequenceLength);
+        for (size_t t = 0; t < this->_sequenceLength; ++t)
+        {
+            VectorType input_gate(hiddenUnits);
+            input_gate.CopyFrom(inputStacks.GetRow(t).Transpose());
 
-        // compute: W_{ ii } x + b_{ ii } +W_{ hi } h + b_{ hi }
-        input_gate += hidden_gate;
+            // Wh * h + b_h
+            VectorType hidden_gate(hiddenBias); // add hidden bias
+            math::MultiplyScaleAddUpdate(alpha, hiddenWeights, this->_hiddenState, beta, hidden_gate);
 
-        // tanh(...)
-        this->_activation.Apply(input_gate);
+            // compute: W_{ ii } x + b_{ ii } +W_{ hi } h + b_{ hi }
+            input_gate += hidden_gate;
 
-        // save new state.
-        this->_hiddenState.CopyFrom(input_gate);
+            // tanh(...)
+            this->_activation.Apply(input_gate);
+
+            // save new state.
+            this->_hiddenState.CopyFrom(input_gate);
+            auto hiddenStateValues = this->_hiddenState.ToArray();
+            outputValues.insert(outputValues.end(), hiddenStateValues.begin(), hiddenStateValues.end());
+        }
 
         if (ShouldReset())
         {
             const_cast<RNNNode<ValueType>*>(this)->Reset();
+            std::fill(outputValues.end() - hiddenUnits, outputValues.end(), static_cast<ValueType>(0));
         }
 
         // copy to output.
-        this->_output.SetOutput(this->_hiddenState.ToArray());
+        this->_output.SetOutput(outputValues);
+    }
+
+    template <typename ValueType>
+    math::RowMatrix<ValueType> RNNNode<ValueType>::ComputeInputStacks(size_t stackSize) const
+    {
+        size_t inputSize = GetInputSize();
+        std::vector<ValueType> inputValue = this->_input.GetValue();
+        math::ConstRowMatrixReference<ValueType> inputs(inputValue.data(), this->_sequenceLength, inputSize);
+        std::vector<ValueType> inputWeightsValue = this->_inputWeights.GetValue();
+        math::ConstRowMatrixReference<ValueType> inputWeights(inputWeightsValue.data(), stackSize, inputSize);
+        std::vector<ValueType> inputBias = this->_inputBias.GetValue();
+
+        // Start with the bias in every row, so the matrix multiplication accumulates onto it
+        math::RowMatrix<ValueType> inputStacks(this->_sequenceLength, stackSize);
+        for (size_t t = 0; t < this->_sequenceLength; ++t)
+        {
+            std::copy(inputBias.begin(), inputBias.end(), inputStacks.GetRow(t).GetDataPointer());
+        }
+        math::MultiplyScaleAddUpdate(static_cast<ValueType>(1), inputs, inputWeights.Transpose(), static_cast<ValueType>(1), inputStacks);
+        return inputStacks;
     }
 
     template <typename ValueType>
@@ -206,13 +239,58 @@ namespace nodes
         });
     }
 
+    template <typename ValueType>
+    void RNNNode<ValueType>::EmitInputStacks(emitters::IRFunctionEmitter& function, emitters::LLVMValue input, emitters::LLVMValue inputWeights, emitters::LLVMValue inputBias, emitters::LLVMValue inputStacks, int stackSize)
+    {
+        const int inputSize = static_cast<int>(GetInputSize());
+        const int sequenceLength = static_cast<int>(this->_sequenceLength);
+        if (sequenceLength == 1)
+        {
+            auto alpha = static_cast<ValueType>(1.0); // GEMV scaling of the matrix multipication
+            auto beta = static_cast<ValueType>(1.0); // GEMV scaling of the bias addition
+            function.MemoryCopy<ValueType>(inputBias, inputStacks, stackSize); // Copy bias values into output so GEMM call accumulates them
+            function.CallGEMV(stackSize, inputSize, alpha, inputWeights, inputSize, input, 1, beta, inputStacks, 1);
+            return;
+        }
+
+        // X * W_i', with one row per timestep, in a single matrix multiplication
+        function.CallGEMM<ValueType>(false, true, sequenceLength, stackSize, inputSize, input, inputSize, inputWeights, inputSize, inputStacks, stackSize);
+
+        // + b_i
+        auto stacks = function.LocalArray(inputStacks);
+        auto bias = function.LocalArray(inputBias);
+        function.For(sequenceLength, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar t) {
+            fn.For(stackSize, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar i) {
+                stacks[t * stackSize + i] = stacks[t * stackSize + i] + bias[i];
+            });
+        });
+    }
+
+    template <typename ValueType>
+    void RNNNode<ValueType>::EmitSequence(emitters::IRFunctionEmitter& function, emitters::LLVMValue inputStacks, int stackSize, emitters::LLVMValue output, EmitStepFunction emitStep)
+    {
+        const int hiddenUnits = static_cast<int>(this->_hiddenUnits);
+        const int sequenceLength = static_cast<int>(this->_sequenceLength);
+        if (sequenceLength == 1)
+        {
+            emitStep(function, function.LocalArray(inputStacks), output);
+            return;
+        }
+
+        function.For(sequenceLength, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar t) {
+            auto inputStack = fn.LocalArray(fn.PointerOffset(inputStacks, t * stackSize));
+            auto stepOutput = fn.PointerOffset(output, t * hiddenUnits);
+            emitStep(fn, inputStack, stepOutput);
+        });
+    }
+
     template <typename ValueType>
     void RNNNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
         // it = sigma(W_{ ii } x + b_{ ii } +W_{ hi } h + b_{ hi })
         // h = tanh(it)
         const int hiddenUnits = static_cast<int>(this->_hiddenUnits);
-        const int inputSize = static_cast<int>(this->input.Size());
+        const int sequenceLength = static_cast<int>(this->_sequenceLength);
 
         // Get LLVM references for all node inputs
         auto input = compiler.EnsurePortEmitted(this->input);
@@ -222,7 +300,7 @@ namespace nodes
         auto hiddenBias = compiler.EnsurePortEmitted(this->hiddenBias);
 
         // Get LLVM reference for node output
-        auto output = function.LocalArray(compiler.EnsurePortEmitted(this->output));
+        auto output = compiler.EnsurePortEmitted(this->output);
 
         // Allocate global buffer for hidden state
         emitters::IRModuleEmitter& module = function.GetModule();
@@ -233,33 +311,34 @@ namespace nodes
         auto& prevHiddenState = hiddenState;
 
         // Allocate local variables
-        auto inputGate = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), hiddenUnits));
+        auto inputGates = function.Variable(emitters::GetVariableType<ValueType>(), hiddenUnits * sequenceLength);
         auto hiddenGate = function.LocalArray(function.Variable(emitters::GetVariableType<ValueType>(), hiddenUnits));
 
         auto alpha = static_cast<ValueType>(1.0); // GEMV scaling of the matrix multipication
         auto beta = static_cast<ValueType>(1.0); // GEMV scaling of the bias addition
 
-        // W_i * x + b_i
-        function.MemoryCopy<ValueType>(inputBias, inputGate, hiddenUnits); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(hiddenUnits, inputSize, alpha, inputWeights, inputSize, input, 1, beta, inputGate, 1);
+        // W_i * x + b_i, for all the timesteps
+        EmitInputStacks(function, input, inputWeights, inputBias, inputGates, hiddenUnits);
 
-        // W_h * h + b_h
-        function.MemoryCopy<ValueType>(hiddenBias, hiddenGate, hiddenUnits); // Copy bias values into output so GEMM call accumulates them
-        function.CallGEMV(hiddenUnits, hiddenUnits, alpha, hiddenWeights, hiddenUnits, prevHiddenState, 1, beta, hiddenGate, 1);
+        EmitSequence(function, inputGates, hiddenUnits, output, [&](emitters::IRFunctionEmitter& fn, emitters::IRLocalArray inputGate, emitters::LLVMValue stepOutput) {
+            // W_h * h + b_h
+            fn.MemoryCopy<ValueType>(hiddenBias, hiddenGate, hiddenUnits); // Copy bias values into output so GEMM call accumulates them
+            fn.CallGEMV(hiddenUnits, hiddenUnits, alpha, hiddenWeights, hiddenUnits, prevHiddenState, 1, beta, hiddenGate, 1);
 
-        // input_gate = sigma(W_{ iz } x + b_{ iz } + W_{ hz } h + b_{ hz })
-        function.For(hiddenUnits, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar i) {
-            inputGate[i] = inputGate[i] + hiddenGate[i];
-        });
+            // input_gate = sigma(W_{ iz } x + b_{ iz } + W_{ hz } h + b_{ hz })
+            fn.For(hiddenUnits, [=](emitters::IRFunctionEmitter&, emitters::IRLocalScalar i) {
+                inputGate[i] = inputGate[i] + hiddenGate[i];
+            });
 
-        // tanh
-        this->ApplyActivation(function, this->_activation, inputGate, hiddenUnits);
+            // tanh
+            this->ApplyActivation(fn, this->_activation, inputGate, hiddenUnits);
 
-        // save new HiddenState
-        function.MemoryCopy<ValueType>(inputGate, hiddenState, hiddenUnits);
+            // save new HiddenState
+            fn.MemoryCopy<ValueType>(inputGate, hiddenState, hiddenUnits);
 
-        // Copy hidden state to the output.
-        function.MemoryCopy<ValueType>(hiddenState, output, hiddenUnits);
+            // Copy hidden state to the output.
+            fn.MemoryCopy<ValueType>(hiddenState, stepOutput, hiddenUnits);
+        });
 
         // Add the internal reset function
         std::string resetFunctionName = compiler.GetGlobalName(*this, "RNNNodeReset");
@@ -295,6 +374,7 @@ namespace nodes
         archiver[defaultInputPortName] << _input;
         archiver[resetTriggerPortName] << _resetTrigger;
         archiver["hiddenUnits"] << _hiddenUnits;
+        archiver["sequenceLength"] << _sequenceLength;
         archiver[inputWeightsPortName] << _inputWeights;
         archiver[hiddenWeightsPortName] << _hiddenWeights;
         archiver[inputBiasPortName] << _inputBias;
@@ -310,6 +390,7 @@ namespace nodes
         archiver[defaultInputPortName] >> _input;
         archiver[resetTriggerPortName] >> _resetTrigger;
         archiver["hiddenUnits"] >> _hiddenUnits;
+        archiver.OptionalProperty("sequenceLength", size_t(1)) >> _sequenceLength;
         archiver[inputWeightsPortName] >> _inputWeights;
         archiver[hiddenWeightsPortName] >> _hiddenWeights;
         archiver[inputBiasPortName] >> _inputBias;
@@ -318,7 +399,7 @@ namespace nodes
         _activation.ReadFromArchive(archiver);
 
         _hiddenState.Resize(_hiddenUnits);
-        this->_output.SetSize(_hiddenUnits);
+        this->_output.SetSize(_hiddenUnits * _sequenceLength);
     }
 
     // Explicit instantiations
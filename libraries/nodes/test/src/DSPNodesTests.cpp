@@ -32,6 +32,7 @@
 #include <nodes/include/DelayNode.h>
 #include <nodes/include/DiagonalConvolutionNode.h>
 #include <nodes/include/FFTNode.h>
+#include <nodes/include/FastGRNNNode.h>
 #include <nodes/include/FilterBankNode.h>
 #include <nodes/include/GRUNode.h>
 #include <nodes/include/IIRFilterNode.h>
@@ -683,8 +684,45 @@ static void TestConvolutionNodeCompileVsReference(ImageShape inputShape, Filters
 }
 
 //
-// Recurrent layer nodes (Recurrent, GRU, LSTM)
+// Recurrent layer nodes (Recurrent, GRU, LSTM, FastGRNN)
 //
+
+// Runs each of the inputs through a recurrent node in sequence mode, as one sequence, and checks that its output holds the hidden state after each of them
+template <typename NodeType, typename... ActivationTypes>
+static void TestRecurrentNodeSequence(const std::vector<std::vector<double>>& inputs, const std::vector<std::vector<double>>& expectedOutputs, const std::vector<double>& inputWeights, const std::vector<double>& hiddenWeights, const std::vector<double>& inputBias, const std::vector<double>& hiddenBias, size_t hiddenSize, ActivationTypes... activations)
+{
+    using ElementType = double;
+
+    std::vector<ElementType> sequence;
+    std::vector<ElementType> expectedOutput;
+    for (size_t t = 0; t < inputs.size(); ++t)
+    {
+        sequence.insert(sequence.end(), inputs[t].begin(), inputs[t].end());
+        expectedOutput.insert(expectedOutput.end(), expectedOutputs[t].begin(), expectedOutputs[t].end());
+    }
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(sequence.size());
+    auto resetTriggerNode = model.AddNode<nodes::ConstantNode<int>>(0);
+    auto inputWeightsNode = model.AddNode<nodes::ConstantNode<ElementType>>(inputWeights);
+    auto hiddenWeightsNode = model.AddNode<nodes::ConstantNode<ElementType>>(hiddenWeights);
+    auto inputBiasNode = model.AddNode<nodes::ConstantNode<ElementType>>(inputBias);
+    auto hiddenBiasNode = model.AddNode<nodes::ConstantNode<ElementType>>(hiddenBias);
+    auto node = model.AddNode<NodeType>(inputNode->output, resetTriggerNode->output, hiddenSize, inputWeightsNode->output, hiddenWeightsNode->output, inputBiasNode->output, hiddenBiasNode->output, activations..., true, inputs.size());
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", node->output } });
+
+    TestWithSerialization(map, "TestRecurrentNodeSequence", [&](model::Map& map, int iteration) {
+        model::MapCompilerOptions settings;
+        settings.compilerSettings.useBlas = true;
+        model::ModelOptimizerOptions optimizerOptions;
+        model::IRMapCompiler compiler(settings, optimizerOptions);
+        auto compiledMap = compiler.Compile(map);
+
+        std::string message = node->GetRuntimeTypeName() + utilities::FormatString(" sequence of %zu iteration %d", inputs.size(), iteration);
+        VerifyCompiledOutputAndResult<ElementType, ElementType>(map, compiledMap, { sequence }, { expectedOutput }, message);
+    });
+}
+
 void TestRNNNode()
 {
     using ElementType = double;
@@ -761,6 +799,15 @@ void TestRNNNode()
             VerifyCompiledOutputAndResult<ElementType, ElementType>(map, compiledMap, signal, { expectedOutput.ToArray() }, message);
         }
     });
+
+    // The same inputs, given to the node as one sequence, should produce the same hidden states
+    std::vector<std::vector<ElementType>> expectedOutputs;
+    for (auto h : h_t)
+    {
+        expectedOutputs.emplace_back(h, h + hiddenSize);
+    }
+    std::vector<std::vector<ElementType>> inputs(expectedOutputs.size(), input.ToArray());
+    TestRecurrentNodeSequence<nodes::RNNNode<ElementType>>(inputs, expectedOutputs, inputWeights.ToArray(), hiddenWeights.ToArray(), inputBias.ToArray(), hiddenBias.ToArray(), hiddenSize, activation);
 }
 void TestGRUNode()
 {
@@ -840,6 +887,15 @@ void TestGRUNode()
             VerifyCompiledOutputAndResult<ElementType, ElementType>(map, compiledMap, signal, { expectedOutput.ToArray() }, message);
         }
     });
+
+    // The same inputs, given to the node as one sequence, should produce the same hidden states
+    std::vector<std::vector<ElementType>> expectedOutputs;
+    for (auto h : h_t)
+    {
+        expectedOutputs.emplace_back(h, h + hiddenSize);
+    }
+    std::vector<std::vector<ElementType>> inputs(expectedOutputs.size(), input.ToArray());
+    TestRecurrentNodeSequence<nodes::GRUNode<ElementType>>(inputs, expectedOutputs, inputWeights.ToArray(), hiddenWeights.ToArray(), inputBias.ToArray(), hiddenBias.ToArray(), hiddenSize, activation, recurrentActivation);
 }
 
 void TestLSTMNode()
@@ -917,6 +973,94 @@ void TestLSTMNode()
             VerifyCompiledOutputAndResult<ElementType, ElementType>(map, compiledMap, signal, { expectedOutput.ToArray() }, message);
         }
     });
+
+    // The same inputs, given to the node as one sequence, should produce the same hidden states
+    std::vector<std::vector<ElementType>> expectedOutputs;
+    for (auto h : h_t)
+    {
+        expectedOutputs.emplace_back(h, h + hiddenSize);
+    }
+    std::vector<std::vector<ElementType>> inputs(expectedOutputs.size(), input.ToArray());
+    TestRecurrentNodeSequence<nodes::LSTMNode<ElementType>>(inputs, expectedOutputs, inputWeights.ToArray(), hiddenWeights.ToArray(), inputBias.ToArray(), hiddenBias.ToArray(), hiddenSize, Activation<ElementType>(new TanhActivation<ElementType>()), Activation<ElementType>(new SigmoidActivation<ElementType>()));
+}
+
+// Runs a sequence through a FastGRNN node in sequence mode, and checks its computed and compiled outputs against the hidden states from stepping through the sequence directly
+void TestFastGRNNNodeSequence(size_t wRank, size_t uRank)
+{
+    using ElementType = double;
+    using namespace ell::predictors::neural;
+
+    const size_t inputSize = 4;
+    const size_t hiddenSize = 3;
+    const size_t sequenceLength = 5;
+
+    std::vector<ElementType> sequence(sequenceLength * inputSize);
+    std::vector<ElementType> W1(wRank == 0 ? hiddenSize * inputSize : wRank * inputSize);
+    std::vector<ElementType> W2(wRank == 0 ? 1 : hiddenSize * wRank); // unused if wRank is 0
+    std::vector<ElementType> U1(uRank == 0 ? hiddenSize * hiddenSize : uRank * hiddenSize);
+    std::vector<ElementType> U2(uRank == 0 ? 1 : hiddenSize * uRank); // unused if uRank is 0
+    std::vector<ElementType> biasGate(hiddenSize);
+    std::vector<ElementType> biasUpdate(hiddenSize);
+    for (auto vector : { &sequence, &W1, &W2, &U1, &U2, &biasGate, &biasUpdate })
+    {
+        FillRandomVector(*vector, -0.5, 0.5);
+    }
+    const ElementType zeta = 0.75;
+    const ElementType nu = 0.125;
+
+    // result = weights * vector, where weights has `rows` rows
+    auto multiply = [](const std::vector<ElementType>& weights, size_t rows, const std::vector<ElementType>& vector) {
+        size_t columns = vector.size();
+        std::vector<ElementType> result(rows, 0);
+        for (size_t row = 0; row < rows; ++row)
+        {
+            for (size_t column = 0; column < columns; ++column)
+            {
+                result[row] += weights[row * columns + column] * vector[column];
+            }
+        }
+        return result;
+    };
+
+    std::vector<ElementType> expectedOutput;
+    std::vector<ElementType> hiddenState(hiddenSize, 0);
+    for (size_t t = 0; t < sequenceLength; ++t)
+    {
+        std::vector<ElementType> x(sequence.begin() + t * inputSize, sequence.begin() + (t + 1) * inputSize);
+        auto wx = wRank == 0 ? multiply(W1, hiddenSize, x) : multiply(W2, hiddenSize, multiply(W1, wRank, x));
+        auto uh = uRank == 0 ? multiply(U1, hiddenSize, hiddenState) : multiply(U2, hiddenSize, multiply(U1, uRank, hiddenState));
+        for (size_t i = 0; i < hiddenSize; ++i)
+        {
+            auto z = 1 / (1 + std::exp(-(wx[i] + uh[i] + biasGate[i])));
+            auto h = std::tanh(wx[i] + uh[i] + biasUpdate[i]);
+            hiddenState[i] = (zeta * (1 - z) + nu) * h + z * hiddenState[i];
+        }
+        expectedOutput.insert(expectedOutput.end(), hiddenState.begin(), hiddenState.end());
+    }
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(sequence.size());
+    auto resetTriggerNode = model.AddNode<nodes::ConstantNode<int>>(0);
+    auto W1Node = model.AddNode<nodes::ConstantNode<ElementType>>(W1);
+    auto W2Node = model.AddNode<nodes::ConstantNode<ElementType>>(W2);
+    auto U1Node = model.AddNode<nodes::ConstantNode<ElementType>>(U1);
+    auto U2Node = model.AddNode<nodes::ConstantNode<ElementType>>(U2);
+    auto biasGateNode = model.AddNode<nodes::ConstantNode<ElementType>>(biasGate);
+    auto biasUpdateNode = model.AddNode<nodes::ConstantNode<ElementType>>(biasUpdate);
+    auto zetaNode = model.AddNode<nodes::ConstantNode<ElementType>>(zeta);
+    auto nuNode = model.AddNode<nodes::ConstantNode<ElementType>>(nu);
+    auto node = model.AddNode<nodes::FastGRNNNode<ElementType>>(inputNode->output, resetTriggerNode->output, hiddenSize, wRank, uRank, W1Node->output, W2Node->output, U1Node->output, U2Node->output, biasGateNode->output, biasUpdateNode->output, zetaNode->output, nuNode->output, Activation<ElementType>(new SigmoidActivation<ElementType>()), Activation<ElementType>(new TanhActivation<ElementType>()), sequenceLength);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", node->output } });
+
+    TestWithSerialization(map, "TestFastGRNNNodeSequence", [&](model::Map& map, int iteration) {
+        model::MapCompilerOptions settings;
+        model::ModelOptimizerOptions optimizerOptions;
+        model::IRMapCompiler compiler(settings, optimizerOptions);
+        auto compiledMap = compiler.Compile(map);
+
+        std::string message = utilities::FormatString("FastGRNNNode sequence of %zu with wRank %zu, uRank %zu iteration %d", sequenceLength, wRank, uRank, iteration);
+        VerifyCompiledOutputAndResult<ElementType, ElementType>(map, compiledMap, { sequence }, { expectedOutput }, message);
+    });
 }
 
 //
@@ -927,6 +1071,8 @@ void TestDSPNodes(const std::string& path)
     TestRNNNode();
     TestGRUNode();
     TestLSTMNode();
+    TestFastGRNNNodeSequence(0, 0);
+    TestFastGRNNNodeSequence(2, 2);
 
     //
     // Compute tests
@@ -19,8 +19,12 @@
 #include <model/include/InputNode.h>
 #include <model/include/Model.h>
 #include <model/include/Node.h>
+#include <model/include/SpliceNode.h>
 
+#include <nodes/include/DTWDistanceNode.h>
 #include <nodes/include/DiagonalConvolutionNode.h>
+#include <nodes/include/MovingAverageNode.h>
+#include <nodes/include/MovingVarianceNode.h>
 #include <nodes/include/SimpleConvolutionNode.h>
 #include <nodes/include/UnrolledConvolutionNode.h>
 #include <nodes/include/WinogradConvolutionNode.h>
@@ -245,6 +249,93 @@ static void TimeConvolutionNode(ImageShape inputShape, FiltersShape filterShape,
               << "(reference: " << referenceTime << " ms)\n";
 }
 
+// Times a moving-window statistic node (MovingAverageNode or MovingVarianceNode), compiled and interpreted
+template <typename NodeType, typename ValueType>
+static void TimeMovingStatisticNode(int dimension, int windowSize, int numIterations)
+{
+    std::vector<ValueType> data(dimension);
+    FillRandomVector(data);
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(dimension);
+    auto statisticNode = model.AddNode<NodeType>(inputNode->output, windowSize);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", statisticNode->output } });
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+
+    utilities::MillisecondTimer timer;
+    for (int index = 0; index < numIterations; ++index)
+    {
+        compiledMap.SetInputValue(0, data);
+        volatile auto compiledResult = compiledMap.ComputeOutput<ValueType>(0);
+    }
+    auto compiledTime = timer.Elapsed();
+
+    timer.Reset();
+    for (int index = 0; index < numIterations; ++index)
+    {
+        map.SetInputValue(0, data);
+        volatile auto computedResult = map.ComputeOutput<ValueType>(0);
+    }
+    auto computedTime = timer.Elapsed();
+
+    std::cout << "Total time for " << numIterations << " samples of " << statisticNode->GetRuntimeTypeName() << " with dimension " << dimension << " and window size " << windowSize << ": " << compiledTime << " ms\t"
+              << "(interpreted: " << computedTime << " ms)\n";
+}
+
+// Times a bank of DTWDistanceNodes that all match the same input signal against their own prototypes, compiled and interpreted
+template <typename ValueType>
+static void TimeDTWDistanceNodes(int dimension, int prototypeLength, int numPrototypes, int bandWidth, int numIterations)
+{
+    std::vector<ValueType> data(dimension);
+    FillRandomVector(data);
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(dimension);
+    std::vector<const model::OutputPortBase*> distances;
+    for (int prototypeIndex = 0; prototypeIndex < numPrototypes; ++prototypeIndex)
+    {
+        std::vector<std::vector<ValueType>> prototype(prototypeLength, std::vector<ValueType>(dimension));
+        for (auto& row : prototype)
+        {
+            FillRandomVector(row);
+        }
+        auto dtwNode = model.AddNode<nodes::DTWDistanceNode<ValueType>>(inputNode->output, prototype, bandWidth);
+        distances.push_back(&dtwNode->output);
+    }
+    auto spliceNode = model.AddNode<model::SpliceNode<ValueType>>(distances);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", spliceNode->output } });
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+
+    utilities::MillisecondTimer timer;
+    for (int index = 0; index < numIterations; ++index)
+    {
+        compiledMap.SetInputValue(0, data);
+        volatile auto compiledResult = compiledMap.ComputeOutput<ValueType>(0);
+    }
+    auto compiledTime = timer.Elapsed();
+
+    timer.Reset();
+    for (int index = 0; index < numIterations; ++index)
+    {
+        map.SetInputValue(0, data);
+        volatile auto computedResult = map.ComputeOutput<ValueType>(0);
+    }
+    auto computedTime = timer.Elapsed();
+
+    std::cout << "Total time for " << numIterations << " samples of " << numPrototypes << " DTW distances with dimension " << dimension << ", prototype length " << prototypeLength << " and band width " << bandWidth << ": " << compiledTime << " ms\t"
+              << "(interpreted: " << computedTime << " ms, " << (numIterations * 1000.0 / compiledTime) << " samples/s compiled)\n";
+}
+
 //
 // Main driver function to call all the timing functions
 //
@@ -253,6 +344,19 @@ void TimeDSPNodes()
     //
     // Timings on jitted models
     //
+    TimeMovingStatisticNode<nodes::MovingAverageNode<float>, float>(40, 1024, 10000);
+    TimeMovingStatisticNode<nodes::MovingAverageNode<float>, float>(40, 16384, 10000);
+    TimeMovingStatisticNode<nodes::MovingVarianceNode<float>, float>(40, 1024, 10000);
+    TimeMovingStatisticNode<nodes::MovingVarianceNode<float>, float>(40, 16384, 10000);
+    std::cout << std::endl;
+
+    for (int numPrototypes : { 1, 10, 100 })
+    {
+        TimeDTWDistanceNodes<float>(3, 50, numPrototypes, 0, 1000);
+        TimeDTWDistanceNodes<float>(3, 50, numPrototypes, 5, 1000);
+    }
+    std::cout << std::endl;
+
     TimeConvolutionNode<float>({ 240, 240, 3 }, { 16, 3, 3, 0 }, 10, dsp::ConvolutionMethodOption::simple);
     TimeConvolutionNode<float>({ 240, 240, 3 }, { 16, 3, 3, 0 }, 10, dsp::ConvolutionMethodOption::unrolled);
     TimeConvolutionNode<float>({ 240, 240, 3 }, { 16, 3, 3, 0 }, 10, dsp::ConvolutionMethodOption::winograd, { 2, dsp::WinogradFilterOrder::tilesFirst });
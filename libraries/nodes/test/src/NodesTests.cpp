@@ -18,6 +18,7 @@
 #include <nodes/include/ConstantNode.h>
 #include <nodes/include/DemultiplexerNode.h>
 #include <nodes/include/FilterBankNode.h>
+#include <nodes/include/FlatForestPredictorNode.h>
 #include <nodes/include/ForestPredictorNode.h>
 #include <nodes/include/IIRFilterNode.h>
 #include <nodes/include/L2NormSquaredNode.h>
@@ -498,6 +499,39 @@ static void TestSimpleForestPredictorNodeRefine()
     testing::ProcessTest("Testing SimpleForestPredictorNode refine (edgeIndicatorVector)", testing::IsEqual(edgeIndicatorVectorValue, refinedEdgeIndicatorVectorValue));
 }
 
+static void TestFlatForestPredictorNode()
+{
+    using SplitAction = predictors::SimpleForestPredictor::SplitAction;
+    using SplitRule = predictors::SingleElementThresholdPredictor;
+    using EdgePredictorVector = std::vector<predictors::ConstantPredictor>;
+
+    predictors::SimpleForestPredictor forest;
+    auto root = forest.Split(SplitAction{ forest.GetNewRootId(), SplitRule{ 0, 0.3 }, EdgePredictorVector{ -1.0, 1.0 } });
+    forest.Split(SplitAction{ forest.GetChildId(root, 0), SplitRule{ 1, 0.6 }, EdgePredictorVector{ -2.0, 2.0 } });
+    forest.Split(SplitAction{ forest.GetChildId(root, 1), SplitRule{ 2, 0.9 }, EdgePredictorVector{ -4.0, 4.0 } });
+    forest.Split(SplitAction{ forest.GetNewRootId(), SplitRule{ 0, 0.2 }, EdgePredictorVector{ -3.0, 3.0 } });
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(3);
+    auto forestNode = model.AddNode<nodes::SimpleForestPredictorNode>(inputNode->output, forest);
+    auto flatForestNode = model.AddNode<nodes::FlatForestPredictorNode>(inputNode->output, predictors::FlatForestPredictor(forest));
+
+    bool outputsEqual = true;
+    bool treeOutputsEqual = true;
+    bool edgeIndicatorVectorsEqual = true;
+    for (auto input : std::vector<std::vector<double>>{ { 0.18, 0.5, 0.0 }, { 0.25, 0.7, 1.0 }, { 0.4, 0.1, 0.95 }, { 0.9, 0.9, 0.2 } })
+    {
+        inputNode->SetInput(input);
+        outputsEqual = outputsEqual && testing::IsEqual(model.ComputeOutput(forestNode->output), model.ComputeOutput(flatForestNode->output));
+        treeOutputsEqual = treeOutputsEqual && testing::IsEqual(model.ComputeOutput(forestNode->treeOutputs), model.ComputeOutput(flatForestNode->treeOutputs));
+        edgeIndicatorVectorsEqual = edgeIndicatorVectorsEqual && testing::IsEqual(model.ComputeOutput(forestNode->edgeIndicatorVector), model.ComputeOutput(flatForestNode->edgeIndicatorVector));
+    }
+
+    testing::ProcessTest("Testing FlatForestPredictorNode (output)", outputsEqual);
+    testing::ProcessTest("Testing FlatForestPredictorNode (treeOutputs)", treeOutputsEqual);
+    testing::ProcessTest("Testing FlatForestPredictorNode (edgeIndicatorVector)", edgeIndicatorVectorsEqual);
+}
+
 static void TestSquaredEuclideanDistanceNodeRefine()
 {
     ComputeContext context("TestSquaredEuclideanDistanceNodeRefine");
@@ -841,6 +875,7 @@ void TestNodes()
     TestLinearPredictorNodeRefine<float>();
     TestMovingAverageNodeRefine();
     TestSimpleForestPredictorNodeRefine();
+    TestFlatForestPredictorNode();
     TestDemultiplexerNodeRefine();
     TestMatrixVectorProductRefine();
     TestEuclideanDistanceNodeRefine();
@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConvolutionTuningDatabase.h (passes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/ModelOptimizerOptions.h>
+
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// A table of the fastest measured convolution method for each convolution problem, where a problem is
+    /// described by the layer's shape, the target device and the number of threads. The table can be saved to
+    /// and loaded from a text file, with one `key<tab>method` entry per line.
+    /// </summary>
+    class ConvolutionTuningDatabase
+    {
+    public:
+        ConvolutionTuningDatabase() = default;
+
+        /// <summary> Constructor that loads the entries from a file, if it exists. </summary>
+        ///
+        /// <param name="filename"> The path to the database file. </param>
+        explicit ConvolutionTuningDatabase(const std::string& filename);
+
+        /// <summary> Indicates if the database has a method for the given problem. </summary>
+        ///
+        /// <param name="key"> The key describing the convolution problem. </param>
+        ///
+        /// <returns> `true` if there is an entry for the key. </returns>
+        bool HasEntry(const std::string& key) const;
+
+        /// <summary> Gets the method stored for the given problem. </summary>
+        ///
+        /// <param name="key"> The key describing the convolution problem. </param>
+        ///
+        /// <returns> The fastest method measured for the problem. Throws an exception if the key isn't present. </returns>
+        model::PreferredConvolutionMethod GetEntry(const std::string& key) const;
+
+        /// <summary> Sets the method for the given problem. </summary>
+        ///
+        /// <param name="key"> The key describing the convolution problem. </param>
+        /// <param name="method"> The fastest method measured for the problem. </param>
+        void SetEntry(const std::string& key, model::PreferredConvolutionMethod method);
+
+        /// <summary> Gets the number of entries in the database. </summary>
+        ///
+        /// <returns> The number of entries. </returns>
+        size_t NumEntries() const { return _entries.size(); }
+
+        /// <summary> Gets all the entries, sorted by key. </summary>
+        ///
+        /// <returns> The map from problem keys to methods. </returns>
+        const std::map<std::string, model::PreferredConvolutionMethod>& GetEntries() const { return _entries; }
+
+        /// <summary> Adds the entries read from a stream, replacing existing entries with the same key. </summary>
+        ///
+        /// <param name="stream"> The stream to read from. </param>
+        void Read(std::istream& stream);
+
+        /// <summary> Writes the entries to a stream. </summary>
+        ///
+        /// <param name="stream"> The stream to write to. </param>
+        void Write(std::ostream& stream) const;
+
+        /// <summary> Adds the entries from a file, if it exists. </summary>
+        ///
+        /// <param name="filename"> The path to the database file. </param>
+        void Load(const std::string& filename);
+
+        /// <summary> Saves the entries to a file, replacing its contents. </summary>
+        ///
+        /// <param name="filename"> The path to the database file. </param>
+        void Save(const std::string& filename) const;
+
+    private:
+        std::map<std::string, model::PreferredConvolutionMethod> _entries;
+    };
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizationCalibrator.h (passes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Map.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary> The node metadata entry that holds the largest absolute value seen on a node's input during calibration. </summary>
+    constexpr const char* quantizationInputRangeKey = "quantizationInputRange";
+
+    /// <summary> Indicates if the quantization transformation knows how to rewrite the given node with int8 arithmetic. </summary>
+    ///
+    /// <param name="node"> The node to check. </param>
+    ///
+    /// <returns> `true` for convolutional layer, fully-connected layer and matrix multiply nodes. </returns>
+    bool IsQuantizableNode(const model::Node& node);
+
+    /// <summary>
+    /// Measures the range of the activations flowing into the quantizable nodes of a map (see `IsQuantizableNode`),
+    /// by running a representative set of examples through it. Neural network predictor nodes are refined into
+    /// their layers first, so each layer gets a range of its own. The calibrated map records each node's range in its
+    /// metadata, where `QuantizeToInt8Transformation` finds it.
+    /// </summary>
+    class QuantizationCalibrator
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="map"> The map to calibrate. It must have a single input. </param>
+        explicit QuantizationCalibrator(const model::Map& map);
+
+        /// <summary> Runs an example through the map and widens the recorded ranges to include its activations. </summary>
+        ///
+        /// <param name="input"> The input to the map. </param>
+        void AddExample(const std::vector<double>& input);
+
+        /// <summary> Gets the number of examples seen so far. </summary>
+        size_t NumExamples() const { return _numExamples; }
+
+        /// <summary> Gets the number of nodes whose input ranges are being measured. </summary>
+        size_t NumQuantizableNodes() const { return _nodes.size(); }
+
+        /// <summary> Gets the largest absolute value seen on the input of the given node. </summary>
+        ///
+        /// <param name="node"> A quantizable node in the calibrated map. </param>
+        ///
+        /// <returns> The range of the node's input. </returns>
+        double GetInputRange(const model::Node& node) const;
+
+        /// <summary> Gets the calibrated map, with each quantizable node's input range stored in its metadata. </summary>
+        ///
+        /// <returns> The calibrated map. </returns>
+        const model::Map& GetCalibratedMap();
+
+    private:
+        model::Map _map;
+        std::vector<const model::Node*> _nodes;
+        std::unordered_map<const model::Node*, double> _ranges;
+        size_t _numExamples = 0;
+    };
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,32 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizeToInt8Transformation.h (passes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Transformation.h>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// A transformation that replaces calibrated convolutional layer, fully-connected layer and matrix multiply nodes
+    /// with `QuantizedMatrixMultiplyNode`s, which do their arithmetic in int8 with int32 accumulation. It only runs
+    /// when the `quantizeInt8` model optimizer option is set, and only rewrites nodes that have an input range
+    /// recorded in their metadata by a `QuantizationCalibrator`.
+    /// </summary>
+    class QuantizeToInt8Transformation : public model::Transformation
+    {
+    public:
+        /// <summary> Replace calibrated nodes with int8 versions. </summary>
+        model::Submodel Transform(const model::Submodel& submodel, model::ModelTransformer& transformer, const model::TransformContext& context) const override;
+
+        /// <summary> Returns the ID for this transformation </summary>
+        std::string GetRuntimeTypeName() const override { return { "QuantizeToInt8Transformation" }; };
+    };
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConvolutionTuningDatabase.cpp (passes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ConvolutionTuningDatabase.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+#include <utilities/include/StringUtil.h>
+
+namespace ell
+{
+namespace passes
+{
+    ConvolutionTuningDatabase::ConvolutionTuningDatabase(const std::string& filename)
+    {
+        Load(filename);
+    }
+
+    bool ConvolutionTuningDatabase::HasEntry(const std::string& key) const
+    {
+        return _entries.find(key) != _entries.end();
+    }
+
+    model::PreferredConvolutionMethod ConvolutionTuningDatabase::GetEntry(const std::string& key) const
+    {
+        auto it = _entries.find(key);
+        if (it == _entries.end())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "No convolution tuning entry for " + key);
+        }
+        return it->second;
+    }
+
+    void ConvolutionTuningDatabase::SetEntry(const std::string& key, model::PreferredConvolutionMethod method)
+    {
+        if (key.find_first_of("\t\n") != std::string::npos)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Convolution tuning keys can't contain tabs or newlines");
+        }
+        _entries[key] = method;
+    }
+
+    void ConvolutionTuningDatabase::Read(std::istream& stream)
+    {
+        std::string line;
+        while (std::getline(stream, line))
+        {
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+
+            auto separator = line.rfind('\t');
+            if (separator == std::string::npos)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::badStringFormat, "Malformed convolution tuning entry: " + line);
+            }
+            _entries[line.substr(0, separator)] = utilities::FromString<model::PreferredConvolutionMethod>(line.substr(separator + 1));
+        }
+    }
+
+    void ConvolutionTuningDatabase::Write(std::ostream& stream) const
+    {
+        stream << "# ELL convolution tuning database: problem<tab>fastest method" << std::endl;
+        for (const auto& entry : _entries)
+        {
+            stream << entry.first << '\t' << model::ToString(entry.second) << std::endl;
+        }
+    }
+
+    void ConvolutionTuningDatabase::Load(const std::string& filename)
+    {
+        if (!utilities::FileExists(filename))
+        {
+            return;
+        }
+
+        auto stream = utilities::OpenIfstream(filename);
+        Read(stream);
+    }
+
+    void ConvolutionTuningDatabase::Save(const std::string& filename) const
+    {
+        auto stream = utilities::OpenOfstream(filename);
+        Write(stream);
+    }
+} // namespace passes
+} // namespace ell
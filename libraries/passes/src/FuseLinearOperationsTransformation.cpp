@@ -156,17 +156,17 @@ LinearCoefficients<ValueType> GetCombinedLinearCoeffs(const nodes::BroadcastLine
     }
     else if (node1Inputs.scaleNode == nullptr) // s1 == 1, so s' = s2
     {
-        coefficients.scale = node2Inputs.scaleNode->GetValues(); // s2
+        coefficients.scale = node2Inputs.scaleNode->GetValues().ToVector(); // s2
     }
     else if (node2Inputs.scaleNode == nullptr) // s2 == 1, so s' = s1,
     {
-        coefficients.scale = node1Inputs.scaleNode->GetValues(); // s1
+        coefficients.scale = node1Inputs.scaleNode->GetValues().ToVector(); // s1
     }
     else // s' = s1*s2*x
     {
-        coefficients.scale = node1Inputs.scaleNode->GetValues(); // scale = s1
+        coefficients.scale = node1Inputs.scaleNode->GetValues().ToVector(); // scale = s1
         const auto& s2 = node2Inputs.scaleNode->GetValues();
-        assert(s2.size() == coefficients.scale.size());
+        assert(s2.Size() == coefficients.scale.size());
         for (size_t index = 0; index < coefficients.scale.size(); ++index)
         {
             coefficients.scale[index] *= s2[index];
@@ -180,15 +180,15 @@ LinearCoefficients<ValueType> GetCombinedLinearCoeffs(const nodes::BroadcastLine
     }
     else if (node1Inputs.biasNode == nullptr) // b1 == 0, so b' = b2
     {
-        coefficients.bias = node2Inputs.biasNode->GetValues(); // b2
+        coefficients.bias = node2Inputs.biasNode->GetValues().ToVector(); // b2
     }
     else // b' = (b1*s2) + b1 (but s2 may be 1, and b1 may be zero)
     {
-        coefficients.bias = node1Inputs.biasNode->GetValues(); // bias == b1
+        coefficients.bias = node1Inputs.biasNode->GetValues().ToVector(); // bias == b1
         if (node2Inputs.scaleNode != nullptr) // if s2 is present, set bias = bias*s2
         {
             const auto& s2 = node2Inputs.scaleNode->GetValues();
-            assert(s2.size() == coefficients.bias.size());
+            assert(s2.Size() == coefficients.bias.size());
             for (size_t index = 0; index < coefficients.bias.size(); ++index)
             {
                 coefficients.bias[index] *= s2[index];
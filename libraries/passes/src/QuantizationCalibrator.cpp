@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizationCalibrator.cpp (passes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizationCalibrator.h"
+
+#include <data/include/DataVector.h>
+
+#include <model/include/InputPort.h>
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+#include <model/include/TransformContext.h>
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ell
+{
+namespace passes
+{
+    namespace
+    {
+        bool IsNeuralNetworkPredictorNode(const model::Node& node)
+        {
+            return (node.GetRuntimeTypeName().find("NeuralNetworkPredictorNode") == 0);
+        }
+
+        bool IsMatrixMatrixMultiplyNode(const model::Node& node)
+        {
+            return (node.GetRuntimeTypeName().find("MatrixMatrixMultiplyNode<") == 0);
+        }
+
+        // The input whose range determines the quantization scale: the data input of a layer, or the
+        // right-hand side of a matrix multiply (the left-hand side holds the weights)
+        const model::InputPortBase& GetObservedInput(const model::Node& node)
+        {
+            return *node.GetInputPort(IsMatrixMatrixMultiplyNode(node) ? 1 : 0);
+        }
+    } // namespace
+
+    bool IsQuantizableNode(const model::Node& node)
+    {
+        const auto typeName = node.GetRuntimeTypeName();
+        return typeName.find("ConvolutionalLayerNode") == 0 ||
+               typeName.find("FullyConnectedLayerNode") == 0 ||
+               IsMatrixMatrixMultiplyNode(node);
+    }
+
+    QuantizationCalibrator::QuantizationCalibrator(const model::Map& map) :
+        _map(map)
+    {
+        if (_map.NumInputs() != 1)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Quantization calibration requires a map with a single input");
+        }
+
+        // Refine the neural network predictors, so each layer is a node of its own
+        model::TransformContext context{ [](const model::Node& node) {
+            return IsNeuralNetworkPredictorNode(node) ? model::NodeAction::refine : model::NodeAction::compile;
+        } };
+        _map.Refine(context);
+
+        _map.GetModel().Visit([this](const model::Node& node) {
+            if (IsQuantizableNode(node))
+            {
+                _nodes.push_back(&node);
+                _ranges[&node] = 0;
+            }
+        });
+    }
+
+    void QuantizationCalibrator::AddExample(const std::vector<double>& input)
+    {
+        if (input.size() != _map.GetInputSize())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Calibration example doesn't match the size of the map's input");
+        }
+
+        // Computing through a data vector converts the input to whatever type the map takes
+        _map.Compute<data::DoubleDataVector>(data::DoubleDataVector(input));
+        for (auto node : _nodes)
+        {
+            auto& range = _ranges[node];
+            for (auto value : GetObservedInput(*node).GetReferencedPort().GetDoubleOutput())
+            {
+                range = std::max(range, std::abs(value));
+            }
+        }
+        ++_numExamples;
+    }
+
+    double QuantizationCalibrator::GetInputRange(const model::Node& node) const
+    {
+        auto it = _ranges.find(&node);
+        if (it == _ranges.end())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Node " + node.GetId().ToString() + " isn't a quantizable node of the calibrated map");
+        }
+        return it->second;
+    }
+
+    const model::Map& QuantizationCalibrator::GetCalibratedMap()
+    {
+        auto& model = _map.GetModel();
+        for (auto node : _nodes)
+        {
+            model.GetNode(node->GetId())->GetMetadata().SetEntry(quantizationInputRangeKey, _ranges[node]);
+        }
+        return _map;
+    }
+} // namespace passes
+} // namespace ell
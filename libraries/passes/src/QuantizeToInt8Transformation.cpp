@@ -0,0 +1,251 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizeToInt8Transformation.cpp (passes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizeToInt8Transformation.h"
+#include "QuantizationCalibrator.h"
+
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+
+#include <nodes/include/ConstantNode.h>
+#include <nodes/include/ConvolutionalLayerNode.h>
+#include <nodes/include/FullyConnectedLayerNode.h>
+#include <nodes/include/MatrixMatrixMultiplyNode.h>
+#include <nodes/include/QuantizedMatrixMultiplyNode.h>
+#include <nodes/include/ReceptiveFieldMatrixNode.h>
+#include <nodes/include/ReorderDataCodeNode.h>
+
+#include <utilities/include/Logger.h>
+#include <utilities/include/StlVectorUtil.h>
+
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    using namespace model;
+    using utilities::logging::Log;
+
+    namespace
+    {
+        template <typename Container, typename Function>
+        auto Transform(const Container& container, Function fn)
+        {
+            return utilities::TransformVector(container.begin(), container.end(), fn);
+        }
+
+        std::vector<const OutputPortBase*> GetReferencedPorts(const std::vector<const InputPortBase*>& inputs)
+        {
+            return Transform(inputs, [](auto input) { return &input->GetReferencedPort(); });
+        }
+
+        bool IsSimpleMatrixLayout(const PortMemoryLayout& layout)
+        {
+            return layout.NumDimensions() == 2 && layout.IsCanonicalOrder() && !layout.HasPadding();
+        }
+
+        template <typename ValueType>
+        ValueType GetInputRange(const Node& node)
+        {
+            return static_cast<ValueType>(node.GetMetadata().GetOrParseEntry<double>(quantizationInputRangeKey, 0.0));
+        }
+
+        // Convolutions are done as a receptive field matrix (in row, column, channel order) multiplied by the filter
+        // weights, like the unrolled convolution method, but with the multiplication done in int8.
+        template <typename ValueType>
+        bool TryQuantizeConvolution(const Node& node, ModelTransformer& transformer)
+        {
+            auto thisNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node);
+            if (thisNode == nullptr)
+            {
+                return false;
+            }
+
+            const auto& layer = thisNode->GetLayer();
+            const auto& weights = layer.GetWeights();
+            if (weights.NumChannels() == 1)
+            {
+                // Leave depthwise-separable convolutions alone: they do too little arithmetic to be worth quantizing
+                transformer.CopyNode(node);
+                return true;
+            }
+
+            const auto originalInputLayout = thisNode->GetInputMemoryLayout();
+            const auto originalOutputLayout = thisNode->GetOutputMemoryLayout();
+            const auto convInputLayout = originalInputLayout.ReorderedCopy({ utilities::RowMajorTensorOrder });
+            const auto inputPadding = convInputLayout.GetLogicalDimensionOffset(0);
+            const auto inputDepth = convInputLayout.GetLogicalDimensionActiveSize(2);
+            const auto outputHeight = originalOutputLayout.GetLogicalDimensionActiveSize(0);
+            const auto outputWidth = originalOutputLayout.GetLogicalDimensionActiveSize(1);
+            const auto numFilters = originalOutputLayout.GetLogicalDimensionActiveSize(2);
+            const auto filterSize = static_cast<int>(layer.GetConvolutionalParameters().receptiveField);
+            const auto stride = static_cast<int>(layer.GetConvolutionalParameters().stride);
+
+            // weights: numFilters x fieldVolumeSize == m x k
+            // receptive field matrix: fieldVolumeSize x outputRows == k x n
+            const int m = numFilters;
+            const int n = outputHeight * outputWidth;
+            const int k = filterSize * filterSize * inputDepth;
+
+            // The filters are stacked in the row dimension of the weights tensor
+            std::vector<ValueType> weightsMatrix(m * k);
+            for (int filter = 0; filter < m; ++filter)
+            {
+                for (int row = 0; row < filterSize; ++row)
+                {
+                    for (int column = 0; column < filterSize; ++column)
+                    {
+                        for (int channel = 0; channel < inputDepth; ++channel)
+                        {
+                            weightsMatrix[filter * k + (row * filterSize + column) * inputDepth + channel] = weights(filter * filterSize + row, column, channel);
+                        }
+                    }
+                }
+            }
+
+            const auto& newInput = transformer.GetCorrespondingInputs(thisNode->input);
+            const auto& preConvReorder = nodes::ReorderDataWithCodeNode(newInput, originalInputLayout, convInputLayout);
+            auto receptiveFieldMatrixNode = transformer.AddNode<nodes::ReceptiveFieldMatrixNode<ValueType>>(preConvReorder, convInputLayout, filterSize, stride, inputPadding, utilities::RowMajorTensorOrder, outputWidth, outputHeight);
+            auto quantizedNode = transformer.AddNode<nodes::QuantizedMatrixMultiplyNode<ValueType>>(receptiveFieldMatrixNode->output, weightsMatrix, m, n, k, GetInputRange<ValueType>(node), true);
+            quantizedNode->GetMetadata() = node.GetMetadata();
+
+            // The transposed product is an (outputRows x numFilters) matrix, which is the unpadded output image in row-major order
+            PortMemoryLayout convOutputLayout(MemoryShape{ outputHeight, outputWidth, numFilters });
+            const auto& postConvReorder = nodes::ReorderDataWithCodeNode(quantizedNode->output, convOutputLayout, originalOutputLayout);
+            transformer.MapNodeOutput(thisNode->output, postConvReorder);
+
+            Log() << "Quantized convolution node " << thisNode->GetId() << " to int8" << std::endl;
+            return true;
+        }
+
+        template <typename ValueType>
+        bool TryQuantizeFullyConnected(const Node& node, ModelTransformer& transformer)
+        {
+            auto thisNode = dynamic_cast<const nodes::FullyConnectedLayerNode<ValueType>*>(&node);
+            if (thisNode == nullptr)
+            {
+                return false;
+            }
+
+            const auto& weights = thisNode->GetLayer().GetWeights();
+            const int m = static_cast<int>(weights.NumRows());
+            const int k = static_cast<int>(weights.NumColumns());
+            const auto& newInput = transformer.GetCorrespondingInputs(thisNode->input);
+            if (static_cast<int>(newInput.Size()) != k || static_cast<int>(thisNode->output.Size()) != m)
+            {
+                // Padded inputs and outputs aren't supported
+                transformer.CopyNode(node);
+                return true;
+            }
+
+            std::vector<ValueType> weightsMatrix(m * k);
+            for (int i = 0; i < m; ++i)
+            {
+                for (int j = 0; j < k; ++j)
+                {
+                    weightsMatrix[i * k + j] = weights(i, j);
+                }
+            }
+
+            auto quantizedNode = transformer.AddNode<nodes::QuantizedMatrixMultiplyNode<ValueType>>(newInput, weightsMatrix, m, 1, k, GetInputRange<ValueType>(node));
+            quantizedNode->GetMetadata() = node.GetMetadata();
+            transformer.MapNodeOutput(thisNode->output, quantizedNode->output);
+
+            Log() << "Quantized fully-connected node " << thisNode->GetId() << " to int8" << std::endl;
+            return true;
+        }
+
+        // Only products of a constant matrix with a computed one can be quantized ahead of time
+        template <typename ValueType>
+        bool TryQuantizeMatrixMultiply(const Node& node, ModelTransformer& transformer)
+        {
+            auto thisNode = dynamic_cast<const nodes::MatrixMatrixMultiplyNode<ValueType>*>(&node);
+            if (thisNode == nullptr)
+            {
+                return false;
+            }
+
+            auto weightsNode = dynamic_cast<const nodes::ConstantNode<ValueType>*>(thisNode->input1.GetReferencedPort().GetNode());
+            const auto input1Layout = thisNode->input1.GetMemoryLayout();
+            const auto input2Layout = thisNode->input2.GetMemoryLayout();
+            const auto outputLayout = thisNode->output.GetMemoryLayout();
+            if (weightsNode == nullptr || !IsSimpleMatrixLayout(input1Layout) || !IsSimpleMatrixLayout(input2Layout) || !IsSimpleMatrixLayout(outputLayout))
+            {
+                transformer.CopyNode(node);
+                return true;
+            }
+
+            const int m = input1Layout.GetLogicalDimensionActiveSize(0);
+            const int k = input1Layout.GetLogicalDimensionActiveSize(1);
+            const int n = input2Layout.GetLogicalDimensionActiveSize(1);
+            const auto& weights = weightsNode->GetValues();
+            if (static_cast<int>(weights.Size()) != m * k)
+            {
+                transformer.CopyNode(node);
+                return true;
+            }
+
+            const auto& newInput = transformer.GetCorrespondingInputs(thisNode->input2);
+            auto quantizedNode = transformer.AddNode<nodes::QuantizedMatrixMultiplyNode<ValueType>>(newInput, weights.ToVector(), m, n, k, GetInputRange<ValueType>(node));
+            quantizedNode->GetMetadata() = node.GetMetadata();
+            transformer.MapNodeOutput(thisNode->output, quantizedNode->output);
+
+            Log() << "Quantized matrix multiply node " << thisNode->GetId() << " to int8" << std::endl;
+            return true;
+        }
+
+        template <typename ValueType>
+        bool TryQuantizeNode(const Node& node, ModelTransformer& transformer)
+        {
+            return TryQuantizeConvolution<ValueType>(node, transformer) ||
+                   TryQuantizeFullyConnected<ValueType>(node, transformer) ||
+                   TryQuantizeMatrixMultiply<ValueType>(node, transformer);
+        }
+
+        void QuantizeNode(const Node& node, ModelTransformer& transformer)
+        {
+            if (TryQuantizeNode<float>(node, transformer))
+            {
+                return;
+            }
+            if (TryQuantizeNode<double>(node, transformer))
+            {
+                return;
+            }
+
+            transformer.CopyNode(node);
+        }
+    } // namespace
+
+    Submodel QuantizeToInt8Transformation::Transform(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context) const
+    {
+        auto compiler = context.GetCompiler();
+        if (!compiler || !compiler->GetModelOptimizerOptions().GetEntry<bool>("quantizeInt8", false))
+        {
+            return submodel;
+        }
+
+        auto onto = transformer.GetCorrespondingOutputs(GetReferencedPorts(submodel.GetInputs()));
+        model::Model destModel = submodel.GetModel().ShallowCopy();
+        auto result = transformer.TransformSubmodelOnto(submodel, destModel, onto, context, [compiler](const Node& node, ModelTransformer& transformer) {
+            bool shouldQuantize = IsQuantizableNode(node) &&
+                                  node.GetMetadata().HasEntry(quantizationInputRangeKey) &&
+                                  compiler->GetModelOptimizerOptions(node).GetEntry<bool>("quantizeInt8", false);
+            if (shouldQuantize)
+            {
+                QuantizeNode(node, transformer);
+            }
+            else
+            {
+                transformer.CopyNode(node);
+            }
+        });
+        return result;
+    }
+} // namespace passes
+} // namespace ell
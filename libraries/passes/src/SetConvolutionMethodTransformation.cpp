@@ -7,7 +7,14 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "SetConvolutionMethodTransformation.h"
+#include "ConvolutionTuningDatabase.h"
 
+#include <emitters/include/TargetDevice.h>
+
+#include <model/include/IRCompiledMap.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputNode.h>
+#include <model/include/Map.h>
 #include <model/include/ModelTransformer.h>
 #include <model/include/RefineTransformation.h>
 
@@ -19,6 +26,10 @@
 #include <utilities/include/Logger.h>
 #include <utilities/include/StlVectorUtil.h>
 
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 namespace ell
@@ -119,6 +130,192 @@ namespace passes
             return true;
         }
 
+        bool IsHostTarget(const emitters::TargetDevice& targetDevice)
+        {
+            return targetDevice.deviceName.empty() || targetDevice.deviceName == "host";
+        }
+
+        // Describes the problem a convolution node solves, in a form usable as a tuning database key
+        template <typename ValueType>
+        std::string GetTuningKey(const nodes::ConvolutionalLayerNode<ValueType>& node, const emitters::CompilerOptions& settings)
+        {
+            const auto& layer = node.GetLayer();
+            auto inputShape = layer.GetInputShape();
+            auto outputShape = layer.GetOutputShape();
+            auto convolutionalParameters = layer.GetConvolutionalParameters();
+            const auto& targetDevice = settings.targetDevice;
+
+            // Timings from one CPU don't carry over to another, so resolve the host to its actual CPU and features
+            auto isHost = IsHostTarget(targetDevice);
+            auto resolvedDevice = isHost ? emitters::GetTargetDevice("host") : targetDevice;
+
+            std::stringstream key;
+            key << (std::is_same<ValueType, float>::value ? "float" : "double")
+                << " input=" << inputShape.NumRows() << "x" << inputShape.NumColumns() << "x" << inputShape.NumChannels()
+                << " output=" << outputShape.NumRows() << "x" << outputShape.NumColumns() << "x" << outputShape.NumChannels()
+                << " inputPadding=" << layer.GetLayerParameters().inputPaddingParameters.paddingSize
+                << " outputPadding=" << layer.GetLayerParameters().outputPaddingParameters.paddingSize
+                << " weightChannels=" << layer.GetWeights().NumChannels()
+                << " receptiveField=" << convolutionalParameters.receptiveField
+                << " stride=" << convolutionalParameters.stride
+                << " target=" << (isHost ? std::string("host") : targetDevice.deviceName)
+                << " triple=" << resolvedDevice.triple
+                << " cpu=" << resolvedDevice.cpu
+                << " features=" << resolvedDevice.features
+                << " threads=" << (settings.parallelize ? settings.maxThreads : 1);
+            return key.str();
+        }
+
+        // Compiles a model with just the given convolution, using the given method, and returns its average run time
+        template <typename ValueType>
+        double TimeConvolutionMethod(const nodes::ConvolutionalLayerNode<ValueType>& node, model::PreferredConvolutionMethod method, const model::MapCompilerOptions& compilerOptions, int numIterations)
+        {
+            const int numBurnInIterations = 2;
+
+            model::Model model;
+            auto inputNode = model.AddNode<model::InputNode<ValueType>>(node.input.GetMemoryLayout());
+            auto convolutionNode = model.AddNode<nodes::ConvolutionalLayerNode<ValueType>>(inputNode->output, node.GetLayer());
+            model::Map map(model, { { "input", inputNode } }, { { "output", convolutionNode->output } });
+
+            auto settings = compilerOptions;
+            settings.profile = true;
+            model::ModelOptimizerOptions optimizerOptions;
+            optimizerOptions["preferredConvolutionMethod"] = method;
+            model::IRMapCompiler compiler(settings, optimizerOptions);
+            auto compiledMap = compiler.Compile(map);
+
+            std::vector<ValueType> input(compiledMap.GetInputSize(), 1);
+            for (int iteration = 0; iteration < numBurnInIterations; ++iteration)
+            {
+                compiledMap.Compute<ValueType>(input);
+            }
+
+            compiledMap.ResetModelProfilingInfo();
+            for (int iteration = 0; iteration < numIterations; ++iteration)
+            {
+                compiledMap.Compute<ValueType>(input);
+            }
+
+            auto counters = compiledMap.GetModelPerformanceCounters();
+            return counters->totalTime / std::max(counters->count, 1);
+        }
+
+        // Chooses convolution methods from a tuning database, measuring the candidate methods for the problems the database doesn't have
+        class ConvolutionMethodTuner
+        {
+        public:
+            ConvolutionMethodTuner(const model::TransformContext& context) :
+                _compiler(context.GetCompiler())
+            {
+                if (_compiler == nullptr)
+                {
+                    return;
+                }
+
+                auto options = _compiler->GetModelOptimizerOptions();
+                _databaseFilename = options.GetEntry<std::string>("convolutionTuningCache", "");
+                _autotune = options.GetEntry<bool>("autotuneConvolutionMethod", false);
+                _numIterations = options.GetEntry<int>("autotuneIterations", 10);
+                if (!_databaseFilename.empty())
+                {
+                    _database.Load(_databaseFilename);
+                }
+            }
+
+            model::PreferredConvolutionMethod GetMethod(const model::Node& node)
+            {
+                auto method = model::PreferredConvolutionMethod::automatic;
+                if (_autotune || _database.NumEntries() > 0)
+                {
+                    if (!TryGetMethod<float>(node, method))
+                    {
+                        TryGetMethod<double>(node, method);
+                    }
+                }
+                return method;
+            }
+
+            void Save() const
+            {
+                if (_isModified && !_databaseFilename.empty())
+                {
+                    Log() << "Saving convolution tuning database to " << _databaseFilename << std::endl;
+                    _database.Save(_databaseFilename);
+                }
+            }
+
+        private:
+            template <typename ValueType>
+            bool TryGetMethod(const model::Node& node, model::PreferredConvolutionMethod& method)
+            {
+                auto thisNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node);
+                if (thisNode == nullptr)
+                {
+                    return false;
+                }
+
+                auto compilerOptions = _compiler->GetMapCompilerOptions(node);
+                auto key = GetTuningKey(*thisNode, compilerOptions.compilerSettings);
+                if (_database.HasEntry(key))
+                {
+                    method = _database.GetEntry(key);
+                    Log() << "Using tuned convolution method " << model::ToString(method) << " for " << key << std::endl;
+                    return true;
+                }
+
+                if (!_autotune)
+                {
+                    return true;
+                }
+
+                if (!IsHostTarget(compilerOptions.compilerSettings.targetDevice))
+                {
+                    // Timings are only meaningful on the device the code runs on
+                    Log() << "Can't autotune convolution for non-host target " << compilerOptions.compilerSettings.targetDevice.deviceName << std::endl;
+                    return true;
+                }
+
+                auto convolutionalParameters = thisNode->GetLayer().GetConvolutionalParameters();
+                double bestTime = 0;
+                for (auto candidate : { model::PreferredConvolutionMethod::unrolled, model::PreferredConvolutionMethod::simple, model::PreferredConvolutionMethod::diagonal, model::PreferredConvolutionMethod::winograd })
+                {
+                    if (!IsMethodCompatible(GetConvolutionMethod(candidate), convolutionalParameters))
+                    {
+                        continue;
+                    }
+
+                    try
+                    {
+                        auto time = TimeConvolutionMethod(*thisNode, candidate, compilerOptions, _numIterations);
+                        Log() << "Convolution method " << model::ToString(candidate) << " took " << time << " ms for " << key << std::endl;
+                        if (method == model::PreferredConvolutionMethod::automatic || time < bestTime)
+                        {
+                            method = candidate;
+                            bestTime = time;
+                        }
+                    }
+                    catch (const utilities::Exception& exception)
+                    {
+                        Log() << "Convolution method " << model::ToString(candidate) << " failed for " << key << ": " << exception.GetMessage() << std::endl;
+                    }
+                }
+
+                if (method != model::PreferredConvolutionMethod::automatic)
+                {
+                    _database.SetEntry(key, method);
+                    _isModified = true;
+                }
+                return true;
+            }
+
+            const model::MapCompiler* _compiler;
+            ConvolutionTuningDatabase _database;
+            std::string _databaseFilename;
+            bool _autotune = false;
+            int _numIterations = 10;
+            bool _isModified = false;
+        };
+
         void SetConvolutionMethod(const model::Node& node, model::ModelTransformer& transformer, model::PreferredConvolutionMethod preferredMethod)
         {
             if (preferredMethod != model::PreferredConvolutionMethod::automatic)
@@ -157,7 +354,9 @@ namespace passes
         // Now set the method on any ConvolutionalLayerNodes, using an in-place transformation
         auto onto = transformer.GetCorrespondingOutputs(GetReferencedPorts(result1.GetInputs()));
         model::Model destModel = result1.GetModel().ShallowCopy();
-        auto result2 = transformer.TransformSubmodelOnto(result1, destModel, onto, context, [context](const Node& node, ModelTransformer& transformer) {
+        // When the method is left to us, use the fastest method measured for the node's shape, if we know it
+        ConvolutionMethodTuner tuner(context);
+        auto result2 = transformer.TransformSubmodelOnto(result1, destModel, onto, context, [context, &tuner](const Node& node, ModelTransformer& transformer) {
             model::PreferredConvolutionMethod preferredMethod = model::PreferredConvolutionMethod::automatic;
             auto compiler = context.GetCompiler();
             if (compiler)
@@ -165,8 +364,14 @@ namespace passes
                 preferredMethod = compiler->GetModelOptimizerOptions(node).GetEntry<PreferredConvolutionMethod>("preferredConvolutionMethod", PreferredConvolutionMethod::automatic);
             }
 
+            if (preferredMethod == model::PreferredConvolutionMethod::automatic)
+            {
+                preferredMethod = tuner.GetMethod(node);
+            }
+
             SetConvolutionMethod(node, transformer, preferredMethod);
         });
+        tuner.Save();
 
         // Finally, refine any ConvolutionalLayerNodes
         auto refineConvLayerFn = [](const model::Node& node) {
@@ -10,6 +10,7 @@
 #include "StandardTransformations.h"
 #include "FuseLinearOperationsTransformation.h"
 #include "OptimizeReorderDataNodesTransformation.h"
+#include "QuantizeToInt8Transformation.h"
 #include "SetConvolutionMethodTransformation.h"
 
 #include <model/include/RefineTransformation.h>
@@ -34,6 +35,7 @@ namespace passes
         if (!done)
         {
             registry.AddTransformation<DetectLowPrecisionConvolutionTransformation>();
+            registry.AddTransformation<QuantizeToInt8Transformation>();
             registry.AddTransformation<SetConvolutionMethodTransformation>();
             registry.AddTransformation<model::RefineTransformation>();
             registry.AddTransformation<FuseLinearOperationsTransformation>();
@@ -16,4 +16,8 @@ void TestTransformations();
 
 void TestFuseLinearOperationsTransformation();
 void TestSetConvolutionMethodTransformation();
+void TestConvolutionTuningDatabase();
+void TestAutotuneConvolutionMethod();
 void TestOptimizeReorderDataNodesTransformation();
+void TestQuantizationCalibrator();
+void TestQuantizeToInt8Transformation();
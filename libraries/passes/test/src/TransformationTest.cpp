@@ -8,10 +8,15 @@
 
 #include "TransformationTest.h"
 
+#include <passes/include/ConvolutionTuningDatabase.h>
 #include <passes/include/FuseLinearOperationsTransformation.h>
 #include <passes/include/OptimizeReorderDataNodesTransformation.h>
+#include <passes/include/QuantizationCalibrator.h>
+#include <passes/include/QuantizeToInt8Transformation.h>
 #include <passes/include/SetConvolutionMethodTransformation.h>
+#include <passes/include/StandardTransformations.h>
 
+#include <model/include/IRMapCompiler.h>
 #include <model/include/InputNode.h>
 #include <model/include/TransformContext.h>
 #include <model/include/Transformation.h>
@@ -28,7 +33,11 @@
 
 #include <utilities/include/JsonArchiver.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
+#include <sstream>
 
 #define PRINT_MODELS 0
 
@@ -119,6 +128,159 @@ model::Map GenerateLinearOpsTestModel(const model::PortMemoryLayout& inputLayout
     model::Map map(model, { { "input", inputNode } }, { { "output", *prevOutput } });
     return map;
 }
+
+model::Map MakeConvolutionalLayerMap()
+{
+    using namespace predictors::neural;
+
+    using ElementType = float;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using TensorReferenceType = typename Layer<ElementType>::TensorReferenceType;
+    using Shape = typename Layer<ElementType>::Shape;
+
+    const size_t inputPaddingSize = 1;
+    const size_t outputPaddingSize = 0;
+    TensorType inputWithPadding(1 + 2 * inputPaddingSize, 2 + 2 * inputPaddingSize, 2);
+    TensorReferenceType input = inputWithPadding.GetSubTensor({ inputPaddingSize, inputPaddingSize, 0 }, { 1, 2, 2 });
+    inputWithPadding.Fill(0);
+    input(0, 0, 0) = 2;
+    input(0, 1, 0) = 1;
+    input(0, 0, 1) = 3;
+    input(0, 1, 1) = 2;
+    // Input channel 0: [2, 3], input channel 1: [1, 2]
+
+    Shape outputShape = { 1 + 2 * outputPaddingSize, 2 + 2 * outputPaddingSize, 2 };
+
+    LayerParameters parameters{ inputWithPadding, ZeroPadding(inputPaddingSize), outputShape, ZeroPadding(outputPaddingSize) };
+    ConvolutionalParameters convolutionalParams{ 3, 1, ConvolutionMethod::automatic, 2 };
+
+    TensorType weights(convolutionalParams.receptiveField * outputShape.NumChannels(), convolutionalParams.receptiveField, input.NumChannels());
+    ConvolutionalLayer<ElementType> layer(parameters, convolutionalParams, weights);
+
+    // Create model
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(inputWithPadding.Size());
+    auto computeNode = model.AddNode<nodes::ConvolutionalLayerNode<ElementType>>(inputNode->output, layer);
+
+    return model::Map(model, { { "input", inputNode } }, { { "output", computeNode->output } });
+}
+
+std::string GetConvolutionNodeTypeName(model::PreferredConvolutionMethod method)
+{
+    switch (method)
+    {
+    case model::PreferredConvolutionMethod::diagonal:
+        return "DiagonalConvolutionNode<float>";
+    case model::PreferredConvolutionMethod::simple:
+        return "SimpleConvolutionNode<float>";
+    case model::PreferredConvolutionMethod::winograd:
+        return "WinogradConvolutionNode<float>";
+    case model::PreferredConvolutionMethod::unrolled:
+        return "UnrolledConvolutionNode<float>";
+    default:
+        return "";
+    }
+}
+
+// Values in [-1, 1] that aren't all multiples of the quantization step
+std::vector<float> GetQuantizationTestValues(int size, int seed)
+{
+    std::vector<float> result(size);
+    for (int index = 0; index < size; ++index)
+    {
+        result[index] = static_cast<float>(((index + seed) * 37) % 23 - 11) / 11.0f;
+    }
+    return result;
+}
+
+// weights (m x k constant) * input (k x n)
+model::Map MakeQuantizableMatrixMultiplyMap(int m, int n, int k)
+{
+    using ElementType = float;
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(model::MemoryShape{ k, n });
+    auto weightsNode = model.AddNode<nodes::ConstantNode<ElementType>>(GetQuantizationTestValues(m * k, 1), model::MemoryShape{ m, k });
+    auto multiplyNode = model.AddNode<nodes::MatrixMatrixMultiplyNode<ElementType>>(weightsNode->output, inputNode->output);
+    return model::Map(model, { { "input", inputNode } }, { { "output", multiplyNode->output } });
+}
+
+// A convolution on a padded 4 x 4 x 2 image, with 3 filters
+model::Map MakeQuantizableConvolutionalLayerMap()
+{
+    using namespace predictors::neural;
+
+    using ElementType = float;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using Shape = typename Layer<ElementType>::Shape;
+
+    const size_t inputPaddingSize = 1;
+    const size_t numFilters = 3;
+    TensorType inputWithPadding(4 + 2 * inputPaddingSize, 4 + 2 * inputPaddingSize, 2);
+    Shape outputShape = { 4, 4, numFilters };
+    LayerParameters parameters{ inputWithPadding, ZeroPadding(inputPaddingSize), outputShape, NoPadding() };
+    ConvolutionalParameters convolutionalParams{ 3, 1, ConvolutionMethod::automatic, 1 };
+
+    TensorType weights(convolutionalParams.receptiveField * numFilters, convolutionalParams.receptiveField, inputWithPadding.NumChannels());
+    auto weightValues = GetQuantizationTestValues(static_cast<int>(weights.Size()), 2);
+    size_t index = 0;
+    for (size_t row = 0; row < weights.NumRows(); ++row)
+    {
+        for (size_t column = 0; column < weights.NumColumns(); ++column)
+        {
+            for (size_t channel = 0; channel < weights.NumChannels(); ++channel)
+            {
+                weights(row, column, channel) = weightValues[index++];
+            }
+        }
+    }
+    ConvolutionalLayer<ElementType> layer(parameters, convolutionalParams, weights);
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(inputWithPadding.Size());
+    auto computeNode = model.AddNode<nodes::ConvolutionalLayerNode<ElementType>>(inputNode->output, layer);
+    return model::Map(model, { { "input", inputNode } }, { { "output", computeNode->output } });
+}
+
+// An input for `MakeQuantizableConvolutionalLayerMap`, with zeros in the padding
+std::vector<float> GetQuantizableConvolutionInput(int seed)
+{
+    const int size = 6;
+    const int numChannels = 2;
+    auto values = GetQuantizationTestValues(size * size * numChannels, seed);
+    for (int row = 0; row < size; ++row)
+    {
+        for (int column = 0; column < size; ++column)
+        {
+            if (row == 0 || column == 0 || row == size - 1 || column == size - 1)
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    values[(row * size + column) * numChannels + channel] = 0;
+                }
+            }
+        }
+    }
+    return values;
+}
+
+const model::Node* FindCalibratedNode(const model::Model& model)
+{
+    const model::Node* result = nullptr;
+    model.Visit([&result](const model::Node& node) {
+        if (node.GetMetadata().HasEntry(passes::quantizationInputRangeKey))
+        {
+            result = &node;
+        }
+    });
+    return result;
+}
+
+std::vector<double> ToDoubleVector(const std::vector<float>& values)
+{
+    return { values.begin(), values.end() };
+}
 } // namespace
 
 //
@@ -129,7 +291,11 @@ void TestTransformations()
 {
     TestFuseLinearOperationsTransformation();
     TestSetConvolutionMethodTransformation();
+    TestConvolutionTuningDatabase();
+    TestAutotuneConvolutionMethod();
     TestOptimizeReorderDataNodesTransformation();
+    TestQuantizationCalibrator();
+    TestQuantizeToInt8Transformation();
 }
 
 void TestFuseLinearOperationsTransformation(std::vector<std::pair<bool, bool>> functionInfos)
@@ -230,39 +396,7 @@ void TestFuseLinearOperationsTransformation()
 
 void TestSetConvolutionMethodTransformation(model::PreferredConvolutionMethod convolutionMethod, std::string expectedNodeTypeName)
 {
-    using namespace predictors::neural;
-
-    using ElementType = float;
-    using LayerParameters = typename Layer<ElementType>::LayerParameters;
-    using TensorType = typename Layer<ElementType>::TensorType;
-    using TensorReferenceType = typename Layer<ElementType>::TensorReferenceType;
-    using Shape = typename Layer<ElementType>::Shape;
-
-    const size_t inputPaddingSize = 1;
-    const size_t outputPaddingSize = 0;
-    TensorType inputWithPadding(1 + 2 * inputPaddingSize, 2 + 2 * inputPaddingSize, 2);
-    TensorReferenceType input = inputWithPadding.GetSubTensor({ inputPaddingSize, inputPaddingSize, 0 }, { 1, 2, 2 });
-    inputWithPadding.Fill(0);
-    input(0, 0, 0) = 2;
-    input(0, 1, 0) = 1;
-    input(0, 0, 1) = 3;
-    input(0, 1, 1) = 2;
-    // Input channel 0: [2, 3], input channel 1: [1, 2]
-
-    Shape outputShape = { 1 + 2 * outputPaddingSize, 2 + 2 * outputPaddingSize, 2 };
-
-    LayerParameters parameters{ inputWithPadding, ZeroPadding(inputPaddingSize), outputShape, ZeroPadding(outputPaddingSize) };
-    ConvolutionalParameters convolutionalParams{ 3, 1, ConvolutionMethod::automatic, 2 };
-
-    TensorType weights(convolutionalParams.receptiveField * outputShape.NumChannels(), convolutionalParams.receptiveField, input.NumChannels());
-    ConvolutionalLayer<ElementType> layer(parameters, convolutionalParams, weights);
-
-    // Create model
-    model::Model model;
-    auto inputNode = model.AddNode<model::InputNode<ElementType>>(inputWithPadding.Size());
-    auto computeNode = model.AddNode<nodes::ConvolutionalLayerNode<ElementType>>(inputNode->output, layer);
-
-    auto map = model::Map(model, { { "input", inputNode } }, { { "output", computeNode->output } });
+    auto map = MakeConvolutionalLayerMap();
 #if PRINT_MODELS
     PrintModel(map.GetModel());
 #endif
@@ -291,6 +425,67 @@ void TestSetConvolutionMethodTransformation()
     TestSetConvolutionMethodTransformation(model::PreferredConvolutionMethod::unrolled, "UnrolledConvolutionNode<float>");
 }
 
+void TestConvolutionTuningDatabase()
+{
+    passes::ConvolutionTuningDatabase database;
+    database.SetEntry("float input=10x10x4 target=host threads=1", model::PreferredConvolutionMethod::winograd);
+    database.SetEntry("float input=10x10x4 target=host threads=4", model::PreferredConvolutionMethod::unrolled);
+
+    std::stringstream stream;
+    database.Write(stream);
+    passes::ConvolutionTuningDatabase database2;
+    database2.Read(stream);
+
+    testing::ProcessTest("Testing ConvolutionTuningDatabase read/write",
+                         database2.NumEntries() == 2 &&
+                             database2.GetEntry("float input=10x10x4 target=host threads=1") == model::PreferredConvolutionMethod::winograd &&
+                             database2.GetEntry("float input=10x10x4 target=host threads=4") == model::PreferredConvolutionMethod::unrolled);
+    testing::ProcessTest("Testing ConvolutionTuningDatabase missing entry", !database2.HasEntry("double input=10x10x4 target=host threads=1"));
+}
+
+void TestAutotuneConvolutionMethod()
+{
+    const std::string tuningCacheFilename = "passes_test_convolution_tuning.txt";
+    std::remove(tuningCacheFilename.c_str());
+
+    // Measure the methods, and record the fastest in the cache
+    {
+        auto map = MakeConvolutionalLayerMap();
+        model::MapCompilerOptions settings;
+        model::ModelOptimizerOptions optimizerOptions;
+        optimizerOptions["autotuneConvolutionMethod"] = true;
+        optimizerOptions["convolutionTuningCache"] = tuningCacheFilename;
+        optimizerOptions["autotuneIterations"] = 2;
+        model::IRMapCompiler compiler(settings, optimizerOptions);
+        model::TransformContext context(&compiler);
+        passes::SetConvolutionMethodTransformation setConvMethod;
+        map.Transform(setConvMethod, context);
+        map.Prune();
+    }
+
+    passes::ConvolutionTuningDatabase database(tuningCacheFilename);
+    testing::ProcessTest("Testing autotuning adds an entry to the tuning cache", database.NumEntries() == 1);
+    if (database.NumEntries() == 1)
+    {
+        // Later compiles use the cached method without measuring
+        auto tunedMethod = database.GetEntries().begin()->second;
+        auto map = MakeConvolutionalLayerMap();
+        model::MapCompilerOptions settings;
+        model::ModelOptimizerOptions optimizerOptions;
+        optimizerOptions["convolutionTuningCache"] = tuningCacheFilename;
+        model::IRMapCompiler compiler(settings, optimizerOptions);
+        model::TransformContext context(&compiler);
+        passes::SetConvolutionMethodTransformation setConvMethod;
+        map.Transform(setConvMethod, context);
+        map.Prune();
+
+        auto expectedNodeTypeName = GetConvolutionNodeTypeName(tunedMethod);
+        testing::ProcessTest("Testing SetConvolutionMethodTransformation uses the tuning cache (" + expectedNodeTypeName + ")", HasNodeWithTypeName(map.GetModel(), expectedNodeTypeName));
+    }
+
+    std::remove(tuningCacheFilename.c_str());
+}
+
 void TestOptimizeReorderDataNodesTransformation1()
 {
     using ValueType = float;
@@ -470,3 +665,110 @@ void TestOptimizeReorderDataNodesTransformation()
     TestOptimizeReorderDataNodesTransformation3();
     TestOptimizeReorderDataNodesTransformation4();
 }
+
+void TestQuantizationCalibrator()
+{
+    const int m = 4, n = 3, k = 8;
+    auto map = MakeQuantizableMatrixMultiplyMap(m, n, k);
+    passes::QuantizationCalibrator calibrator(map);
+    testing::ProcessTest("Testing QuantizationCalibrator finds quantizable nodes", calibrator.NumQuantizableNodes() == 1);
+
+    // The range is the largest absolute value seen on the multiply's input, over all the examples
+    auto example = GetQuantizationTestValues(k * n, 3);
+    auto scaledExample = example;
+    std::transform(example.begin(), example.end(), scaledExample.begin(), [](float value) { return value / 2; });
+    calibrator.AddExample(ToDoubleVector(example));
+    calibrator.AddExample(ToDoubleVector(scaledExample));
+
+    double expectedRange = 0;
+    for (auto value : example)
+    {
+        expectedRange = std::max(expectedRange, std::abs(static_cast<double>(value)));
+    }
+
+    const auto& calibratedMap = calibrator.GetCalibratedMap();
+    auto node = FindCalibratedNode(calibratedMap.GetModel());
+    testing::ProcessTest("Testing QuantizationCalibrator example count", calibrator.NumExamples() == 2);
+    testing::ProcessTest("Testing QuantizationCalibrator records the input range",
+                         node != nullptr &&
+                             testing::IsEqual(calibrator.GetInputRange(*node), expectedRange) &&
+                             testing::IsEqual(node->GetMetadata().GetOrParseEntry<double>(passes::quantizationInputRangeKey, 0.0), expectedRange));
+}
+
+void TestQuantizeMatrixMultiply()
+{
+    const int m = 4, n = 3, k = 8;
+    auto map = MakeQuantizableMatrixMultiplyMap(m, n, k);
+    auto input = GetQuantizationTestValues(k * n, 3);
+    auto referenceOutput = map.Compute<float>(input);
+
+    passes::QuantizationCalibrator calibrator(map);
+    calibrator.AddExample(ToDoubleVector(input));
+
+    // Without the option, the transformation leaves the map alone
+    {
+        model::Map unquantizedMap = calibrator.GetCalibratedMap();
+        model::MapCompilerOptions settings;
+        model::ModelOptimizerOptions optimizerOptions;
+        model::IRMapCompiler compiler(settings, optimizerOptions);
+        model::TransformContext context(&compiler);
+        passes::QuantizeToInt8Transformation quantize;
+        unquantizedMap.Transform(quantize, context);
+        testing::ProcessTest("Testing QuantizeToInt8Transformation is off by default", !HasNodeWithTypeName(unquantizedMap.GetModel(), "QuantizedMatrixMultiplyNode<float>"));
+    }
+
+    model::Map quantizedMap = calibrator.GetCalibratedMap();
+    model::MapCompilerOptions settings;
+    model::ModelOptimizerOptions optimizerOptions;
+    optimizerOptions["quantizeInt8"] = true;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    model::TransformContext context(&compiler);
+    passes::QuantizeToInt8Transformation quantize;
+    quantizedMap.Transform(quantize, context);
+    quantizedMap.Prune();
+
+#if PRINT_MODELS
+    PrintModel(quantizedMap.GetModel());
+#endif
+
+    testing::ProcessTest("Testing QuantizeToInt8Transformation replaces matrix multiply",
+                         HasNodeWithTypeName(quantizedMap.GetModel(), "QuantizedMatrixMultiplyNode<float>") &&
+                             !HasNodeWithTypeName(quantizedMap.GetModel(), "MatrixMatrixMultiplyNode<float>"));
+
+    // Each of the k products is off by at most about 1/127 of the largest product
+    auto quantizedOutput = quantizedMap.Compute<float>(input);
+    testing::ProcessTest("Testing quantized matrix multiply result", testing::IsEqual(referenceOutput, quantizedOutput, 0.1f));
+}
+
+void TestQuantizeConvolution()
+{
+    auto map = MakeQuantizableConvolutionalLayerMap();
+    auto input = GetQuantizableConvolutionInput(3);
+    auto referenceOutput = map.Compute<float>(input);
+
+    passes::QuantizationCalibrator calibrator(map);
+    calibrator.AddExample(ToDoubleVector(input));
+    calibrator.AddExample(ToDoubleVector(GetQuantizableConvolutionInput(5)));
+
+    passes::AddStandardTransformationsToRegistry();
+    model::MapCompilerOptions settings;
+    model::ModelOptimizerOptions optimizerOptions;
+    optimizerOptions["quantizeInt8"] = true;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(calibrator.GetCalibratedMap());
+
+#if PRINT_MODELS
+    PrintModel(compiledMap.GetModel());
+#endif
+
+    testing::ProcessTest("Testing QuantizeToInt8Transformation replaces convolution", HasNodeWithTypeName(compiledMap.GetModel(), "QuantizedMatrixMultiplyNode<float>"));
+
+    auto quantizedOutput = compiledMap.Compute<float>(input);
+    testing::ProcessTest("Testing compiled quantized convolution result", testing::IsEqual(referenceOutput, quantizedOutput, 0.2f));
+}
+
+void TestQuantizeToInt8Transformation()
+{
+    TestQuantizeMatrixMultiply();
+    TestQuantizeConvolution();
+}
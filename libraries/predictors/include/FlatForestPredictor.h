@@ -0,0 +1,228 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FlatForestPredictor.h (predictors)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ForestPredictor.h"
+#include "IPredictor.h"
+
+#include <data/include/DenseDataVector.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/IArchivable.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace predictors
+{
+    /// <summary>
+    /// A read-only copy of a SimpleForestPredictor, laid out for fast inference. The interior nodes are stored as a
+    /// structure of arrays (input element index, threshold and the two children of each node), with the nodes of each
+    /// tree contiguous and in depth-first order. Leaves aren't stored as nodes: a child that is a leaf refers directly
+    /// to the leaf's value, which is the sum of the edge outputs along the path from the root. The batch version of
+    /// `Predict` walks each tree for a block of examples at once, so the memory accesses of the different examples
+    /// overlap.
+    /// </summary>
+    class FlatForestPredictor : public IPredictor<double>
+        , public utilities::IArchivable
+    {
+    public:
+        /// <summary> Type of the data vector expected by this predictor type. </summary>
+        using DataVectorType = data::FloatDataVector;
+
+        FlatForestPredictor() = default;
+
+        /// <summary> Constructs a flat copy of a forest. </summary>
+        ///
+        /// <param name="forest"> The forest. </param>
+        explicit FlatForestPredictor(const SimpleForestPredictor& forest);
+
+        /// <summary> Gets the number of trees in the forest. </summary>
+        size_t NumTrees() const { return _treeRoots.size(); }
+
+        /// <summary> Gets the total number of interior nodes in the forest. </summary>
+        size_t NumInteriorNodes() const { return _featureIndices.size(); }
+
+        /// <summary> Gets the number of edges in the forest. </summary>
+        size_t NumEdges() const { return _numEdges; }
+
+        /// <summary> Gets the minimum size of an input, which is one more than the largest element index used by a split rule. </summary>
+        size_t NumInputs() const { return _numInputs; }
+
+        /// <summary> Gets the bias value. </summary>
+        double GetBias() const { return _bias; }
+
+        /// <summary> Returns the output of the forest (including all trees and the bias term) for a given input. </summary>
+        ///
+        /// <param name="input"> The input vector. </param>
+        ///
+        /// <returns> The prediction. </returns>
+        double Predict(const DataVectorType& input) const;
+
+        /// <summary> Returns the output of one tree for a given input. </summary>
+        ///
+        /// <param name="input"> The input vector. </param>
+        /// <param name="treeIndex"> The index of the tree. </param>
+        ///
+        /// <returns> The prediction of the tree. </returns>
+        double PredictTree(const DataVectorType& input, size_t treeIndex) const;
+
+        /// <summary> Generates the edge path indicator vector of the forest, with the same edge order as the original forest. </summary>
+        ///
+        /// <param name="input"> The input vector. </param>
+        ///
+        /// <returns> The edge indicator vector. </returns>
+        std::vector<bool> GetEdgeIndicatorVector(const DataVectorType& input) const;
+
+        /// <summary> Returns the output of the forest for an input in a dense array. </summary>
+        ///
+        /// <typeparam name="ValueType"> The input element type. </typeparam>
+        /// <param name="input"> The input, which must have at least `NumInputs()` elements. </param>
+        ///
+        /// <returns> The prediction. </returns>
+        template <typename ValueType>
+        double Predict(const ValueType* input) const;
+
+        /// <summary> Computes the output of the forest on a batch of examples. </summary>
+        ///
+        /// <typeparam name="ValueType"> The input element type. </typeparam>
+        /// <param name="inputs"> The inputs, one after the other, each `inputSize` elements long. </param>
+        /// <param name="inputSize"> The size of each input, which must be at least `NumInputs()`. </param>
+        /// <param name="numExamples"> The number of examples. </param>
+        /// <param name="outputs"> The array that receives the `numExamples` predictions. </param>
+        template <typename ValueType>
+        void PredictBatch(const ValueType* inputs, size_t inputSize, size_t numExamples, double* outputs) const;
+
+        /// <summary> Gets the input element index of each interior node. </summary>
+        const std::vector<int>& GetFeatureIndices() const { return _featureIndices; }
+
+        /// <summary> Gets the threshold of each interior node. An input goes to child 1 if its element is greater than the threshold. </summary>
+        const std::vector<double>& GetThresholds() const { return _thresholds; }
+
+        /// <summary> Gets the two children of each interior node. A negative child `c` is the leaf with index `-c - 1`. </summary>
+        const std::vector<int>& GetChildren() const { return _children; }
+
+        /// <summary> Gets the index in the edge indicator vector of the first outgoing edge of each interior node. </summary>
+        const std::vector<int>& GetFirstEdgeIndices() const { return _firstEdgeIndices; }
+
+        /// <summary> Gets the output of each leaf, which is the sum of the edge outputs along its path. </summary>
+        const std::vector<double>& GetLeafValues() const { return _leafValues; }
+
+        /// <summary> Gets the index of the root node of each tree. </summary>
+        const std::vector<int>& GetTreeRoots() const { return _treeRoots; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return "FlatForestPredictor"; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+
+    private:
+        int AddSubtree(const SimpleForestPredictor& forest, size_t interiorNodeIndex, double pathOutput);
+        void CheckInputSize(size_t inputSize) const;
+
+        template <typename GetValueFunction>
+        int FindLeaf(int nodeIndex, GetValueFunction getValue) const;
+
+        std::vector<int> _featureIndices;
+        std::vector<double> _thresholds;
+        std::vector<int> _children;
+        std::vector<int> _firstEdgeIndices;
+        std::vector<double> _leafValues;
+        std::vector<int> _treeRoots;
+        double _bias = 0.0;
+        size_t _numEdges = 0;
+        size_t _numInputs = 0;
+    };
+} // namespace predictors
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace predictors
+{
+    template <typename GetValueFunction>
+    int FlatForestPredictor::FindLeaf(int nodeIndex, GetValueFunction getValue) const
+    {
+        while (nodeIndex >= 0)
+        {
+            nodeIndex = _children[2 * nodeIndex + (getValue(_featureIndices[nodeIndex]) > _thresholds[nodeIndex] ? 1 : 0)];
+        }
+        return -nodeIndex - 1;
+    }
+
+    template <typename ValueType>
+    double FlatForestPredictor::Predict(const ValueType* input) const
+    {
+        double output = _bias;
+        for (auto root : _treeRoots)
+        {
+            output += _leafValues[FindLeaf(root, [input](int index) { return static_cast<double>(input[index]); })];
+        }
+        return output;
+    }
+
+    template <typename ValueType>
+    void FlatForestPredictor::PredictBatch(const ValueType* inputs, size_t inputSize, size_t numExamples, double* outputs) const
+    {
+        CheckInputSize(inputSize);
+
+        // walk each tree for a block of examples in lockstep, so the loads for the different examples are in flight together
+        const size_t blockSize = 16;
+        int nodes[blockSize];
+        for (size_t blockStart = 0; blockStart < numExamples; blockStart += blockSize)
+        {
+            const auto currentBlockSize = std::min(blockSize, numExamples - blockStart);
+            const auto blockInputs = inputs + blockStart * inputSize;
+            const auto blockOutputs = outputs + blockStart;
+            std::fill(blockOutputs, blockOutputs + currentBlockSize, _bias);
+
+            for (auto root : _treeRoots)
+            {
+                std::fill(nodes, nodes + currentBlockSize, root);
+                bool isAnyInterior = true;
+                while (isAnyInterior)
+                {
+                    isAnyInterior = false;
+                    for (size_t i = 0; i < currentBlockSize; ++i)
+                    {
+                        const auto nodeIndex = nodes[i];
+                        if (nodeIndex >= 0)
+                        {
+                            const auto value = static_cast<double>(blockInputs[i * inputSize + _featureIndices[nodeIndex]]);
+                            nodes[i] = _children[2 * nodeIndex + (value > _thresholds[nodeIndex] ? 1 : 0)];
+                            isAnyInterior = isAnyInterior || nodes[i] >= 0;
+                        }
+                    }
+                }
+
+                for (size_t i = 0; i < currentBlockSize; ++i)
+                {
+                    blockOutputs[i] += _leafValues[-nodes[i] - 1];
+                }
+            }
+        }
+    }
+} // namespace predictors
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,147 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FlatForestPredictor.cpp (predictors)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FlatForestPredictor.h"
+
+#include <limits>
+
+namespace ell
+{
+namespace predictors
+{
+    FlatForestPredictor::FlatForestPredictor(const SimpleForestPredictor& forest) :
+        _bias(forest.GetBias()),
+        _numEdges(forest.NumEdges())
+    {
+        if (forest.NumInteriorNodes() > static_cast<size_t>(std::numeric_limits<int>::max()) || forest.NumEdges() > static_cast<size_t>(std::numeric_limits<int>::max()))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Forest is too big to flatten");
+        }
+
+        for (auto rootIndex : forest.GetRootIndices())
+        {
+            _treeRoots.push_back(AddSubtree(forest, rootIndex, 0.0));
+        }
+    }
+
+    int FlatForestPredictor::AddSubtree(const SimpleForestPredictor& forest, size_t interiorNodeIndex, double pathOutput)
+    {
+        const auto& interiorNode = forest.GetInteriorNodes()[interiorNodeIndex];
+        const auto& splitRule = interiorNode.GetSplitRule();
+        const auto& edges = interiorNode.GetOutgoingEdges();
+        if (edges.size() != 2)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Flat forests only support binary splits");
+        }
+
+        const auto nodeIndex = static_cast<int>(_featureIndices.size());
+        _featureIndices.push_back(static_cast<int>(splitRule.GetElementIndex()));
+        _thresholds.push_back(splitRule.GetThreshold());
+        _firstEdgeIndices.push_back(static_cast<int>(interiorNode.GetFirstEdgeIndex()));
+        _children.resize(_children.size() + 2);
+        _numInputs = std::max(_numInputs, splitRule.GetElementIndex() + 1);
+
+        // the outputs are added up in the same order as ForestPredictor adds them, so the results are identical
+        for (size_t edgePosition = 0; edgePosition < 2; ++edgePosition)
+        {
+            const auto& edge = edges[edgePosition];
+            auto output = pathOutput + edge.GetPredictor().GetValue();
+            int child = 0;
+            if (edge.IsTargetInterior())
+            {
+                child = AddSubtree(forest, edge.GetTargetNodeIndex(), output);
+            }
+            else
+            {
+                child = -static_cast<int>(_leafValues.size()) - 1;
+                _leafValues.push_back(output);
+            }
+            _children[2 * nodeIndex + edgePosition] = child;
+        }
+
+        return nodeIndex;
+    }
+
+    double FlatForestPredictor::Predict(const DataVectorType& input) const
+    {
+        double output = _bias;
+        for (size_t treeIndex = 0; treeIndex < NumTrees(); ++treeIndex)
+        {
+            output += PredictTree(input, treeIndex);
+        }
+        return output;
+    }
+
+    double FlatForestPredictor::PredictTree(const DataVectorType& input, size_t treeIndex) const
+    {
+        const auto prefixLength = input.PrefixLength();
+        return _leafValues[FindLeaf(_treeRoots[treeIndex], [&input, prefixLength](int index) {
+            if (prefixLength <= static_cast<size_t>(index))
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange);
+            }
+            return input[index];
+        })];
+    }
+
+    std::vector<bool> FlatForestPredictor::GetEdgeIndicatorVector(const DataVectorType& input) const
+    {
+        std::vector<bool> edgeIndicator(_numEdges);
+        const auto prefixLength = input.PrefixLength();
+        for (auto nodeIndex : _treeRoots)
+        {
+            while (nodeIndex >= 0)
+            {
+                const auto featureIndex = static_cast<size_t>(_featureIndices[nodeIndex]);
+                if (prefixLength <= featureIndex)
+                {
+                    throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange);
+                }
+
+                const auto edgePosition = input[featureIndex] > _thresholds[nodeIndex] ? 1 : 0;
+                edgeIndicator[_firstEdgeIndices[nodeIndex] + edgePosition] = true;
+                nodeIndex = _children[2 * nodeIndex + edgePosition];
+            }
+        }
+        return edgeIndicator;
+    }
+
+    void FlatForestPredictor::CheckInputSize(size_t inputSize) const
+    {
+        if (inputSize < _numInputs)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Input is smaller than the forest's input");
+        }
+    }
+
+    void FlatForestPredictor::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        archiver["featureIndices"] << _featureIndices;
+        archiver["thresholds"] << _thresholds;
+        archiver["children"] << _children;
+        archiver["firstEdgeIndices"] << _firstEdgeIndices;
+        archiver["leafValues"] << _leafValues;
+        archiver["treeRoots"] << _treeRoots;
+        archiver["bias"] << _bias;
+        archiver["numEdges"] << _numEdges;
+        archiver["numInputs"] << _numInputs;
+    }
+
+    void FlatForestPredictor::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        archiver["featureIndices"] >> _featureIndices;
+        archiver["thresholds"] >> _thresholds;
+        archiver["children"] >> _children;
+        archiver["firstEdgeIndices"] >> _firstEdgeIndices;
+        archiver["leafValues"] >> _leafValues;
+        archiver["treeRoots"] >> _treeRoots;
+        archiver["bias"] >> _bias;
+        archiver["numEdges"] >> _numEdges;
+        archiver["numInputs"] >> _numInputs;
+    }
+} // namespace predictors
+} // namespace ell
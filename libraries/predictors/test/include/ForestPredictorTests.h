@@ -11,3 +11,5 @@
 #include <testing/include/testing.h>
 
 void ForestPredictorTest();
+
+void FlatForestPredictorTest();
@@ -6,10 +6,14 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <predictors/include/FlatForestPredictor.h>
 #include <predictors/include/ForestPredictor.h>
 
 #include <testing/include/testing.h>
 
+#include <random>
+#include <vector>
+
 using namespace ell;
 
 void ForestPredictorTest()
@@ -65,3 +69,59 @@ void ForestPredictorTest()
     auto edgeIndicator = forest.GetEdgeIndicatorVector(ExampleType{ 0.25, 0.7, 0.0 });
     testing::ProcessTest("Testing ForestPredictor, SetEdgeIndicatorVector()", testing::IsEqual(edgeIndicator, std::vector<bool>{ 1, 0, 0, 1, 0, 0, 0, 1 }));
 }
+
+void FlatForestPredictorTest()
+{
+    // define some abbreviations
+    using SplitAction = predictors::SimpleForestPredictor::SplitAction;
+    using SplitRule = predictors::SingleElementThresholdPredictor;
+    using EdgePredictorVector = std::vector<predictors::ConstantPredictor>;
+
+    // build a forest with trees of different shapes
+    predictors::SimpleForestPredictor forest;
+    auto root = forest.Split(SplitAction{ forest.GetNewRootId(), SplitRule{ 0, 0.3 }, EdgePredictorVector{ -1.0, 1.0 } });
+    auto child = forest.Split(SplitAction{ forest.GetChildId(root, 0), SplitRule{ 1, 0.6 }, EdgePredictorVector{ -2.0, 2.0 } });
+    forest.Split(SplitAction{ forest.GetChildId(child, 1), SplitRule{ 3, 0.4 }, EdgePredictorVector{ -0.5, 0.5 } });
+    forest.Split(SplitAction{ forest.GetChildId(root, 1), SplitRule{ 2, 0.9 }, EdgePredictorVector{ -4.0, 4.0 } });
+    forest.Split(SplitAction{ forest.GetNewRootId(), SplitRule{ 0, 0.2 }, EdgePredictorVector{ -3.0, 3.0 } });
+    forest.AddToBias(0.25);
+
+    predictors::FlatForestPredictor flatForest(forest);
+    testing::ProcessTest("Testing FlatForestPredictor, NumTrees()", flatForest.NumTrees() == 2);
+    testing::ProcessTest("Testing FlatForestPredictor, NumInteriorNodes()", flatForest.NumInteriorNodes() == 5);
+    testing::ProcessTest("Testing FlatForestPredictor, NumInputs()", flatForest.NumInputs() == 4);
+
+    // compare with the original forest on random inputs
+    const size_t numExamples = 37;
+    const size_t inputSize = 4;
+    std::default_random_engine random(123);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    std::vector<float> inputs(numExamples * inputSize);
+    for (auto& value : inputs)
+    {
+        value = distribution(random);
+    }
+
+    std::vector<double> batchOutputs(numExamples);
+    flatForest.PredictBatch(inputs.data(), inputSize, numExamples, batchOutputs.data());
+
+    bool predictionsEqual = true;
+    bool treePredictionsEqual = true;
+    bool edgeIndicatorsEqual = true;
+    for (size_t i = 0; i < numExamples; ++i)
+    {
+        std::vector<float> values(inputs.begin() + i * inputSize, inputs.begin() + (i + 1) * inputSize);
+        predictors::SimpleForestPredictor::DataVectorType input(values);
+        auto expected = forest.Predict(input);
+        predictionsEqual = predictionsEqual && flatForest.Predict(input) == expected && flatForest.Predict(values.data()) == expected && batchOutputs[i] == expected;
+        for (size_t treeIndex = 0; treeIndex < forest.NumTrees(); ++treeIndex)
+        {
+            treePredictionsEqual = treePredictionsEqual && flatForest.PredictTree(input, treeIndex) == forest.Predict(input, forest.GetRootIndex(treeIndex));
+        }
+        edgeIndicatorsEqual = edgeIndicatorsEqual && flatForest.GetEdgeIndicatorVector(input) == forest.GetEdgeIndicatorVector(input);
+    }
+
+    testing::ProcessTest("Testing FlatForestPredictor, Predict()", predictionsEqual);
+    testing::ProcessTest("Testing FlatForestPredictor, PredictTree()", treePredictionsEqual);
+    testing::ProcessTest("Testing FlatForestPredictor, GetEdgeIndicatorVector()", edgeIndicatorsEqual);
+}
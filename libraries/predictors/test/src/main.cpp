@@ -19,6 +19,7 @@ int main()
 {
     // ForestPredictor
     ForestPredictorTest();
+    FlatForestPredictorTest();
 
     // LinearPredictor
     LinearPredictorTest<double>();
@@ -8,8 +8,12 @@
 
 #pragma once
 
+#include "ISharedDatasetTrainer.h"
 #include "ITrainer.h"
 
+#include <data/include/Dataset.h>
+#include <data/include/Example.h>
+
 #include <evaluators/include/Evaluator.h>
 
 #include <memory>
@@ -30,6 +34,7 @@ namespace trainers
     public:
         typedef ITrainer<PredictorType> InternalTrainerType;
         typedef evaluators::IEvaluator<PredictorType> EvaluatorType;
+        typedef data::Example<typename PredictorType::DataVectorType, data::WeightLabel> ExampleType;
 
         /// <summary> Constructs an instance of EvaluatingTrainer. </summary>
         ///
@@ -42,6 +47,13 @@ namespace trainers
         /// <param name="anyDataset"> A dataset. </param>
         void SetDataset(const data::AnyDataset& anyDataset) override;
 
+        /// <summary> Sets the trainer's dataset to one shared with other trainers, if the internal trainer supports it. </summary>
+        ///
+        /// <param name="dataset"> The shared dataset. </param>
+        ///
+        /// <returns> True if the internal trainer reads the shared dataset; false if it doesn't, and needs `SetDataset` instead. </returns>
+        bool SetSharedDataset(std::shared_ptr<const data::Dataset<ExampleType>> dataset);
+
         /// <summary> Updates the state of the trainer by performing a learning epoch. </summary>
         void Update() override;
 
@@ -99,6 +111,19 @@ namespace trainers
         _internalTrainer->SetDataset(anyDataset);
     }
 
+    template <typename PredictorType>
+    bool EvaluatingTrainer<PredictorType>::SetSharedDataset(std::shared_ptr<const data::Dataset<ExampleType>> dataset)
+    {
+        auto sharedDatasetTrainer = dynamic_cast<ISharedDatasetTrainer<ExampleType>*>(_internalTrainer.get());
+        if (sharedDatasetTrainer == nullptr)
+        {
+            return false;
+        }
+
+        sharedDatasetTrainer->SetSharedDataset(std::move(dataset));
+        return true;
+    }
+
     template <typename PredictorType>
     void EvaluatingTrainer<PredictorType>::Update()
     {
@@ -16,10 +16,13 @@
 #include <predictors/include/ForestPredictor.h>
 
 #include <utilities/include/OutputStreamImpostor.h>
+#include <utilities/include/ParallelFor.h>
 
+#include <algorithm>
 #include <iostream> // For std::cout in VERBOSE_MODE
 #include <memory>
 #include <queue>
+#include <vector>
 
 namespace ell
 {
@@ -32,6 +35,7 @@ namespace trainers
         double minSplitGain = 0.0;
         size_t maxSplitsPerRound = 0;
         size_t numRounds = 0;
+        size_t numThreads = 1; // 0 means one thread per hardware thread
     };
 
     /// <summary> Nontemplated base class for forest trainers, provides some reusable internal classes. </summary>
@@ -45,6 +49,7 @@ namespace trainers
             double sumWeightedLabels = 0;
 
             void Increment(const data::WeightLabel& weightLabel);
+            Sums operator+(const Sums& other) const;
             Sums operator-(const Sums& other) const;
             double GetMeanLabel() const;
             void Print(std::ostream& os) const;
@@ -177,6 +182,9 @@ namespace trainers
         void UpdateCurrentOutputs(double value);
         void UpdateCurrentOutputs(Range range, const EdgePredictorType& edgePredictor);
 
+        // gets the number of threads to use on a loop over a number of examples, so that each thread gets enough work to be worth starting
+        size_t GetNumThreads(size_t numExamples) const;
+
         // after performing a split, we rearrange the data set to ensure that each node's examples occupy contiguous rows in the dataset
         void SortNodeDataset(Range range, const SplitRuleType& splitRule);
 
@@ -187,6 +195,16 @@ namespace trainers
         virtual SplitCandidate GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) = 0;
         virtual std::vector<EdgePredictorType> GetEdgePredictors(const NodeStats& nodeStats) = 0;
 
+        //
+        // implementation specific functions that a derived class may override
+        //
+
+        // called at the start of each boosting round, after the weak weights and labels are set
+        virtual void OnBoostingRound() {}
+
+        // finds the best split rule at each of the children of a node that was just split; by default, calls GetBestSplitRuleAtNode on each child
+        virtual std::vector<SplitCandidate> GetBestSplitRulesAtChildren(const SplitCandidate& parentSplit, size_t interiorNodeIndex);
+
         //
         // member variables
         //
@@ -254,6 +272,7 @@ namespace trainers
             double bias = sums.GetMeanLabel();
             _forest.AddToBias(bias);
             UpdateCurrentOutputs(bias);
+            OnBoostingRound();
 
             VERBOSE_MODE(_dataset.Print(std::cout));
             VERBOSE_MODE(std::cout << "\nBoosting iteration\n");
@@ -292,13 +311,23 @@ namespace trainers
     template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
     auto ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SetWeakWeightsLabels() -> Sums
     {
-        Sums sums;
+        // each thread sums its own chunk, and the chunk sums are added up in order
+        const auto numExamples = _dataset.NumExamples();
+        const auto numThreads = GetNumThreads(numExamples);
+        std::vector<Sums> chunkSums(numThreads);
+        utilities::ParallelFor(numExamples, numThreads, [&](size_t begin, size_t end, size_t chunkIndex) {
+            for (size_t rowIndex = begin; rowIndex < end; ++rowIndex)
+            {
+                auto& metadata = _dataset[rowIndex].GetMetadata();
+                metadata.weak = _booster.GetWeakWeightLabel(metadata.strong, metadata.currentOutput);
+                chunkSums[chunkIndex].Increment(metadata.weak);
+            }
+        });
 
-        for (size_t rowIndex = 0; rowIndex < _dataset.NumExamples(); ++rowIndex)
+        Sums sums;
+        for (const auto& chunkSum : chunkSums)
         {
-            auto& metadata = _dataset[rowIndex].GetMetadata();
-            metadata.weak = _booster.GetWeakWeightLabel(metadata.strong, metadata.currentOutput);
-            sums.Increment(metadata.weak);
+            sums = sums + chunkSum;
         }
 
         if (sums.sumWeights == 0.0)
@@ -312,21 +341,33 @@ namespace trainers
     template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
     void ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::UpdateCurrentOutputs(double value)
     {
-        for (size_t rowIndex = 0; rowIndex < _dataset.NumExamples(); ++rowIndex)
-        {
-            auto& example = _dataset[rowIndex];
-            example.GetMetadata().currentOutput += value;
-        }
+        const auto numExamples = _dataset.NumExamples();
+        utilities::ParallelFor(numExamples, GetNumThreads(numExamples), [&](size_t begin, size_t end, size_t) {
+            for (size_t rowIndex = begin; rowIndex < end; ++rowIndex)
+            {
+                auto& example = _dataset[rowIndex];
+                example.GetMetadata().currentOutput += value;
+            }
+        });
     }
 
     template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
     void ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::UpdateCurrentOutputs(Range range, const EdgePredictorType& edgePredictor)
     {
-        for (size_t rowIndex = range.firstIndex; rowIndex < range.firstIndex + range.size; ++rowIndex)
-        {
-            auto& example = _dataset[rowIndex];
-            example.GetMetadata().currentOutput += edgePredictor.Predict(example.GetDataVector());
-        }
+        utilities::ParallelFor(range.size, GetNumThreads(range.size), [&](size_t begin, size_t end, size_t) {
+            for (size_t rowIndex = range.firstIndex + begin; rowIndex < range.firstIndex + end; ++rowIndex)
+            {
+                auto& example = _dataset[rowIndex];
+                example.GetMetadata().currentOutput += edgePredictor.Predict(example.GetDataVector());
+            }
+        });
+    }
+
+    template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
+    size_t ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::GetNumThreads(size_t numExamples) const
+    {
+        const size_t minExamplesPerThread = 1024;
+        return std::max<size_t>(1, std::min(utilities::GetNumThreads(_parameters.numThreads), numExamples / minExamplesPerThread));
     }
 
     template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
@@ -373,17 +414,27 @@ namespace trainers
             }
 
             // queue new split candidates
-            for (size_t i = 0; i < splitCandidate.splitRule.NumOutputs(); ++i)
+            for (auto& childSplitCandidate : GetBestSplitRulesAtChildren(splitCandidate, interiorNodeIndex))
             {
-                auto splitCandidate = GetBestSplitRuleAtNode(_forest.GetChildId(interiorNodeIndex, i), ranges.GetChildRange(i), stats.GetChildSums(i));
-                if (splitCandidate.gain > _parameters.minSplitGain)
+                if (childSplitCandidate.gain > _parameters.minSplitGain)
                 {
-                    _queue.push(std::move(splitCandidate));
+                    _queue.push(std::move(childSplitCandidate));
                 }
             }
         }
     }
 
+    template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
+    auto ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::GetBestSplitRulesAtChildren(const SplitCandidate& parentSplit, size_t interiorNodeIndex) -> std::vector<SplitCandidate>
+    {
+        std::vector<SplitCandidate> childSplitCandidates;
+        for (size_t i = 0; i < parentSplit.splitRule.NumOutputs(); ++i)
+        {
+            childSplitCandidates.push_back(GetBestSplitRuleAtNode(_forest.GetChildId(interiorNodeIndex, i), parentSplit.ranges.GetChildRange(i), parentSplit.stats.GetChildSums(i)));
+        }
+        return childSplitCandidates;
+    }
+
     template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
     void ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SortNodeDataset(Range range, const SplitRuleType& splitRule)
     {
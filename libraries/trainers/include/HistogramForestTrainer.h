@@ -14,8 +14,10 @@
 #include <predictors/include/ConstantPredictor.h>
 #include <predictors/include/SingleElementThresholdPredictor.h>
 
+#include <map>
 #include <random>
-#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace ell
 {
@@ -29,7 +31,14 @@ namespace trainers
         size_t candidatesPerInput;
     };
 
-    /// <summary> A histogram trainer for binary decision forests with threshold split rules and constant outputs. </summary>
+    /// <summary>
+    /// A histogram trainer for binary decision forests with threshold split rules and constant outputs. At the start
+    /// of each boosting round, the threshold finder picks the candidate thresholds from a sample of the whole dataset.
+    /// The examples at a node are then binned by those thresholds into a histogram of weak weight and label sums, and
+    /// the best split is read off the histogram's prefix sums. Histograms are built on several threads, each thread
+    /// binning a chunk of the examples. After a split, only the smaller child's histogram is built; the larger child's
+    /// histogram is its parent's minus its sibling's.
+    /// </summary>
     ///
     /// <typeparam name="LossFunctionType"> The loss function type. </typeparam>
     /// <typeparam name="BoosterType"> The booster type. </typeparam>
@@ -56,19 +65,37 @@ namespace trainers
 
     protected:
         using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_dataset;
+        using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_forest;
+        using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::GetNumThreads;
+        void OnBoostingRound() override;
         SplitCandidate GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) override;
+        std::vector<SplitCandidate> GetBestSplitRulesAtChildren(const SplitCandidate& parentSplit, size_t interiorNodeIndex) override;
         std::vector<EdgePredictorType> GetEdgePredictors(const NodeStats& nodeStats) override;
 
     private:
-        struct EvaluateSplitRuleResult
+        // the sorted candidate thresholds of one input element; the histogram has one bin per threshold plus one
+        struct FeatureBins
         {
-            Sums sums0;
-            size_t size0;
+            size_t index;
+            std::vector<double> thresholds;
+            size_t firstBin;
+        };
+
+        // the weak weight and label sums, and the number of examples, in each bin
+        struct Histogram
+        {
+            std::vector<Sums> sums;
+            std::vector<size_t> counts;
         };
 
+        using HistogramKey = std::pair<size_t, size_t>; // the first index and size of a node's range
+
         double CalculateGain(const Sums& sums, const Sums& sums0, const Sums& sums1) const;
         std::vector<SplitRuleType> CallThresholdFinder(Range range);
-        std::tuple<Sums, size_t> EvaluateSplitRule(const SplitRuleType& splitRule, const Range& range) const;
+        void SetFeatureBins(const std::vector<SplitRuleType>& splitRules);
+        Histogram BuildHistogram(Range range) const;
+        Histogram SubtractHistograms(const Histogram& histogram, const Histogram& other) const;
+        SplitCandidate GetBestSplitFromHistogram(const Histogram& histogram, SplittableNodeId nodeId, Range range, Sums sums) const;
 
         // member variables
         LossFunctionType _lossFunction;
@@ -76,6 +103,11 @@ namespace trainers
         std::default_random_engine _random;
         size_t _thresholdFinderSampleSize;
         size_t _candidatesPerInput;
+
+        // the candidate thresholds of the current boosting round, and the histograms of the nodes that can still be split
+        std::vector<FeatureBins> _featureBins;
+        size_t _numBins = 0;
+        std::map<HistogramKey, Histogram> _nodeHistograms;
     };
 
     /// <summary> Makes a simple forest trainer. </summary>
@@ -92,8 +124,12 @@ namespace trainers
 
 #pragma region implementation
 
+#include <utilities/include/Exception.h>
+#include <utilities/include/ParallelFor.h>
 #include <utilities/include/RandomEngines.h>
 
+#include <algorithm>
+
 namespace ell
 {
 namespace trainers
@@ -110,33 +146,47 @@ namespace trainers
     }
 
     template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
-    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) -> SplitCandidate
+    void HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::OnBoostingRound()
     {
-        SplitCandidate bestSplitCandidate(nodeId, range, sums);
+        _nodeHistograms.clear();
+        SetFeatureBins(CallThresholdFinder(Range{ 0, _dataset.NumExamples() }));
+    }
 
-        auto splitRuleCandidates = CallThresholdFinder(range);
+    template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
+    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) -> SplitCandidate
+    {
+        auto histogram = BuildHistogram(range);
+        auto bestSplitCandidate = GetBestSplitFromHistogram(histogram, nodeId, range, sums);
+        _nodeHistograms[HistogramKey{ range.firstIndex, range.size }] = std::move(histogram);
+        return bestSplitCandidate;
+    }
 
-        for (const auto& splitRuleCandidate : splitRuleCandidates)
+    template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
+    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::GetBestSplitRulesAtChildren(const SplitCandidate& parentSplit, size_t interiorNodeIndex) -> std::vector<SplitCandidate>
+    {
+        const auto parentRange = parentSplit.ranges.GetTotalRange();
+        auto parentHistogramIterator = _nodeHistograms.find(HistogramKey{ parentRange.firstIndex, parentRange.size });
+        if (parentHistogramIterator == _nodeHistograms.end())
         {
-            Sums sums0;
-            size_t size0;
-
-            std::tie(sums0, size0) = EvaluateSplitRule(splitRuleCandidate, range);
+            return ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::GetBestSplitRulesAtChildren(parentSplit, interiorNodeIndex);
+        }
+        auto parentHistogram = std::move(parentHistogramIterator->second);
+        _nodeHistograms.erase(parentHistogramIterator);
 
-            Sums sums1 = sums - sums0;
-            double gain = CalculateGain(sums, sums0, sums1);
+        // build the smaller child's histogram, and get the larger child's by subtraction
+        std::vector<Histogram> childHistograms(2);
+        const size_t smallerChild = parentSplit.ranges.GetChildRange(0).size <= parentSplit.ranges.GetChildRange(1).size ? 0 : 1;
+        childHistograms[smallerChild] = BuildHistogram(parentSplit.ranges.GetChildRange(smallerChild));
+        childHistograms[1 - smallerChild] = SubtractHistograms(parentHistogram, childHistograms[smallerChild]);
 
-            // find gain maximizer
-            if (gain > bestSplitCandidate.gain)
-            {
-                bestSplitCandidate.gain = gain;
-                bestSplitCandidate.splitRule = splitRuleCandidate;
-                bestSplitCandidate.ranges.SplitChildRange(0, size0);
-                bestSplitCandidate.stats.SetChildSums({ sums0, sums1 });
-            }
+        std::vector<SplitCandidate> childSplitCandidates;
+        for (size_t i = 0; i < 2; ++i)
+        {
+            const auto childRange = parentSplit.ranges.GetChildRange(i);
+            childSplitCandidates.push_back(GetBestSplitFromHistogram(childHistograms[i], _forest.GetChildId(interiorNodeIndex, i), childRange, parentSplit.stats.GetChildSums(i)));
+            _nodeHistograms[HistogramKey{ childRange.firstIndex, childRange.size }] = std::move(childHistograms[i]);
         }
-
-        return bestSplitCandidate;
+        return childSplitCandidates;
     }
 
     template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
@@ -172,26 +222,127 @@ namespace trainers
     }
 
     template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
-    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::EvaluateSplitRule(const SplitRuleType& splitRule, const Range& range) const -> std::tuple<Sums, size_t>
+    void HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::SetFeatureBins(const std::vector<SplitRuleType>& splitRules)
     {
-        Sums sums0;
-        size_t size0 = 0;
+        // group the thresholds by input element, in order of the element index
+        std::map<size_t, std::vector<double>> featureThresholds;
+        for (const auto& splitRule : splitRules)
+        {
+            featureThresholds[splitRule.GetElementIndex()].push_back(splitRule.GetThreshold());
+        }
 
-        auto exampleIterator = _dataset.GetExampleIterator(range.firstIndex, range.size);
-        while (exampleIterator.IsValid())
+        _featureBins.clear();
+        _numBins = 0;
+        for (auto& entry : featureThresholds)
         {
-            const auto& example = exampleIterator.Get();
-            auto prediction = splitRule.Predict(example.GetDataVector());
-            if (prediction == 0)
+            auto& thresholds = entry.second;
+            std::sort(thresholds.begin(), thresholds.end());
+            thresholds.erase(std::unique(thresholds.begin(), thresholds.end()), thresholds.end());
+            const auto numThresholds = thresholds.size();
+            _featureBins.push_back({ entry.first, std::move(thresholds), _numBins });
+            _numBins += numThresholds + 1;
+        }
+    }
+
+    template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
+    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::BuildHistogram(Range range) const -> Histogram
+    {
+        // each thread bins its own chunk of the range, and the partial histograms are added up in order
+        const auto numThreads = GetNumThreads(range.size);
+        std::vector<Histogram> partialHistograms(numThreads, Histogram{ std::vector<Sums>(_numBins), std::vector<size_t>(_numBins) });
+        utilities::ParallelFor(range.size, numThreads, [&](size_t begin, size_t end, size_t chunkIndex) {
+            auto& histogram = partialHistograms[chunkIndex];
+            for (size_t rowIndex = range.firstIndex + begin; rowIndex < range.firstIndex + end; ++rowIndex)
+            {
+                const auto& example = _dataset[rowIndex];
+                const auto& dataVector = example.GetDataVector();
+                const auto& weak = example.GetMetadata().weak;
+                for (const auto& featureBins : _featureBins)
+                {
+                    if (dataVector.PrefixLength() <= featureBins.index)
+                    {
+                        throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange);
+                    }
+
+                    // an example falls in bin j if its value is greater than the first j thresholds, so it goes to child 0 of the j'th threshold and all the ones after it
+                    const auto& thresholds = featureBins.thresholds;
+                    const auto bin = featureBins.firstBin + (std::lower_bound(thresholds.begin(), thresholds.end(), dataVector[featureBins.index]) - thresholds.begin());
+                    histogram.sums[bin].Increment(weak);
+                    ++histogram.counts[bin];
+                }
+            }
+        });
+
+        auto& histogram = partialHistograms[0];
+        for (size_t chunkIndex = 1; chunkIndex < numThreads; ++chunkIndex)
+        {
+            const auto& partialHistogram = partialHistograms[chunkIndex];
+            for (size_t bin = 0; bin < _numBins; ++bin)
             {
-                sums0.Increment(example.GetMetadata().weak);
-                ++size0;
+                histogram.sums[bin] = histogram.sums[bin] + partialHistogram.sums[bin];
+                histogram.counts[bin] += partialHistogram.counts[bin];
             }
-            exampleIterator.Next();
         }
+        return std::move(histogram);
+    }
 
-        return std::make_tuple(sums0, size0);
-    };
+    template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
+    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::SubtractHistograms(const Histogram& histogram, const Histogram& other) const -> Histogram
+    {
+        Histogram difference{ std::vector<Sums>(_numBins), std::vector<size_t>(_numBins) };
+        for (size_t bin = 0; bin < _numBins; ++bin)
+        {
+            difference.sums[bin] = histogram.sums[bin] - other.sums[bin];
+            difference.counts[bin] = histogram.counts[bin] - other.counts[bin];
+        }
+        return difference;
+    }
+
+    template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
+    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::GetBestSplitFromHistogram(const Histogram& histogram, SplittableNodeId nodeId, Range range, Sums sums) const -> SplitCandidate
+    {
+        SplitCandidate bestSplitCandidate(nodeId, range, sums);
+        Sums bestSums0;
+        size_t bestSize0 = 0;
+
+        for (const auto& featureBins : _featureBins)
+        {
+            Sums sums0;
+            size_t size0 = 0;
+            for (size_t thresholdIndex = 0; thresholdIndex < featureBins.thresholds.size(); ++thresholdIndex)
+            {
+                const auto bin = featureBins.firstBin + thresholdIndex;
+                sums0 = sums0 + histogram.sums[bin];
+                size0 += histogram.counts[bin];
+
+                // use the counts to skip empty children, since subtracted histograms can leave rounding residue in the sums
+                if (size0 == 0 || size0 == range.size)
+                {
+                    continue;
+                }
+
+                double gain = CalculateGain(sums, sums0, sums - sums0);
+
+                // find gain maximizer
+                if (gain > bestSplitCandidate.gain)
+                {
+                    bestSplitCandidate.gain = gain;
+                    bestSplitCandidate.splitRule = SplitRuleType{ featureBins.index, featureBins.thresholds[thresholdIndex] };
+                    bestSums0 = sums0;
+                    bestSize0 = size0;
+                }
+            }
+        }
+
+        // the child ranges can only be split once, so they're set after the best split is found
+        if (bestSplitCandidate.gain > 0)
+        {
+            bestSplitCandidate.ranges.SplitChildRange(0, bestSize0);
+            bestSplitCandidate.stats.SetChildSums({ bestSums0, sums - bestSums0 });
+        }
+
+        return bestSplitCandidate;
+    }
 
     template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
     std::unique_ptr<ITrainer<predictors::SimpleForestPredictor>> MakeHistogramForestTrainer(const LossFunctionType& lossFunction, const BoosterType& booster, const ThresholdFinderType& thresholdFinder, const HistogramForestTrainerParameters& parameters)
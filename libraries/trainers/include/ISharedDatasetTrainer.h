@@ -0,0 +1,38 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ISharedDatasetTrainer.h (trainers)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <data/include/Dataset.h>
+
+#include <memory>
+
+namespace ell
+{
+namespace trainers
+{
+    /// <summary>
+    /// Interface to a trainer that can train on a dataset shared with other trainers, instead of making its own copy.
+    /// </summary>
+    ///
+    /// <typeparam name="ExampleType"> The type of example the trainer reads. </typeparam>
+    template <typename ExampleType>
+    class ISharedDatasetTrainer
+    {
+    public:
+        virtual ~ISharedDatasetTrainer() = default;
+
+        /// <summary>
+        /// Sets the trainer's examples to a dataset that other trainers may be reading at the same time. The trainer
+        /// never modifies the dataset: it visits the examples in the order of its own permutation of their indices.
+        /// </summary>
+        ///
+        /// <param name="dataset"> The shared dataset. </param>
+        virtual void SetSharedDataset(std::shared_ptr<const data::Dataset<ExampleType>> dataset) = 0;
+    };
+} // namespace trainers
+} // namespace ell
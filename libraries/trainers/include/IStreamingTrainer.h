@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IStreamingTrainer.h (trainers)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <data/include/ExampleShardReader.h>
+
+#include <memory>
+
+namespace ell
+{
+namespace trainers
+{
+    /// <summary>
+    /// Interface to a trainer that can read its examples in shards, instead of holding the whole dataset in memory.
+    /// </summary>
+    ///
+    /// <typeparam name="ExampleType"> The type of example the trainer reads. </typeparam>
+    template <typename ExampleType>
+    class IStreamingTrainer
+    {
+    public:
+        virtual ~IStreamingTrainer() = default;
+
+        /// <summary>
+        /// Sets the trainer's examples to the ones read by a shard reader. Each call to `Update()` makes one pass over
+        /// them. The examples are shuffled within each shard, and the shards are visited in a random order when the
+        /// reader supports it (see `ExampleShardReader`), but examples in different shards are never mixed: a source
+        /// sorted by label should be shuffled before it's streamed.
+        /// </summary>
+        ///
+        /// <param name="shardReader"> The shard reader. </param>
+        virtual void SetShardedDataset(std::unique_ptr<data::ExampleShardReader<ExampleType>> shardReader) = 0;
+    };
+} // namespace trainers
+} // namespace ell
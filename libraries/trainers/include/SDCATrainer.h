@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "IStreamingTrainer.h"
 #include "ITrainer.h"
 
 #include <predictors/include/LinearPredictor.h>
@@ -17,7 +18,9 @@
 
 #include <math/include/Vector.h>
 
+#include <memory>
 #include <random>
+#include <vector>
 
 namespace ell
 {
@@ -47,6 +50,7 @@ namespace trainers
     /// <typeparam name="RegularizerType"> Regularizer type. </typeparam>
     template <typename LossFunctionType, typename RegularizerType>
     class SDCATrainer : public ITrainer<predictors::LinearPredictor<double>>
+        , public IStreamingTrainer<data::AutoSupervisedExample>
     {
     public:
         /// <summary> Constructs an instance of SDCATrainer. </summary>
@@ -61,6 +65,15 @@ namespace trainers
         /// <param name="anyDataset"> A dataset. </param>
         void SetDataset(const data::AnyDataset& anyDataset) override;
 
+        /// <summary>
+        /// Sets the trainer to read its examples in shards. This makes a first pass over the examples to count them,
+        /// and keeps one dual variable per example in memory. The objectives computed for a streamed epoch use the
+        /// predictor as it was when each shard was trained, so the duality gap they give is an overestimate.
+        /// </summary>
+        ///
+        /// <param name="shardReader"> The shard reader. </param>
+        void SetShardedDataset(std::unique_ptr<data::ExampleShardReader<data::AutoSupervisedExample>> shardReader) override;
+
         /// <summary> Updates the state of the trainer by performing a learning epoch. </summary>
         void Update() override;
 
@@ -93,7 +106,12 @@ namespace trainers
         using TrainerExampleType = data::Example<DataVectorType, TrainerMetadata>;
 
         void Step(TrainerExampleType& x);
+        void Step(const DataVectorType& dataVector, const data::WeightLabel& weightLabel, double norm2Squared, double& dualVariable);
+        void UpdateSharded();
         void ComputeObjectives();
+        void ResetObjectives();
+        void AddExampleObjectives(const DataVectorType& dataVector, double label, double dualVariable, double numExamples);
+        void AddRegularizerObjectives();
         void ResizeTo(const data::AutoDataVector& x);
 
         LossFunctionType _lossFunction;
@@ -103,6 +121,8 @@ namespace trainers
         double _inverseScaledRegularization;
 
         data::Dataset<TrainerExampleType> _dataset;
+        std::unique_ptr<data::ExampleShardReader<data::AutoSupervisedExample>> _shardReader;
+        std::vector<double> _shardedDualVariables;
 
         predictors::LinearPredictor<double> _predictor;
         SDCAPredictorInfo _predictorInfo;
@@ -132,8 +152,12 @@ namespace trainers
 
 #include <data/include/DataVectorOperations.h>
 
+#include <utilities/include/Exception.h>
 #include <utilities/include/RandomEngines.h>
 
+#include <algorithm>
+#include <numeric>
+
 namespace ell
 {
 namespace trainers
@@ -153,6 +177,8 @@ namespace trainers
         DEBUG_THROW(_v.Norm0() != 0, utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "can only call SetDataset before updates"));
 
         _dataset = data::Dataset<TrainerExampleType>(anyDataset);
+        _shardReader.reset();
+        _shardedDualVariables.clear();
         auto numExamples = _dataset.NumExamples();
         _inverseScaledRegularization = 1.0 / (numExamples * _parameters.regularization);
 
@@ -170,9 +196,47 @@ namespace trainers
         }
     }
 
+    template <typename LossFunctionType, typename RegularizerType>
+    void SDCATrainer<LossFunctionType, RegularizerType>::SetShardedDataset(std::unique_ptr<data::ExampleShardReader<data::AutoSupervisedExample>> shardReader)
+    {
+        DEBUG_THROW(_v.Norm0() != 0, utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "can only call SetShardedDataset before updates"));
+
+        _dataset = data::Dataset<TrainerExampleType>();
+        _shardReader = std::move(shardReader);
+
+        // count the examples, since the step size depends on how many there are
+        std::vector<double> labels;
+        _shardReader->Reset();
+        while (_shardReader->Next())
+        {
+            const auto& shard = _shardReader->GetShard();
+            for (size_t i = 0; i < shard.NumExamples(); ++i)
+            {
+                labels.push_back(shard[i].GetMetadata().label);
+            }
+        }
+
+        auto numExamples = labels.size();
+        _shardedDualVariables.assign(numExamples, 0);
+        _inverseScaledRegularization = 1.0 / (numExamples * _parameters.regularization);
+
+        _predictorInfo.primalObjective = 0;
+        _predictorInfo.dualObjective = 0;
+        for (auto label : labels)
+        {
+            _predictorInfo.primalObjective += _lossFunction(0, label) / numExamples;
+        }
+    }
+
     template <typename LossFunctionType, typename RegularizerType>
     void SDCATrainer<LossFunctionType, RegularizerType>::Update()
     {
+        if (_shardReader)
+        {
+            UpdateSharded();
+            return;
+        }
+
         if (_parameters.permute)
         {
             _dataset.RandomPermute(_random);
@@ -188,6 +252,54 @@ namespace trainers
         ComputeObjectives();
     }
 
+    template <typename LossFunctionType, typename RegularizerType>
+    void SDCATrainer<LossFunctionType, RegularizerType>::UpdateSharded()
+    {
+        const double numExamples = static_cast<double>(_shardedDualVariables.size());
+        ResetObjectives();
+
+        if (_parameters.permute)
+        {
+            _shardReader->Reset(_random);
+        }
+        else
+        {
+            _shardReader->Reset();
+        }
+        while (_shardReader->Next())
+        {
+            auto& shard = _shardReader->GetShard();
+            const auto shardOffset = _shardReader->GetShardOffset();
+            if (shardOffset + shard.NumExamples() > _shardedDualVariables.size())
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The sharded dataset has more examples than it had when it was set");
+            }
+
+            // shuffle the order of the examples within the shard, and keep track of where each one came from
+            std::vector<size_t> order(shard.NumExamples());
+            std::iota(order.begin(), order.end(), shardOffset);
+            if (_parameters.permute)
+            {
+                std::shuffle(order.begin(), order.end(), _random);
+            }
+
+            for (auto index : order)
+            {
+                const auto& example = shard[index - shardOffset];
+                const auto& dataVector = example.GetDataVector();
+                Step(dataVector, example.GetMetadata(), dataVector.Norm2Squared(), _shardedDualVariables[index]);
+            }
+
+            for (size_t i = 0; i < shard.NumExamples(); ++i)
+            {
+                const auto& example = shard[i];
+                AddExampleObjectives(example.GetDataVector(), example.GetMetadata().label, _shardedDualVariables[shardOffset + i], numExamples);
+            }
+        }
+
+        AddRegularizerObjectives();
+    }
+
     template <typename LossFunctionType, typename RegularizerType>
     SDCATrainer<LossFunctionType, RegularizerType>::TrainerMetadata::TrainerMetadata(const data::WeightLabel& original) :
         weightLabel(original)
@@ -196,13 +308,18 @@ namespace trainers
     template <typename LossFunctionType, typename RegularizerType>
     void SDCATrainer<LossFunctionType, RegularizerType>::Step(TrainerExampleType& example)
     {
-        const auto& dataVector = example.GetDataVector();
+        auto& metadata = example.GetMetadata();
+        Step(example.GetDataVector(), metadata.weightLabel, metadata.norm2Squared, metadata.dualVariable);
+    }
+
+    template <typename LossFunctionType, typename RegularizerType>
+    void SDCATrainer<LossFunctionType, RegularizerType>::Step(const DataVectorType& dataVector, const data::WeightLabel& weightLabel, double norm2Squared, double& dualVariable)
+    {
         ResizeTo(dataVector);
 
-        auto weightLabel = example.GetMetadata().weightLabel;
-        auto norm2Squared = example.GetMetadata().norm2Squared + 1; // add one because of bias term
+        norm2Squared += 1; // add one because of bias term
         auto lipschitz = norm2Squared * _inverseScaledRegularization;
-        auto dual = example.GetMetadata().dualVariable;
+        auto dual = dualVariable;
 
         if (lipschitz > 0)
         {
@@ -216,7 +333,7 @@ namespace trainers
                 _v.Transpose() += (-dualDiff * _inverseScaledRegularization) * dataVector;
                 _d += (-dualDiff * _inverseScaledRegularization);
                 _regularizer.ConjugateGradient(_v, _d, _predictor.GetWeights(), _predictor.GetBias());
-                example.GetMetadata().dualVariable = newDual;
+                dualVariable = newDual;
             }
         }
     }
@@ -224,22 +341,38 @@ namespace trainers
     template <typename LossFunctionType, typename RegularizerType>
     void SDCATrainer<LossFunctionType, RegularizerType>::ComputeObjectives()
     {
-        double invSize = 1.0 / _dataset.NumExamples();
-
-        _predictorInfo.primalObjective = 0;
-        _predictorInfo.dualObjective = 0;
+        const double numExamples = static_cast<double>(_dataset.NumExamples());
+        ResetObjectives();
 
         for (size_t i = 0; i < _dataset.NumExamples(); ++i)
         {
             const auto& example = _dataset.GetExample(i);
-            auto label = example.GetMetadata().weightLabel.label;
-            auto prediction = _predictor.Predict(example.GetDataVector());
-            auto dualVariable = example.GetMetadata().dualVariable;
-
-            _predictorInfo.primalObjective += invSize * _lossFunction(prediction, label);
-            _predictorInfo.dualObjective -= invSize * _lossFunction.Conjugate(dualVariable, label);
+            AddExampleObjectives(example.GetDataVector(), example.GetMetadata().weightLabel.label, example.GetMetadata().dualVariable, numExamples);
         }
 
+        AddRegularizerObjectives();
+    }
+
+    template <typename LossFunctionType, typename RegularizerType>
+    void SDCATrainer<LossFunctionType, RegularizerType>::ResetObjectives()
+    {
+        _predictorInfo.primalObjective = 0;
+        _predictorInfo.dualObjective = 0;
+    }
+
+    template <typename LossFunctionType, typename RegularizerType>
+    void SDCATrainer<LossFunctionType, RegularizerType>::AddExampleObjectives(const DataVectorType& dataVector, double label, double dualVariable, double numExamples)
+    {
+        double invSize = 1.0 / numExamples;
+        auto prediction = _predictor.Predict(dataVector);
+
+        _predictorInfo.primalObjective += invSize * _lossFunction(prediction, label);
+        _predictorInfo.dualObjective -= invSize * _lossFunction.Conjugate(dualVariable, label);
+    }
+
+    template <typename LossFunctionType, typename RegularizerType>
+    void SDCATrainer<LossFunctionType, RegularizerType>::AddRegularizerObjectives()
+    {
         _predictorInfo.primalObjective += _parameters.regularization * _regularizer(_predictor.GetWeights(), _predictor.GetBias());
         _predictorInfo.dualObjective -= _parameters.regularization * _regularizer.Conjugate(_v, _d);
     }
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "ISharedDatasetTrainer.h"
+#include "IStreamingTrainer.h"
 #include "ITrainer.h"
 
 #include <predictors/include/LinearPredictor.h>
@@ -15,10 +17,13 @@
 #include <data/include/Dataset.h>
 #include <data/include/Example.h>
 
+#include <utilities/include/Exception.h>
+
 #include <cstddef>
 #include <memory>
 #include <random>
 #include <string>
+#include <vector>
 
 namespace ell
 {
@@ -36,6 +41,8 @@ namespace trainers
     /// loss. This class must be have a derived class that implements DoFirstStep(), DoNextStep(), and CalculatePredictors().
     /// </summary>
     class SGDTrainerBase : public ITrainer<predictors::LinearPredictor<double>>
+        , public IStreamingTrainer<data::AutoSupervisedExample>
+        , public ISharedDatasetTrainer<data::AutoSupervisedExample>
     {
     public:
         using PredictorType = predictors::LinearPredictor<double>;
@@ -45,6 +52,16 @@ namespace trainers
         /// <param name="anyDataset"> A dataset. </param>
         void SetDataset(const data::AnyDataset& anyDataset) override;
 
+        /// <summary> Sets the trainer to read its examples in shards. </summary>
+        ///
+        /// <param name="shardReader"> The shard reader. </param>
+        void SetShardedDataset(std::unique_ptr<data::ExampleShardReader<data::AutoSupervisedExample>> shardReader) override;
+
+        /// <summary> Sets the trainer to read its examples from a dataset shared with other trainers. </summary>
+        ///
+        /// <param name="dataset"> The shared dataset. </param>
+        void SetSharedDataset(std::shared_ptr<const data::AutoSupervisedDataset> dataset) override;
+
         /// <summary> Updates the state of the trainer by performing a learning epoch. </summary>
         void Update() override;
 
@@ -61,8 +78,16 @@ namespace trainers
         virtual const PredictorType& GetAveragedPredictor() const = 0;
 
         data::AutoSupervisedDataset _dataset;
+        std::unique_ptr<data::ExampleShardReader<data::AutoSupervisedExample>> _shardReader;
+        std::shared_ptr<const data::AutoSupervisedDataset> _sharedDataset;
+        std::vector<size_t> _sharedDatasetOrder; // this trainer's permutation of the shared dataset's examples
         std::default_random_engine _random;
         bool _firstIteration = true;
+
+    private:
+        void UpdateOnDataset(data::AutoSupervisedDataset& dataset);
+        void UpdateOnSharedDataset();
+        void Step(const data::AutoSupervisedExample& example);
     };
 
     //
@@ -181,6 +206,19 @@ namespace trainers
         /// <param name="parameters"> Trainer parameters. </param>
         SparseDataCenteredSGDTrainer(const LossFunctionType& lossFunction, math::RowVector<double> center, const SGDTrainerParameters& parameters);
 
+        /// <summary>
+        /// Throws, because the center this trainer is constructed with comes from a dataset in memory, and there
+        /// isn't one when the examples are streamed.
+        /// </summary>
+        ///
+        /// <param name="shardReader"> The shard reader. </param>
+        void SetShardedDataset(std::unique_ptr<data::ExampleShardReader<data::AutoSupervisedExample>> shardReader) override;
+
+        /// <summary> Sets the trainer to read its examples from a dataset shared with other trainers. </summary>
+        ///
+        /// <param name="dataset"> The shared dataset. </param>
+        void SetSharedDataset(std::shared_ptr<const data::AutoSupervisedDataset> dataset) override;
+
         /// <summary> Returns a const reference to the last predictor. </summary>
         ///
         /// <returns> A const reference to the last predictor. </returns>
@@ -442,6 +480,12 @@ namespace trainers
         _theta = 1 + _center.Norm2Squared();
     }
 
+    template <typename LossFunctionType>
+    void SparseDataCenteredSGDTrainer<LossFunctionType>::SetShardedDataset(std::unique_ptr<data::ExampleShardReader<data::AutoSupervisedExample>>)
+    {
+        throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "SparseDataCenteredSGDTrainer needs the whole dataset in memory to compute its center, so it can't stream its data");
+    }
+
     template <typename LossFunctionType>
     void SparseDataCenteredSGDTrainer<LossFunctionType>::DoFirstStep(const data::AutoDataVector& x, double y, double weight)
     {
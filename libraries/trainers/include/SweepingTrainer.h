@@ -15,6 +15,10 @@
 
 #include <evaluators/include/Evaluator.h>
 
+#include <utilities/include/ParallelFor.h>
+
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <random>
 #include <string>
@@ -25,7 +29,26 @@ namespace ell
 {
 namespace trainers
 {
-    /// <summary> A class that runs multiple internal trainers and chooses the best performing predictor. </summary>
+    /// <summary> Parameters for the sweeping trainer. </summary>
+    struct SweepingTrainerParameters
+    {
+        /// <summary> The number of trainers to update concurrently, or 0 for one per hardware thread. </summary>
+        size_t numThreads = 1;
+
+        /// <summary>
+        /// If greater than 1, each update keeps only the best 1 / `halvingFactor` of the remaining trainers (and at
+        /// least one), as in successive halving. The other trainers aren't updated again.
+        /// </summary>
+        size_t halvingFactor = 0;
+    };
+
+    /// <summary>
+    /// A class that runs multiple internal trainers and chooses the predictor whose evaluator reports the highest
+    /// goodness (the first value of its first aggregator, which should be a measure where higher is better). The
+    /// internal trainers are updated concurrently, so each one must have its own evaluator. Each trainer's result
+    /// depends only on its own configuration, not on the number of threads. Internal trainers that support it share a
+    /// single copy of the dataset, which none of them modifies; each one visits the examples in its own order.
+    /// </summary>
     ///
     /// <typeparam name="PredictorType"> The type of predictor returned by this trainer. </typeparam>
     template <typename PredictorType>
@@ -38,7 +61,8 @@ namespace trainers
         /// <summary> Constructs an instance of SweepingTrainer. </summary>
         ///
         /// <param name="evaluatingTrainers"> A vector of evaluating trainers. </param>
-        SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers);
+        /// <param name="parameters"> The sweeping trainer parameters. </param>
+        SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers, const SweepingTrainerParameters& parameters = {});
 
         /// <summary> Sets the trainer's dataset. </summary>
         ///
@@ -53,19 +77,30 @@ namespace trainers
         /// <returns> A const reference to the current predictor. </returns>
         const PredictorType& GetPredictor() const override;
 
+        /// <summary> Gets the indices of the trainers that are still being updated. </summary>
+        ///
+        /// <returns> The indices of the remaining trainers, in increasing order. </returns>
+        const std::vector<size_t>& GetActiveTrainerIndices() const { return _activeTrainerIndices; }
+
     private:
-        data::Dataset<ExampleType> _dataset;
+        template <typename FunctionType>
+        void ForEachActiveTrainer(FunctionType&& function);
+        size_t GetBestActiveTrainerIndex() const;
+
         std::vector<EvaluatingTrainerType> _evaluatingTrainers;
+        SweepingTrainerParameters _parameters;
+        std::vector<size_t> _activeTrainerIndices;
     };
 
     /// <summary> Makes an incremental trainer that runs multiple internal trainers and chooses the best performing predictor. </summary>
     ///
     /// <typeparam name="PredictorType"> Type of the predictor returned by this trainer. </typeparam>
     /// <param name="evaluatingTrainers"> A vector of evaluating trainers. </param>
+    /// <param name="parameters"> The sweeping trainer parameters. </param>
     ///
     /// <returns> A unique_ptr to a sweeping trainer. </returns>
     template <typename PredictorType>
-    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers);
+    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers, const SweepingTrainerParameters& parameters = {});
 } // namespace trainers
 } // namespace ell
 
@@ -76,33 +111,77 @@ namespace ell
 namespace trainers
 {
     template <typename PredictorType>
-    SweepingTrainer<PredictorType>::SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers) :
-        _evaluatingTrainers(std::move(evaluatingTrainers))
+    SweepingTrainer<PredictorType>::SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers, const SweepingTrainerParameters& parameters) :
+        _evaluatingTrainers(std::move(evaluatingTrainers)),
+        _parameters(parameters),
+        _activeTrainerIndices(_evaluatingTrainers.size())
     {
         assert(_evaluatingTrainers.size() > 0);
+        for (size_t i = 0; i < _activeTrainerIndices.size(); ++i)
+        {
+            _activeTrainerIndices[i] = i;
+        }
     }
 
     template <typename PredictorType>
     void SweepingTrainer<PredictorType>::SetDataset(const data::AnyDataset& anyDataset)
     {
-        _dataset = data::Dataset<ExampleType>(anyDataset);
+        // one immutable copy for all the trainers that can share it, each of which keeps its own permutation of the
+        // example indices; the others make their own copies
+        auto dataset = std::make_shared<const data::Dataset<ExampleType>>(anyDataset);
+        ForEachActiveTrainer([&anyDataset, &dataset](EvaluatingTrainerType& trainer) {
+            if (!trainer.SetSharedDataset(dataset))
+            {
+                trainer.SetDataset(anyDataset);
+            }
+        });
     }
 
     template <typename PredictorType>
     void SweepingTrainer<PredictorType>::Update()
     {
-        for (size_t i = 0; i < _evaluatingTrainers.size(); ++i)
+        ForEachActiveTrainer([](EvaluatingTrainerType& trainer) { trainer.Update(); });
+
+        if (_parameters.halvingFactor > 1 && _activeTrainerIndices.size() > 1)
         {
-            _evaluatingTrainers[i].Update();
+            // stable sort, so that ties are broken by index and the surviving trainers don't depend on timing
+            std::stable_sort(_activeTrainerIndices.begin(), _activeTrainerIndices.end(), [this](size_t a, size_t b) {
+                return _evaluatingTrainers[a].GetEvaluator()->GetGoodness() > _evaluatingTrainers[b].GetEvaluator()->GetGoodness();
+            });
+            auto numSurvivors = std::max<size_t>(1, _activeTrainerIndices.size() / _parameters.halvingFactor);
+            _activeTrainerIndices.resize(numSurvivors);
+            std::sort(_activeTrainerIndices.begin(), _activeTrainerIndices.end());
         }
     }
 
     template <typename PredictorType>
     const PredictorType& SweepingTrainer<PredictorType>::GetPredictor() const
     {
-        double bestGoodness = _evaluatingTrainers[0].GetEvaluator()->GetGoodness();
-        size_t bestIndex = 0;
-        for (size_t i = 1; i < _evaluatingTrainers.size(); ++i)
+        return _evaluatingTrainers[GetBestActiveTrainerIndex()].GetPredictor();
+    }
+
+    template <typename PredictorType>
+    template <typename FunctionType>
+    void SweepingTrainer<PredictorType>::ForEachActiveTrainer(FunctionType&& function)
+    {
+        // each thread takes the next trainer that hasn't been started, since some configurations train faster than others
+        const auto numTrainers = _activeTrainerIndices.size();
+        const auto numThreads = std::min(utilities::GetNumThreads(_parameters.numThreads), numTrainers);
+        std::atomic<size_t> nextIndex(0);
+        utilities::ParallelFor(numThreads, numThreads, [&](size_t, size_t, size_t) {
+            for (auto i = nextIndex++; i < numTrainers; i = nextIndex++)
+            {
+                function(_evaluatingTrainers[_activeTrainerIndices[i]]);
+            }
+        });
+    }
+
+    template <typename PredictorType>
+    size_t SweepingTrainer<PredictorType>::GetBestActiveTrainerIndex() const
+    {
+        size_t bestIndex = _activeTrainerIndices[0];
+        double bestGoodness = _evaluatingTrainers[bestIndex].GetEvaluator()->GetGoodness();
+        for (auto i : _activeTrainerIndices)
         {
             double goodness = _evaluatingTrainers[i].GetEvaluator()->GetGoodness();
             if (goodness > bestGoodness)
@@ -112,13 +191,13 @@ namespace trainers
             }
         }
 
-        return _evaluatingTrainers[bestIndex].GetPredictor();
+        return bestIndex;
     }
 
     template <typename PredictorType>
-    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers)
+    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers, const SweepingTrainerParameters& parameters)
     {
-        return std::make_unique<SweepingTrainer<PredictorType>>(std::move(evaluatingTrainers));
+        return std::make_unique<SweepingTrainer<PredictorType>>(std::move(evaluatingTrainers), parameters);
     }
 } // namespace trainers
 } // namespace ell
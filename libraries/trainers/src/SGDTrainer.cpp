@@ -8,6 +8,9 @@
 
 #include "SGDTrainer.h"
 
+#include <numeric>
+#include <utility>
+
 namespace ell
 {
 namespace trainers
@@ -16,43 +19,89 @@ namespace trainers
     void SGDTrainerBase::SetDataset(const data::AnyDataset& anyDataset)
     {
         _dataset = data::Dataset<data::AutoSupervisedExample>(anyDataset);
+        _shardReader.reset();
+        _sharedDataset.reset();
     }
 
-    void SGDTrainerBase::Update()
+    void SGDTrainerBase::SetShardedDataset(std::unique_ptr<data::ExampleShardReader<data::AutoSupervisedExample>> shardReader)
     {
-        // permute the data
-        _dataset.RandomPermute(_random);
+        _dataset = data::AutoSupervisedDataset();
+        _shardReader = std::move(shardReader);
+        _sharedDataset.reset();
+    }
 
-        // get example iterator
-        auto exampleIterator = _dataset.GetExampleReferenceIterator();
+    void SGDTrainerBase::SetSharedDataset(std::shared_ptr<const data::AutoSupervisedDataset> dataset)
+    {
+        _dataset = data::AutoSupervisedDataset();
+        _shardReader.reset();
+        _sharedDataset = std::move(dataset);
+        _sharedDatasetOrder.resize(_sharedDataset->NumExamples());
+        std::iota(_sharedDatasetOrder.begin(), _sharedDatasetOrder.end(), 0);
+    }
 
-        // first iteration handled separately
-        if (_firstIteration && exampleIterator.IsValid())
+    void SGDTrainerBase::Update()
+    {
+        if (_sharedDataset)
         {
-            const auto& example = exampleIterator.Get();
+            UpdateOnSharedDataset();
+            return;
+        }
+        if (!_shardReader)
+        {
+            UpdateOnDataset(_dataset);
+            return;
+        }
 
-            const auto& x = example.GetDataVector();
-            double y = example.GetMetadata().label;
-            double weight = example.GetMetadata().weight;
+        _shardReader->Reset(_random);
+        while (_shardReader->Next())
+        {
+            UpdateOnDataset(_shardReader->GetShard());
+        }
+    }
 
-            DoFirstStep(x, y, weight);
+    void SGDTrainerBase::UpdateOnDataset(data::AutoSupervisedDataset& dataset)
+    {
+        // permute the data
+        dataset.RandomPermute(_random);
 
-            exampleIterator.Next();
-            _firstIteration = false;
+        for (size_t index = 0; index < dataset.NumExamples(); ++index)
+        {
+            Step(dataset[index]);
         }
+    }
 
-        while (exampleIterator.IsValid())
+    void SGDTrainerBase::UpdateOnSharedDataset()
+    {
+        // permute the indices the same way Dataset::RandomPermute permutes examples, so training on a shared dataset
+        // visits the examples in the same order as training on a copy
+        const auto numExamples = _sharedDatasetOrder.size();
+        for (size_t index = 0; index < numExamples; ++index)
         {
-            // get the Next example
-            const auto& example = exampleIterator.Get();
+            std::uniform_int_distribution<size_t> distribution(index, numExamples - 1);
+            std::swap(_sharedDatasetOrder[index], _sharedDatasetOrder[distribution(_random)]);
+        }
 
-            const auto& x = example.GetDataVector();
-            double y = example.GetMetadata().label;
-            double weight = example.GetMetadata().weight;
+        for (auto index : _sharedDatasetOrder)
+        {
+            Step(_sharedDataset->GetExample(index));
+        }
+    }
 
-            DoNextStep(x, y, weight);
+    void SGDTrainerBase::Step(const data::AutoSupervisedExample& example)
+    {
+        const auto& x = example.GetDataVector();
+        double y = example.GetMetadata().label;
+        double weight = example.GetMetadata().weight;
 
-            exampleIterator.Next();
+        // first iteration handled separately
+        if (_firstIteration)
+        {
+            DoFirstStep(x, y, weight);
+            _firstIteration = false;
+        }
+        else
+        {
+            DoNextStep(x, y, weight);
         }
     }
 
@@ -7,17 +7,29 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <data/include/Dataset.h>
+#include <data/include/ExampleShardReader.h>
+
+#include <evaluators/include/AUCAggregator.h>
+#include <evaluators/include/Evaluator.h>
 
 #include <functions/include/L2Regularizer.h>
 #include <functions/include/LogLoss.h>
 #include <functions/include/SquaredLoss.h>
 
+#include <trainers/include/HistogramForestTrainer.h>
+#include <trainers/include/LogitBooster.h>
 #include <trainers/include/MeanCalculator.h>
 #include <trainers/include/SDCATrainer.h>
 #include <trainers/include/SGDTrainer.h>
+#include <trainers/include/SweepingTrainer.h>
+#include <trainers/include/ThresholdFinder.h>
 
 #include <testing/include/testing.h>
 
+#include <memory>
+#include <random>
+#include <vector>
+
 using namespace ell;
 
 /// Runs all tests
@@ -59,6 +71,186 @@ void TestSDCATrainer()
     return;
 }
 
+// Streaming the examples must take the same steps as training in memory, when the order of the examples is the same
+void TestShardedTrainers()
+{
+    data::AutoSupervisedDataset dataset;
+    dataset.AddExample({ { 1.0, 0.0, 2.0, 0.0, 3.0 }, { 1.0, 1.0 } });
+    dataset.AddExample({ { 0.0, 4.0, 5.0, 6.0, 7.0 }, { 1.0, -1.0 } });
+    dataset.AddExample({ { 8.0, 0.0, 9.0 }, { 1.0, 1.0 } });
+    dataset.AddExample({ { 0.0, 10.0 }, { 1.0, -1.0 } });
+
+    auto getShardReader = [&dataset](size_t maxShardBytes) {
+        return std::make_unique<data::ExampleShardReader<data::AutoSupervisedExample>>([&dataset]() { return dataset.GetExampleIterator(); }, maxShardBytes);
+    };
+
+    trainers::SDCATrainer<functions::LogLoss, functions::L2Regularizer> sdcaTrainer(functions::LogLoss(), functions::L2Regularizer(), { 1.0e-4, 1.0e-8, 20, false, "XYZ" });
+    trainers::SDCATrainer<functions::LogLoss, functions::L2Regularizer> shardedSdcaTrainer(functions::LogLoss(), functions::L2Regularizer(), { 1.0e-4, 1.0e-8, 20, false, "XYZ" });
+    sdcaTrainer.SetDataset(dataset.GetAnyDataset());
+    shardedSdcaTrainer.SetShardedDataset(getShardReader(1));
+    for (int i = 0; i < 5; ++i)
+    {
+        sdcaTrainer.Update();
+        shardedSdcaTrainer.Update();
+    }
+    testing::ProcessTest("TestShardedTrainers SDCA weights", sdcaTrainer.GetPredictor().GetWeights() == shardedSdcaTrainer.GetPredictor().GetWeights());
+    testing::ProcessTest("TestShardedTrainers SDCA bias", sdcaTrainer.GetPredictor().GetBias() == shardedSdcaTrainer.GetPredictor().GetBias());
+    testing::ProcessTest("TestShardedTrainers SDCA dual objective", testing::IsEqual(sdcaTrainer.GetPredictorInfo().dualObjective, shardedSdcaTrainer.GetPredictorInfo().dualObjective, 1e-12));
+
+    // With all the examples in one shard, SGD shuffles them the same way it does in memory in the first epoch (later
+    // epochs differ, because the in-memory dataset stays shuffled while the shards are read afresh)
+    trainers::SGDTrainer<functions::SquaredLoss> sgdTrainer(functions::SquaredLoss(), { 1.0e-2, "XYZ" });
+    trainers::SGDTrainer<functions::SquaredLoss> shardedSgdTrainer(functions::SquaredLoss(), { 1.0e-2, "XYZ" });
+    sgdTrainer.SetDataset(dataset.GetAnyDataset());
+    shardedSgdTrainer.SetShardedDataset(getShardReader(1 << 20));
+    sgdTrainer.Update();
+    shardedSgdTrainer.Update();
+    testing::ProcessTest("TestShardedTrainers SGD weights", sgdTrainer.GetPredictor().GetWeights() == shardedSgdTrainer.GetPredictor().GetWeights());
+}
+
+// Trainers sharing a dataset permute its indices the same way a trainer with its own copy permutes its examples
+void TestSharedDatasetTrainers()
+{
+    auto dataset = std::make_shared<data::AutoSupervisedDataset>();
+    dataset->AddExample({ { 1.0, 0.0, 2.0, 0.0, 3.0 }, { 1.0, 1.0 } });
+    dataset->AddExample({ { 0.0, 4.0, 5.0, 6.0, 7.0 }, { 1.0, -1.0 } });
+    dataset->AddExample({ { 8.0, 0.0, 9.0 }, { 1.0, 1.0 } });
+    dataset->AddExample({ { 0.0, 10.0 }, { 1.0, -1.0 } });
+
+    trainers::SGDTrainer<functions::SquaredLoss> sgdTrainer(functions::SquaredLoss(), { 1.0e-2, "XYZ" });
+    trainers::SGDTrainer<functions::SquaredLoss> sharedSgdTrainer1(functions::SquaredLoss(), { 1.0e-2, "XYZ" });
+    trainers::SGDTrainer<functions::SquaredLoss> sharedSgdTrainer2(functions::SquaredLoss(), { 1.0e-2, "XYZ" });
+    sgdTrainer.SetDataset(dataset->GetAnyDataset());
+    sharedSgdTrainer1.SetSharedDataset(dataset);
+    sharedSgdTrainer2.SetSharedDataset(dataset);
+    for (int i = 0; i < 5; ++i)
+    {
+        sgdTrainer.Update();
+        sharedSgdTrainer1.Update();
+        sharedSgdTrainer2.Update();
+    }
+    testing::ProcessTest("TestSharedDatasetTrainers SGD weights", sgdTrainer.GetPredictor().GetWeights() == sharedSgdTrainer1.GetPredictor().GetWeights() && sgdTrainer.GetPredictor().GetWeights() == sharedSgdTrainer2.GetPredictor().GetWeights());
+    testing::ProcessTest("TestSharedDatasetTrainers SGD bias", sgdTrainer.GetPredictor().GetBias() == sharedSgdTrainer1.GetPredictor().GetBias());
+    testing::ProcessTest("TestSharedDatasetTrainers dataset unchanged", dataset->GetExample(0).GetDataVector().PrefixLength() == 5 && dataset->GetExample(1).GetDataVector().PrefixLength() == 5 && dataset->GetExample(2).GetDataVector().PrefixLength() == 3 && dataset->GetExample(3).GetDataVector().PrefixLength() == 2);
+}
+
+// Training on several threads must grow the same forest as training on one, up to rounding
+void TestHistogramForestTrainer()
+{
+    std::default_random_engine random(1234);
+    std::uniform_int_distribution<int> distribution(1, 20);
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < 8192; ++i)
+    {
+        std::vector<double> values = { double(distribution(random)), double(distribution(random)), double(distribution(random)) };
+        double label = values[0] + 2 * values[1] > 31 ? 1.0 : -1.0;
+        dataset.AddExample({ values, { 1.0, label } });
+    }
+
+    auto train = [&dataset](size_t numThreads) {
+        trainers::HistogramForestTrainerParameters parameters;
+        parameters.minSplitGain = 0;
+        parameters.maxSplitsPerRound = 8;
+        parameters.numRounds = 3;
+        parameters.numThreads = numThreads;
+        parameters.randomSeed = "XYZ";
+        parameters.thresholdFinderSampleSize = 1000;
+        parameters.candidatesPerInput = 8;
+        auto trainer = trainers::MakeHistogramForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainers::ExhaustiveThresholdFinder(), parameters);
+        trainer->SetDataset(dataset.GetAnyDataset());
+        trainer->Update();
+        return trainer->GetPredictor();
+    };
+
+    auto forest = train(1);
+    auto parallelForest = train(4);
+
+    bool predictionsEqual = true;
+    size_t numErrors = 0;
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        auto dataVector = dataset[i].GetDataVector().CopyAs<data::FloatDataVector>();
+        auto prediction = forest.Predict(dataVector);
+        predictionsEqual = predictionsEqual && testing::IsEqual(prediction, parallelForest.Predict(dataVector), 1e-8);
+        if (prediction * dataset[i].GetMetadata().label <= 0)
+        {
+            ++numErrors;
+        }
+    }
+
+    testing::ProcessTest("TestHistogramForestTrainer number of trees", forest.NumTrees() == 3 && parallelForest.NumTrees() == 3);
+    testing::ProcessTest("TestHistogramForestTrainer multithreaded predictions", predictionsEqual);
+    testing::ProcessTest("TestHistogramForestTrainer training error", numErrors < dataset.NumExamples() / 10);
+}
+
+// Sweeping on several threads must train each configuration exactly as on one thread
+void TestSweepingTrainer()
+{
+    using PredictorType = predictors::LinearPredictor<double>;
+
+    std::default_random_engine random(1234);
+    std::normal_distribution<double> distribution;
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < 200; ++i)
+    {
+        std::vector<double> values = { distribution(random), distribution(random), 1.0 };
+        double label = values[0] - values[1] + 0.5 * distribution(random) > 0 ? 1.0 : -1.0;
+        dataset.AddExample({ values, { 1.0, label } });
+    }
+
+    std::vector<double> regularization{ 1.0e-0, 1.0e-1, 1.0e-2, 1.0e-3, 1.0e-4 };
+    auto train = [&](const trainers::SweepingTrainerParameters& parameters, size_t numEpochs, std::vector<std::shared_ptr<evaluators::IEvaluator<PredictorType>>>& evaluators) {
+        std::vector<trainers::EvaluatingTrainer<PredictorType>> evaluatingTrainers;
+        for (auto lambda : regularization)
+        {
+            evaluators.push_back(evaluators::MakeEvaluator<PredictorType>(dataset.GetAnyDataset(), { 1, false }, evaluators::AUCAggregator()));
+            evaluatingTrainers.push_back(trainers::MakeEvaluatingTrainer(trainers::MakeSGDTrainer(functions::LogLoss(), { lambda, "XYZ" }), evaluators.back()));
+        }
+
+        auto trainer = std::make_unique<trainers::SweepingTrainer<PredictorType>>(std::move(evaluatingTrainers), parameters);
+        trainer->SetDataset(dataset.GetAnyDataset());
+        for (size_t epoch = 0; epoch < numEpochs; ++epoch)
+        {
+            trainer->Update();
+        }
+        return trainer;
+    };
+
+    std::vector<std::shared_ptr<evaluators::IEvaluator<PredictorType>>> evaluators;
+    std::vector<std::shared_ptr<evaluators::IEvaluator<PredictorType>>> parallelEvaluators;
+    auto trainer = train({ 1, 0 }, 3, evaluators);
+    auto parallelTrainer = train({ 3, 0 }, 3, parallelEvaluators);
+
+    bool goodnessEqual = true;
+    for (size_t i = 0; i < regularization.size(); ++i)
+    {
+        goodnessEqual = goodnessEqual && evaluators[i]->GetGoodness() == parallelEvaluators[i]->GetGoodness();
+    }
+    testing::ProcessTest("TestSweepingTrainer multithreaded evaluations", goodnessEqual);
+    testing::ProcessTest("TestSweepingTrainer multithreaded predictor", trainer->GetPredictor().GetWeights() == parallelTrainer->GetPredictor().GetWeights());
+
+    // successive halving: 5 -> 2 -> 1 configurations, and the survivor is one of the best after the first epoch
+    std::vector<std::shared_ptr<evaluators::IEvaluator<PredictorType>>> halvingEvaluators;
+    auto halvingTrainer = train({ 3, 2 }, 3, halvingEvaluators);
+    const auto& activeTrainerIndices = halvingTrainer->GetActiveTrainerIndices();
+    testing::ProcessTest("TestSweepingTrainer successive halving", activeTrainerIndices.size() == 1);
+    if (activeTrainerIndices.size() == 1)
+    {
+        using EvaluatorType = evaluators::Evaluator<PredictorType, evaluators::AUCAggregator>;
+        auto getValues = [&halvingEvaluators](size_t index) { return std::dynamic_pointer_cast<EvaluatorType>(halvingEvaluators[index])->GetValues(); };
+        auto survivor = activeTrainerIndices[0];
+        size_t numBetterAfterFirstEpoch = 0;
+        for (size_t i = 0; i < halvingEvaluators.size(); ++i)
+        {
+            if (getValues(i)[0][0][0] > getValues(survivor)[0][0][0])
+            {
+                ++numBetterAfterFirstEpoch;
+            }
+        }
+        testing::ProcessTest("TestSweepingTrainer successive halving survivor", numBetterAfterFirstEpoch < 2 && getValues(survivor).size() == 3);
+    }
+}
+
 void TestSGDTrainer()
 {
     data::AutoSupervisedDataset dataset;
@@ -134,6 +326,10 @@ void TestMeanCalculator()
 int main()
 {
     TestSDCATrainer();
+    TestShardedTrainers();
+    TestSharedDatasetTrainers();
+    TestHistogramForestTrainer();
+    TestSweepingTrainer();
     TestSGDTrainer();
     TestMeanCalculator();
 }
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "ArchiveVersion.h"
+#include "ArrayView.h"
 #include "TypeFactory.h"
 #include "TypeName.h"
 #include "TypeTraits.h"
@@ -135,6 +136,7 @@ namespace utilities
 #define ARCHIVABLE_TYPES_LIST      \
     ARCHIVE_TYPE_OP(bool)          \
     ARCHIVE_TYPE_OP(char)          \
+    ARCHIVE_TYPE_OP(int8_t)        \
     ARCHIVE_TYPE_OP(short)         \
     ARCHIVE_TYPE_OP(int)           \
     ARCHIVE_TYPE_OP(unsigned int)  \
@@ -147,6 +149,7 @@ namespace utilities
 #define ARCHIVABLE_TYPES_LIST     \
     ARCHIVE_TYPE_OP(bool)         \
     ARCHIVE_TYPE_OP(char)         \
+    ARCHIVE_TYPE_OP(int8_t)       \
     ARCHIVE_TYPE_OP(short)        \
     ARCHIVE_TYPE_OP(int)          \
     ARCHIVE_TYPE_OP(unsigned int) \
@@ -335,6 +338,8 @@ namespace utilities
 #define DECLARE_UNARCHIVE_ARRAY_BASE(type) virtual void UnarchiveArray(const char* name, std::vector<type>& value, IsFundamental<type> = true) = 0;
 #define DECLARE_UNARCHIVE_VALUE_OVERRIDE(type) void UnarchiveValue(const char* name, type& value, IsFundamental<type> = true) override;
 #define DECLARE_UNARCHIVE_ARRAY_OVERRIDE(type) void UnarchiveArray(const char* name, std::vector<type>& value, IsFundamental<type> = true) override;
+#define DECLARE_UNARCHIVE_ARRAY_VIEW_BASE(type) virtual bool UnarchiveArrayView(const char* name, ArrayView<type>& value, IsFundamental<type> = true);
+#define DECLARE_UNARCHIVE_ARRAY_VIEW_OVERRIDE(type) bool UnarchiveArrayView(const char* name, ArrayView<type>& value, IsFundamental<type> = true) override;
 
     /// <summary> Unarchiver class </summary>
     class Unarchiver
@@ -408,6 +413,19 @@ namespace utilities
         template <typename ValueType>
         void Unarchive(const char* name, ValueType&& value);
 
+        /// <summary>
+        /// Reads a named array of fundamental values as a view of the archive's storage, without copying it. Only some
+        /// unarchivers can do this. The others return false without reading anything, and the array should then be
+        /// read into a std::vector instead.
+        /// </summary>
+        ///
+        /// <param name="name"> The name of the array. </param>
+        /// <param name="value"> The view to set. </param>
+        ///
+        /// <returns> true if the array was read. </returns>
+        template <typename ValueType, IsFundamental<ValueType> concept = true>
+        bool TryUnarchiveArrayView(const std::string& name, ArrayView<ValueType>& value);
+
         /// <summary> Get an unarchiver scoped to a particular property name. </summary>
         ///
         /// <param name="name"> The name of the property </param>
@@ -482,6 +500,11 @@ namespace utilities
 
         virtual void UnarchiveArray(const char* name, std::vector<std::string>& array) = 0;
 
+        // By default, arrays can't be read as views
+#define ARCHIVE_TYPE_OP(t) DECLARE_UNARCHIVE_ARRAY_VIEW_BASE(t);
+        ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
         // Extra functions needed for deserializing arrays.
         virtual void BeginUnarchiveArray(const char* name, const std::string& typeName);
         virtual bool BeginUnarchiveArrayItem(const std::string& typeName) = 0;
@@ -592,6 +615,8 @@ namespace utilities
     void base::UnarchiveValue(const char* name, type& value, IsFundamental<type>) { ReadScalar(name, value); }
 #define IMPLEMENT_UNARCHIVE_ARRAY(base, type) \
     void base::UnarchiveArray(const char* name, std::vector<type>& value, IsFundamental<type>) { ReadArray(name, value); }
+#define IMPLEMENT_UNARCHIVE_ARRAY_VIEW(base, type) \
+    bool base::UnarchiveArrayView(const char* name, ArrayView<type>& value, IsFundamental<type>) { return ReadArrayView(name, value); }
 } // namespace utilities
 } // namespace ell
 
@@ -801,6 +826,12 @@ namespace utilities
         UnarchiveItem(name, value);
     }
 
+    template <typename ValueType, IsFundamental<ValueType> concept>
+    bool Unarchiver::TryUnarchiveArrayView(const std::string& name, ArrayView<ValueType>& value)
+    {
+        return UnarchiveArrayView(name.c_str(), value);
+    }
+
     // STYLE: inline to keep next to its sibling overload
     inline Unarchiver::OptionalPropertyUnarchiver<Unarchiver::NoDefault> Unarchiver::OptionalProperty(const std::string& name)
     {
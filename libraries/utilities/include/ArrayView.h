@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ArrayView.h (utilities)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary>
+    /// A read-only array whose storage is reference-counted, so copies of the view share it. The storage is either a
+    /// copy of a std::vector made by the view, or memory owned by some other object, such as a memory-mapped archive,
+    /// that the view keeps alive.
+    /// </summary>
+    template <typename ValueType>
+    class ArrayView
+    {
+    public:
+        /// <summary> Constructs an empty view. </summary>
+        ArrayView() = default;
+
+        /// <summary> Constructs a view of a copy of a vector. </summary>
+        ///
+        /// <param name="values"> The values. </param>
+        explicit ArrayView(const std::vector<ValueType>& values);
+
+        /// <summary> Constructs a view that takes over the contents of a vector. </summary>
+        ///
+        /// <param name="values"> The values. </param>
+        explicit ArrayView(std::vector<ValueType>&& values);
+
+        /// <summary> Constructs a view of memory owned by another object. </summary>
+        ///
+        /// <param name="storage"> The object that owns the memory, which is kept alive as long as the view (or a copy of it) exists. </param>
+        /// <param name="data"> A pointer to the first element. </param>
+        /// <param name="size"> The number of elements. </param>
+        ArrayView(std::shared_ptr<const void> storage, const ValueType* data, size_t size);
+
+        /// <summary> Gets a pointer to the first element. </summary>
+        const ValueType* GetData() const { return _data; }
+
+        /// <summary> Gets the number of elements. </summary>
+        size_t Size() const { return _size; }
+
+        /// <summary> Gets the object that owns the memory. </summary>
+        const std::shared_ptr<const void>& GetStorage() const { return _storage; }
+
+        /// <summary> Gets an element. </summary>
+        const ValueType& operator[](size_t index) const { return _data[index]; }
+
+        /// <summary> Gets an iterator to the first element. </summary>
+        const ValueType* begin() const { return _data; }
+
+        /// <summary> Gets an iterator past the last element. </summary>
+        const ValueType* end() const { return _data + _size; }
+
+        /// <summary> Returns a copy of the elements. </summary>
+        std::vector<ValueType> ToVector() const { return { begin(), end() }; }
+
+    private:
+        std::shared_ptr<const void> _storage;
+        const ValueType* _data = nullptr;
+        size_t _size = 0;
+    };
+} // namespace utilities
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace utilities
+{
+    template <typename ValueType>
+    ArrayView<ValueType>::ArrayView(const std::vector<ValueType>& values) :
+        ArrayView(std::vector<ValueType>(values))
+    {
+    }
+
+    template <typename ValueType>
+    ArrayView<ValueType>::ArrayView(std::vector<ValueType>&& values) :
+        _size(values.size())
+    {
+        if constexpr (std::is_same_v<ValueType, bool>)
+        {
+            // std::vector<bool> doesn't store its elements contiguously, so it can't be viewed
+            std::shared_ptr<ValueType> storage(new ValueType[_size], std::default_delete<ValueType[]>());
+            std::copy(values.begin(), values.end(), storage.get());
+            _data = storage.get();
+            _storage = std::move(storage);
+        }
+        else
+        {
+            auto storage = std::make_shared<std::vector<ValueType>>(std::move(values));
+            _data = storage->data();
+            _storage = std::move(storage);
+        }
+    }
+
+    template <typename ValueType>
+    ArrayView<ValueType>::ArrayView(std::shared_ptr<const void> storage, const ValueType* data, size_t size) :
+        _storage(std::move(storage)),
+        _data(data),
+        _size(size)
+    {
+    }
+} // namespace utilities
+} // namespace ell
+
+#pragma endregion implementation
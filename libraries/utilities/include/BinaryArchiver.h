@@ -0,0 +1,514 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryArchiver.h (utilities)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Archiver.h"
+#include "ArrayView.h"
+#include "Exception.h"
+#include "MemoryMappedFile.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary> The kinds of records in a binary archive. </summary>
+    enum class BinaryArchiveTag : uint8_t
+    {
+        null = 0,
+        boolean,
+        int8,
+        uint8,
+        int16,
+        uint16,
+        int32,
+        uint32,
+        int64,
+        uint64,
+        float32,
+        float64,
+        string,
+        array,
+        object,
+        primitiveObject,
+        objectArray,
+        endObject,
+        endArray
+    };
+
+    /// <summary>
+    /// An archiver that encodes data in a compact binary format. The archive starts with a magic number and a format
+    /// version, followed by a sequence of records. Each record starts with a tag byte and (except for the end-of-object
+    /// and end-of-array markers) a reference to its name. Names and type names are stored once, in a string table that
+    /// is built as the archive is written: a reference is a 32-bit index, and an index one past the end of the table is
+    /// followed by a new string. Numbers are stored in their native width in little-endian byte order; arrays of numbers
+    /// are stored as an element tag, a 64-bit element count, padding that aligns the elements to their size, and the raw
+    /// elements. They can be read with a single copy, or used in place from a memory-mapped archive.
+    /// </summary>
+    class BinaryArchiver : public Archiver
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="outputStream"> The stream to write data to, which should be opened in binary mode. </param>
+        BinaryArchiver(std::ostream& outputStream);
+
+    protected:
+#define ARCHIVE_TYPE_OP(t) DECLARE_ARCHIVE_VALUE_OVERRIDE(t);
+        ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+        void ArchiveValue(const char* name, const std::string& value) override;
+
+#define ARCHIVE_TYPE_OP(t) DECLARE_ARCHIVE_ARRAY_OVERRIDE(t);
+        ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+        void ArchiveNull(const char* name) override;
+
+        void ArchiveArray(const char* name, const std::vector<std::string>& array) override;
+        void ArchiveArray(const char* name, const std::string& baseTypeName, const std::vector<const IArchivable*>& array) override;
+
+        void BeginArchiveObject(const char* name, const IArchivable& value) override;
+        void EndArchiveObject(const char* name, const IArchivable& value) override;
+
+        void EndArchiving() override;
+
+    private:
+        // Serialization
+        template <typename ValueType, IsFundamental<ValueType> concept = 0>
+        void WriteScalar(const char* name, const ValueType& value);
+
+        template <typename ValueType, IsFundamental<ValueType> concept = 0>
+        void WriteArray(const char* name, const std::vector<ValueType>& array);
+
+        void WriteTag(BinaryArchiveTag tag);
+        void WriteStringReference(const std::string& str);
+        void WriteString(const std::string& str);
+        void WriteAlignmentPadding(size_t alignment);
+        void WriteBytes(const char* data, size_t size);
+
+        template <typename ValueType>
+        void WriteRaw(const ValueType& value);
+
+        std::ostream& _out;
+        uint64_t _position = 0; // relative to the start of the archive
+        std::unordered_map<std::string, uint32_t> _stringTable;
+    };
+
+    /// <summary> An unarchiver that reads data written by a BinaryArchiver. </summary>
+    class BinaryUnarchiver : public Unarchiver
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="inputStream"> The stream to read data from, which should be opened in binary mode. </param>
+        /// <param name="context"> The initial `SerializationContext` to use. </param>
+        BinaryUnarchiver(std::istream& inputStream, SerializationContext context);
+
+        /// <summary> Constructor for reading an archive from a memory-mapped file. Arrays of numbers in the archive can
+        /// then be read as views of the file with `TryUnarchiveArrayView`, instead of being copied. </summary>
+        ///
+        /// <param name="file"> The file to read data from, which is kept alive as long as any views of it exist. Objects
+        /// such as matrices may write through the views they hold, so views are only made of a file that's mapped
+        /// copy-on-write; the arrays of a read-only mapping are copied instead. </param>
+        /// <param name="context"> The initial `SerializationContext` to use. </param>
+        BinaryUnarchiver(std::shared_ptr<const MemoryMappedFile> file, SerializationContext context);
+
+        /// <summary> Indicates if a property with the given name is available to be read next </summary>
+        ///
+        /// <param name="name"> The name of the property </param>
+        ///
+        /// <returns> true if a property with the given name can be read next </returns>
+        bool HasNextPropertyName(const std::string& name) override;
+
+        /// <summary> Checks if a stream contains a binary archive, without consuming anything from the stream. </summary>
+        ///
+        /// <param name="inputStream"> The stream. </param>
+        ///
+        /// <returns> true if the next byte in the stream is the first byte of a binary archive. </returns>
+        static bool IsBinaryArchive(std::istream& inputStream);
+
+    protected:
+#define ARCHIVE_TYPE_OP(t) DECLARE_UNARCHIVE_VALUE_OVERRIDE(t);
+        ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+        void UnarchiveValue(const char* name, std::string& value) override;
+
+        bool UnarchiveNull(const char* name) override;
+
+#define ARCHIVE_TYPE_OP(t) DECLARE_UNARCHIVE_ARRAY_OVERRIDE(t);
+        ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+        void UnarchiveArray(const char* name, std::vector<std::string>& array) override;
+
+#define ARCHIVE_TYPE_OP(t) DECLARE_UNARCHIVE_ARRAY_VIEW_OVERRIDE(t);
+        ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+        void BeginUnarchiveArray(const char* name, const std::string& typeName) override;
+        bool BeginUnarchiveArrayItem(const std::string& typeName) override;
+        void EndUnarchiveArrayItem(const std::string& typeName) override;
+        void EndUnarchiveArray(const char* name, const std::string& typeName) override;
+
+        ArchivedObjectInfo BeginUnarchiveObject(const char* name, const std::string& typeName) override;
+        void EndUnarchiveObject(const char* name, const std::string& typeName) override;
+        void UnarchiveObjectAsPrimitive(const char* name, IArchivable& value) override;
+
+    private:
+        struct RecordHeader
+        {
+            BinaryArchiveTag tag;
+            std::string name;
+        };
+
+        template <typename ValueType, IsFundamental<ValueType> concept = 0>
+        void ReadScalar(const char* name, ValueType& value);
+
+        template <typename ValueType, IsFundamental<ValueType> concept = 0>
+        void ReadArray(const char* name, std::vector<ValueType>& array);
+
+        template <typename ValueType, IsFundamental<ValueType> concept = 0>
+        bool ReadArrayView(const char* name, ArrayView<ValueType>& array);
+
+        template <typename ValueType>
+        ValueType ReadNumber(BinaryArchiveTag tag);
+
+        void ReadArchiveHeader();
+        void SkipAlignmentPadding();
+        void CheckRemainingSize(uint64_t count, size_t elementSize);
+
+        const RecordHeader& PeekRecordHeader();
+        RecordHeader ReadRecordHeader();
+        RecordHeader ReadRecordHeader(const char* name, BinaryArchiveTag expectedTag);
+        BinaryArchiveTag ReadTag();
+        std::string ReadStringReference();
+        std::string ReadString();
+
+        template <typename ValueType>
+        ValueType ReadRaw();
+
+        // the stream reads from the mapped file, if there is one
+        std::shared_ptr<const MemoryMappedFile> _mappedFile;
+        std::unique_ptr<std::streambuf> _mappedFileBuffer;
+        std::unique_ptr<std::istream> _mappedFileStream;
+
+        std::istream& _in;
+        std::vector<std::string> _stringTable;
+        RecordHeader _nextRecordHeader;
+        bool _hasNextRecordHeader = false;
+    };
+
+    namespace BinaryArchiverImpl
+    {
+        /// <summary> Gets the tag of the record that stores a fundamental type. </summary>
+        template <typename ValueType>
+        constexpr BinaryArchiveTag GetTag()
+        {
+            if constexpr (std::is_same_v<ValueType, bool>)
+            {
+                return BinaryArchiveTag::boolean;
+            }
+            else if constexpr (std::is_floating_point_v<ValueType>)
+            {
+                static_assert(sizeof(ValueType) == 4 || sizeof(ValueType) == 8, "Unsupported floating-point type");
+                return sizeof(ValueType) == 4 ? BinaryArchiveTag::float32 : BinaryArchiveTag::float64;
+            }
+            else
+            {
+                static_assert(sizeof(ValueType) == 1 || sizeof(ValueType) == 2 || sizeof(ValueType) == 4 || sizeof(ValueType) == 8, "Unsupported integer type");
+                constexpr bool isSigned = std::is_signed_v<ValueType>;
+                switch (sizeof(ValueType))
+                {
+                case 1:
+                    return isSigned ? BinaryArchiveTag::int8 : BinaryArchiveTag::uint8;
+                case 2:
+                    return isSigned ? BinaryArchiveTag::int16 : BinaryArchiveTag::uint16;
+                case 4:
+                    return isSigned ? BinaryArchiveTag::int32 : BinaryArchiveTag::uint32;
+                default:
+                    return isSigned ? BinaryArchiveTag::int64 : BinaryArchiveTag::uint64;
+                }
+            }
+        }
+
+        /// <summary> Gets the number of bytes a number with the given tag takes, or 0 if the tag isn't a number. </summary>
+        inline size_t GetNumberSize(BinaryArchiveTag tag)
+        {
+            switch (tag)
+            {
+            case BinaryArchiveTag::boolean:
+            case BinaryArchiveTag::int8:
+            case BinaryArchiveTag::uint8:
+                return 1;
+            case BinaryArchiveTag::int16:
+            case BinaryArchiveTag::uint16:
+                return 2;
+            case BinaryArchiveTag::int32:
+            case BinaryArchiveTag::uint32:
+            case BinaryArchiveTag::float32:
+                return 4;
+            case BinaryArchiveTag::int64:
+            case BinaryArchiveTag::uint64:
+            case BinaryArchiveTag::float64:
+                return 8;
+            default:
+                return 0;
+            }
+        }
+
+        /// <summary> The most memory the unarchiver allocates for a string or array before reading the data that fills it. </summary>
+        constexpr uint64_t maxReadChunkBytes = 1 << 20;
+
+        /// <summary> Returns true if this machine stores numbers in little-endian byte order. </summary>
+        inline bool IsLittleEndian()
+        {
+            const uint16_t one = 1;
+            uint8_t firstByte;
+            std::memcpy(&firstByte, &one, 1);
+            return firstByte == 1;
+        }
+
+        /// <summary> Reverses the bytes of each element of an array, in place. </summary>
+        inline void SwapByteOrder(char* data, size_t elementSize, size_t numElements)
+        {
+            for (size_t i = 0; i < numElements; ++i)
+            {
+                std::reverse(data + i * elementSize, data + (i + 1) * elementSize);
+            }
+        }
+    } // namespace BinaryArchiverImpl
+} // namespace utilities
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace utilities
+{
+    //
+    // Serialization
+    //
+    template <typename ValueType>
+    void BinaryArchiver::WriteRaw(const ValueType& value)
+    {
+        char bytes[sizeof(ValueType)];
+        std::memcpy(bytes, &value, sizeof(ValueType));
+        if (!BinaryArchiverImpl::IsLittleEndian())
+        {
+            BinaryArchiverImpl::SwapByteOrder(bytes, sizeof(ValueType), 1);
+        }
+        WriteBytes(bytes, sizeof(ValueType));
+    }
+
+    template <typename ValueType, IsFundamental<ValueType> concept>
+    void BinaryArchiver::WriteScalar(const char* name, const ValueType& value)
+    {
+        WriteTag(BinaryArchiverImpl::GetTag<ValueType>());
+        WriteStringReference(name);
+        if constexpr (std::is_same_v<ValueType, bool>)
+        {
+            WriteRaw<uint8_t>(value ? 1 : 0);
+        }
+        else
+        {
+            WriteRaw(value);
+        }
+    }
+
+    template <typename ValueType, IsFundamental<ValueType> concept>
+    void BinaryArchiver::WriteArray(const char* name, const std::vector<ValueType>& array)
+    {
+        WriteTag(BinaryArchiveTag::array);
+        WriteStringReference(name);
+        WriteTag(BinaryArchiverImpl::GetTag<ValueType>());
+        WriteRaw<uint64_t>(array.size());
+        WriteAlignmentPadding(sizeof(ValueType));
+        if constexpr (std::is_same_v<ValueType, bool>)
+        {
+            for (bool value : array)
+            {
+                WriteRaw<uint8_t>(value ? 1 : 0);
+            }
+        }
+        else if (BinaryArchiverImpl::IsLittleEndian())
+        {
+            WriteBytes(reinterpret_cast<const char*>(array.data()), array.size() * sizeof(ValueType));
+        }
+        else
+        {
+            for (const auto& value : array)
+            {
+                WriteRaw(value);
+            }
+        }
+    }
+
+    //
+    // Deserialization
+    //
+    template <typename ValueType>
+    ValueType BinaryUnarchiver::ReadRaw()
+    {
+        char bytes[sizeof(ValueType)];
+        _in.read(bytes, sizeof(ValueType));
+        if (!_in)
+        {
+            throw InputException(InputExceptionErrors::badData, "Unexpected end of binary archive");
+        }
+        if (!BinaryArchiverImpl::IsLittleEndian())
+        {
+            BinaryArchiverImpl::SwapByteOrder(bytes, sizeof(ValueType), 1);
+        }
+        ValueType value;
+        std::memcpy(&value, bytes, sizeof(ValueType));
+        return value;
+    }
+
+    template <typename ValueType>
+    ValueType BinaryUnarchiver::ReadNumber(BinaryArchiveTag tag)
+    {
+        // values are converted if the archive stores a different type than the one being read, as the text archivers do
+        switch (tag)
+        {
+        case BinaryArchiveTag::boolean:
+            return static_cast<ValueType>(ReadRaw<uint8_t>() != 0);
+        case BinaryArchiveTag::int8:
+            return static_cast<ValueType>(ReadRaw<int8_t>());
+        case BinaryArchiveTag::uint8:
+            return static_cast<ValueType>(ReadRaw<uint8_t>());
+        case BinaryArchiveTag::int16:
+            return static_cast<ValueType>(ReadRaw<int16_t>());
+        case BinaryArchiveTag::uint16:
+            return static_cast<ValueType>(ReadRaw<uint16_t>());
+        case BinaryArchiveTag::int32:
+            return static_cast<ValueType>(ReadRaw<int32_t>());
+        case BinaryArchiveTag::uint32:
+            return static_cast<ValueType>(ReadRaw<uint32_t>());
+        case BinaryArchiveTag::int64:
+            return static_cast<ValueType>(ReadRaw<int64_t>());
+        case BinaryArchiveTag::uint64:
+            return static_cast<ValueType>(ReadRaw<uint64_t>());
+        case BinaryArchiveTag::float32:
+            return static_cast<ValueType>(ReadRaw<float>());
+        case BinaryArchiveTag::float64:
+            return static_cast<ValueType>(ReadRaw<double>());
+        default:
+            throw InputException(InputExceptionErrors::badData, "Binary archive: expected a number");
+        }
+    }
+
+    template <typename ValueType, IsFundamental<ValueType> concept>
+    void BinaryUnarchiver::ReadScalar(const char* name, ValueType& value)
+    {
+        auto header = ReadRecordHeader();
+        if (name != std::string("") && header.name != name)
+        {
+            throw InputException(InputExceptionErrors::badStringFormat, std::string{ "Failed to match field " } + name + ", instead found '" + header.name + "'");
+        }
+        value = ReadNumber<ValueType>(header.tag);
+    }
+
+    template <typename ValueType, IsFundamental<ValueType> concept>
+    void BinaryUnarchiver::ReadArray(const char* name, std::vector<ValueType>& array)
+    {
+        ReadRecordHeader(name, BinaryArchiveTag::array);
+        auto elementTag = ReadTag();
+        auto size = ReadRaw<uint64_t>();
+        SkipAlignmentPadding();
+        auto elementSize = BinaryArchiverImpl::GetNumberSize(elementTag);
+        if (elementSize == 0)
+        {
+            throw InputException(InputExceptionErrors::badData, "Binary archive: expected an array of numbers");
+        }
+        CheckRemainingSize(size, elementSize);
+
+        if constexpr (!std::is_same_v<ValueType, bool>)
+        {
+            if (elementTag == BinaryArchiverImpl::GetTag<ValueType>())
+            {
+                // read in bounded chunks, so a stream whose size is unknown can't make us allocate more than it holds
+                const uint64_t chunkSize = std::max<uint64_t>(1, BinaryArchiverImpl::maxReadChunkBytes / sizeof(ValueType));
+                for (uint64_t numRead = 0; numRead < size;)
+                {
+                    auto numToRead = std::min(size - numRead, chunkSize);
+                    array.resize(numRead + numToRead);
+                    _in.read(reinterpret_cast<char*>(array.data() + numRead), numToRead * sizeof(ValueType));
+                    if (!_in)
+                    {
+                        throw InputException(InputExceptionErrors::badData, "Unexpected end of binary archive");
+                    }
+                    numRead += numToRead;
+                }
+                if (!BinaryArchiverImpl::IsLittleEndian())
+                {
+                    BinaryArchiverImpl::SwapByteOrder(reinterpret_cast<char*>(array.data()), sizeof(ValueType), size);
+                }
+                return;
+            }
+        }
+
+        array.reserve(std::min<uint64_t>(size, BinaryArchiverImpl::maxReadChunkBytes / elementSize));
+        for (uint64_t index = 0; index < size; ++index)
+        {
+            array.push_back(ReadNumber<ValueType>(elementTag));
+        }
+    }
+
+    template <typename ValueType, IsFundamental<ValueType> concept>
+    bool BinaryUnarchiver::ReadArrayView(const char* name, ArrayView<ValueType>& array)
+    {
+        // A view can only point into a writable mapping (the objects holding views may write through them) that stores
+        // the elements just as this machine does
+        if (!_mappedFile || !_mappedFile->IsWritable() || !BinaryArchiverImpl::IsLittleEndian())
+        {
+            return false;
+        }
+
+        // Anything unexpected is left for the regular unarchiving code to read, or report
+        const auto& header = PeekRecordHeader();
+        if (header.tag != BinaryArchiveTag::array || (name != std::string("") && header.name != name))
+        {
+            return false;
+        }
+
+        const auto start = _in.tellg();
+        const auto elementTag = ReadTag();
+        const auto size = ReadRaw<uint64_t>();
+        SkipAlignmentPadding();
+        const auto offset = static_cast<size_t>(_in.tellg());
+        const char* data = _mappedFile->GetData() + offset;
+        if (elementTag != BinaryArchiverImpl::GetTag<ValueType>() || reinterpret_cast<uintptr_t>(data) % alignof(ValueType) != 0 || size > (_mappedFile->GetSize() - offset) / sizeof(ValueType))
+        {
+            _in.seekg(start);
+            return false;
+        }
+
+        _in.seekg(offset + size * sizeof(ValueType));
+        _hasNextRecordHeader = false;
+        array = ArrayView<ValueType>(_mappedFile, reinterpret_cast<const ValueType*>(data), size);
+        return true;
+    }
+} // namespace utilities
+} // namespace ell
+
+#pragma endregion implementation
@@ -110,6 +110,11 @@ namespace utilities
     /// <returns> The path to the directory. </returns>
     void EnsureDirectoryExists(const std::string& path);
 
+    /// <summary> Deletes a directory and everything in it. Nothing happens if the directory doesn't exist. </summary>
+    ///
+    /// <param name="path"> The path. </param>
+    void DeleteDirectory(const std::string& path);
+
     /// <summary> Returns the combined filename from joining two or more paths. </summary>
     ///
     /// <param name="path"> The starting path. </param>
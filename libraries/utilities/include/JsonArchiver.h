@@ -196,7 +196,14 @@ namespace utilities
         {
             _out << std::quoted(name) << ": ";
         }
-        _out << value;
+        if constexpr (std::is_same_v<ValueType, int8_t>)
+        {
+            _out << static_cast<int>(value); // a number, not a character
+        }
+        else
+        {
+            _out << value;
+        }
         SetEndOfLine(endOfLine);
     }
 
@@ -0,0 +1,61 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MemoryMappedFile.h (utilities)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary>
+    /// A read-only view of the contents of a file. Where the platform supports it, the file is memory-mapped, so its
+    /// pages are only read when they're touched and are shared with other processes reading the same file. Elsewhere,
+    /// the file is read into memory.
+    /// </summary>
+    class MemoryMappedFile
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="filepath"> The path of the file to map. </param>
+        /// <param name="copyOnWrite">
+        /// If true, the contents can be written to through pointers to them. Pages that are written to are copied
+        /// privately for this process, and the changes never reach the file. Pages that aren't written to stay backed by
+        /// the file, so the system can drop them from memory and read them again as needed.
+        /// </param>
+        explicit MemoryMappedFile(const std::string& filepath, bool copyOnWrite = false);
+
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+        ~MemoryMappedFile();
+
+        /// <summary> Gets a pointer to the contents of the file, which is aligned to a page boundary if the file is memory-mapped. </summary>
+        const char* GetData() const { return _data; }
+
+        /// <summary> Gets the size of the file, in bytes. </summary>
+        size_t GetSize() const { return _size; }
+
+        /// <summary> Indicates if the file is memory-mapped (as opposed to read into memory). </summary>
+        bool IsMapped() const { return _isMapped; }
+
+        /// <summary> Indicates if the contents can be written to, because they're mapped copy-on-write or were read into memory. </summary>
+        bool IsWritable() const { return _isWritable; }
+
+    private:
+        const char* _data = nullptr;
+        size_t _size = 0;
+        bool _isMapped = false;
+        bool _isWritable = false;
+        std::vector<char> _buffer; // the contents of the file, if it isn't memory-mapped
+    };
+} // namespace utilities
+} // namespace ell
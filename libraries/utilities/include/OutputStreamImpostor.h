@@ -47,6 +47,12 @@ namespace utilities
         /// <param name="filename"> A filename </param>
         OutputStreamImpostor(const std::string& filename);
 
+        /// <summary> Constructor that creates an object that directs output to a file, opened in text or binary mode</summary>
+        ///
+        /// <param name="filename"> A filename </param>
+        /// <param name="binary"> If true, the file is opened in binary mode </param>
+        OutputStreamImpostor(const std::string& filename, bool binary);
+
         /// <summary> Constructor that creates an object that directs output to an existing stream</summary>
         ///
         /// <param name="stream"> A stream </param>
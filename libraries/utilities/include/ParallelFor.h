@@ -0,0 +1,96 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ParallelFor.h (utilities)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary>
+    /// Splits the range [0, numItems) into `numThreads` contiguous chunks of nearly equal size, and calls a function on
+    /// each chunk on its own thread. The chunks are the same for any given `numItems` and `numThreads`, so results
+    /// reduced in chunk order are deterministic. If a call throws, the first exception (in chunk order) is rethrown
+    /// after all the threads finish.
+    /// </summary>
+    ///
+    /// <typeparam name="FunctionType"> A function type with signature `void(size_t begin, size_t end, size_t chunkIndex)`. </typeparam>
+    /// <param name="numItems"> The number of items to process. </param>
+    /// <param name="numThreads"> The number of chunks (and threads). If 1 or less, the function is called on the calling thread. </param>
+    /// <param name="function"> The function to call on each chunk. </param>
+    template <typename FunctionType>
+    void ParallelFor(size_t numItems, size_t numThreads, FunctionType&& function);
+
+    /// <summary> Gets the number of threads to use, where 0 means one per hardware thread. </summary>
+    ///
+    /// <param name="numThreads"> The requested number of threads, or 0. </param>
+    ///
+    /// <returns> The number of threads, at least 1. </returns>
+    inline size_t GetNumThreads(size_t numThreads)
+    {
+        if (numThreads == 0)
+        {
+            numThreads = std::thread::hardware_concurrency();
+        }
+        return numThreads == 0 ? 1 : numThreads;
+    }
+} // namespace utilities
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace utilities
+{
+    template <typename FunctionType>
+    void ParallelFor(size_t numItems, size_t numThreads, FunctionType&& function)
+    {
+        if (numThreads <= 1)
+        {
+            function(0, numItems, 0);
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        std::vector<std::exception_ptr> exceptions(numThreads);
+        for (size_t chunkIndex = 0; chunkIndex < numThreads; ++chunkIndex)
+        {
+            threads.emplace_back([&, chunkIndex]() {
+                try
+                {
+                    function(chunkIndex * numItems / numThreads, (chunkIndex + 1) * numItems / numThreads, chunkIndex);
+                }
+                catch (...)
+                {
+                    exceptions[chunkIndex] = std::current_exception();
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        for (const auto& exception : exceptions)
+        {
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+        }
+    }
+} // namespace utilities
+} // namespace ell
+
+#pragma endregion implementation
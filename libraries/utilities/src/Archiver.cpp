@@ -169,6 +169,15 @@ namespace utilities
         UNUSED(name, typeName);
     }
 
+#define ARCHIVE_TYPE_OP(t)                                                                    \
+    bool Unarchiver::UnarchiveArrayView(const char* name, ArrayView<t>& value, IsFundamental<t>) \
+    {                                                                                            \
+        UNUSED(name, value);                                                                     \
+        return false;                                                                            \
+    }
+    ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
     void Unarchiver::BeginUnarchiveArray(const char* name, const std::string& typeName)
     {
         UNUSED(name, typeName);
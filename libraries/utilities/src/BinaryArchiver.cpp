@@ -0,0 +1,462 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryArchiver.cpp (utilities)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BinaryArchiver.h"
+#include "IArchivable.h"
+#include "Unused.h"
+
+#include <algorithm>
+#include <streambuf>
+#include <string>
+
+namespace ell
+{
+namespace utilities
+{
+    namespace
+    {
+        // The first byte isn't valid at the start of a text archive, so the format can be detected from one byte
+        const char binaryArchiveMagic[] = { '\x89', 'E', 'L', 'L' };
+
+        // Version 2 aligns the elements of arrays of numbers. Version 1 was never released, so it isn't read.
+        const uint32_t binaryArchiveFormatVersion = 2;
+
+        // A read-only stream buffer over memory, which doesn't copy it
+        class MemoryStreamBuffer : public std::streambuf
+        {
+        public:
+            MemoryStreamBuffer(const char* data, size_t size)
+            {
+                auto begin = const_cast<char*>(data); // never written through
+                setg(begin, begin, begin + size);
+            }
+
+        protected:
+            pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which) override
+            {
+                char* base = direction == std::ios_base::beg ? eback() : (direction == std::ios_base::cur ? gptr() : egptr());
+                if (!(which & std::ios_base::in) || offset < eback() - base || offset > egptr() - base)
+                {
+                    return pos_type(off_type(-1));
+                }
+                setg(eback(), base + offset, egptr());
+                return pos_type(gptr() - eback());
+            }
+
+            pos_type seekpos(pos_type position, std::ios_base::openmode which) override
+            {
+                return seekoff(off_type(position), std::ios_base::beg, which);
+            }
+        };
+    } // namespace
+
+    //
+    // Serialization
+    //
+    BinaryArchiver::BinaryArchiver(std::ostream& outputStream) :
+        _out(outputStream)
+    {
+        WriteBytes(binaryArchiveMagic, sizeof(binaryArchiveMagic));
+        WriteRaw(binaryArchiveFormatVersion);
+    }
+
+#define ARCHIVE_TYPE_OP(t) IMPLEMENT_ARCHIVE_VALUE(BinaryArchiver, t);
+    ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+    // strings
+    void BinaryArchiver::ArchiveValue(const char* name, const std::string& value)
+    {
+        WriteTag(BinaryArchiveTag::string);
+        WriteStringReference(name);
+        WriteString(value);
+    }
+
+    void BinaryArchiver::ArchiveNull(const char* name)
+    {
+        WriteTag(BinaryArchiveTag::null);
+        WriteStringReference(name);
+    }
+
+    // IArchivable
+    void BinaryArchiver::BeginArchiveObject(const char* name, const IArchivable& value)
+    {
+        if (value.ArchiveAsPrimitive())
+        {
+            WriteTag(BinaryArchiveTag::primitiveObject);
+            WriteStringReference(name);
+            return;
+        }
+
+        WriteTag(BinaryArchiveTag::object);
+        WriteStringReference(name);
+        WriteStringReference(GetArchivedTypeName(value));
+        WriteRaw<int32_t>(GetArchiveVersion(value).versionNumber);
+    }
+
+    void BinaryArchiver::EndArchiveObject(const char* name, const IArchivable& value)
+    {
+        UNUSED(name);
+        if (!value.ArchiveAsPrimitive())
+        {
+            WriteTag(BinaryArchiveTag::endObject);
+        }
+    }
+
+    void BinaryArchiver::EndArchiving()
+    {
+        _out.flush();
+    }
+
+//
+// Arrays
+//
+#define ARCHIVE_TYPE_OP(t) IMPLEMENT_ARCHIVE_ARRAY(BinaryArchiver, t);
+    ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+    void BinaryArchiver::ArchiveArray(const char* name, const std::vector<std::string>& array)
+    {
+        WriteTag(BinaryArchiveTag::array);
+        WriteStringReference(name);
+        WriteTag(BinaryArchiveTag::string);
+        WriteRaw<uint64_t>(array.size());
+        for (const auto& str : array)
+        {
+            WriteString(str);
+        }
+    }
+
+    void BinaryArchiver::ArchiveArray(const char* name, const std::string& baseTypeName, const std::vector<const IArchivable*>& array)
+    {
+        WriteTag(BinaryArchiveTag::objectArray);
+        WriteStringReference(name);
+        WriteStringReference(baseTypeName);
+        for (const auto& item : array)
+        {
+            Archive(*item);
+        }
+        WriteTag(BinaryArchiveTag::endArray);
+    }
+
+    void BinaryArchiver::WriteTag(BinaryArchiveTag tag)
+    {
+        WriteRaw(static_cast<uint8_t>(tag));
+    }
+
+    void BinaryArchiver::WriteStringReference(const std::string& str)
+    {
+        auto it = _stringTable.find(str);
+        if (it != _stringTable.end())
+        {
+            WriteRaw(it->second);
+            return;
+        }
+
+        // a new string gets the next index, and is written out after it
+        auto index = static_cast<uint32_t>(_stringTable.size());
+        _stringTable.emplace(str, index);
+        WriteRaw(index);
+        WriteString(str);
+    }
+
+    void BinaryArchiver::WriteString(const std::string& str)
+    {
+        WriteRaw<uint64_t>(str.size());
+        WriteBytes(str.data(), str.size());
+    }
+
+    void BinaryArchiver::WriteAlignmentPadding(size_t alignment)
+    {
+        // the padding is preceded by its length, so readers don't need to know where the archive starts
+        const char zeros[sizeof(uint64_t)] = {};
+        auto padding = static_cast<uint8_t>((alignment - (_position + 1) % alignment) % alignment);
+        WriteRaw(padding);
+        WriteBytes(zeros, padding);
+    }
+
+    void BinaryArchiver::WriteBytes(const char* data, size_t size)
+    {
+        _out.write(data, size);
+        _position += size;
+    }
+
+    //
+    // Deserialization
+    //
+    BinaryUnarchiver::BinaryUnarchiver(std::istream& inputStream, SerializationContext context) :
+        Unarchiver(std::move(context)),
+        _in(inputStream)
+    {
+        ReadArchiveHeader();
+    }
+
+    BinaryUnarchiver::BinaryUnarchiver(std::shared_ptr<const MemoryMappedFile> file, SerializationContext context) :
+        Unarchiver(std::move(context)),
+        _mappedFile(std::move(file)),
+        _mappedFileBuffer(std::make_unique<MemoryStreamBuffer>(_mappedFile->GetData(), _mappedFile->GetSize())),
+        _mappedFileStream(std::make_unique<std::istream>(_mappedFileBuffer.get())),
+        _in(*_mappedFileStream)
+    {
+        ReadArchiveHeader();
+    }
+
+    void BinaryUnarchiver::ReadArchiveHeader()
+    {
+        char magic[sizeof(binaryArchiveMagic)];
+        _in.read(magic, sizeof(magic));
+        if (!_in || !std::equal(magic, magic + sizeof(magic), binaryArchiveMagic))
+        {
+            throw InputException(InputExceptionErrors::badData, "Not a binary archive");
+        }
+
+        auto formatVersion = ReadRaw<uint32_t>();
+        if (formatVersion > binaryArchiveFormatVersion)
+        {
+            throw InputException(InputExceptionErrors::versionMismatch, "Binary archive was written by a newer version");
+        }
+        if (formatVersion < binaryArchiveFormatVersion)
+        {
+            throw InputException(InputExceptionErrors::versionMismatch, "Binary archive format version " + std::to_string(formatVersion) + " isn't supported");
+        }
+    }
+
+    bool BinaryUnarchiver::IsBinaryArchive(std::istream& inputStream)
+    {
+        return inputStream.peek() == static_cast<unsigned char>(binaryArchiveMagic[0]);
+    }
+
+#define ARCHIVE_TYPE_OP(t) IMPLEMENT_UNARCHIVE_VALUE(BinaryUnarchiver, t);
+    ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+    // strings
+    void BinaryUnarchiver::UnarchiveValue(const char* name, std::string& value)
+    {
+        ReadRecordHeader(name, BinaryArchiveTag::string);
+        value = ReadString();
+    }
+
+    bool BinaryUnarchiver::UnarchiveNull(const char* name)
+    {
+        const auto& header = PeekRecordHeader();
+        if (header.tag == BinaryArchiveTag::null && header.name == name)
+        {
+            ReadRecordHeader();
+            return true;
+        }
+        return false;
+    }
+
+    // IArchivable
+    ArchivedObjectInfo BinaryUnarchiver::BeginUnarchiveObject(const char* name, const std::string& typeName)
+    {
+        UNUSED(typeName);
+        ReadRecordHeader(name, BinaryArchiveTag::object);
+        auto encodedTypeName = ReadStringReference();
+        auto version = ReadRaw<int32_t>();
+        return { encodedTypeName, version };
+    }
+
+    void BinaryUnarchiver::EndUnarchiveObject(const char* name, const std::string& typeName)
+    {
+        UNUSED(name, typeName);
+        ReadRecordHeader("", BinaryArchiveTag::endObject);
+    }
+
+    void BinaryUnarchiver::UnarchiveObjectAsPrimitive(const char* name, IArchivable& value)
+    {
+        ReadRecordHeader(name, BinaryArchiveTag::primitiveObject);
+        UnarchiveObject(name, value);
+    }
+
+    bool BinaryUnarchiver::HasNextPropertyName(const std::string& name)
+    {
+        if (!_hasNextRecordHeader && _in.peek() == std::char_traits<char>::eof())
+        {
+            return false;
+        }
+
+        const auto& header = PeekRecordHeader();
+        return header.tag != BinaryArchiveTag::endObject && header.tag != BinaryArchiveTag::endArray && header.name == name;
+    }
+
+//
+// Arrays
+//
+#define ARCHIVE_TYPE_OP(t) IMPLEMENT_UNARCHIVE_ARRAY(BinaryUnarchiver, t);
+    ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+#define ARCHIVE_TYPE_OP(t) IMPLEMENT_UNARCHIVE_ARRAY_VIEW(BinaryUnarchiver, t);
+    ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+    void BinaryUnarchiver::UnarchiveArray(const char* name, std::vector<std::string>& array)
+    {
+        ReadRecordHeader(name, BinaryArchiveTag::array);
+        if (ReadTag() != BinaryArchiveTag::string)
+        {
+            throw InputException(InputExceptionErrors::badData, "Binary archive: expected an array of strings");
+        }
+
+        // every string takes at least the 8 bytes of its length
+        auto size = ReadRaw<uint64_t>();
+        CheckRemainingSize(size, sizeof(uint64_t));
+        array.reserve(size);
+        for (uint64_t index = 0; index < size; ++index)
+        {
+            array.push_back(ReadString());
+        }
+    }
+
+    void BinaryUnarchiver::BeginUnarchiveArray(const char* name, const std::string& typeName)
+    {
+        UNUSED(typeName);
+        ReadRecordHeader(name, BinaryArchiveTag::objectArray);
+        ReadStringReference(); // base type name
+    }
+
+    bool BinaryUnarchiver::BeginUnarchiveArrayItem(const std::string& typeName)
+    {
+        UNUSED(typeName);
+        return PeekRecordHeader().tag != BinaryArchiveTag::endArray;
+    }
+
+    void BinaryUnarchiver::EndUnarchiveArrayItem(const std::string& typeName)
+    {
+        UNUSED(typeName);
+    }
+
+    void BinaryUnarchiver::EndUnarchiveArray(const char* name, const std::string& typeName)
+    {
+        UNUSED(name, typeName);
+        ReadRecordHeader("", BinaryArchiveTag::endArray);
+    }
+
+    const BinaryUnarchiver::RecordHeader& BinaryUnarchiver::PeekRecordHeader()
+    {
+        if (!_hasNextRecordHeader)
+        {
+            _nextRecordHeader = ReadRecordHeader();
+            _hasNextRecordHeader = true;
+        }
+        return _nextRecordHeader;
+    }
+
+    BinaryUnarchiver::RecordHeader BinaryUnarchiver::ReadRecordHeader()
+    {
+        if (_hasNextRecordHeader)
+        {
+            _hasNextRecordHeader = false;
+            return std::move(_nextRecordHeader);
+        }
+
+        RecordHeader header;
+        header.tag = ReadTag();
+        if (header.tag != BinaryArchiveTag::endObject && header.tag != BinaryArchiveTag::endArray)
+        {
+            header.name = ReadStringReference();
+        }
+        return header;
+    }
+
+    BinaryUnarchiver::RecordHeader BinaryUnarchiver::ReadRecordHeader(const char* name, BinaryArchiveTag expectedTag)
+    {
+        auto header = ReadRecordHeader();
+        if (header.tag != expectedTag)
+        {
+            throw InputException(InputExceptionErrors::badData, std::string{ "Binary archive: unexpected record type while reading '" } + name + "'");
+        }
+        if (name != std::string("") && header.name != name)
+        {
+            throw InputException(InputExceptionErrors::badStringFormat, std::string{ "Failed to match field " } + name + ", instead found '" + header.name + "'");
+        }
+        return header;
+    }
+
+    BinaryArchiveTag BinaryUnarchiver::ReadTag()
+    {
+        auto tag = ReadRaw<uint8_t>();
+        if (tag > static_cast<uint8_t>(BinaryArchiveTag::endArray))
+        {
+            throw InputException(InputExceptionErrors::badData, "Binary archive: invalid record type");
+        }
+        return static_cast<BinaryArchiveTag>(tag);
+    }
+
+    std::string BinaryUnarchiver::ReadStringReference()
+    {
+        auto index = ReadRaw<uint32_t>();
+        if (index == _stringTable.size())
+        {
+            _stringTable.push_back(ReadString());
+        }
+        else if (index > _stringTable.size())
+        {
+            throw InputException(InputExceptionErrors::badData, "Binary archive: invalid string reference");
+        }
+        return _stringTable[index];
+    }
+
+    void BinaryUnarchiver::SkipAlignmentPadding()
+    {
+        auto padding = ReadRaw<uint8_t>();
+        _in.ignore(padding);
+        if (!_in)
+        {
+            throw InputException(InputExceptionErrors::badData, "Unexpected end of binary archive");
+        }
+    }
+
+    std::string BinaryUnarchiver::ReadString()
+    {
+        auto size = ReadRaw<uint64_t>();
+        CheckRemainingSize(size, 1);
+
+        // read in bounded chunks, so a stream whose size is unknown can't make us allocate more than it holds
+        std::string str;
+        for (uint64_t numRead = 0; numRead < size;)
+        {
+            auto chunkSize = std::min<uint64_t>(size - numRead, BinaryArchiverImpl::maxReadChunkBytes);
+            str.resize(numRead + chunkSize);
+            _in.read(&str[numRead], chunkSize);
+            if (!_in)
+            {
+                throw InputException(InputExceptionErrors::badData, "Unexpected end of binary archive");
+            }
+            numRead += chunkSize;
+        }
+        return str;
+    }
+
+    void BinaryUnarchiver::CheckRemainingSize(uint64_t count, size_t elementSize)
+    {
+        // A stream that can't seek doesn't know its size, so its reads are done in bounded chunks instead
+        const auto position = _in.tellg();
+        if (position == std::streampos(-1))
+        {
+            return;
+        }
+
+        _in.seekg(0, std::ios_base::end);
+        const auto end = _in.tellg();
+        _in.seekg(position);
+        if (end == std::streampos(-1) || !_in)
+        {
+            _in.clear();
+            _in.seekg(position);
+            return;
+        }
+
+        if (count > static_cast<uint64_t>(end - position) / elementSize)
+        {
+            throw InputException(InputExceptionErrors::badData, "Binary archive: a size is larger than the rest of the archive");
+        }
+    }
+} // namespace utilities
+} // namespace ell
@@ -15,6 +15,7 @@
 #include <ios>
 #include <memory>
 #ifndef WIN32
+#include <ftw.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #else
@@ -328,6 +329,30 @@ namespace utilities
         }
     }
 
+    void DeleteDirectory(const std::string& path)
+    {
+        if (!DirectoryExists(path))
+        {
+            return;
+        }
+
+        int rc = 0;
+#ifdef WIN32
+        std::error_code ec;
+        fs::remove_all(fs::u8path(path), ec);
+        rc = ec.value();
+#else
+        // Walk the tree depth-first, so each directory is empty by the time it's removed
+        constexpr int maxOpenDirectories = 16;
+        rc = nftw(
+            path.c_str(), [](const char* entryPath, const struct stat*, int, struct FTW*) { return remove(entryPath); }, maxOpenDirectories, FTW_DEPTH | FTW_PHYS);
+#endif
+        if (rc != 0)
+        {
+            throw ell::utilities::Exception(ell::utilities::FormatString("removing directory failed with error code %d", errno));
+        }
+    }
+
     std::string GetWorkingDirectory()
     {
         int rc = 0;
@@ -0,0 +1,83 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MemoryMappedFile.cpp (utilities)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MemoryMappedFile.h"
+#include "Exception.h"
+#include "Files.h"
+#include "Unused.h"
+
+#include <iterator>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // WIN32
+
+namespace ell
+{
+namespace utilities
+{
+    MemoryMappedFile::MemoryMappedFile(const std::string& filepath, bool copyOnWrite)
+    {
+        if (!FileExists(filepath))
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "file " + filepath + " doesn't exist");
+        }
+
+#ifndef WIN32
+        int fd = open(filepath.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "error opening file " + filepath);
+        }
+
+        struct stat fileInfo;
+        if (fstat(fd, &fileInfo) != 0)
+        {
+            close(fd);
+            throw InputException(InputExceptionErrors::invalidArgument, "error reading the size of file " + filepath);
+        }
+
+        _size = static_cast<size_t>(fileInfo.st_size);
+        if (_size > 0)
+        {
+            void* data = copyOnWrite ? mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0) : mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+            if (data == MAP_FAILED)
+            {
+                close(fd);
+                throw InputException(InputExceptionErrors::invalidArgument, "error memory-mapping file " + filepath);
+            }
+            _data = static_cast<const char*>(data);
+            _isMapped = true;
+        }
+        _isWritable = copyOnWrite;
+
+        // The mapping keeps its own reference to the file
+        close(fd);
+#else
+        UNUSED(copyOnWrite); // the buffer is already a private, writable copy
+        auto stream = OpenBinaryIfstream(filepath);
+        _buffer.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+        _data = _buffer.data();
+        _size = _buffer.size();
+        _isWritable = true;
+#endif // WIN32
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+#ifndef WIN32
+        if (_isMapped)
+        {
+            munmap(const_cast<char*>(_data), _size);
+        }
+#endif // WIN32
+    }
+} // namespace utilities
+} // namespace ell
@@ -49,6 +49,11 @@ namespace utilities
         _outputStream(*_fileStream)
     {}
 
+    OutputStreamImpostor::OutputStreamImpostor(const std::string& filename, bool binary) :
+        _fileStream(std::make_shared<std::ofstream>(binary ? OpenBinaryOfstream(filename) : OpenOfstream(filename))),
+        _outputStream(*_fileStream)
+    {}
+
     std::streamsize OutputStreamImpostor::precision() const
     {
         return _outputStream.get().precision();
@@ -16,6 +16,10 @@ void TestArchiveVersion();
 void TestJsonArchiver();
 void TestJsonUnarchiver();
 
+void TestBinaryArchiver();
+void TestBinaryUnarchiver();
+void TestBinaryUnarchiverArrayView();
+
 void TestXmlArchiver();
 void TestXmlUnarchiver();
 } // namespace ell
@@ -9,6 +9,8 @@
 #include "Archiver_test.h"
 
 #include <utilities/include/Archiver.h>
+#include <utilities/include/BinaryArchiver.h>
+#include <utilities/include/Files.h>
 #include <utilities/include/IArchivable.h>
 #include <utilities/include/JsonArchiver.h>
 #include <utilities/include/UniqueId.h>
@@ -16,6 +18,8 @@
 
 #include <testing/include/testing.h>
 
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <sstream>
@@ -264,6 +268,20 @@ void TestUnarchiver()
         testing::ProcessTest(name + "Deserialize vector<int> check", val[0] == 1 && val[1] == 2 && val[2] == 3);
     }
 
+    {
+        std::stringstream strstream;
+        {
+            ArchiverType archiver(strstream);
+            std::vector<int8_t> arr{ -127, -1, 0, 10, 127 };
+            archiver.Archive("arr", arr);
+        }
+
+        UnarchiverType unarchiver(strstream, context);
+        std::vector<int8_t> val;
+        unarchiver.Unarchive("arr", val);
+        testing::ProcessTest(name + "Deserialize vector<int8_t> check", val == std::vector<int8_t>{ -127, -1, 0, 10, 127 });
+    }
+
     {
         std::stringstream strstream;
         {
@@ -361,6 +379,168 @@ void TestJsonUnarchiver()
     TestUnarchiver<utilities::JsonArchiver, utilities::JsonUnarchiver>();
 }
 
+void TestBinaryArchiver()
+{
+    TestArchiver<utilities::BinaryArchiver>();
+}
+
+void TestBinaryUnarchiver()
+{
+    TestUnarchiver<utilities::BinaryArchiver, utilities::BinaryUnarchiver>();
+
+    utilities::SerializationContext context;
+    {
+        // values are converted when read as a different type, and names are stored only once
+        std::stringstream strstream;
+        std::vector<float> floatVector{ 1.5f, 2.5f, 3.5f };
+        std::vector<TestStruct> structVector(10, TestStruct{ 1, 2.5f, 3.5 });
+        {
+            utilities::BinaryArchiver archiver(strstream);
+            archiver.Archive("val", 7);
+            archiver.Archive("vec", floatVector);
+            archiver.Archive("structs", structVector);
+        }
+
+        testing::ProcessTest("BinaryUnarchiver: archive starts with magic number", utilities::BinaryUnarchiver::IsBinaryArchive(strstream));
+        auto archiveString = strstream.str();
+        auto firstTypeName = archiveString.find("TestStruct");
+        testing::ProcessTest("BinaryUnarchiver: archive stores type names once", firstTypeName != std::string::npos && archiveString.find("TestStruct", firstTypeName + 1) == std::string::npos);
+
+        utilities::BinaryUnarchiver unarchiver(strstream, context);
+        double val = 0;
+        std::vector<double> doubleVector;
+        std::vector<TestStruct> newStructVector;
+        unarchiver.Unarchive("val", val);
+        unarchiver.Unarchive("vec", doubleVector);
+        unarchiver.Unarchive("structs", newStructVector);
+        testing::ProcessTest("BinaryUnarchiver: Deserialize int as double", val == 7.0);
+        testing::ProcessTest("BinaryUnarchiver: Deserialize vector<float> as vector<double>", doubleVector == std::vector<double>{ 1.5, 2.5, 3.5 });
+        testing::ProcessTest("BinaryUnarchiver: Deserialize struct array", newStructVector.size() == 10 && newStructVector[9].b == 2.5f && newStructVector[9].c == 3.5);
+    }
+
+    {
+        std::stringstream strstream{ "{ \"a\": 1 }" };
+        testing::ProcessTest("BinaryUnarchiver: JSON isn't a binary archive", !utilities::BinaryUnarchiver::IsBinaryArchive(strstream));
+        bool threw = false;
+        try
+        {
+            utilities::BinaryUnarchiver unarchiver(strstream, context);
+        }
+        catch (const utilities::InputException&)
+        {
+            threw = true;
+        }
+        testing::ProcessTest("BinaryUnarchiver: reject non-binary archive", threw);
+    }
+
+    {
+        // sizes that are larger than the rest of the archive, and unsupported format versions, are rejected before anything is allocated
+        std::stringstream strstream;
+        {
+            utilities::BinaryArchiver archiver(strstream);
+            archiver.Archive("vec", std::vector<double>{ 1.5, 2.5 });
+            archiver.Archive("str", std::string("abc"));
+        }
+        const auto archiveString = strstream.str();
+        const uint64_t hugeSize = uint64_t{ 1 } << 60;
+
+        // an array's element count follows its name and element tag, and a string's length follows its name
+        auto badArraySize = archiveString;
+        std::memcpy(&badArraySize[archiveString.find("vec") + 4], &hugeSize, sizeof(hugeSize));
+        auto badStringSize = archiveString;
+        std::memcpy(&badStringSize[archiveString.find("str") + 3], &hugeSize, sizeof(hugeSize));
+        auto oldVersion = archiveString;
+        oldVersion[4] = 1;
+
+        auto isRejected = [&context](const std::string& archive) {
+            std::stringstream stream(archive);
+            try
+            {
+                utilities::BinaryUnarchiver unarchiver(stream, context);
+                std::vector<double> vec;
+                std::string str;
+                unarchiver.Unarchive("vec", vec);
+                unarchiver.Unarchive("str", str);
+            }
+            catch (const utilities::InputException&)
+            {
+                return true;
+            }
+            return false;
+        };
+        testing::ProcessTest("BinaryUnarchiver: accept a valid archive", !isRejected(archiveString));
+        testing::ProcessTest("BinaryUnarchiver: reject a huge array size", isRejected(badArraySize));
+        testing::ProcessTest("BinaryUnarchiver: reject a huge string size", isRejected(badStringSize));
+        testing::ProcessTest("BinaryUnarchiver: reject format version 1", isRejected(oldVersion));
+    }
+}
+
+void TestBinaryUnarchiverArrayView()
+{
+    const std::string filename("arrayView.ellarchive");
+    std::vector<double> doubleVector{ 1.5, 2.5, 3.5 };
+    std::vector<char> charVector{ 'a', 'b', 'c' };
+    {
+        auto stream = utilities::OpenBinaryOfstream(filename);
+        utilities::BinaryArchiver archiver(stream);
+        archiver.Archive("chars", charVector); // leaves the following array unaligned, unless it's padded
+        archiver.Archive("doubles", doubleVector);
+        archiver.Archive("floats", std::vector<float>{ 4.5f });
+    }
+
+    utilities::SerializationContext context;
+    {
+        auto file = std::make_shared<utilities::MemoryMappedFile>(filename, true);
+        utilities::BinaryUnarchiver unarchiver(file, context);
+        utilities::ArrayView<char> charView;
+        utilities::ArrayView<double> doubleView;
+        utilities::ArrayView<double> wrongTypeView;
+        std::vector<double> floatsAsDoubles;
+        bool readChars = unarchiver.TryUnarchiveArrayView("chars", charView);
+        bool readDoubles = unarchiver.TryUnarchiveArrayView("doubles", doubleView);
+        bool readWrongType = unarchiver.TryUnarchiveArrayView("floats", wrongTypeView);
+        unarchiver["floats"] >> floatsAsDoubles;
+
+        auto fileEnd = file->GetData() + file->GetSize();
+        bool inFile = reinterpret_cast<const char*>(doubleView.GetData()) > file->GetData() && reinterpret_cast<const char*>(doubleView.end()) <= fileEnd;
+        testing::ProcessTest("BinaryUnarchiver: array views", readChars && readDoubles && charView.ToVector() == charVector && doubleView.ToVector() == doubleVector);
+        testing::ProcessTest("BinaryUnarchiver: array views point into the file", inFile && doubleView.GetStorage() == file);
+        testing::ProcessTest("BinaryUnarchiver: array views of another type aren't read", !readWrongType && floatsAsDoubles == std::vector<double>{ 4.5 });
+
+        // views keep the file mapped
+        file.reset();
+        testing::ProcessTest("BinaryUnarchiver: array views keep the file alive", doubleView[2] == 3.5);
+    }
+
+    {
+        // the objects holding views may write through them, so a read-only mapping's arrays are copied instead
+        auto file = std::make_shared<utilities::MemoryMappedFile>(filename);
+        utilities::BinaryUnarchiver unarchiver(file, context);
+        utilities::ArrayView<char> charView;
+        std::vector<char> chars;
+        bool readView = unarchiver.TryUnarchiveArrayView("chars", charView);
+        unarchiver["chars"] >> chars;
+        testing::ProcessTest("BinaryUnarchiver: no array views of a read-only mapping", (!readView || !file->IsMapped()) && chars == charVector);
+    }
+
+    {
+        // unarchivers that can't make views leave the archive alone
+        std::stringstream strstream;
+        {
+            utilities::JsonArchiver archiver(strstream);
+            archiver.Archive("doubles", doubleVector);
+        }
+        utilities::JsonUnarchiver unarchiver(strstream, context);
+        utilities::ArrayView<double> doubleView;
+        std::vector<double> doubles;
+        bool readView = unarchiver.TryUnarchiveArrayView("doubles", doubleView);
+        unarchiver["doubles"] >> doubles;
+        testing::ProcessTest("JsonUnarchiver: no array views", !readView && doubles == doubleVector);
+    }
+
+    std::remove(filename.c_str());
+}
+
 void TestXmlArchiver()
 {
     TestArchiver<utilities::XmlArchiver>();
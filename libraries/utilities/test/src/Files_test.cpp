@@ -49,6 +49,23 @@ void TestJoinPaths(const std::string& basePath)
     testing::ProcessTest("JoinPaths", norm == result);
 }
 
+void TestDeleteDirectory(const std::string& basePath)
+{
+    std::string testdir = utilities::JoinPaths(basePath, { "Testing", "DeleteDirectory" });
+    utilities::EnsureDirectoryExists(utilities::JoinPaths(testdir, "nested"));
+    {
+        auto outputStream = utilities::OpenOfstream(utilities::JoinPaths(testdir, { "nested", "file.txt" }));
+        outputStream << "this is a test";
+    }
+
+    utilities::DeleteDirectory(testdir);
+    testing::ProcessTest("DeleteDirectory", !utilities::DirectoryExists(testdir));
+
+    // Deleting a directory that doesn't exist does nothing
+    utilities::DeleteDirectory(testdir);
+    testing::ProcessTest("DeleteDirectory of missing directory", !utilities::DirectoryExists(testdir));
+}
+
 std::string GetUnicodeTestPath(const std::string& basePath, const std::string& utf8test)
 {
     std::string testing = utilities::JoinPaths(basePath, "Testing");
@@ -89,6 +89,10 @@ int main(int argc, char* argv[])
         TestJsonArchiver();
         TestJsonUnarchiver();
 
+        TestBinaryArchiver();
+        TestBinaryUnarchiver();
+        TestBinaryUnarchiverArrayView();
+
         TestXmlArchiver();
         TestXmlUnarchiver();
 
@@ -111,6 +115,7 @@ int main(int argc, char* argv[])
         // File system tests
         TestStringf();
         TestJoinPaths(basePath);
+        TestDeleteDirectory(basePath);
 #ifdef WIN32
         TestUnicodePaths(basePath);
 #endif
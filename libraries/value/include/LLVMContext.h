@@ -12,6 +12,7 @@
 #include "EmitterContext.h"
 #include "FunctionDeclaration.h"
 #include "Scalar.h"
+#include "ScheduleTuner.h"
 
 #include <emitters/include/IRModuleEmitter.h>
 #include <emitters/include/LLVMUtilities.h>
@@ -54,6 +55,22 @@ namespace value
 
         emitters::IRFunctionEmitter& GetFunctionEmitter() const;
 
+        /// <summary> Gets the schedule tuning cache named by the `scheduleTuningCache` compiler option. The file is read
+        /// the first time this is called, and the same cache is used for the rest of the compile. </summary>
+        ScheduleTuningCache& GetScheduleTuningCache();
+
+        /// <summary> Emits a loop over a constant range as vector code. The iterations up to the last multiple of `vectorWidth`
+        /// are emitted as a loop marked with `IRForLoopEmitter::SetVectorized`, which the optimizer turns into `vectorWidth`-lane
+        /// vector loads, arithmetic and stores if it can prove the iterations independent; otherwise the loop is left to
+        /// LLVM's loop vectorizer. The remaining iterations are emitted as scalar code. </summary>
+        ///
+        /// <param name="start"> The first value of the index. </param>
+        /// <param name="stop"> One past the last value of the index. </param>
+        /// <param name="vectorWidth"> The number of lanes in each vector operation. </param>
+        /// <param name="fn"> The function that emits the body of the loop for an index value. </param>
+        /// <param name="name"> The name of the loop. </param>
+        void VectorizedFor(int start, int stop, int vectorWidth, std::function<void(Scalar)> fn, const std::string& name);
+
         emitters::LLVMFunction DeclareFunction(const FunctionDeclaration& func);
 
         std::optional<emitters::LLVMValue> ToLLVMValue(Value value) const;
@@ -157,6 +174,7 @@ namespace value
         std::stack<std::reference_wrapper<emitters::IRFunctionEmitter>> _functionStack;
         std::map<std::string, std::pair<Emittable, MemoryLayout>> _globals;
         std::unordered_map<FunctionDeclaration, DefinedFunction> _definedFunctions;
+        std::unique_ptr<ScheduleTuningCache> _scheduleTuningCache;
     };
 
     emitters::LLVMValue ToLLVMValue(Value value);
@@ -77,6 +77,16 @@ namespace value
         /// <returns> The index which represents the outer loop, now unrolled </returns>
         Index Unroll(Index index, int factor);
 
+        /// <summary> Emits the loop represented by the index as vector code, one lane per iteration, if its iterations are provably independent </summary>
+        /// <param name="index"> Represents the loop to vectorize. Its extent is the vector width. It can't also be unrolled or parallelized </param>
+        void Vectorize(Index index);
+
+        /// <summary> Splits the loop represented by the index into vectors and vectorizes the inner loop. Leftover iterations are emitted as scalar code </summary>
+        /// <param name="index"> Represents the loop to vectorize. On return, this index points to the inner (vectorized) loop created by the split </param>
+        /// <param name="width"> The number of elements in a vector </param>
+        /// <returns> The index which represents the outer loop, over whole vectors </returns>
+        Index Vectorize(Index& index, int width);
+
         void Cache(std::unique_ptr<CachingProvider> provider);
 
         template <typename CachingStrategyType>
@@ -0,0 +1,202 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ScheduleTuner.h (value)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <emitters/include/CompilerOptions.h>
+#include <emitters/include/TargetDevice.h>
+
+#include <functional>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ell
+{
+namespace value
+{
+    /// <summary> The values chosen for the parameters of a schedule (split sizes, unroll factors, etc.), by name. </summary>
+    using ScheduleParameters = std::map<std::string, int>;
+
+    /// <summary>
+    /// The set of schedules to search over, described as a set of named integer parameters, each with a list of
+    /// candidate values. Choices that aren't naturally integers, like the loop order or whether to cache an
+    /// input, are described by an index into the list of alternatives. Constraints can be added to rule out
+    /// combinations of values that don't make a legal schedule.
+    /// </summary>
+    class ScheduleSearchSpace
+    {
+    public:
+        /// <summary> A function that indicates if a set of parameter values is legal. </summary>
+        using Constraint = std::function<bool(const ScheduleParameters&)>;
+
+        /// <summary> Adds a parameter to the search space. </summary>
+        ///
+        /// <param name="name"> The name of the parameter. </param>
+        /// <param name="values"> The values to try for the parameter. </param>
+        void AddParameter(const std::string& name, std::vector<int> values);
+
+        /// <summary> Gets the powers of two in a range, for use as the values of a split size or unroll parameter. </summary>
+        ///
+        /// <param name="minValue"> The smallest value. Rounded up to a power of two. </param>
+        /// <param name="maxValue"> The largest value. If it isn't a power of two, it's included as the last value. </param>
+        ///
+        /// <returns> The values, in increasing order. </returns>
+        static std::vector<int> PowersOfTwo(int minValue, int maxValue);
+
+        /// <summary> Adds a constraint that every candidate must satisfy. </summary>
+        ///
+        /// <param name="constraint"> A function that returns `true` if a set of parameter values is legal. </param>
+        void AddConstraint(Constraint constraint);
+
+        /// <summary> Gets the number of parameters in the search space. </summary>
+        ///
+        /// <returns> The number of parameters. </returns>
+        size_t NumParameters() const { return _parameters.size(); }
+
+        /// <summary> Gets every combination of parameter values that satisfies all the constraints. </summary>
+        ///
+        /// <returns> The legal candidates. </returns>
+        std::vector<ScheduleParameters> GetCandidates() const;
+
+    private:
+        std::vector<std::pair<std::string, std::vector<int>>> _parameters;
+        std::vector<Constraint> _constraints;
+    };
+
+    /// <summary> The outcome of a schedule search. </summary>
+    struct ScheduleTuningResult
+    {
+        /// <summary> The parameters of the fastest schedule. </summary>
+        ScheduleParameters parameters;
+
+        /// <summary> The average run time of the fastest schedule, in milliseconds. </summary>
+        double time = 0;
+
+        /// <summary> The number of candidates that were compiled and timed. </summary>
+        int numCandidatesMeasured = 0;
+    };
+
+    /// <summary>
+    /// Searches for the fastest schedule for a loop nest. Each candidate is emitted by a user-supplied function that
+    /// builds the loop nest (and the data it works on) and applies the schedule described by the candidate's parameters.
+    /// The candidate is JIT-compiled in an `LLVMContext` of its own, so the tuner can be used while another function
+    /// is being emitted. Candidates that fail to emit or compile are skipped.
+    /// </summary>
+    class ScheduleTuner
+    {
+    public:
+        /// <summary> A function that emits the code for one candidate schedule. </summary>
+        using DefineCandidateFunction = std::function<void(const ScheduleParameters&)>;
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="compilerOptions"> The options to compile the candidates with. The target device must be the host. </param>
+        /// <param name="numIterations"> The number of timed runs of each candidate. </param>
+        /// <param name="maxCandidates"> The most candidates to time, or 0 for no limit. If the search space has more legal
+        /// candidates than this, a fixed pseudo-random sample of them is timed. </param>
+        ScheduleTuner(const emitters::CompilerOptions& compilerOptions, int numIterations = 5, int maxCandidates = 0);
+
+        /// <summary> Times the candidates in a search space (or a sample of them, if there are more than `maxCandidates`) and returns the fastest. </summary>
+        ///
+        /// <param name="searchSpace"> The schedules to try. </param>
+        /// <param name="defineCandidate"> The function that emits the loop nest for a set of parameters. </param>
+        ///
+        /// <returns> The parameters and run time of the fastest candidate. </returns>
+        ScheduleTuningResult Tune(const ScheduleSearchSpace& searchSpace, DefineCandidateFunction defineCandidate) const;
+
+        /// <summary> Compiles and times a single candidate. </summary>
+        ///
+        /// <param name="parameters"> The parameters of the schedule to time. </param>
+        /// <param name="defineCandidate"> The function that emits the loop nest for a set of parameters. </param>
+        ///
+        /// <returns> The average run time of the candidate, in milliseconds. </returns>
+        double TimeCandidate(const ScheduleParameters& parameters, DefineCandidateFunction defineCandidate) const;
+
+    private:
+        emitters::CompilerOptions _compilerOptions;
+        int _numIterations;
+        int _maxCandidates;
+    };
+
+    /// <summary>
+    /// A table of the fastest measured schedule parameters for each loop nest problem, where a problem is described
+    /// by a name, its shape and the target device. The table can be saved to and loaded from a text file, with one
+    /// `key<tab>name=value,name=value...` entry per line.
+    /// </summary>
+    class ScheduleTuningCache
+    {
+    public:
+        ScheduleTuningCache() = default;
+
+        /// <summary> Constructor that loads the entries from a file, if it exists. </summary>
+        ///
+        /// <param name="filename"> The path to the cache file. </param>
+        explicit ScheduleTuningCache(const std::string& filename);
+
+        /// <summary> Indicates if the cache has parameters for the given problem. </summary>
+        ///
+        /// <param name="key"> The key describing the problem. </param>
+        ///
+        /// <returns> `true` if there is an entry for the key. </returns>
+        bool HasEntry(const std::string& key) const;
+
+        /// <summary> Gets the parameters stored for the given problem. </summary>
+        ///
+        /// <param name="key"> The key describing the problem. </param>
+        ///
+        /// <returns> The fastest parameters measured for the problem. Throws an exception if the key isn't present. </returns>
+        const ScheduleParameters& GetEntry(const std::string& key) const;
+
+        /// <summary> Sets the parameters for the given problem. </summary>
+        ///
+        /// <param name="key"> The key describing the problem. </param>
+        /// <param name="parameters"> The fastest parameters measured for the problem. </param>
+        void SetEntry(const std::string& key, const ScheduleParameters& parameters);
+
+        /// <summary> Gets the number of entries in the cache. </summary>
+        ///
+        /// <returns> The number of entries. </returns>
+        size_t NumEntries() const { return _entries.size(); }
+
+        /// <summary> Adds the entries read from a stream, replacing existing entries with the same key. </summary>
+        ///
+        /// <param name="stream"> The stream to read from. </param>
+        void Read(std::istream& stream);
+
+        /// <summary> Writes the entries to a stream. </summary>
+        ///
+        /// <param name="stream"> The stream to write to. </param>
+        void Write(std::ostream& stream) const;
+
+        /// <summary> Adds the entries from a file, if it exists. </summary>
+        ///
+        /// <param name="filename"> The path to the cache file. </param>
+        void Load(const std::string& filename);
+
+        /// <summary> Saves the entries to a file, replacing its contents. </summary>
+        ///
+        /// <param name="filename"> The path to the cache file. </param>
+        void Save(const std::string& filename) const;
+
+    private:
+        std::map<std::string, ScheduleParameters> _entries;
+    };
+
+    /// <summary> Gets the key used to store the tuned schedule of a problem in a `ScheduleTuningCache`. </summary>
+    ///
+    /// <param name="problemName"> The kind of loop nest, e.g. "gemm_float". </param>
+    /// <param name="shape"> The sizes of the loop nest's dimensions. </param>
+    /// <param name="targetDevice"> The device the code is compiled for. </param>
+    ///
+    /// <returns> The key. </returns>
+    std::string GetScheduleTuningKey(const std::string& problemName, const std::vector<int>& shape, const emitters::TargetDevice& targetDevice);
+} // namespace value
+} // namespace ell
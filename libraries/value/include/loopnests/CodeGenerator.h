@@ -36,6 +36,7 @@ namespace value
 
             void InvokeKernel(const Kernel& kernel, const LoopIndexSymbolTable& runtimeIndexVariables, const LoopVisitSchedule& schedule) const;
             Scalar EmitKernelPredicate(const KernelPredicate& predicate, const LoopIndexSymbolTable& runtimeIndexVariables, const LoopVisitSchedule& schedule) const;
+            void EmitVectorLanes(const LoopNest& loopNest, const Index& loopIndex, int start, int stop, int step, std::function<void(Scalar)> codegenFn) const;
         };
 
     } // namespace loopnests
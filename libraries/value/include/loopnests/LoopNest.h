@@ -203,6 +203,16 @@ namespace value
             void Unroll(Index index);
             [[maybe_unused]] SplitIndex Unroll(Index index, int factor);
 
+            /// <summary> Emit a loop as vector code, with the loop's extent as the number of lanes. With the LLVM context, the
+            /// loop is turned into vector loads, arithmetic and stores when the optimizer can prove its iterations independent;
+            /// otherwise (for example, a reduction over the index) it's left to LLVM's loop vectorizer. Other contexts emit an
+            /// ordinary loop. The index can't also be unrolled or parallelized. </summary>
+            void Vectorize(Index index);
+
+            /// <summary> Split a loop by the given vector width and vectorize the inner loop. If the loop's extent isn't a
+            /// multiple of the width, the leftover iterations are emitted as scalar code. </summary>
+            [[maybe_unused]] SplitIndex Vectorize(Index index, int width);
+
             [[maybe_unused]] SplitIndex Split(Index index, int size);
 
             void SetLoopOrder(const std::vector<Index>& order);
@@ -228,6 +238,8 @@ namespace value
 
             bool IsUnrolled(const Index& index) const;
 
+            bool IsVectorized(const Index& index) const;
+
             /// <summary> See if an Index is used as a parameter to a kernel </summary>
             bool IsUsed(const Index& index, const std::vector<ScheduledKernel>& activeKernels) const;
 
@@ -261,6 +273,7 @@ namespace value
             std::vector<RenameAction> _renameActions;
             std::vector<Index> _parallelizedIndices;
             std::vector<Index> _unrolledIndices;
+            std::vector<Index> _vectorizedIndices;
             std::string _name = UniqueName("LoopNest");
         };
 
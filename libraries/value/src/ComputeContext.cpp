@@ -1279,8 +1279,18 @@ namespace value
             VariantVisitor{
                 [](Emittable) {},
                 [&castedData, destType, &value](auto&& data) {
-                    auto ptrBegin = data;
-                    auto ptrEnd = data + value.GetLayout().GetMemorySize();
+                    // Char8 is a signed 8-bit type, as in emitted code, even where `char` is unsigned
+                    auto ptrBegin = [data] {
+                        if constexpr (std::is_same_v<std::decay_t<decltype(data)>, char*>)
+                        {
+                            return reinterpret_cast<const int8_t*>(data);
+                        }
+                        else
+                        {
+                            return data;
+                        }
+                    }();
+                    auto ptrEnd = ptrBegin + value.GetLayout().GetMemorySize();
 
                     switch (destType)
                     {
@@ -1288,8 +1298,13 @@ namespace value
                         castedData = std::vector<Boolean>(ptrBegin, ptrEnd);
                         break;
                     case ValueType::Char8:
-                        castedData = std::vector<char>(ptrBegin, ptrEnd);
+                    {
+                        // Convert to a signed 8-bit value before storing it as a char
+                        std::vector<char> chars(ptrEnd - ptrBegin);
+                        std::transform(ptrBegin, ptrEnd, chars.begin(), [](auto x) { return static_cast<char>(static_cast<int8_t>(x)); });
+                        castedData = std::move(chars);
                         break;
+                    }
                     case ValueType::Byte:
                         castedData = std::vector<uint8_t>(ptrBegin, ptrEnd);
                         break;
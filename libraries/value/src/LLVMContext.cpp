@@ -715,6 +715,15 @@ namespace value
         return _emitter;
     }
 
+    ScheduleTuningCache& LLVMContext::GetScheduleTuningCache()
+    {
+        if (!_scheduleTuningCache)
+        {
+            _scheduleTuningCache = std::make_unique<ScheduleTuningCache>(_emitter.GetCompilerOptions().scheduleTuningCache);
+        }
+        return *_scheduleTuningCache;
+    }
+
     Value LLVMContext::AllocateImpl(ValueType type, MemoryLayout layout, size_t alignment, AllocateFlags flags)
     {
         auto& fn = GetFunctionEmitter();
@@ -980,6 +989,34 @@ namespace value
             });
     }
 
+    void LLVMContext::VectorizedFor(int start, int stop, int vectorWidth, std::function<void(Scalar)> fn, const std::string& name)
+    {
+        if (vectorWidth < 1)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "Vector width must be positive");
+        }
+
+        auto& fnEmitter = GetFunctionEmitter();
+        const int vectorStop = start + ((stop - start) / vectorWidth) * vectorWidth;
+        if (vectorStop > start)
+        {
+            Scalar index = value::Allocate<int>(ScalarLayout);
+
+            emitters::IRForLoopEmitter loop(fnEmitter, name);
+            loop.Begin(start, vectorStop, 1);
+            index = Scalar(Value{ Emittable{ loop.LoadIterationVariable() }, ScalarLayout });
+            fn(index);
+            loop.SetVectorized(vectorWidth);
+            loop.End();
+        }
+
+        // The remainder is shorter than one vector
+        for (int i = vectorStop; i < stop; ++i)
+        {
+            fn(i);
+        }
+    }
+
     void LLVMContext::MoveDataImpl(Value& source, Value& destination)
     {
         // we treat a move the same as a copy, except we clear out the source
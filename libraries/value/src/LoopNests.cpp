@@ -129,6 +129,12 @@ namespace value
             _nest->Unroll(index);
         }
 
+        void Vectorize(Index index)
+        {
+            EnsureCreated();
+            _nest->Vectorize(index);
+        }
+
         void SetOrder(std::vector<Index> indices)
         {
             EnsureCreated();
@@ -302,6 +308,18 @@ namespace value
         return outer;
     }
 
+    void Schedule::Vectorize(Index index)
+    {
+        _impl.get().Vectorize(index);
+    }
+
+    Index Schedule::Vectorize(Index& index, int width)
+    {
+        auto outer = Split(index, width);
+        Vectorize(index);
+        return outer;
+    }
+
     void Schedule::Cache(std::unique_ptr<CachingProvider> provider)
     {
         provider->HandleCaching(_nest.get());
@@ -0,0 +1,340 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ScheduleTuner.cpp (value)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ScheduleTuner.h"
+#include "EmitterContext.h"
+#include "FunctionDeclaration.h"
+#include "LLVMContext.h"
+
+#include <emitters/include/IRExecutionEngine.h>
+#include <emitters/include/IRModuleEmitter.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+#include <utilities/include/Logger.h>
+#include <utilities/include/StringUtil.h>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <sstream>
+
+namespace ell
+{
+namespace value
+{
+    namespace
+    {
+        bool IsHostTarget(const emitters::TargetDevice& targetDevice)
+        {
+            return targetDevice.deviceName.empty() || targetDevice.deviceName == "host";
+        }
+
+        std::string GetCandidateName(const ScheduleParameters& parameters)
+        {
+            std::string result = "ScheduleTunerCandidate";
+            for (const auto& [name, value] : parameters)
+            {
+                result += "_" + name + std::to_string(value);
+            }
+            return result;
+        }
+    } // namespace
+
+    //
+    // ScheduleSearchSpace
+    //
+    void ScheduleSearchSpace::AddParameter(const std::string& name, std::vector<int> values)
+    {
+        if (values.empty())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Schedule parameter " + name + " has no values to try");
+        }
+        _parameters.emplace_back(name, std::move(values));
+    }
+
+    std::vector<int> ScheduleSearchSpace::PowersOfTwo(int minValue, int maxValue)
+    {
+        if (minValue < 1 || maxValue < minValue)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Invalid range for schedule parameter values");
+        }
+
+        std::vector<int> result;
+        int value = 1;
+        while (value < minValue)
+        {
+            value *= 2;
+        }
+        for (; value <= maxValue; value *= 2)
+        {
+            result.push_back(value);
+            if (value > maxValue / 2)
+            {
+                break;
+            }
+        }
+        if (result.empty() || result.back() != maxValue)
+        {
+            result.push_back(maxValue);
+        }
+        return result;
+    }
+
+    void ScheduleSearchSpace::AddConstraint(Constraint constraint)
+    {
+        _constraints.push_back(std::move(constraint));
+    }
+
+    std::vector<ScheduleParameters> ScheduleSearchSpace::GetCandidates() const
+    {
+        std::vector<ScheduleParameters> result;
+        if (_parameters.empty())
+        {
+            return result;
+        }
+
+        // Step through the combinations like an odometer, with the last parameter changing fastest
+        std::vector<size_t> position(_parameters.size(), 0);
+        while (true)
+        {
+            ScheduleParameters candidate;
+            for (size_t index = 0; index < _parameters.size(); ++index)
+            {
+                candidate[_parameters[index].first] = _parameters[index].second[position[index]];
+            }
+
+            if (std::all_of(_constraints.begin(), _constraints.end(), [&](const Constraint& constraint) { return constraint(candidate); }))
+            {
+                result.push_back(std::move(candidate));
+            }
+
+            auto index = _parameters.size();
+            while (index > 0 && ++position[index - 1] == _parameters[index - 1].second.size())
+            {
+                position[index - 1] = 0;
+                --index;
+            }
+            if (index == 0)
+            {
+                break;
+            }
+        }
+        return result;
+    }
+
+    //
+    // ScheduleTuner
+    //
+    ScheduleTuner::ScheduleTuner(const emitters::CompilerOptions& compilerOptions, int numIterations, int maxCandidates) :
+        _compilerOptions(compilerOptions),
+        _numIterations(numIterations),
+        _maxCandidates(maxCandidates)
+    {
+        if (!IsHostTarget(_compilerOptions.targetDevice))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Schedules can only be tuned for the host target");
+        }
+        if (_numIterations < 1)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The number of tuning iterations must be positive");
+        }
+        if (_maxCandidates < 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The maximum number of tuning candidates must not be negative");
+        }
+
+        // The candidates are run once, on the tuning thread
+        _compilerOptions.parallelize = false;
+        _compilerOptions.profile = false;
+    }
+
+    ScheduleTuningResult ScheduleTuner::Tune(const ScheduleSearchSpace& searchSpace, DefineCandidateFunction defineCandidate) const
+    {
+        ScheduleTuningResult result;
+        result.time = std::numeric_limits<double>::max();
+        auto candidates = searchSpace.GetCandidates();
+        if (_maxCandidates > 0 && candidates.size() > static_cast<size_t>(_maxCandidates))
+        {
+            // Use a fixed seed, so the same search space always gives the same sample
+            std::mt19937 generator;
+            std::shuffle(candidates.begin(), candidates.end(), generator);
+            candidates.resize(_maxCandidates);
+        }
+
+        for (const auto& candidate : candidates)
+        {
+            double time = 0;
+            try
+            {
+                time = TimeCandidate(candidate, defineCandidate);
+            }
+            catch (const std::exception& exception)
+            {
+                utilities::logging::Log() << "Skipping schedule " << GetCandidateName(candidate) << ": " << exception.what() << utilities::logging::EOL;
+                continue;
+            }
+
+            ++result.numCandidatesMeasured;
+            if (time < result.time)
+            {
+                result.time = time;
+                result.parameters = candidate;
+            }
+        }
+
+        if (result.numCandidatesMeasured == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "None of the candidate schedules could be compiled");
+        }
+        return result;
+    }
+
+    double ScheduleTuner::TimeCandidate(const ScheduleParameters& parameters, DefineCandidateFunction defineCandidate) const
+    {
+        const auto functionName = GetCandidateName(parameters);
+        emitters::IRModuleEmitter moduleEmitter("ScheduleTuner", _compilerOptions);
+        {
+            ContextGuard<LLVMContext> guard(moduleEmitter);
+            (void)DeclareFunction(functionName)
+                .Decorated(false)
+                .Define([&] { defineCandidate(parameters); });
+        }
+
+        emitters::IRExecutionEngine engine(std::move(moduleEmitter), true);
+        auto candidate = reinterpret_cast<void (*)()>(engine.ResolveFunctionAddress(functionName));
+
+        // The first run pulls the code and data into the caches
+        candidate();
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int iteration = 0; iteration < _numIterations; ++iteration)
+        {
+            candidate();
+        }
+        auto elapsed = std::chrono::high_resolution_clock::now() - start;
+        return std::chrono::duration<double, std::milli>(elapsed).count() / _numIterations;
+    }
+
+    //
+    // ScheduleTuningCache
+    //
+    ScheduleTuningCache::ScheduleTuningCache(const std::string& filename)
+    {
+        Load(filename);
+    }
+
+    bool ScheduleTuningCache::HasEntry(const std::string& key) const
+    {
+        return _entries.find(key) != _entries.end();
+    }
+
+    const ScheduleParameters& ScheduleTuningCache::GetEntry(const std::string& key) const
+    {
+        auto it = _entries.find(key);
+        if (it == _entries.end())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "No schedule tuning entry for " + key);
+        }
+        return it->second;
+    }
+
+    void ScheduleTuningCache::SetEntry(const std::string& key, const ScheduleParameters& parameters)
+    {
+        if (key.find_first_of("\t\n") != std::string::npos)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Schedule tuning keys can't contain tabs or newlines");
+        }
+        for (const auto& entry : parameters)
+        {
+            if (entry.first.empty() || entry.first.find_first_of("\t\n,=") != std::string::npos)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Invalid schedule parameter name '" + entry.first + "'");
+            }
+        }
+        _entries[key] = parameters;
+    }
+
+    void ScheduleTuningCache::Read(std::istream& stream)
+    {
+        std::string line;
+        while (std::getline(stream, line))
+        {
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+
+            auto separator = line.rfind('\t');
+            if (separator == std::string::npos)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::badStringFormat, "Malformed schedule tuning entry: " + line);
+            }
+
+            ScheduleParameters parameters;
+            for (const auto& assignment : utilities::Split(line.substr(separator + 1), ','))
+            {
+                auto equals = assignment.find('=');
+                if (equals == std::string::npos)
+                {
+                    throw utilities::InputException(utilities::InputExceptionErrors::badStringFormat, "Malformed schedule tuning entry: " + line);
+                }
+                parameters[assignment.substr(0, equals)] = utilities::FromString<int>(assignment.substr(equals + 1));
+            }
+            _entries[line.substr(0, separator)] = std::move(parameters);
+        }
+    }
+
+    void ScheduleTuningCache::Write(std::ostream& stream) const
+    {
+        stream << "# ELL schedule tuning cache: problem<tab>parameters of the fastest schedule" << std::endl;
+        for (const auto& entry : _entries)
+        {
+            std::vector<std::string> assignments;
+            for (const auto& [name, value] : entry.second)
+            {
+                assignments.push_back(name + "=" + std::to_string(value));
+            }
+            stream << entry.first << '\t' << utilities::Join(assignments, ",") << std::endl;
+        }
+    }
+
+    void ScheduleTuningCache::Load(const std::string& filename)
+    {
+        if (!utilities::FileExists(filename))
+        {
+            return;
+        }
+
+        auto stream = utilities::OpenIfstream(filename);
+        Read(stream);
+    }
+
+    void ScheduleTuningCache::Save(const std::string& filename) const
+    {
+        auto stream = utilities::OpenOfstream(filename);
+        Write(stream);
+    }
+
+    std::string GetScheduleTuningKey(const std::string& problemName, const std::vector<int>& shape, const emitters::TargetDevice& targetDevice)
+    {
+        std::stringstream key;
+        key << problemName << " shape=";
+        for (size_t index = 0; index < shape.size(); ++index)
+        {
+            key << (index == 0 ? "" : "x") << shape[index];
+        }
+        key << " target=" << (IsHostTarget(targetDevice) ? std::string("host") : targetDevice.deviceName);
+        if (!targetDevice.cpu.empty())
+        {
+            key << " cpu=" << targetDevice.cpu;
+        }
+        return key.str();
+    }
+} // namespace value
+} // namespace ell
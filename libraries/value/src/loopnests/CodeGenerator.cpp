@@ -36,6 +36,28 @@ namespace value
             Visit(loopNest);
         }
 
+        void CodeGenerator::EmitVectorLanes(const LoopNest& loopNest, const Index& loopIndex, int start, int stop, int step, std::function<void(Scalar)> codegenFn) const
+        {
+            if (step != 1)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Only loops with unit stride can be vectorized");
+            }
+
+            // The vector width is the extent of the vectorized index. The last piece of a split whose extent isn't a
+            // multiple of the width is shorter than that, and is emitted entirely as the scalar remainder.
+            const int vectorWidth = loopNest.GetIndexRange(loopIndex).Size();
+            auto name = UniqueName(loopNest.Name());
+            auto emitted = InvokeForContext<LLVMContext>([&](LLVMContext& context) {
+                context.VectorizedFor(start, stop, vectorWidth, codegenFn, name);
+                return true;
+            });
+            if (!emitted)
+            {
+                // Contexts without vector code generation run the lanes as an ordinary loop
+                ForRange(name, start, stop, codegenFn);
+            }
+        }
+
         void CodeGenerator::GenerateLoopRangeNew(const LoopRange& r, const RecursionStateNew& state, const LoopVisitSchedule& schedule, std::function<void(Scalar)> codegenFn) const
         {
             const LoopNest& loopNest = schedule.GetLoopNest();
@@ -43,7 +65,11 @@ namespace value
 
             bool isParallelized = loopNest.IsParallelized(loopIndex);
             bool isUnrolled = loopNest.IsUnrolled(loopIndex);
-            assert(!(isParallelized && isUnrolled) && "An index cannot be both unrolled and parallelized");
+            bool isVectorized = loopNest.IsVectorized(loopIndex);
+            if ((isParallelized && isUnrolled) || (isVectorized && (isParallelized || isUnrolled)))
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "A loop index can only be one of unrolled, parallelized or vectorized");
+            }
 
             const int startInt = r.start.Get<int>();
             const int stopInt = r.stop.Get<int>();
@@ -55,7 +81,7 @@ namespace value
                 isParallelized = false;
             }
 
-            if (!(isParallelized || isUnrolled))
+            if (!(isParallelized || isUnrolled || isVectorized))
             {
                 ForRange(UniqueName(loopNest.Name()), r.start, r.stop, r.step, codegenFn);
             }
@@ -100,6 +126,10 @@ namespace value
                     codegenFn(i);
                 }
             }
+            else if (isVectorized)
+            {
+                EmitVectorLanes(loopNest, loopIndex, startInt, stopInt, stepInt, codegenFn);
+            }
         }
 
         void CodeGenerator::GenerateLoopRangeOld(const LoopRange& r, const RecursionState& state, const LoopVisitSchedule& schedule, std::function<void(Scalar)> codegenFn) const
@@ -109,7 +139,11 @@ namespace value
 
             bool isParallelized = loopNest.IsParallelized(loopIndex);
             bool isUnrolled = loopNest.IsUnrolled(loopIndex);
-            assert(!(isParallelized && isUnrolled) && "An index cannot be both unrolled and parallelized");
+            bool isVectorized = loopNest.IsVectorized(loopIndex);
+            if ((isParallelized && isUnrolled) || (isVectorized && (isParallelized || isUnrolled)))
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "A loop index can only be one of unrolled, parallelized or vectorized");
+            }
 
             const int startInt = r.start.Get<int>();
             const int stopInt = r.stop.Get<int>();
@@ -121,7 +155,7 @@ namespace value
                 isParallelized = false;
             }
 
-            if (!(isParallelized || isUnrolled))
+            if (!(isParallelized || isUnrolled || isVectorized))
             {
                 ForRange(UniqueName(loopNest.Name()), r.start, r.stop, r.step, codegenFn);
             }
@@ -162,6 +196,10 @@ namespace value
                     codegenFn(i);
                 }
             }
+            else if (isVectorized)
+            {
+                EmitVectorLanes(loopNest, loopIndex, startInt, stopInt, stepInt, codegenFn);
+            }
         }
 
         Scalar CodeGenerator::EmitIndexExpression(const Index& index, const IndexExpression& expr, const LoopIndexSymbolTable& indexVariables) const
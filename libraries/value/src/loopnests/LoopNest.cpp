@@ -608,6 +608,10 @@ namespace value
 
         void LoopNest::Parallelize(Index index)
         {
+            if (IsVectorized(index))
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Parallelize() --- an index can't be parallelized and also vectorized");
+            }
             _parallelizedIndices.push_back(index);
         }
 
@@ -621,6 +625,10 @@ namespace value
 
         void LoopNest::Unroll(Index index)
         {
+            if (IsVectorized(index))
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Unroll() --- an index can't be unrolled and also vectorized");
+            }
             _unrolledIndices.push_back(index);
         }
 
@@ -632,6 +640,30 @@ namespace value
             return result;
         }
 
+        void LoopNest::Vectorize(Index index)
+        {
+            if (IsParallelized(index) || IsUnrolled(index))
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Vectorize() --- an index can't be vectorized and also unrolled or parallelized");
+            }
+            if (IsVectorized(index))
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Vectorize() --- index is already vectorized");
+            }
+            _vectorizedIndices.push_back(index);
+        }
+
+        SplitIndex LoopNest::Vectorize(Index index, int width)
+        {
+            if (width < 1)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Vectorize() --- vector width must be positive");
+            }
+            auto result = Split(index, width);
+            Vectorize(result.inner);
+            return result;
+        }
+
         void LoopNest::SetLoopOrder(const std::vector<Index>& order)
         {
             if (order.size() != _loopSequence.size())
@@ -728,6 +760,11 @@ namespace value
             return std::find(_unrolledIndices.begin(), _unrolledIndices.end(), index) != _unrolledIndices.end();
         }
 
+        bool LoopNest::IsVectorized(const Index& index) const
+        {
+            return std::find(_vectorizedIndices.begin(), _vectorizedIndices.end(), index) != _vectorizedIndices.end();
+        }
+
         const std::vector<RenameAction>& LoopNest::GetRenameActions() const
         {
             return _renameActions;
@@ -47,6 +47,7 @@ namespace value
 
             bool isParallelized = loopNest.IsParallelized(loopIndex);
             bool isUnrolled = loopNest.IsUnrolled(loopIndex);
+            bool isVectorized = loopNest.IsVectorized(loopIndex);
             assert(!(isParallelized && isUnrolled) && "An index cannot be both unrolled and parallelized");
 
             const int startInt = r.start.Get<int>();
@@ -68,6 +69,10 @@ namespace value
             {
                 properties.push_back("unrolled");
             }
+            if (isVectorized)
+            {
+                properties.push_back("vectorized");
+            }
             if (numIterations == 1)
             {
                 properties.push_back("single");
@@ -95,6 +100,7 @@ namespace value
 
             bool isParallelized = loopNest.IsParallelized(loopIndex);
             bool isUnrolled = loopNest.IsUnrolled(loopIndex);
+            bool isVectorized = loopNest.IsVectorized(loopIndex);
             assert(!(isParallelized && isUnrolled) && "An index cannot be both unrolled and parallelized");
 
             const int startInt = r.start.Get<int>();
@@ -110,6 +116,10 @@ namespace value
             {
                 properties.push_back("unrolled");
             }
+            if (isVectorized)
+            {
+                properties.push_back("vectorized");
+            }
 
             auto currentLoopHasPrologue = r.currentLoopFragmentFlags.GetFlag(LoopFragmentType::prologue);
             auto currentLoopHasEpilogue = r.currentLoopFragmentFlags.GetFlag(LoopFragmentType::epilogue);
@@ -22,6 +22,7 @@ value::Scalar LoopNest_api_test5();
 value::Scalar LoopNest_api_Parallelized_test1();
 value::Scalar LoopNest_api_Parallelized_test2();
 value::Scalar LoopNest_api_Unrolled_test1();
+value::Scalar LoopNest_api_Vectorized_test1();
 value::Scalar LoopNest_api_SetOrder_test1();
 value::Scalar LoopNest_api_CachedMatrix_test1();
 value::Scalar LoopNest_api_SlidingCachedMatrix_test();
@@ -70,6 +70,10 @@ value::Scalar LoopNest_Parallelized_test2();
 
 value::Scalar LoopNest_Unrolled_test1();
 
+value::Scalar LoopNest_Vectorized_test1();
+value::Scalar LoopNest_Vectorized_test2();
+value::Scalar LoopNest_Vectorized_test3();
+
 value::Scalar LoopNest_DebugDump_test1();
 value::Scalar LoopNest_DebugDump_test2();
 
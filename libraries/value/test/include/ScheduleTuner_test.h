@@ -0,0 +1,18 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ScheduleTuner_test.h (value)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+namespace ell
+{
+
+// These tests compile and run code themselves, so they aren't run in each of the test contexts
+void ScheduleSearchSpace_test();
+void ScheduleTuningCache_test();
+void ScheduleTuner_test();
+
+} // namespace ell
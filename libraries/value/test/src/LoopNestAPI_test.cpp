@@ -265,6 +265,26 @@ Scalar LoopNest_api_Unrolled_test1()
     return matrix(2, 3) - 19; // will return 0 if calculation is correct
 }
 
+Scalar LoopNest_api_Vectorized_test1()
+{
+    auto matrix = MakeMatrix<int>(4, 10);
+    Index i("i"), j("j");
+
+    auto nest = Using({ matrix }, ArgumentType::Output)
+                    .ForAll(i, 0, 4)
+                    .ForAll(j, 0, 10)
+                    .Do(loopnest_kernel);
+
+    auto& schedule = nest.GetSchedule();
+
+    // 10 columns make two whole vectors and a scalar remainder
+    schedule.Vectorize(j, 4);
+
+    nest.Run();
+
+    return (matrix(2, 3) - 23) + (matrix(3, 9) - 39); // will return 0 if calculation is correct
+}
+
 Scalar LoopNest_api_SetOrder_test1()
 {
     auto matrix = MakeMatrix<int>(4, 5);
@@ -30,12 +30,14 @@
 #include <math/include/Tensor.h>
 #include <math/include/Vector.h>
 
+#include <utilities/include/Exception.h>
 #include <utilities/include/FunctionUtils.h>
 #include <utilities/include/Logger.h>
 
 #include <testing/include/testing.h>
 
 #include <deque>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <queue>
@@ -92,6 +94,84 @@ namespace
         loops.SetLoopOrder(splits);
     }
 
+    // Multiplies matrices with the register-blocked structure of MatrixMatrixMultiplyCodeNode's kernel (a block of
+    // rows by two vectors of columns), vectorizing the innermost column loop with the given vector width
+    Scalar VectorizedGemmTest(int M, int N, int K, int vectorWidth)
+    {
+        const int kernelRows = 4;
+        auto A = MakeMatrix<float>(M, K, "A");
+        auto B = MakeMatrix<float>(K, N, "B");
+        auto C = MakeMatrix<float>(M, N, "C");
+        auto expected = MakeMatrix<float>(M, N, "expected");
+
+        ForRange(M, [&](Scalar i) {
+            ForRange(K, [&](Scalar k) {
+                A(i, k) = Cast<float>(i - k);
+            });
+        });
+        ForRange(K, [&](Scalar k) {
+            ForRange(N, [&](Scalar j) {
+                B(k, j) = Cast<float>(k + 2 * j);
+            });
+        });
+        ForRange(M, [&](Scalar i) {
+            ForRange(N, [&](Scalar j) {
+                C(i, j) = 0.0f;
+                expected(i, j) = 0.0f;
+                ForRange(K, [&](Scalar k) {
+                    expected(i, j) += A(i, k) * B(k, j);
+                });
+            });
+        });
+
+        Index i("i"), j("j"), k("k");
+        LoopNest loop({ { i, { 0, M } },
+                        { j, { 0, N } },
+                        { k, { 0, K } } });
+
+        auto [jKernelOuter, jKernelInner] = loop.Split(j, 2 * vectorWidth);
+        auto [iKernelOuter, iKernelInner] = loop.Split(i, kernelRows);
+        auto [jVectorOuter, jVectorInner] = loop.Vectorize(jKernelInner, vectorWidth);
+
+        auto kernel = Kernel("gemm")
+                          .Inputs(A.GetValue(), B.GetValue(), C.GetValue())
+                          .Indices(i, j, k)
+                          .Define([](Matrix A, Matrix B, Matrix C, Scalar i, Scalar j, Scalar k) {
+                              C(i, j) += B(k, j) * A(i, k);
+                          });
+
+        loop.AddKernel(kernel, LoopNest::ConstraintType::constraint);
+        loop.SetLoopOrder({ jKernelOuter, iKernelOuter, k, iKernelInner, jVectorOuter, jVectorInner });
+
+        if (!loop.IsVectorized(jVectorInner) || loop.IsVectorized(jVectorOuter))
+        {
+            return 1;
+        }
+
+        // A vectorized index can't be vectorized again or unrolled
+        int numRejected = 0;
+        for (auto schedule : std::vector<std::function<void()>>{ [&] { loop.Vectorize(jVectorInner); }, [&] { loop.Unroll(jVectorInner); }, [&] { loop.Parallelize(jVectorInner); } })
+        {
+            try
+            {
+                schedule();
+            }
+            catch (const InputException&)
+            {
+                ++numRejected;
+            }
+        }
+        if (numRejected != 3 || loop.IsUnrolled(jVectorInner) || loop.IsParallelized(jVectorInner))
+        {
+            return 1;
+        }
+
+        CodeGenerator generator;
+        generator.Run(loop);
+
+        return VerifySame(C, expected);
+    }
+
 } // namespace
 
 // Low-level tests of loop nest infrastructure
@@ -2383,6 +2463,24 @@ Scalar LoopNest_Unrolled_test1()
     return matrix(2, 3) - 19; // will return 0 if calculation is correct
 }
 
+// 8 lanes (the float vector width of AVX2)
+Scalar LoopNest_Vectorized_test1()
+{
+    return VectorizedGemmTest(8, 32, 16, 8);
+}
+
+// 4 lanes (the float vector width of NEON)
+Scalar LoopNest_Vectorized_test2()
+{
+    return VectorizedGemmTest(8, 16, 16, 4);
+}
+
+// A column count that isn't a multiple of the vector width leaves a scalar remainder at the end of each row
+Scalar LoopNest_Vectorized_test3()
+{
+    return VectorizedGemmTest(6, 21, 8, 8);
+}
+
 Scalar LoopNest_DebugDump_test1()
 {
     auto matrix = MakeMatrix<int>(4, 5);
@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ScheduleTuner_test.cpp (value)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ScheduleTuner_test.h"
+
+#include <value/include/LoopNests.h>
+#include <value/include/Matrix.h>
+#include <value/include/Scalar.h>
+#include <value/include/ScheduleTuner.h>
+
+#include <emitters/include/CompilerOptions.h>
+
+#include <testing/include/testing.h>
+
+#include <sstream>
+#include <vector>
+
+using namespace ell::utilities;
+using namespace ell::value;
+
+namespace ell
+{
+void ScheduleSearchSpace_test()
+{
+    ScheduleSearchSpace searchSpace;
+    searchSpace.AddParameter("split", { 2, 4, 8 });
+    searchSpace.AddParameter("unroll", { 1, 2, 4 });
+    auto allCandidates = searchSpace.GetCandidates();
+
+    searchSpace.AddConstraint([](const ScheduleParameters& candidate) { return candidate.at("unroll") <= candidate.at("split") / 2; });
+    auto legalCandidates = searchSpace.GetCandidates();
+
+    bool ok = allCandidates.size() == 9 && legalCandidates.size() == 6;
+    for (const auto& candidate : legalCandidates)
+    {
+        ok = ok && candidate.size() == 2 && candidate.at("unroll") <= candidate.at("split") / 2;
+    }
+    ok = ok && ScheduleSearchSpace::PowersOfTwo(8, 64) == std::vector<int>{ 8, 16, 32, 64 };
+    ok = ok && ScheduleSearchSpace::PowersOfTwo(3, 20) == std::vector<int>{ 4, 8, 16, 20 };
+    ok = ok && ScheduleSearchSpace::PowersOfTwo(5, 5) == std::vector<int>{ 5 };
+    testing::ProcessTest("ScheduleSearchSpace_test", ok);
+}
+
+void ScheduleTuningCache_test()
+{
+    emitters::TargetDevice targetDevice;
+    targetDevice.deviceName = "host";
+    auto key1 = GetScheduleTuningKey("gemm_float", { 64, 64, 64 }, targetDevice);
+    auto key2 = GetScheduleTuningKey("gemm_float", { 64, 64, 32 }, targetDevice);
+
+    ScheduleTuningCache cache;
+    cache.SetEntry(key1, { { "columnBlock", 64 }, { "kUnroll", 4 } });
+    cache.SetEntry(key2, { { "columnBlock", 32 }, { "kUnroll", 2 } });
+
+    std::stringstream stream;
+    cache.Write(stream);
+
+    ScheduleTuningCache readCache;
+    readCache.Read(stream);
+
+    bool ok = key1 != key2 && readCache.NumEntries() == 2 && readCache.HasEntry(key1) && readCache.HasEntry(key2) &&
+              readCache.GetEntry(key1) == cache.GetEntry(key1) && readCache.GetEntry(key2) == cache.GetEntry(key2);
+    testing::ProcessTest("ScheduleTuningCache_test", ok);
+}
+
+void ScheduleTuner_test()
+{
+    const int rows = 16;
+    const int columns = 64;
+
+    ScheduleSearchSpace searchSpace;
+    searchSpace.AddParameter("jSplit", { 4, 8, 16 });
+    searchSpace.AddParameter("unroll", { 0, 1 });
+
+    int numCandidatesDefined = 0;
+    emitters::CompilerOptions compilerOptions;
+    ScheduleTuner tuner(compilerOptions, 2);
+    auto result = tuner.Tune(searchSpace, [&](const ScheduleParameters& parameters) {
+        ++numCandidatesDefined;
+        auto output = MakeStaticMatrix(rows, columns, ValueType::Int32, "output");
+
+        Index i("i"), j("j");
+        auto nest = Using({ output }, ArgumentType::Output)
+                        .ForAll(i, 0, rows)
+                        .ForAll(j, 0, columns)
+                        .Do([](Matrix m, Scalar i, Scalar j) {
+                            m(i, j) = i * 10 + j;
+                        });
+
+        auto& schedule = nest.GetSchedule();
+        schedule.Split(j, parameters.at("jSplit"));
+        if (parameters.at("unroll") != 0)
+        {
+            schedule.Unroll(j);
+        }
+        nest.Run();
+    });
+
+    bool ok = numCandidatesDefined == 6 && result.numCandidatesMeasured == 6 && result.time >= 0 && result.parameters.size() == 2;
+
+    // A tuner with a smaller budget than the search space times a sample of the candidates
+    numCandidatesDefined = 0;
+    ScheduleTuner limitedTuner(compilerOptions, 1, 4);
+    auto limitedResult = limitedTuner.Tune(searchSpace, [&](const ScheduleParameters& parameters) {
+        ++numCandidatesDefined;
+        auto output = MakeStaticMatrix(rows, columns, ValueType::Int32, "output");
+
+        Index i("i"), j("j");
+        auto nest = Using({ output }, ArgumentType::Output)
+                        .ForAll(i, 0, rows)
+                        .ForAll(j, 0, columns)
+                        .Do([](Matrix m, Scalar i, Scalar j) {
+                            m(i, j) = i * 10 + j;
+                        });
+        nest.GetSchedule().Split(j, parameters.at("jSplit"));
+        nest.Run();
+    });
+    ok = ok && numCandidatesDefined == 4 && limitedResult.numCandidatesMeasured == 4;
+    testing::ProcessTest("ScheduleTuner_test", ok);
+}
+} // namespace ell
@@ -13,6 +13,7 @@
 #include "LoopNest_test.h"
 #include "Matrix_test.h"
 #include "Scalar_test.h"
+#include "ScheduleTuner_test.h"
 #include "Tensor_test.h"
 #include "Value_test.h"
 #include "Vector_test.h"
@@ -475,6 +476,9 @@ int main()
         ADD_TEST_FUNCTION(LoopNest_Parallelized_test2);
 
         ADD_TEST_FUNCTION(LoopNest_Unrolled_test1);
+        ADD_TEST_FUNCTION(LoopNest_Vectorized_test1);
+        ADD_TEST_FUNCTION(LoopNest_Vectorized_test2);
+        ADD_TEST_FUNCTION(LoopNest_Vectorized_test3);
 
         ADD_TEST_FUNCTION(LoopNest_DebugDump_test1);
         ADD_TEST_FUNCTION(LoopNest_DebugDump_test2);
@@ -489,6 +493,7 @@ int main()
         ADD_TEST_FUNCTION(LoopNest_api_Parallelized_test1);
         ADD_TEST_FUNCTION(LoopNest_api_Parallelized_test2);
         ADD_TEST_FUNCTION(LoopNest_api_Unrolled_test1);
+        ADD_TEST_FUNCTION(LoopNest_api_Vectorized_test1);
         ADD_TEST_FUNCTION(LoopNest_api_SetOrder_test1);
         // ADD_TEST_FUNCTION(LoopNest_api_CachedMatrix_test1); // Fails
         ADD_TEST_FUNCTION(GotoBLASGemmWithRefDeref);
@@ -660,6 +665,10 @@ int main()
             RunTest(name, fn);
         }
 
+        ScheduleSearchSpace_test();
+        ScheduleTuningCache_test();
+        ScheduleTuner_test();
+
 #undef ADD_TEST_FUNCTION
     }
     catch (const std::exception& exception)
@@ -0,0 +1,30 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ForestTrainerToolArguments.h (forestTrainer)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <utilities/include/CommandLineParser.h>
+
+namespace ell
+{
+/// <summary> Arguments specific to the forestTrainer tool. </summary>
+struct ForestTrainerToolArguments
+{
+    /// <summary> If true, train on one thread and on `numThreads` threads, and time the trained forest's predictions with both forest layouts. </summary>
+    bool benchmark = false;
+};
+
+/// <summary> Parsed version of ForestTrainerToolArguments. </summary>
+struct ParsedForestTrainerToolArguments : public ForestTrainerToolArguments
+    , public utilities::ParsedArgSet
+{
+    /// <summary> Adds the arguments to the command line parser. </summary>
+    ///
+    /// <param name="parser"> [in,out] The command line parser. </param>
+    void AddArgs(utilities::CommandLineParser& parser) override;
+};
+} // namespace ell
@@ -0,0 +1,20 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ForestTrainerToolArguments.cpp (forestTrainer)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ForestTrainerToolArguments.h"
+
+namespace ell
+{
+void ParsedForestTrainerToolArguments::AddArgs(utilities::CommandLineParser& parser)
+{
+    parser.AddOption(benchmark,
+                     "benchmark",
+                     "",
+                     "Train with one thread and with numThreads threads, and time the trained forest's predictions with the pointer-based and flat layouts",
+                     false);
+}
+} // namespace ell
@@ -6,10 +6,13 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "ForestTrainerToolArguments.h"
+
 #include <utilities/include/CommandLineParser.h>
 #include <utilities/include/Exception.h>
 #include <utilities/include/Files.h>
 #include <utilities/include/OutputStreamImpostor.h>
+#include <utilities/include/ParallelFor.h>
 
 #include <data/include/Dataset.h>
 
@@ -29,11 +32,81 @@
 
 #include <nodes/include/ForestPredictorNode.h>
 
+#include <predictors/include/FlatForestPredictor.h>
+
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <stdexcept>
+#include <vector>
 
 using namespace ell;
 
+template <typename DatasetType>
+void BenchmarkPrediction(const predictors::SimpleForestPredictor& forest, const DatasetType& dataset)
+{
+    using DataVectorType = predictors::SimpleForestPredictor::DataVectorType;
+    const auto numExamples = dataset.NumExamples();
+    if (numExamples == 0)
+    {
+        return;
+    }
+
+    predictors::FlatForestPredictor flatForest(forest);
+    std::vector<DataVectorType> dataVectors;
+    dataVectors.reserve(numExamples);
+    size_t inputSize = flatForest.NumInputs();
+    for (size_t i = 0; i < numExamples; ++i)
+    {
+        dataVectors.push_back(dataset[i].GetDataVector().template CopyAs<DataVectorType>());
+        inputSize = std::max(inputSize, dataVectors.back().PrefixLength());
+    }
+
+    std::vector<float> denseInputs(numExamples * inputSize);
+    for (size_t i = 0; i < numExamples; ++i)
+    {
+        auto values = dataVectors[i].ToArray(inputSize);
+        std::copy(values.begin(), values.end(), denseInputs.begin() + i * inputSize);
+    }
+
+    // each layout sums its predictions, so that the work can't be optimized away and the results can be compared
+    auto time = [numExamples](const char* name, auto predict) {
+        auto startTime = std::chrono::steady_clock::now();
+        double sum = predict();
+        auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        std::cout << name << ": " << 1.0e6 * seconds / numExamples << " us per example (sum of predictions " << sum << ")" << std::endl;
+    };
+
+    time("ForestPredictor::Predict", [&]() {
+        double sum = 0;
+        for (const auto& dataVector : dataVectors)
+        {
+            sum += forest.Predict(dataVector);
+        }
+        return sum;
+    });
+
+    time("FlatForestPredictor::Predict", [&]() {
+        double sum = 0;
+        for (size_t i = 0; i < numExamples; ++i)
+        {
+            sum += flatForest.Predict(denseInputs.data() + i * inputSize);
+        }
+        return sum;
+    });
+
+    time("FlatForestPredictor::PredictBatch", [&]() {
+        std::vector<double> outputs(numExamples);
+        flatForest.PredictBatch(denseInputs.data(), inputSize, numExamples, outputs.data());
+        double sum = 0;
+        for (auto output : outputs)
+        {
+            sum += output;
+        }
+        return sum;
+    });
+}
+
 int main(int argc, char* argv[])
 {
     try
@@ -48,6 +121,7 @@ int main(int argc, char* argv[])
         common::ParsedModelSaveArguments modelSaveArguments;
         common::ParsedForestTrainerArguments forestTrainerArguments;
         common::ParsedEvaluatorArguments evaluatorArguments;
+        ParsedForestTrainerToolArguments forestTrainerToolArguments;
 
         commandLineParser.AddOptionSet(trainerArguments);
         commandLineParser.AddOptionSet(dataLoadArguments);
@@ -55,6 +129,7 @@ int main(int argc, char* argv[])
         commandLineParser.AddOptionSet(modelSaveArguments);
         commandLineParser.AddOptionSet(forestTrainerArguments);
         commandLineParser.AddOptionSet(evaluatorArguments);
+        commandLineParser.AddOptionSet(forestTrainerToolArguments);
 
         // parse command line
         commandLineParser.Parse();
@@ -73,32 +148,67 @@ int main(int argc, char* argv[])
 
         // load dataset
         if (trainerArguments.verbose) std::cout << "Loading data ..." << std::endl;
-        auto stream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
-        auto parsedDataset = common::GetDataset(stream);
+        auto parsedDataset = common::GetDataset(dataLoadArguments.inputDataFilename);
         auto mappedDataset = common::TransformDataset(parsedDataset, map);
 
         // predictor type
         using PredictorType = predictors::SimpleForestPredictor;
 
+        // benchmark: train on one thread first, for comparison with the multithreaded run below
+        double singleThreadSeconds = 0;
+        if (forestTrainerToolArguments.benchmark)
+        {
+            if (trainerArguments.verbose) std::cout << "Training on 1 thread ..." << std::endl;
+            auto singleThreadArguments = forestTrainerArguments;
+            singleThreadArguments.numThreads = 1;
+            auto singleThreadTrainer = common::MakeForestTrainer(trainerArguments.lossFunctionArguments, singleThreadArguments);
+
+            auto startTime = std::chrono::steady_clock::now();
+            singleThreadTrainer->SetDataset(mappedDataset.GetAnyDataset());
+            for (size_t epoch = 0; epoch < trainerArguments.numEpochs; ++epoch)
+            {
+                singleThreadTrainer->Update();
+            }
+            singleThreadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        }
+
         // create trainer and evaluator
         auto trainer = common::MakeForestTrainer(trainerArguments.lossFunctionArguments, forestTrainerArguments);
         auto evaluator = common::MakeEvaluator<PredictorType>(mappedDataset.GetAnyDataset(), evaluatorArguments, trainerArguments.lossFunctionArguments);
 
         // train
         if (trainerArguments.verbose) std::cout << "Training ..." << std::endl;
+        auto startTime = std::chrono::steady_clock::now();
+        double evaluationSeconds = 0;
         trainer->SetDataset(mappedDataset.GetAnyDataset());
 
         for (size_t epoch = 0; epoch < trainerArguments.numEpochs; ++epoch)
         {
             trainer->Update();
+
+            auto evaluationStartTime = std::chrono::steady_clock::now();
             evaluator->Evaluate(trainer->GetPredictor());
+            evaluationSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - evaluationStartTime).count();
+        }
+        auto trainingSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() - evaluationSeconds;
+
+        if (forestTrainerToolArguments.benchmark)
+        {
+            std::cout << "Training time on 1 thread: " << singleThreadSeconds << " s" << std::endl;
+            std::cout << "Training time on " << utilities::GetNumThreads(forestTrainerArguments.numThreads) << " threads: " << trainingSeconds << " s" << std::endl;
+            std::cout << "Speedup: " << singleThreadSeconds / trainingSeconds << "x" << std::endl;
         }
 
         auto predictor = trainer->GetPredictor();
+        if (forestTrainerToolArguments.benchmark)
+        {
+            BenchmarkPrediction(predictor, mappedDataset);
+        }
+
         // print loss and errors
         if (trainerArguments.verbose)
         {
-            std::cout << "Finished training forest with " << predictor.NumTrees() << " trees." << std::endl;
+            std::cout << "Finished training forest with " << predictor.NumTrees() << " trees in " << trainingSeconds << " seconds." << std::endl;
 
             // print evaluation
             std::cout << "Training error\n";
@@ -110,7 +220,7 @@ int main(int argc, char* argv[])
         if (modelSaveArguments.outputModelFilename != "")
         {
             auto model = common::AppendNodeToModel<nodes::SimpleForestPredictorNode, PredictorType>(map, predictor);
-            common::SaveModel(model, modelSaveArguments.outputModelFilename);
+            common::SaveModel(model, modelSaveArguments.outputModelFilename, modelSaveArguments.outputModelFormat);
         }
     }
     catch (const utilities::CommandLineParserPrintHelpException& exception)
@@ -29,6 +29,9 @@ struct LinearTrainerArguments
     size_t maxEpochs;
     bool permute;
     std::string randomSeedString;
+
+    /// <summary> If nonzero, read the training data in shards that fit in this many megabytes, instead of loading all of it. </summary>
+    size_t maxMemoryMB = 0;
 };
 
 /// <summary> Parsed version of LinearTrainerArguments. </summary>
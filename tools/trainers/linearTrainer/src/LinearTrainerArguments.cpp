@@ -55,5 +55,11 @@ void ParsedLinearTrainerArguments::AddArgs(utilities::CommandLineParser& parser)
                      "seed",
                      "The random seed string",
                      "ABCDEFG");
+
+    parser.AddOption(maxMemoryMB,
+                     "maxMemoryMB",
+                     "mm",
+                     "If nonzero, stream the training data from the file in shards that use at most this many megabytes, instead of loading it all into memory",
+                     0);
 }
 } // namespace ell
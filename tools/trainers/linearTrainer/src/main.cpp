@@ -13,7 +13,9 @@
 #include <utilities/include/Files.h>
 #include <utilities/include/OutputStreamImpostor.h>
 
+#include <data/include/BinaryDataset.h>
 #include <data/include/Dataset.h>
+#include <data/include/ExampleShardReader.h>
 
 #include <common/include/DataLoadArguments.h>
 #include <common/include/DataLoaders.h>
@@ -31,6 +33,7 @@
 
 #include <nodes/include/LinearPredictorNode.h>
 
+#include <trainers/include/IStreamingTrainer.h>
 #include <trainers/include/MeanCalculator.h>
 
 #include <evaluators/include/Evaluator.h>
@@ -108,10 +111,16 @@ int main(int argc, char* argv[])
             map = model::Map(model, { { "input", input } }, { { "output", output } });
         }
 
+        // When streaming, the examples are read straight from the file in every epoch, so they can't be transformed first
+        const bool streamData = linearTrainerArguments.maxMemoryMB > 0;
+        if (streamData && (mapLoadArguments.HasInputFilename() || linearTrainerArguments.normalize || linearTrainerArguments.algorithm == LinearTrainerArguments::Algorithm::SparseDataCenteredSGD))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "maxMemoryMB can't be used with an input map, normalization, or the SparseDataCenteredSGD algorithm");
+        }
+
         // load dataset
-        if (trainerArguments.verbose) std::cout << "Loading data ..." << std::endl;
-        auto stream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
-        auto parsedDataset = common::GetDataset(stream);
+        if (trainerArguments.verbose && !streamData) std::cout << "Loading data ..." << std::endl;
+        auto parsedDataset = streamData ? data::AutoSupervisedDataset() : common::GetDataset(dataLoadArguments.inputDataFilename);
         auto mappedDataset = common::TransformDataset(parsedDataset, map);
         auto mappedDatasetDimension = map.GetOutput(0).Size();
 
@@ -162,17 +171,50 @@ int main(int argc, char* argv[])
             throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "unrecognized algorithm type");
         }
 
-        // create an evaluator
-        auto evaluator = common::MakeEvaluator<PredictorType>(mappedDataset.GetAnyDataset(), evaluatorArguments, trainerArguments.lossFunctionArguments);
+        // create an evaluator (the training data isn't in memory to evaluate on when it's streamed)
+        std::shared_ptr<evaluators::IEvaluator<PredictorType>> evaluator;
+        if (!streamData)
+        {
+            evaluator = common::MakeEvaluator<PredictorType>(mappedDataset.GetAnyDataset(), evaluatorArguments, trainerArguments.lossFunctionArguments);
+        }
 
         // Train the predictor
         if (trainerArguments.verbose) std::cout << "Training ..." << std::endl;
-        trainer->SetDataset(mappedDataset.GetAnyDataset());
+        if (streamData)
+        {
+            auto streamingTrainer = dynamic_cast<trainers::IStreamingTrainer<data::AutoSupervisedExample>*>(trainer.get());
+            if (streamingTrainer == nullptr)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The training algorithm can't stream its data");
+            }
+
+            // The shard reader keeps two shards in memory: the one being trained on, and the one being read
+            const size_t maxShardBytes = linearTrainerArguments.maxMemoryMB * 1024 * 1024 / 2;
+            const auto filename = dataLoadArguments.inputDataFilename;
+            using ShardReaderType = data::ExampleShardReader<data::AutoSupervisedExample>;
+            if (data::IsBinaryDatasetFile(filename))
+            {
+                // Binary datasets can be read from any example, so each epoch visits the shards in a new order
+                data::BinaryDataset binaryDataset(filename);
+                streamingTrainer->SetShardedDataset(std::make_unique<ShardReaderType>([binaryDataset](size_t fromIndex) { return binaryDataset.GetExampleIterator(fromIndex); }, maxShardBytes));
+            }
+            else
+            {
+                streamingTrainer->SetShardedDataset(std::make_unique<ShardReaderType>([filename]() { return common::GetAutoSupervisedExampleIterator(filename); }, maxShardBytes));
+            }
+        }
+        else
+        {
+            trainer->SetDataset(mappedDataset.GetAnyDataset());
+        }
 
         for (size_t epoch = 0; epoch < trainerArguments.numEpochs; ++epoch)
         {
             trainer->Update();
-            evaluator->Evaluate(trainer->GetPredictor());
+            if (evaluator)
+            {
+                evaluator->Evaluate(trainer->GetPredictor());
+            }
         }
 
         // Print loss and errors
@@ -181,9 +223,12 @@ int main(int argc, char* argv[])
             std::cout << "Finished training.\n";
 
             // print evaluation
-            std::cout << "Training error\n";
-            evaluator->Print(std::cout);
-            std::cout << std::endl;
+            if (evaluator)
+            {
+                std::cout << "Training error\n";
+                evaluator->Print(std::cout);
+                std::cout << std::endl;
+            }
         }
 
         // Save predictor model
@@ -195,13 +240,13 @@ int main(int argc, char* argv[])
             case model::Port::PortType::smallReal:
             {
                 auto outputMap = AppendTrainedLinearPredictorToMap<float>(trainer->GetPredictor(), map, mappedDatasetDimension);
-                common::SaveMap(outputMap, modelSaveArguments.outputModelFilename);
+                common::SaveMap(outputMap, modelSaveArguments.outputModelFilename, modelSaveArguments.outputModelFormat);
             }
             break;
             case model::Port::PortType::real:
             {
                 auto outputMap = AppendTrainedLinearPredictorToMap<double>(trainer->GetPredictor(), map, mappedDatasetDimension);
-                common::SaveMap(outputMap, modelSaveArguments.outputModelFilename);
+                common::SaveMap(outputMap, modelSaveArguments.outputModelFilename, modelSaveArguments.outputModelFormat);
             }
             break;
             default:
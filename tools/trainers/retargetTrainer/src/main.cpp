@@ -428,8 +428,7 @@ int main(int argc, char* argv[])
         {
             // This is a multi-class dataset
             _timer.Start();
-            auto stream = utilities::OpenIfstream(retargetArguments.inputDataFilename);
-            auto multiclassDataset = common::GetMultiClassDataset(stream);
+            auto multiclassDataset = common::GetMultiClassDataset(retargetArguments.inputDataFilename);
             if (retargetArguments.verbose) std::cout << "(" << _timer.Elapsed() << " ms)" << std::endl;
 
             // Obtain a new training dataset for the set of Linear Predictors by running the
@@ -468,8 +467,7 @@ int main(int argc, char* argv[])
         {
             // This is a binary classification dataset
             _timer.Start();
-            auto stream = utilities::OpenIfstream(retargetArguments.inputDataFilename);
-            auto binaryDataset = common::GetDataset(stream);
+            auto binaryDataset = common::GetDataset(retargetArguments.inputDataFilename);
             if (retargetArguments.verbose) std::cout << "Loading dataset took :" << _timer.Elapsed() << " ms" << std::endl;
             // Obtain a new training dataset for the Linear Predictor by running the
             // binaryDataset through the modified model
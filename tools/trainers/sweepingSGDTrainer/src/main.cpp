@@ -18,17 +18,19 @@
 #include <common/include/DataLoadArguments.h>
 #include <common/include/DataLoaders.h>
 #include <common/include/LoadModel.h>
-#include <common/include/MakeEvaluator.h>
 #include <common/include/MakeTrainer.h>
 #include <common/include/MapLoadArguments.h>
 #include <common/include/ModelSaveArguments.h>
 #include <common/include/ParametersEnumerator.h>
+#include <common/include/SweepingTrainerArguments.h>
 #include <common/include/TrainerArguments.h>
 
 #include <trainers/include/EvaluatingTrainer.h>
 #include <trainers/include/SGDTrainer.h>
 #include <trainers/include/SweepingTrainer.h>
 
+#include <evaluators/include/AUCAggregator.h>
+#include <evaluators/include/BinaryErrorAggregator.h>
 #include <evaluators/include/Evaluator.h>
 
 #include <model/include/Model.h>
@@ -53,11 +55,13 @@ int main(int argc, char* argv[])
         common::ParsedDataLoadArguments dataLoadArguments;
         common::ParsedMapLoadArguments mapLoadArguments;
         common::ParsedModelSaveArguments modelSaveArguments;
+        common::ParsedSweepingTrainerArguments sweepingTrainerArguments;
 
         commandLineParser.AddOptionSet(trainerArguments);
         commandLineParser.AddOptionSet(dataLoadArguments);
         commandLineParser.AddOptionSet(mapLoadArguments);
         commandLineParser.AddOptionSet(modelSaveArguments);
+        commandLineParser.AddOptionSet(sweepingTrainerArguments);
 
         // parse command line
         commandLineParser.Parse();
@@ -81,8 +85,7 @@ int main(int argc, char* argv[])
 
         // load dataset
         if (trainerArguments.verbose) std::cout << "Loading data ..." << std::endl;
-        auto stream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
-        auto parsedDataset = common::GetDataset(stream);
+        auto parsedDataset = common::GetDataset(dataLoadArguments.inputDataFilename);
         auto mappedDataset = common::TransformDataset(parsedDataset, map);
         auto mappedDatasetDimension = map.GetOutput(0).Size();
 
@@ -90,7 +93,8 @@ int main(int argc, char* argv[])
         using PredictorType = predictors::LinearPredictor<double>;
         using LinearPredictorNodeType = nodes::LinearPredictorNode<double>;
 
-        // set up evaluators to only evaluate on the last update of the multi-epoch trainer
+        // set up evaluators to evaluate after every epoch, so that losing configurations can be dropped early. The
+        // sweeping trainer keeps the configuration with the highest value of the first aggregator, so AUC goes first.
         evaluators::EvaluatorParameters evaluatorParameters{ 1, false };
 
         // create trainers
@@ -100,17 +104,20 @@ int main(int argc, char* argv[])
         for (size_t i = 0; i < regularization.size(); ++i)
         {
             auto SGDTrainer = common::MakeSGDTrainer(trainerArguments.lossFunctionArguments, generator.GenerateParameters(i));
-            evaluators.push_back(common::MakeEvaluator<PredictorType>(mappedDataset.GetAnyDataset(), evaluatorParameters, trainerArguments.lossFunctionArguments));
+            evaluators.push_back(evaluators::MakeEvaluator<PredictorType>(mappedDataset.GetAnyDataset(), evaluatorParameters, evaluators::AUCAggregator(), evaluators::BinaryErrorAggregator()));
             evaluatingTrainers.push_back(trainers::MakeEvaluatingTrainer(std::move(SGDTrainer), evaluators.back()));
         }
 
         // create meta trainer
-        auto trainer = trainers::MakeSweepingTrainer(std::move(evaluatingTrainers));
+        auto trainer = trainers::MakeSweepingTrainer(std::move(evaluatingTrainers), sweepingTrainerArguments);
 
         // train
         if (trainerArguments.verbose) std::cout << "Training ..." << std::endl;
         trainer->SetDataset(mappedDataset.GetAnyDataset());
-        trainer->Update();
+        for (size_t epoch = 0; epoch < trainerArguments.numEpochs; ++epoch)
+        {
+            trainer->Update();
+        }
         PredictorType predictor(trainer->GetPredictor());
         predictor.Resize(mappedDatasetDimension);
 
@@ -133,7 +140,7 @@ int main(int argc, char* argv[])
         {
             // Create a model
             auto model = common::AppendNodeToModel<LinearPredictorNodeType, PredictorType>(map, predictor);
-            common::SaveModel(model, modelSaveArguments.outputModelFilename);
+            common::SaveModel(model, modelSaveArguments.outputModelFilename, modelSaveArguments.outputModelFormat);
         }
     }
     catch (const utilities::CommandLineParserPrintHelpException& exception)
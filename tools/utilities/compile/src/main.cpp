@@ -10,10 +10,12 @@
 
 #include <data/include/Dataset.h>
 
+#include <common/include/ArchiveFormat.h>
 #include <common/include/LoadModel.h>
 #include <common/include/MapCompilerArguments.h>
 #include <common/include/MapLoadArguments.h>
 
+#include <model/include/CompilationCache.h>
 #include <model/include/IRCompiledMap.h>
 #include <model/include/IRMapCompiler.h>
 #include <model/include/Map.h>
@@ -24,13 +26,18 @@
 
 #include <utilities/include/CommandLineParser.h>
 #include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
 #include <utilities/include/Logger.h>
 #include <utilities/include/MillisecondTimer.h>
 
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 using namespace ell;
 using namespace utilities::logging;
@@ -88,11 +95,97 @@ private:
     }
 };
 
-std::string GetObjExtension(model::IRCompiledMap& map)
+std::string GetObjExtension()
 {
     return ".o";
 }
 
+// The suffixes of the output files the arguments ask for
+std::vector<std::string> GetOutputFileSuffixes(const ParsedCompileArguments& compileArguments, const model::MapCompilerOptions& settings)
+{
+    std::vector<std::string> suffixes;
+    if (compileArguments.outputCompiledMap) suffixes.push_back("_compiled.ell");
+    if (compileArguments.outputHeader) suffixes.push_back(".h");
+    if (compileArguments.outputIr) suffixes.push_back(".ll");
+    if (compileArguments.outputBitcode) suffixes.push_back(".bc");
+    if (compileArguments.outputAssembly) suffixes.push_back(".s");
+    if (compileArguments.outputObjectCode) suffixes.push_back(GetObjExtension());
+    if (settings.compilerSettings.externalWeights) suffixes.push_back(".weights");
+    if (compileArguments.outputSwigInterface)
+    {
+        suffixes.push_back(".i.h");
+        suffixes.push_back(".i");
+    }
+    return suffixes;
+}
+
+// A description of everything the output files depend on: the map itself and all the options used to compile it
+std::string GetCompiledOutputDescription(const model::Map& map, const model::MapCompilerOptions& settings, const model::ModelOptimizerOptions& optimizerOptions, const std::string& baseFilename)
+{
+    std::stringstream description;
+    description << "outputs: " << utilities::GetFileName(baseFilename) << '\n'
+                << model::GetCompilationCacheDescription(settings);
+
+    const auto& optimizerProperties = optimizerOptions.AsPropertyBag();
+    auto optimizerKeys = optimizerProperties.Keys();
+    std::sort(optimizerKeys.begin(), optimizerKeys.end());
+    for (const auto& key : optimizerKeys)
+    {
+        description << key << ": " << optimizerProperties.GetEntry(key).ToString() << '\n';
+    }
+
+    // The tuned convolution methods change the compiled map without changing the options
+    auto convolutionTuningCache = optimizerProperties.GetEntry<std::string>("convolutionTuningCache", "");
+    if (!convolutionTuningCache.empty() && utilities::FileExists(convolutionTuningCache))
+    {
+        auto stream = utilities::OpenBinaryIfstream(convolutionTuningCache);
+        description << "convolutionTuningCache contents: " << std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()) << '\n';
+    }
+
+    description << "map: ";
+    common::SaveMap(map, description, common::ArchiveFormat::binary);
+    return description.str();
+}
+
+std::string GetOutputCacheKey(const std::string& description, const std::string& suffix)
+{
+    return model::CompilationCache::GetKey(description + "\noutput: " + suffix);
+}
+
+// Writes the output files from the cache if all of them are there
+bool TryReuseCompiledOutputs(model::CompilationCache& cache, const std::string& description, const std::vector<std::string>& suffixes, const std::string& baseFilename)
+{
+    std::vector<std::string> contents(suffixes.size());
+    for (size_t index = 0; index < suffixes.size(); ++index)
+    {
+        if (!cache.TryGetEntry(GetOutputCacheKey(description, suffixes[index]), contents[index]))
+        {
+            return false;
+        }
+    }
+
+    for (size_t index = 0; index < suffixes.size(); ++index)
+    {
+        auto stream = utilities::OpenBinaryOfstream(baseFilename + suffixes[index]);
+        stream.write(contents[index].data(), contents[index].size());
+    }
+    return true;
+}
+
+void AddCompiledOutputsToCache(model::CompilationCache& cache, const std::string& description, const std::vector<std::string>& suffixes, const std::string& baseFilename)
+{
+    for (const auto& suffix : suffixes)
+    {
+        auto stream = utilities::OpenBinaryIfstream(baseFilename + suffix);
+        cache.SetEntry(GetOutputCacheKey(description, suffix), { std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() });
+    }
+}
+
+void ReportCompilationCache(const std::string& name, const model::CompilationCache& cache)
+{
+    std::cout << name << ": " << cache.NumHits() << " hits, " << cache.NumMisses() << " misses (" << 100.0 * cache.GetHitRate() << "% hit rate)" << std::endl;
+}
+
 void ProduceMapOutput(ParsedCompileArguments& compileArguments, common::ParsedMapCompilerArguments& mapCompilerArguments, common::MapLoadArguments& mapLoadArguments, model::Map& map)
 {
     std::stringstream timingOutput;
@@ -137,12 +230,39 @@ void ProduceMapOutput(ParsedCompileArguments& compileArguments, common::ParsedMa
 
     auto optimizerOptions = mapCompilerArguments.GetModelOptimizerOptions();
 
+    // If nothing about the map or the options has changed since an earlier run, its outputs are reused as they are
+    auto useCompilationCache = !settings.compilationCache.empty();
+    std::unique_ptr<model::CompilationCache> outputCache;
+    std::string outputDescription;
+    auto outputSuffixes = GetOutputFileSuffixes(compileArguments, settings);
+    if (useCompilationCache)
+    {
+        outputCache = std::make_unique<model::CompilationCache>(settings.compilationCache);
+        outputDescription = GetCompiledOutputDescription(map, settings, optimizerOptions, baseFilename);
+        if (TryReuseCompiledOutputs(*outputCache, outputDescription, outputSuffixes, baseFilename))
+        {
+            std::cout << "Compilation cache: reused the outputs of an earlier compilation of the same map" << std::endl;
+            return;
+        }
+    }
+
     model::IRMapCompiler compiler(settings, optimizerOptions);
-    TimingOutputCollector timer(timingOutput, "Time to compile map", compileArguments.verbose);
+    TimingOutputCollector timer(timingOutput, "Time to compile map", compileArguments.verbose || useCompilationCache);
 
     auto compiledMap = compiler.Compile(map);
     timer.Stop();
 
+    if (auto cache = compiler.GetCompilationCache())
+    {
+        ReportCompilationCache("Compilation cache (node functions)", *cache);
+    }
+
+    if (auto planner = compiler.GetPortMemoryPlanner())
+    {
+        std::cout << "Port memory: " << planner->GetArenaSize() << " bytes in shared arena for " << planner->NumBuffers() << " buffers ("
+                  << planner->GetUnsharedSize() << " bytes without sharing)" << std::endl;
+    }
+
     if (compileArguments.outputCompiledMap)
     {
         TimingOutputCollector timer(timingOutput, "Time to save compiled map", compileArguments.verbose);
@@ -173,9 +293,16 @@ void ProduceMapOutput(ParsedCompileArguments& compileArguments, common::ParsedMa
         if (compileArguments.outputObjectCode)
         {
             TimingOutputCollector timer(timingOutput, "Time to save object code", compileArguments.verbose);
-            compiledMap.WriteCode(baseFilename + GetObjExtension(compiledMap), emitters::ModuleOutputFormat::objectCode);
+            compiledMap.WriteCode(baseFilename + GetObjExtension(), emitters::ModuleOutputFormat::objectCode);
         }
     }
+    if (settings.compilerSettings.externalWeights)
+    {
+        TimingOutputCollector timer(timingOutput, "Time to save weights", compileArguments.verbose);
+        auto& module = compiledMap.GetModule();
+        module.WriteExternalWeights(baseFilename + ".weights");
+        std::cout << "Weights: " << module.GetExternalWeights().size() << " bytes written to " << baseFilename << ".weights" << std::endl;
+    }
     if (compileArguments.outputSwigInterface)
     {
         TimingOutputCollector timer(timingOutput, "Time to save SWIG interface", compileArguments.verbose);
@@ -183,7 +310,12 @@ void ProduceMapOutput(ParsedCompileArguments& compileArguments, common::ParsedMa
         compiledMap.WriteCode(baseFilename + ".i", emitters::ModuleOutputFormat::swigInterface);
     }
 
-    if (compileArguments.verbose)
+    if (outputCache)
+    {
+        AddCompiledOutputsToCache(*outputCache, outputDescription, outputSuffixes, baseFilename);
+    }
+
+    if (compileArguments.verbose || useCompilationCache)
     {
         std::cout << timingOutput.str();
     }
@@ -0,0 +1,45 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConvertDatasetArguments.h (convertDataset)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <utilities/include/CommandLineParser.h>
+
+#include <string>
+
+namespace ell
+{
+/// <summary> Command line arguments for the convertDataset executable. </summary>
+struct ConvertDatasetArguments
+{
+    /// <summary> The path of the binary dataset file to write. </summary>
+    std::string outputDataFilename;
+
+    /// <summary> Parse the labels as class indices. </summary>
+    bool multiClass = false;
+
+    /// <summary> Time loading the text file, sequentially and in parallel, against loading the binary file. </summary>
+    bool benchmark = false;
+};
+
+/// <summary> Parsed command line arguments for the convertDataset executable. </summary>
+struct ParsedConvertDatasetArguments : public ConvertDatasetArguments
+    , public utilities::ParsedArgSet
+{
+    /// <summary> Adds the arguments to the command line parser. </summary>
+    ///
+    /// <param name="parser"> [in,out] The parser. </param>
+    void AddArgs(utilities::CommandLineParser& parser) override;
+
+    /// <summary> Check the parsed arguments. </summary>
+    ///
+    /// <param name="parser"> The parser. </param>
+    ///
+    /// <returns> An utilities::CommandLineParseResult. </returns>
+    utilities::CommandLineParseResult PostProcess(const utilities::CommandLineParser& parser) override;
+};
+} // namespace ell
@@ -0,0 +1,45 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConvertDatasetArguments.cpp (convertDataset)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ConvertDatasetArguments.h"
+
+namespace ell
+{
+void ParsedConvertDatasetArguments::AddArgs(utilities::CommandLineParser& parser)
+{
+    parser.AddOption(
+        outputDataFilename,
+        "outputDataFilename",
+        "odf",
+        "Path to the binary dataset file to write.",
+        "");
+
+    parser.AddOption(
+        multiClass,
+        "multiClass",
+        "mc",
+        "Parse the labels of the text file as class indices.",
+        false);
+
+    parser.AddOption(
+        benchmark,
+        "benchmark",
+        "",
+        "Report how long loading the text file, on one thread and on all of them, and loading the binary file take.",
+        false);
+}
+
+utilities::CommandLineParseResult ParsedConvertDatasetArguments::PostProcess(const utilities::CommandLineParser& parser)
+{
+    std::vector<std::string> errors;
+    if (outputDataFilename.empty())
+    {
+        errors.push_back("outputDataFilename is required");
+    }
+    return errors;
+}
+} // namespace ell
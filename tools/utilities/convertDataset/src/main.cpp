@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     main.cpp (convertDataset)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ConvertDatasetArguments.h"
+
+#include <utilities/include/CommandLineParser.h>
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+
+#include <data/include/BinaryDataset.h>
+
+#include <common/include/DataLoadArguments.h>
+#include <common/include/DataLoaders.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace ell;
+
+namespace
+{
+template <typename ExampleIteratorType>
+size_t AddExamples(ExampleIteratorType exampleIterator, data::BinaryDatasetWriter& writer)
+{
+    while (exampleIterator.IsValid())
+    {
+        const auto& example = exampleIterator.Get();
+        writer.AddExample(example.GetDataVector(), example.GetMetadata());
+        exampleIterator.Next();
+    }
+    return writer.NumExamples();
+}
+
+size_t GetFileSize(const std::string& filepath)
+{
+    auto stream = utilities::OpenBinaryIfstream(filepath);
+    stream.seekg(0, std::ios::end);
+    return static_cast<size_t>(stream.tellg());
+}
+
+template <typename Function>
+double TimeMilliseconds(Function function)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    function();
+    auto elapsed = std::chrono::high_resolution_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        // create a command line parser
+        utilities::CommandLineParser commandLineParser(argc, argv);
+
+        // add arguments to the command line parser
+        common::ParsedDataLoadArguments dataLoadArguments;
+        ParsedConvertDatasetArguments convertDatasetArguments;
+
+        commandLineParser.AddOptionSet(dataLoadArguments);
+        commandLineParser.AddOptionSet(convertDatasetArguments);
+
+        // parse command line
+        commandLineParser.Parse();
+
+        const auto inputFilename = dataLoadArguments.GetDataFilePath();
+        data::BinaryDatasetWriter writer(convertDatasetArguments.outputDataFilename);
+        auto stream = utilities::OpenIfstream(inputFilename);
+        if (convertDatasetArguments.multiClass)
+        {
+            AddExamples(common::GetAutoSupervisedMultiClassExampleIterator(stream), writer);
+        }
+        else
+        {
+            AddExamples(common::GetAutoSupervisedExampleIterator(stream), writer);
+        }
+        writer.Write();
+        std::cout << "Wrote " << writer.NumExamples() << " examples to " << convertDatasetArguments.outputDataFilename << std::endl;
+
+        if (convertDatasetArguments.benchmark)
+        {
+            const auto numThreads = std::max(1u, std::thread::hardware_concurrency());
+            const auto megabytes = GetFileSize(inputFilename) / (1024.0 * 1024.0);
+            size_t numSequentialExamples = 0;
+            size_t numParallelExamples = 0;
+            size_t numBinaryExamples = 0;
+            auto sequentialTime = TimeMilliseconds([&] {
+                auto textStream = utilities::OpenIfstream(inputFilename);
+                numSequentialExamples = common::GetDataset(textStream).NumExamples();
+            });
+            auto parallelTime = TimeMilliseconds([&] {
+                auto textStream = utilities::OpenIfstream(inputFilename);
+                numParallelExamples = common::GetDataset(textStream, numThreads).NumExamples();
+            });
+            auto binaryTime = TimeMilliseconds([&] { numBinaryExamples = common::GetDataset(convertDatasetArguments.outputDataFilename).NumExamples(); });
+            if (numSequentialExamples != numParallelExamples || numSequentialExamples != numBinaryExamples)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::badData, "The datasets loaded in different ways don't have the same number of examples");
+            }
+
+            std::cout << "Text load time, 1 thread (ms):\t" << sequentialTime << "\t(" << megabytes * 1000 / sequentialTime << " MB/s)" << std::endl;
+            std::cout << "Text load time, " << numThreads << " threads (ms):\t" << parallelTime << "\t(" << megabytes * 1000 / parallelTime << " MB/s, "
+                      << megabytes * 1000 / parallelTime / numThreads << " MB/s per core)" << std::endl;
+            std::cout << "Binary load time (ms):\t" << binaryTime << std::endl;
+            if (binaryTime > 0)
+            {
+                std::cout << "Speedup over parallel text loading:\t" << parallelTime / binaryTime << std::endl;
+            }
+        }
+    }
+    catch (const utilities::CommandLineParserPrintHelpException& exception)
+    {
+        std::cout << exception.GetHelpText() << std::endl;
+        return 0;
+    }
+    catch (const utilities::CommandLineParserErrorException& exception)
+    {
+        std::cerr << "Command line parse error:" << std::endl;
+        for (const auto& error : exception.GetParseErrors())
+        {
+            std::cerr << error.GetMessage() << std::endl;
+        }
+        return 1;
+    }
+    catch (const utilities::Exception& exception)
+    {
+        std::cerr << "exception: " << exception.GetMessage() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
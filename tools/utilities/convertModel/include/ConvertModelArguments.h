@@ -0,0 +1,33 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConvertModelArguments.h (convertModel)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <utilities/include/CommandLineParser.h>
+
+#include <string>
+
+namespace ell
+{
+struct ConvertModelArguments
+{
+    /// <summary> Time loading the input file against loading the converted file. </summary>
+    bool benchmark = false;
+
+    /// <summary> The number of times to load each file when benchmarking. </summary>
+    size_t numBenchmarkIterations = 1;
+};
+
+struct ParsedConvertModelArguments : public ConvertModelArguments
+    , public utilities::ParsedArgSet
+{
+    /// <summary> Adds the arguments to the command line parser. </summary>
+    ///
+    /// <param name="parser"> [in,out] The parser. </param>
+    void AddArgs(utilities::CommandLineParser& parser) override;
+};
+} // namespace ell
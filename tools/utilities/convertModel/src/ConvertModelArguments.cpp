@@ -0,0 +1,28 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConvertModelArguments.cpp (convertModel)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ConvertModelArguments.h"
+
+namespace ell
+{
+void ParsedConvertModelArguments::AddArgs(utilities::CommandLineParser& parser)
+{
+    parser.AddOption(
+        benchmark,
+        "benchmark",
+        "",
+        "Report how long loading the input file and loading the converted file take.",
+        false);
+
+    parser.AddOption(
+        numBenchmarkIterations,
+        "numBenchmarkIterations",
+        "",
+        "The number of times to load each file when benchmarking (the fastest time is reported).",
+        1);
+}
+} // namespace ell
@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     main.cpp (convertModel)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ConvertModelArguments.h"
+
+#include <common/include/LoadModel.h>
+#include <common/include/MapLoadArguments.h>
+#include <common/include/MapSaveArguments.h>
+
+#include <model/include/Map.h>
+#include <model/include/Model.h>
+
+#include <utilities/include/BinaryArchiver.h>
+#include <utilities/include/CommandLineParser.h>
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <string>
+
+using namespace ell;
+
+namespace
+{
+size_t GetFileSize(const std::string& filepath)
+{
+    auto stream = utilities::OpenBinaryIfstream(filepath);
+    stream.seekg(0, std::ios::end);
+    return static_cast<size_t>(stream.tellg());
+}
+
+std::string GetFormatName(const std::string& filepath)
+{
+    auto stream = utilities::OpenBinaryIfstream(filepath);
+    return utilities::BinaryUnarchiver::IsBinaryArchive(stream) ? "binary" : "json";
+}
+
+template <typename Function>
+double TimeMilliseconds(Function function, size_t numIterations)
+{
+    double bestTime = std::numeric_limits<double>::max();
+    for (size_t iteration = 0; iteration < std::max<size_t>(numIterations, 1); ++iteration)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        function();
+        auto elapsed = std::chrono::high_resolution_clock::now() - start;
+        bestTime = std::min(bestTime, std::chrono::duration<double, std::milli>(elapsed).count());
+    }
+    return bestTime;
+}
+
+size_t LoadModelOrMap(const std::string& filename, bool isMap)
+{
+    return isMap ? common::LoadMap(filename).GetModel().Size() : common::LoadModel(filename).Size();
+}
+
+void PrintLoadTime(const std::string& filename, double milliseconds)
+{
+    std::cout << GetFormatName(filename) << " load time (ms):\t" << milliseconds << "\t(" << GetFileSize(filename) << " bytes, " << filename << ")" << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        // create a command line parser
+        utilities::CommandLineParser commandLineParser(argc, argv);
+
+        // add arguments to the command line parser
+        common::ParsedMapLoadArguments mapLoadArguments;
+        common::ParsedMapSaveArguments mapSaveArguments;
+        ParsedConvertModelArguments convertModelArguments;
+
+        commandLineParser.AddOptionSet(mapLoadArguments);
+        commandLineParser.AddOptionSet(mapSaveArguments);
+        commandLineParser.AddOptionSet(convertModelArguments);
+
+        // parse command line
+        commandLineParser.Parse();
+
+        if (!mapLoadArguments.HasInputFilename())
+        {
+            std::cout << commandLineParser.GetHelpString() << std::endl;
+            return 1;
+        }
+
+        // models are converted without turning them into maps, since not all models have input and output nodes
+        const bool isMap = mapLoadArguments.HasMapFilename();
+        const auto inputFilename = mapLoadArguments.GetInputFilename();
+        std::ostream& outputStream = mapSaveArguments.outputMapStream;
+        if (isMap)
+        {
+            common::SaveMap(common::LoadMap(inputFilename), outputStream, mapSaveArguments.outputMapFormat);
+        }
+        else
+        {
+            common::SaveModel(common::LoadModel(inputFilename), outputStream, mapSaveArguments.outputMapFormat);
+        }
+        outputStream.flush();
+
+        if (convertModelArguments.benchmark)
+        {
+            const auto& outputFilename = mapSaveArguments.outputMapFilename;
+            if (outputFilename.empty() || outputFilename == "null")
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Benchmarking needs an output file");
+            }
+
+            const auto numIterations = convertModelArguments.numBenchmarkIterations;
+            size_t numInputNodes = 0;
+            size_t numOutputNodes = 0;
+            auto inputTime = TimeMilliseconds([&] { numInputNodes = LoadModelOrMap(inputFilename, isMap); }, numIterations);
+            auto outputTime = TimeMilliseconds([&] { numOutputNodes = LoadModelOrMap(outputFilename, isMap); }, numIterations);
+            if (numInputNodes != numOutputNodes)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::badData, "The input and converted models don't have the same number of nodes");
+            }
+
+            std::cout << "Nodes:\t" << numInputNodes << std::endl;
+            PrintLoadTime(inputFilename, inputTime);
+            PrintLoadTime(outputFilename, outputTime);
+            if (outputTime > 0)
+            {
+                std::cout << "Speedup:\t" << inputTime / outputTime << std::endl;
+            }
+        }
+    }
+    catch (const utilities::CommandLineParserPrintHelpException& exception)
+    {
+        std::cout << exception.GetHelpText() << std::endl;
+        return 0;
+    }
+    catch (const utilities::CommandLineParserErrorException& exception)
+    {
+        std::cerr << "Command line parse error:" << std::endl;
+        for (const auto& error : exception.GetParseErrors())
+        {
+            std::cerr << error.GetMessage() << std::endl;
+        }
+        return 1;
+    }
+    catch (const utilities::Exception& exception)
+    {
+        std::cerr << "exception: " << exception.GetMessage() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -67,6 +67,8 @@ struct FineTuneArguments
     bool multiClass = true;
     std::string dataFormat;
     int maxCacheEntries = 8;
+    int maxCacheMemory = 0; // in MB
+    std::string cacheDirectory;
 
     // Node selection
     int numPrefixNodesToSkip = 0;
@@ -87,6 +89,7 @@ struct FineTuneArguments
     bool normalizeOutputs = false;
     bool reoptimizeSparseWeights = false;
     bool optimizeFiltersIndependently = false;
+    int numThreads = 1;
     bool permute = true;
     TargetNodeFlags fineTuneTargets = TargetNodeType::fullConvolution | TargetNodeType::pointwiseConvolution | TargetNodeType::fullyConnected;
 
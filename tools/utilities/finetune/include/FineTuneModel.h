@@ -74,6 +74,7 @@ struct FineTuningLayerResult
     FineTuningStats statistics;
     std::chrono::milliseconds::rep dataTransformTime;
     std::chrono::milliseconds::rep optimizationTime;
+    std::chrono::milliseconds::rep cacheTimeSaved = 0;
 };
 
 /// <summary> Various outputs and statistics from the fine-tuning process. </summary>
@@ -83,6 +84,7 @@ struct FineTuningResult
     ell::model::Submodel fineTunedSubmodel;
     std::chrono::milliseconds::rep dataTransformTime;
     std::chrono::milliseconds::rep optimizationTime;
+    std::chrono::milliseconds::rep cacheTimeSaved;
 };
 
 // Functions
@@ -12,34 +12,93 @@
 
 #include <model/include/OutputPort.h>
 
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <optional>
+#include <string>
 #include <unordered_map>
 
 namespace ell
 {
-/// <summary> Caches the results from running a dataset through a model. </summary>
+/// <summary>
+/// Caches the results from running a dataset through a model. When the cache is over its entry or memory limit, the
+/// least-recently-used entries are evicted. If the cache has a spill directory, evicted entries are compressed and
+/// written to a file there, and are read back (through a memory-mapped file) the next time they're used.
+/// </summary>
 class ModelOutputDataCache
 {
 public:
     ModelOutputDataCache();
-    ModelOutputDataCache(int maxCacheSize);
+
+    /// <summary> Constructor </summary>
+    ///
+    /// <param name="maxCacheSize"> The maximum number of entries to keep in memory, or 0 for no limit. </param>
+    /// <param name="maxCacheMemory"> The maximum number of bytes of data to keep in memory, or 0 for no limit. </param>
+    /// <param name="spillDirectory"> The directory to write evicted entries to. If empty, evicted entries are discarded. </param>
+    ModelOutputDataCache(int maxCacheSize, size_t maxCacheMemory = 0, const std::string& spillDirectory = "");
+
+    ModelOutputDataCache(const ModelOutputDataCache&) = delete;
+    ModelOutputDataCache& operator=(const ModelOutputDataCache&) = delete;
+
+    /// <summary> Destructor. Deletes the files of the spilled entries. </summary>
+    ~ModelOutputDataCache();
+
     bool HasCachedData(const ell::model::OutputPortBase* port) const;
-    const UnlabeledDataContainer& GetCachedData(const ell::model::OutputPortBase* port) const;
+    const UnlabeledDataContainer& GetCachedData(const ell::model::OutputPortBase* port);
     void RemoveCachedData(const ell::model::OutputPortBase* port);
-    void SetCachedData(const ell::model::OutputPortBase* port, UnlabeledDataContainer data);
+
+    /// <summary> Adds or replaces an entry. </summary>
+    ///
+    /// <param name="port"> The port whose output the data is. </param>
+    /// <param name="data"> The output data. </param>
+    /// <param name="computeTime"> The time it took to compute the data, which is counted as saved each time the entry is used. </param>
+    void SetCachedData(const ell::model::OutputPortBase* port, UnlabeledDataContainer data, std::chrono::milliseconds::rep computeTime = 0);
+
+    /// <summary> Starts reading an entry that has been spilled to disk on a background thread, so it's ready when it's used next.
+    /// The entry's memory counts against the cache's memory limit from the time it's started. </summary>
+    ///
+    /// <param name="port"> The port whose output to read. Nothing happens if it isn't cached, or if its data is already in memory. </param>
+    void Prefetch(const ell::model::OutputPortBase* port);
+
+    /// <summary> Gets the number of bytes of data in memory. </summary>
+    size_t GetMemoryUsage() const { return _memoryUsage; }
+
+    /// <summary> Gets the number of entries that are spilled to disk, and not also in memory. </summary>
+    int NumSpilledEntries() const;
+
+    /// <summary> Gets the total time saved by using cached entries instead of recomputing them, less the time spent reading spilled entries. </summary>
+    std::chrono::milliseconds::rep GetTimeSaved() const { return _timeSaved; }
 
     // ??
     const ell::model::OutputPortBase* FindNearestCachedOutputPort(const ell::model::OutputPortBase* output);
 
 private:
-    void RemoveLeastRecentlyUsedEntry();
-
     struct CacheEntry
     {
         int64_t generation;
-        UnlabeledDataContainer data;
+        std::optional<UnlabeledDataContainer> data; // empty if the entry is only on disk
+        size_t size = 0; // size of the data, in bytes
+        std::chrono::milliseconds::rep computeTime = 0;
+        std::string spillFilePath; // empty if the entry hasn't been spilled
+        std::future<UnlabeledDataContainer> prefetchedData;
     };
-    mutable std::unordered_map<const ell::model::OutputPortBase*, CacheEntry> _cache;
-    mutable int64_t _currentGeneration = 0;
+
+    void MakeRoom(size_t size);
+    void RemoveLeastRecentlyUsedEntry();
+    void EvictEntry(CacheEntry& entry);
+    void LoadEntry(CacheEntry& entry);
+    void DeleteEntry(CacheEntry& entry);
+    int NumEntriesInMemory() const;
+
+    std::unordered_map<const ell::model::OutputPortBase*, CacheEntry> _cache;
+    int64_t _currentGeneration = 0;
     int _maxCacheSize = 0;
+    size_t _maxCacheMemory = 0;
+    size_t _memoryUsage = 0;
+    std::string _spillDirectory;
+    std::string _spillFilePrefix; // keeps the files of caches sharing a spill directory apart
+    int _numSpillFiles = 0;
+    std::chrono::milliseconds::rep _timeSaved = 0;
 };
 } // namespace ell
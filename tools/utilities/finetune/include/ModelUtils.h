@@ -12,6 +12,8 @@
 #include "DataUtils.h"
 #include "OptimizationUtils.h"
 
+#include <common/include/ArchiveFormat.h>
+
 #include <math/include/Matrix.h>
 #include <math/include/Vector.h>
 
@@ -53,7 +55,7 @@ struct FullyConnectedParameters
 };
 
 // I/O
-void SaveModel(const ell::model::OutputPortBase& output, std::string filename);
+void SaveModel(const ell::model::OutputPortBase& output, std::string filename, ell::common::ArchiveFormat format = ell::common::ArchiveFormat::json);
 
 // Querying nodes
 bool IsInputNode(const ell::model::Node* node);
@@ -60,6 +60,7 @@ struct FineTuneOptimizationParameters
 
     // optimization params
     bool optimizeFiltersIndependently = false;
+    int numThreads = 1; // for optimizing filters independently (0 = one per hardware thread)
     ell::optimization::SDCAOptimizerParameters optimizerParameters;
     int maxEpochs = 0;
     double desiredPrecision = 0;
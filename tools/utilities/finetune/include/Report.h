@@ -50,7 +50,7 @@ private:
     void WriteLayerRegularizationParameters(std::string nodeType, std::string nodeId, double l2Regularization, double l1Regularization);
     void WriteLayerStatistics(std::string nodeType, std::string nodeId, std::string tag, std::string statsType, const DataStatistics& statistics);
     void WriteLayerActivationStatistics(std::string nodeType, std::string nodeId, const DataStatistics& originalStatistics, const std::optional<DataStatistics>& unnormalizedFineTunedStatistics, const std::optional<DataStatistics>& fineTunedStatistics);
-    void WriteLayerTiming(std::string nodeType, std::string nodeId, int transformTime, int optimizationTime);
+    void WriteLayerTiming(std::string nodeType, std::string nodeId, int transformTime, int optimizationTime, int cacheTimeSaved);
 
     template <typename ValueType>
     void WriteKeyValue(std::string key, const ValueType& value);
@@ -72,6 +72,7 @@ FineTuneOptimizationParameters FineTuneArguments::GetFineTuneParameters() const
     params.desiredPrecision = desiredPrecision;
     params.requiredPrecision = requiredPrecision;
     params.optimizeFiltersIndependently = optimizeFiltersIndependently;
+    params.numThreads = numThreads;
     params.randomSeed = randomSeed;
     return params;
 }
@@ -232,6 +233,18 @@ void InitArguments(utilities::CommandLineParser& parser, FineTuneArguments& args
 
     parser.AddOption(args.dataFormat, "format", "", "Dataset format (GSDF, CIFAR, MNIST; default: guess)", "");
 
+    parser.AddOption(args.maxCacheMemory,
+                     "maxCacheMemory",
+                     "",
+                     "Maximum amount of memory, in MB, to use for caching the outputs of the model's layers (0 = no limit)",
+                     0);
+
+    parser.AddOption(args.cacheDirectory,
+                     "cacheDirectory",
+                     "",
+                     "Directory to write cached layer outputs to when they don't fit in memory, instead of recomputing them",
+                     "");
+
     parser.AddDocumentationString("");
     parser.AddDocumentationString("Node selection");
     parser.AddOption(args.numPrefixNodesToSkip, "skipStart", "", "Number of nodes in the beginning of the model to skip", 0);
@@ -278,6 +291,8 @@ void InitArguments(utilities::CommandLineParser& parser, FineTuneArguments& args
 
     parser.AddOption(args.optimizeFiltersIndependently, "optimizePerFilter", "", "Re-optimize filters independently", false);
 
+    parser.AddOption(args.numThreads, "numThreads", "", "Number of threads to use when optimizing filters independently, as for spatial convolutions (0 = one per hardware thread)", 1);
+
     parser.AddOption(args.reoptimizeSparseWeights, "reoptimizeSparseWeights", "", "Re-optimize sparsified weights", false);
 
     parser.AddOption(args.permute,
@@ -240,13 +240,14 @@ FineTuningResult FineTuneNodesInSubmodel(const Submodel& submodel,
     std::chrono::milliseconds::rep optimizationTime = 0;
     std::vector<FineTuningLayerResult> layerResults;
 
-    ModelOutputDataCache dataCache(args.maxCacheEntries);
+    ModelOutputDataCache dataCache(args.maxCacheEntries, static_cast<size_t>(args.maxCacheMemory) * 1024 * 1024, args.cacheDirectory);
 
     bool didModifyAnyNodes = false;
     auto problemParams = args.GetFineTuneProblemParameters();
     auto resultSubmodel = transformer.TransformSubmodel(submodel, context, [&problemParams, &didModifyAnyNodes, &layerResults, &dataTransformTime, &optimizationTime, &dataCache, &trainingData, &args, &layerCallback](const Node& node, ModelTransformer& transformer) {
         FineTuningLayerResult retrainingResult;
         auto action = GetNodeAction(node, args, didModifyAnyNodes);
+        auto cacheTimeSaved = dataCache.GetTimeSaved();
 
         if (action != FineTuneNodeAction::none)
         {
@@ -268,6 +269,7 @@ FineTuningResult FineTuneNodesInSubmodel(const Submodel& submodel,
             transformer.CopyNode(node);
             return;
         }
+        retrainingResult.cacheTimeSaved = dataCache.GetTimeSaved() - cacheTimeSaved;
         dataTransformTime += retrainingResult.dataTransformTime;
         optimizationTime += retrainingResult.optimizationTime;
         if (layerCallback)
@@ -277,7 +279,7 @@ FineTuningResult FineTuneNodesInSubmodel(const Submodel& submodel,
         layerResults.push_back(retrainingResult);
     });
 
-    return { layerResults, resultSubmodel, dataTransformTime, optimizationTime };
+    return { layerResults, resultSubmodel, dataTransformTime, optimizationTime, dataCache.GetTimeSaved() };
 }
 
 TargetNodeType GetConvNodeTargetType(const Node& node)
@@ -493,6 +495,10 @@ FineTuningLayerResult ApproximateSubmodelWithNewLayer(const MultiClassDataContai
 
     bool isSpatialConvolution = IsConvolutionalLayerNode(node) && GetConvolutionalNodeType(node) == ConvolutionalNodeType::spatial;
 
+    // The next layer's data is computed from these outputs, so if they've been spilled to disk, read them while the optimizer runs
+    dataCache.Prefetch(&submodelOutput);
+    dataCache.Prefetch(retrainingDataset.normalizedFeaturesOutput);
+
     // Run SDCA to find weights that map data1->data2
     utilities::MillisecondTimer optTimer;
     auto optimizerParameters = GetParametersForNodeAction(problemParameters, action);
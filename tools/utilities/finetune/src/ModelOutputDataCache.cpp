@@ -11,20 +11,140 @@
 #include <model/include/InputPort.h>
 
 #include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
 #include <utilities/include/Logger.h>
+#include <utilities/include/MemoryMappedFile.h>
+#include <utilities/include/MillisecondTimer.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
 
 namespace ell
 {
 using namespace ell::model;
 
+namespace
+{
+    size_t GetDataSize(const UnlabeledDataContainer& data)
+    {
+        size_t size = 0;
+        for (const auto& row : data)
+        {
+            size += row.Size() * sizeof(float);
+        }
+        return size;
+    }
+
+    // Activations are often mostly zero (e.g., after a ReLU), so each row is written as a sequence of
+    // runs, each one a count of zeros followed by a count of nonzero values and the values themselves
+    void WriteSpillFile(const std::string& path, const UnlabeledDataContainer& data)
+    {
+        auto stream = utilities::OpenBinaryOfstream(path);
+        auto write = [&stream](auto value) { stream.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+
+        write(static_cast<uint64_t>(data.Size()));
+        for (const auto& row : data)
+        {
+            const auto size = row.Size();
+            write(static_cast<uint64_t>(size));
+            size_t index = 0;
+            while (index < size)
+            {
+                auto zerosBegin = index;
+                while (index < size && row[index] == 0)
+                {
+                    ++index;
+                }
+                auto valuesBegin = index;
+                while (index < size && row[index] != 0)
+                {
+                    ++index;
+                }
+                write(static_cast<uint32_t>(valuesBegin - zerosBegin));
+                write(static_cast<uint32_t>(index - valuesBegin));
+                stream.write(reinterpret_cast<const char*>(row.GetConstDataPointer() + valuesBegin), (index - valuesBegin) * sizeof(float));
+            }
+        }
+
+        if (!stream)
+        {
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotWritable, "Unable to write cached data to " + path);
+        }
+    }
+
+    UnlabeledDataContainer ReadSpillFile(const std::string& path)
+    {
+        utilities::MemoryMappedFile file(path);
+        auto position = file.GetData();
+        const auto end = position + file.GetSize();
+        auto read = [&position, end, &path](void* destination, size_t size) {
+            if (static_cast<size_t>(end - position) < size)
+            {
+                throw utilities::DataFormatException(utilities::DataFormatErrors::abruptEnd, "Cached data file " + path + " is truncated");
+            }
+            std::memcpy(destination, position, size);
+            position += size;
+        };
+
+        uint64_t numRows = 0;
+        read(&numRows, sizeof(numRows));
+        UnlabeledDataContainer result;
+        std::vector<float> row;
+        for (uint64_t rowIndex = 0; rowIndex < numRows; ++rowIndex)
+        {
+            uint64_t size = 0;
+            read(&size, sizeof(size));
+            row.assign(size, 0.0f);
+            uint64_t index = 0;
+            while (index < size)
+            {
+                uint32_t numZeros = 0;
+                uint32_t numValues = 0;
+                read(&numZeros, sizeof(numZeros));
+                read(&numValues, sizeof(numValues));
+                if (numZeros == 0 && numValues == 0)
+                {
+                    throw utilities::DataFormatException(utilities::DataFormatErrors::badFormat, "Cached data file " + path + " is corrupt");
+                }
+                index += numZeros;
+                if (index + numValues > size)
+                {
+                    throw utilities::DataFormatException(utilities::DataFormatErrors::badFormat, "Cached data file " + path + " is corrupt");
+                }
+                read(row.data() + index, numValues * sizeof(float));
+                index += numValues;
+            }
+            result.Add({ row });
+        }
+        return result;
+    }
+} // namespace
+
 ModelOutputDataCache::ModelOutputDataCache() :
     _maxCacheSize(0)
 {
 }
 
-ModelOutputDataCache::ModelOutputDataCache(int maxCacheSize) :
-    _maxCacheSize(maxCacheSize)
+ModelOutputDataCache::ModelOutputDataCache(int maxCacheSize, size_t maxCacheMemory, const std::string& spillDirectory) :
+    _maxCacheSize(maxCacheSize),
+    _maxCacheMemory(maxCacheMemory),
+    _spillDirectory(spillDirectory)
 {
+    if (!_spillDirectory.empty())
+    {
+        utilities::EnsureDirectoryExists(_spillDirectory);
+        _spillFilePrefix = "cache" + std::to_string(std::random_device()()) + "_";
+    }
+}
+
+ModelOutputDataCache::~ModelOutputDataCache()
+{
+    for (auto& entry : _cache)
+    {
+        DeleteEntry(entry.second);
+    }
 }
 
 bool ModelOutputDataCache::HasCachedData(const ell::model::OutputPortBase* port) const
@@ -32,47 +152,177 @@ bool ModelOutputDataCache::HasCachedData(const ell::model::OutputPortBase* port)
     return _cache.find(port) != _cache.end();
 }
 
-const UnlabeledDataContainer& ModelOutputDataCache::GetCachedData(const ell::model::OutputPortBase* port) const
+const UnlabeledDataContainer& ModelOutputDataCache::GetCachedData(const ell::model::OutputPortBase* port)
 {
+    auto& entry = _cache.at(port);
     ++_currentGeneration;
-    _cache.at(port).generation = _currentGeneration;
-    return _cache.at(port).data;
+    entry.generation = _currentGeneration;
+    if (!entry.data)
+    {
+        LoadEntry(entry);
+    }
+    _timeSaved += entry.computeTime;
+    return *entry.data;
 }
 
 void ModelOutputDataCache::RemoveCachedData(const ell::model::OutputPortBase* port)
 {
-    _cache.erase(port);
+    auto it = _cache.find(port);
+    if (it == _cache.end())
+    {
+        return;
+    }
+
+    // An entry being prefetched already has its memory reserved
+    if (it->second.data || it->second.prefetchedData.valid())
+    {
+        _memoryUsage -= it->second.size;
+    }
+    DeleteEntry(it->second);
+    _cache.erase(it);
 }
 
-void ModelOutputDataCache::SetCachedData(const ell::model::OutputPortBase* port, UnlabeledDataContainer data)
+void ModelOutputDataCache::SetCachedData(const ell::model::OutputPortBase* port, UnlabeledDataContainer data, std::chrono::milliseconds::rep computeTime)
 {
+    RemoveCachedData(port);
+
     // if the cache is too big, first remove entries
-    while (_maxCacheSize > 0 && static_cast<int>(_cache.size()) >= _maxCacheSize)
+    auto size = GetDataSize(data);
+    MakeRoom(size);
+
+    auto& entry = _cache[port];
+    entry.generation = _currentGeneration;
+    entry.data = std::move(data);
+    entry.size = size;
+    entry.computeTime = computeTime;
+    _memoryUsage += size;
+}
+
+void ModelOutputDataCache::Prefetch(const ell::model::OutputPortBase* port)
+{
+    auto it = _cache.find(port);
+    if (it == _cache.end() || it->second.data || it->second.prefetchedData.valid())
     {
-        RemoveLeastRecentlyUsedEntry();
+        return;
     }
 
-    _cache[port] = { _currentGeneration, data };
+    // Don't prefetch an entry that can't fit in memory at all
+    auto& entry = it->second;
+    if (_maxCacheMemory > 0 && entry.size > _maxCacheMemory)
+    {
+        return;
+    }
+
+    // The prefetched data is in memory from the time it's read, so its memory is reserved now
+    MakeRoom(entry.size);
+    _memoryUsage += entry.size;
+
+    using namespace logging;
+    Log() << "Prefetching cached output " << port->GetFullName() << EOL;
+    auto path = entry.spillFilePath;
+    entry.prefetchedData = std::async(std::launch::async, [path]() { return ReadSpillFile(path); });
+}
+
+int ModelOutputDataCache::NumSpilledEntries() const
+{
+    return static_cast<int>(_cache.size()) - NumEntriesInMemory();
+}
+
+void ModelOutputDataCache::MakeRoom(size_t size)
+{
+    auto isFull = [this, size]() {
+        return (_maxCacheSize > 0 && NumEntriesInMemory() >= _maxCacheSize) ||
+               (_maxCacheMemory > 0 && _memoryUsage + size > _maxCacheMemory);
+    };
+    while (NumEntriesInMemory() > 0 && isFull())
+    {
+        RemoveLeastRecentlyUsedEntry();
+    }
 }
 
 void ModelOutputDataCache::RemoveLeastRecentlyUsedEntry()
 {
     using namespace logging;
     Log() << "Removing least-recently-used entry" << EOL;
-    if (_cache.empty())
+
+    auto lruEntry = _cache.end();
+    for (auto it = _cache.begin(); it != _cache.end(); ++it)
+    {
+        if (it->second.data && (lruEntry == _cache.end() || it->second.generation < lruEntry->second.generation))
+        {
+            lruEntry = it;
+        }
+    }
+    if (lruEntry == _cache.end())
     {
         return;
     }
 
-    auto lruEntry = _cache.begin();
-    for (auto it = _cache.begin(); it != _cache.end(); ++it)
+    if (_spillDirectory.empty())
+    {
+        _memoryUsage -= lruEntry->second.size;
+        DeleteEntry(lruEntry->second);
+        _cache.erase(lruEntry);
+    }
+    else
+    {
+        EvictEntry(lruEntry->second);
+    }
+}
+
+void ModelOutputDataCache::EvictEntry(CacheEntry& entry)
+{
+    // The data doesn't change once it's cached, so an entry that has been spilled before doesn't need to be written again
+    if (entry.spillFilePath.empty())
+    {
+        auto path = utilities::JoinPaths(_spillDirectory, _spillFilePrefix + std::to_string(_numSpillFiles++));
+        WriteSpillFile(path, *entry.data);
+        entry.spillFilePath = path;
+    }
+    entry.data.reset();
+    _memoryUsage -= entry.size;
+}
+
+void ModelOutputDataCache::LoadEntry(CacheEntry& entry)
+{
+    // Reading the entry counts against the time saved by caching it
+    utilities::MillisecondTimer timer;
+    auto wasPrefetched = entry.prefetchedData.valid();
+    auto data = wasPrefetched ? entry.prefetchedData.get() : ReadSpillFile(entry.spillFilePath);
+    _timeSaved -= timer.Elapsed();
+
+    // A prefetched entry's memory was reserved by Prefetch, but it may still need room under the entry limit
+    MakeRoom(wasPrefetched ? 0 : entry.size);
+    entry.data = std::move(data);
+    if (!wasPrefetched)
     {
-        if (it->second.generation < lruEntry->second.generation)
+        _memoryUsage += entry.size;
+    }
+}
+
+void ModelOutputDataCache::DeleteEntry(CacheEntry& entry)
+{
+    if (entry.prefetchedData.valid())
+    {
+        entry.prefetchedData.wait();
+    }
+    if (!entry.spillFilePath.empty())
+    {
+        std::remove(entry.spillFilePath.c_str());
+    }
+}
+
+int ModelOutputDataCache::NumEntriesInMemory() const
+{
+    int count = 0;
+    for (const auto& entry : _cache)
+    {
+        if (entry.second.data)
         {
-            lruEntry = it;
+            ++count;
         }
     }
-    _cache.erase(lruEntry);
+    return count;
 }
 
 const OutputPortBase* ModelOutputDataCache::FindNearestCachedOutputPort(const OutputPortBase* output)
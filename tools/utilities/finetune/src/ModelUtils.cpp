@@ -36,13 +36,13 @@ namespace
     }
 } // namespace
 
-void SaveModel(const OutputPortBase& output, std::string filename)
+void SaveModel(const OutputPortBase& output, std::string filename, common::ArchiveFormat format)
 {
     ModelTransformer transformer;
     TransformContext context;
     Submodel submodel({ &output });
     auto prunedSubmodel = transformer.CopySubmodel(submodel, context);
-    common::SaveModel(prunedSubmodel.GetModel(), filename);
+    common::SaveModel(prunedSubmodel.GetModel(), filename, format);
 }
 
 // Querying nodes
@@ -13,8 +13,11 @@
 
 #include <utilities/include/Exception.h>
 #include <utilities/include/Logger.h>
+#include <utilities/include/ParallelFor.h>
 
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 namespace ell
 {
@@ -132,35 +135,38 @@ VectorOptimizerResult TrainVectorPredictor(VectorLabelDataContainer dataset,
     VectorLabelSolution resultSolution;
     resultSolution.Resize(in0, out0);
 
-    Log() << "Optimizing " << outputChannels << " output channels independently\n";
+    const auto numThreads = std::min(utilities::GetNumThreads(static_cast<size_t>(std::max(optimizerParameters.numThreads, 0))), outputChannels);
+    Log() << "Optimizing " << outputChannels << " output channels independently on " << numThreads << " threads\n";
 
-    SolutionInfo solutionInfo;
-    for (size_t i = 0; i < outputChannels; ++i)
-    {
-        // For each output channel, create a tiny dataset that goes from the pixels under a filter support -> output value
-        VectorLabelDataContainer channelDataset;
-
-        if (isSpatialConvolution)
-        {
-            channelDataset = CreateSubBlockVectorLabelDataContainer(dataset, filterSizeSq, 1, i);
-        }
-        else
+    // The channels' problems are independent: each thread only reads the (shared) dataset, and writes its own channels' columns of the solution
+    std::vector<SolutionInfo> channelSolutionInfos(outputChannels);
+    utilities::ParallelFor(outputChannels, numThreads, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i)
         {
-            channelDataset = CreateSingleOutputVectorLabelDataContainer(dataset, i);
+            // For each output channel, create a tiny dataset that goes from the pixels under a filter support -> output value
+            VectorLabelDataContainer channelDataset;
+
+            if (isSpatialConvolution)
+            {
+                channelDataset = CreateSubBlockVectorLabelDataContainer(dataset, filterSizeSq, 1, i);
+            }
+            else
+            {
+                channelDataset = CreateSingleOutputVectorLabelDataContainer(dataset, i);
+            }
+
+            auto channelResult = TrainVectorPredictor(channelDataset, spatialParameters);
+
+            resultSolution.GetBias()[i] = channelResult.predictor.GetBias()[0];
+            resultSolution.GetMatrix().GetColumn(i).CopyFrom(channelResult.predictor.GetMatrix().GetColumn(0));
+            channelSolutionInfos[i] = channelResult.info;
         }
+    });
 
-        auto channelResult = TrainVectorPredictor(channelDataset, spatialParameters);
-
-        resultSolution.GetBias()[i] = channelResult.predictor.GetBias()[0];
-        resultSolution.GetMatrix().GetColumn(i).CopyFrom(channelResult.predictor.GetMatrix().GetColumn(0));
-
-        // For now, just keep the last solution info result.
-        // TODO: in the "trainFiltersIndependently" case, we should
-        // keep some kind of summary thing instead.
-        solutionInfo = channelResult.info;
-    }
-
-    return { resultSolution, solutionInfo, {} };
+    // For now, just keep the last solution info result.
+    // TODO: in the "trainFiltersIndependently" case, we should
+    // keep some kind of summary thing instead.
+    return { resultSolution, channelSolutionInfos.back(), {} };
 }
 
 VectorOptimizerResult TrainVectorPredictor(VectorLabelDataContainer dataset, const FineTuneOptimizationParameters& optimizerParameters)
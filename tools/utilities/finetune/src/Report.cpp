@@ -93,7 +93,7 @@ void Report::WriteLayerOptimizationResult(const FineTuningLayerResult& layerInfo
     WriteLayerStatistics(nodeType, nodeId, "Original", "Weights", layerInfo.statistics.originalWeightsStatistics);
     WriteLayerStatistics(nodeType, nodeId, "Final", "Weights", layerInfo.statistics.finalWeightsStatistics);
     WriteLayerActivationStatistics(nodeType, nodeId, layerInfo.statistics.originalActivationStatistics, layerInfo.statistics.rawFineTunedActivationStatistics, layerInfo.statistics.fineTunedActivationStatistics);
-    WriteLayerTiming(nodeType, nodeId, layerInfo.dataTransformTime, layerInfo.optimizationTime);
+    WriteLayerTiming(nodeType, nodeId, layerInfo.dataTransformTime, layerInfo.optimizationTime, layerInfo.cacheTimeSaved);
 }
 
 void Report::WriteLayerOptimizationInfo(std::string nodeType, std::string nodeId, const optimization::SDCASolutionInfo& info)
@@ -153,10 +153,11 @@ void Report::WriteLayerActivationStatistics(std::string nodeType, std::string no
     Flush();
 }
 
-void Report::WriteLayerTiming(std::string nodeType, std::string nodeId, int transformTime, int optimizationTime)
+void Report::WriteLayerTiming(std::string nodeType, std::string nodeId, int transformTime, int optimizationTime, int cacheTimeSaved)
 {
     WriteTiming(nodeType + "_" + nodeId + "_DataTransformTime", transformTime);
     WriteTiming(nodeType + "_" + nodeId + "_OptimizationTime", optimizationTime);
+    WriteTiming(nodeType + "_" + nodeId + "_CacheTimeSaved", cacheTimeSaved);
 }
 
 void Report::WriteModelAccuracy(std::string modelName, std::string datasetName, double accuracy)
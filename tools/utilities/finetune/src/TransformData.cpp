@@ -16,6 +16,7 @@
 
 #include <utilities/include/Logger.h>
 #include <utilities/include/MemoryLayout.h>
+#include <utilities/include/MillisecondTimer.h>
 
 #include <memory>
 #include <vector>
@@ -246,11 +247,13 @@ UnlabeledDataContainer TransformDataWithSubmodel(const UnlabeledDataContainer& d
         transformDataset = dataCache.GetCachedData(cachedOutput);
     }
 
+    utilities::MillisecondTimer timer;
     auto result = TransformDataWithSubmodel(transformDataset, transformSubmodel);
+    auto computeTime = timer.Elapsed();
 
     if (cacheResult && transformSubmodel.GetOutputs().size() == 1)
     {
-        dataCache.SetCachedData(submodelOutput, result);
+        dataCache.SetCachedData(submodelOutput, result, computeTime);
     }
     return result;
 }
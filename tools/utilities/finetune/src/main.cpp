@@ -105,6 +105,7 @@ void Run(const FineTuneArguments& args)
     report.WriteTiming("LoadDatasetsTime", loadDatasetTimer.Elapsed());
     report.WriteTiming("DataTransformTime", fineTunedOutputs.dataTransformTime);
     report.WriteTiming("OptimizationTime", fineTunedOutputs.optimizationTime);
+    report.WriteTiming("CacheTimeSaved", fineTunedOutputs.cacheTimeSaved);
     report.WriteTiming("TotalFineTuningTime", fineTuningTotalTimer.Elapsed());
     report.WriteTiming("EvalModelTime", evalModelTimer.Elapsed());
     report.WriteTiming("TotalTime", totalTimer.Elapsed());
@@ -150,7 +151,7 @@ void SaveModel(const model::OutputPortBase& output, const FineTuneArguments& arg
 {
     if (!args.mapSaveArguments.outputMapFilename.empty())
     {
-        SaveModel(output, args.mapSaveArguments.outputMapFilename);
+        SaveModel(output, args.mapSaveArguments.outputMapFilename, args.mapSaveArguments.outputMapFormat);
     }
 }
 } // namespace ell
@@ -14,4 +14,6 @@ void TestModelOutputDataCache();
 // Individual tests
 void TestModelOutputDataCache_CreateAndPopulate();
 void TestModelOutputDataCache_FindNearestCachedOutput();
+void TestModelOutputDataCache_MemoryLimit();
+void TestModelOutputDataCache_SpillToDisk();
 void TestModelOutputDataCache_TransformWithCache();
@@ -10,3 +10,6 @@
 
 // Main driver function
 void TestOptimizationUtils();
+
+// Individual tests
+void TestTrainIndependentFiltersInParallel();
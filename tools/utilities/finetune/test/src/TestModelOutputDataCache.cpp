@@ -20,6 +20,7 @@
 #include <testing/include/testing.h>
 
 #include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
 
 // stl
 #include <algorithm>
@@ -47,6 +48,41 @@ UnlabeledDataContainer GetTestDataset()
     return result;
 }
 
+// A dataset where half of the values are zero, like the output of a ReLU
+UnlabeledDataContainer GetSparseTestDataset()
+{
+    UnlabeledDataContainer result;
+    std::vector<float> row(10);
+
+    const int numRows = 12;
+    for (int i = 0; i < numRows; ++i)
+    {
+        for (int j = 0; j < static_cast<int>(row.size()); ++j)
+        {
+            row[j] = ((i + j) % 4 < 2) ? 0.0f : static_cast<float>(i - j);
+        }
+        result.Add({ row });
+    }
+
+    return result;
+}
+
+bool IsEqual(const UnlabeledDataContainer& a, const UnlabeledDataContainer& b)
+{
+    if (a.Size() != b.Size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.Size(); ++i)
+    {
+        if (!(a[i] == b[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 Model GetLinearTestModel()
 {
     //  in -> sqrt -> square
@@ -87,6 +123,8 @@ void TestModelOutputDataCache()
 {
     FailOnException(TestModelOutputDataCache_CreateAndPopulate);
     FailOnException(TestModelOutputDataCache_FindNearestCachedOutput);
+    FailOnException(TestModelOutputDataCache_MemoryLimit);
+    FailOnException(TestModelOutputDataCache_SpillToDisk);
 }
 
 void TestModelOutputDataCache_CreateAndPopulate()
@@ -143,3 +181,56 @@ void TestModelOutputDataCache_FindNearestCachedOutput()
 
     ProcessTest("Testing FindNearestCachedOutput", cache.FindNearestCachedOutputPort(outputPorts[3]) == outputPorts[1]);
 }
+
+void TestModelOutputDataCache_MemoryLimit()
+{
+    auto model = GetLinearTestModel();
+    auto data = GetTestDataset();
+    auto outputPorts = GetModelOutputPorts(model);
+    const size_t dataSize = data.Size() * data[0].Size() * sizeof(float);
+
+    // Room for 2 entries, and evicted entries are discarded
+    ModelOutputDataCache cache(0, 2 * dataSize);
+    cache.SetCachedData(outputPorts[0], data);
+    cache.SetCachedData(outputPorts[1], data);
+    ProcessTest("Testing memory usage of ModelOutputDataCache", cache.GetMemoryUsage() == 2 * dataSize);
+
+    cache.GetCachedData(outputPorts[0]);
+    cache.SetCachedData(outputPorts[2], data);
+    ProcessTest("Testing ModelOutputDataCache evicts least-recently-used entry when over its memory limit",
+                cache.HasCachedData(outputPorts[0]) && !cache.HasCachedData(outputPorts[1]) && cache.HasCachedData(outputPorts[2]));
+    ProcessTest("Testing memory usage of ModelOutputDataCache after eviction", cache.GetMemoryUsage() == 2 * dataSize);
+}
+
+void TestModelOutputDataCache_SpillToDisk()
+{
+    auto model = GetLinearTestModel();
+    auto data = GetSparseTestDataset();
+    auto outputPorts = GetModelOutputPorts(model);
+    const size_t dataSize = data.Size() * data[0].Size() * sizeof(float);
+    auto spillDirectory = utilities::JoinPaths(utilities::GetWorkingDirectory(), "finetune_test_cache");
+    utilities::DeleteDirectory(spillDirectory);
+
+    {
+        // Room for 1 entry, and evicted entries are written to disk
+        ModelOutputDataCache cache(0, dataSize, spillDirectory);
+        cache.SetCachedData(outputPorts[0], data);
+        cache.SetCachedData(outputPorts[1], GetTestDataset());
+        cache.SetCachedData(outputPorts[2], data);
+        ProcessTest("Testing ModelOutputDataCache keeps spilled entries",
+                    cache.HasCachedData(outputPorts[0]) && cache.HasCachedData(outputPorts[1]) && cache.HasCachedData(outputPorts[2]));
+        ProcessTest("Testing number of spilled entries", cache.NumSpilledEntries() == 2);
+        ProcessTest("Testing memory usage of ModelOutputDataCache with spilled entries", cache.GetMemoryUsage() == dataSize);
+
+        ProcessTest("Testing GetCachedData on a spilled entry", IsEqual(cache.GetCachedData(outputPorts[0]), data));
+        ProcessTest("Testing number of spilled entries after reading one", cache.NumSpilledEntries() == 2);
+
+        cache.Prefetch(outputPorts[1]);
+        ProcessTest("Testing memory usage of ModelOutputDataCache while prefetching", cache.GetMemoryUsage() <= dataSize);
+        ProcessTest("Testing GetCachedData on a prefetched entry", IsEqual(cache.GetCachedData(outputPorts[1]), GetTestDataset()));
+        ProcessTest("Testing memory usage of ModelOutputDataCache after prefetching", cache.GetMemoryUsage() <= dataSize);
+        ProcessTest("Testing GetCachedData on an entry that was evicted again", IsEqual(cache.GetCachedData(outputPorts[0]), data));
+    }
+
+    utilities::DeleteDirectory(spillDirectory);
+}
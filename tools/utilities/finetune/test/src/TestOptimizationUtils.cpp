@@ -8,6 +8,9 @@
 
 #include "TestOptimizationUtils.h"
 
+#include "DataUtils.h"
+#include "OptimizationUtils.h"
+
 #include <math/include/Matrix.h>
 
 #include <testing/include/testing.h>
@@ -23,9 +26,71 @@
 using namespace ell;
 using namespace ell::testing;
 
+namespace
+{
+// A dataset whose outputs are (noisy) linear functions of its inputs
+VectorLabelDataContainer GetLinearTestDataset(int numRows, int inputSize, int outputSize)
+{
+    auto randomEngine = utilities::GetRandomEngine("123");
+    std::uniform_real_distribution<float> uniform(-1, 1);
+    auto random = [&]() { return uniform(randomEngine); };
+
+    std::vector<std::vector<float>> weights(outputSize, std::vector<float>(inputSize));
+    for (auto& row : weights)
+    {
+        std::generate(row.begin(), row.end(), random);
+    }
+
+    UnlabeledDataContainer features;
+    UnlabeledDataContainer labels;
+    std::vector<float> input(inputSize);
+    std::vector<float> output(outputSize);
+    for (int rowIndex = 0; rowIndex < numRows; ++rowIndex)
+    {
+        std::generate(input.begin(), input.end(), random);
+        for (int i = 0; i < outputSize; ++i)
+        {
+            output[i] = 0.1f * random();
+            for (int j = 0; j < inputSize; ++j)
+            {
+                output[i] += weights[i][j] * input[j];
+            }
+        }
+        features.Add({ input });
+        labels.Add({ output });
+    }
+    return CreateVectorLabelDataContainer(features, labels);
+}
+
+FineTuneOptimizationParameters GetIndependentFiltersParameters(int numThreads)
+{
+    FineTuneOptimizationParameters params;
+    params.optimizerParameters.regularizationParameter = 0.001;
+    params.optimizerParameters.permuteData = true;
+    params.lossFunction = LossFunction::square;
+    params.l1Regularization.reset();
+    params.maxEpochs = 10;
+    params.desiredPrecision = 1e-5;
+    params.optimizeFiltersIndependently = true;
+    params.numThreads = numThreads;
+    params.randomSeed = "ABCDEFG";
+    return params;
+}
+} // namespace
+
 void TestOptimizationUtils()
 {
-    NoFailOnUnimplemented([]() {
-        throw TestNotImplementedException("TestOptimizationUtils");
-    });
+    FailOnException(TestTrainIndependentFiltersInParallel);
+}
+
+void TestTrainIndependentFiltersInParallel()
+{
+    auto dataset = GetLinearTestDataset(200, 8, 5);
+    auto serialResult = GetWeightsAndBias<float>(TrainVectorPredictor(dataset, GetIndependentFiltersParameters(1), false).predictor);
+    auto parallelResult = GetWeightsAndBias<float>(TrainVectorPredictor(dataset, GetIndependentFiltersParameters(3), false).predictor);
+
+    ProcessTest("Testing parallel optimization of independent filters weights",
+                IsEqual(serialResult.weights.ReferenceAsVector().ToArray(), parallelResult.weights.ReferenceAsVector().ToArray(), 0.0f));
+    ProcessTest("Testing parallel optimization of independent filters bias",
+                IsEqual(serialResult.bias.ToArray(), parallelResult.bias.ToArray(), 0.0f));
 }
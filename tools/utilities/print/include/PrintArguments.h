@@ -24,6 +24,7 @@ struct PrintArguments
     bool compile;
     bool includeNodeId;
     bool nodeDetails;
+    bool criticalPath;
     utilities::OutputStreamImpostor outputStream;
 };
 
@@ -20,4 +20,5 @@ struct PrintModelOptions
     bool nodeDetails = true;
 };
 void PrintModel(const model::Model& model, std::ostream& out, const PrintModelOptions& options);
+void PrintCriticalPath(const model::Model& model, std::ostream& out, const PrintModelOptions& options);
 } // namespace ell
@@ -20,6 +20,7 @@ void ParsedPrintArguments::AddArgs(utilities::CommandLineParser& parser)
     parser.AddOption(compile, "compile", "c", "If true, the model is compiled before being printed", false);
     parser.AddOption(includeNodeId, "includeNodeId", "incid", "Include the node id in the print", false);
     parser.AddOption(nodeDetails, "nodeDetails", "", "Include node details", true);
+    parser.AddOption(criticalPath, "criticalPath", "cp", "Print the model's critical path and how much of it can run in parallel", false);
 }
 
 utilities::CommandLineParseResult ParsedPrintArguments::PostProcess(const utilities::CommandLineParser& parser)
@@ -15,6 +15,7 @@
 #include <model/include/InputPort.h>
 #include <model/include/Model.h>
 #include <model/include/Node.h>
+#include <model/include/NodeScheduler.h>
 
 #include <nodes/include/NeuralNetworkPredictorNode.h>
 
@@ -131,4 +132,26 @@ void PrintModel(const model::Model& model, std::ostream& out, const PrintModelOp
 {
     model.Visit([&out, options](const model::Node& node) { PrintNode(node, out, options); });
 }
+
+void PrintCriticalPath(const model::Model& model, std::ostream& out, const PrintModelOptions& options)
+{
+    // Costs are estimated as the number of output values each node computes
+    model::NodeScheduler scheduler(model);
+    const auto& criticalPath = scheduler.GetCriticalPath();
+    auto criticalPathCost = scheduler.GetCriticalPathCost();
+    auto totalCost = scheduler.GetTotalCost();
+
+    out << std::endl;
+    out << "Critical path: " << criticalPath.size() << " of " << scheduler.NumNodes() << " nodes, cost " << criticalPathCost << " of " << totalCost << std::endl;
+    if (criticalPathCost > 0)
+    {
+        out << "Maximum speedup from running independent branches in parallel: " << static_cast<double>(totalCost) / criticalPathCost << std::endl;
+    }
+    out << "Stages: " << scheduler.GetStages().size() << " (" << scheduler.NumParallelStages() << " parallel)" << std::endl;
+    for (auto node : criticalPath)
+    {
+        out << "  [" << model::GetNodeCostEstimate(*node) << "] ";
+        PrintNode(*node, out, { options.includeNodeId, false });
+    }
+}
 } // namespace ell
@@ -132,6 +132,11 @@ int main(int argc, char* argv[])
         {
             PrintModel(model, out, { printArguments.includeNodeId, printArguments.nodeDetails });
         }
+
+        if (printArguments.criticalPath)
+        {
+            PrintCriticalPath(model, out, { printArguments.includeNodeId, printArguments.nodeDetails });
+        }
     }
     catch (const utilities::CommandLineParserPrintHelpException& exception)
     {
@@ -20,5 +20,9 @@ model::Map GenerateTreeModel(size_t numSplits);
 model::Map GenerateBinaryConvolutionModel(size_t imageRows, size_t imageColumns, size_t numChannels, size_t numFilters);
 model::Map GenerateBinaryConvolutionPlusDenseModel(size_t imageRows, size_t imageColumns, size_t numChannels, size_t numFilters, size_t numOutputs);
 model::Map GenerateBinaryDarknetLikeModel(bool lastLayerReal = false);
+model::Map GenerateConvolutionalLayerModel(size_t imageRows, size_t imageColumns, size_t numChannels, size_t numFilters);
 model::Map GenerateConvolutionModel(int inputRows, int inputColumns, int numChannels, int numFilters, int filterSize, int stride, dsp::ConvolutionMethodOption convolutionMethod);
+
+// Linear algebra
+model::Map GenerateMatrixMultiplyModel(int m, int n, int k);
 } // namespace ell
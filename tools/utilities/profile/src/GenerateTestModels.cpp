@@ -11,8 +11,10 @@
 #include <math/include/Tensor.h>
 
 #include <nodes/include/BroadcastFunctionNode.h>
+#include <nodes/include/ConstantNode.h>
 #include <nodes/include/DiagonalConvolutionNode.h>
 #include <nodes/include/ForestPredictorNode.h>
+#include <nodes/include/MatrixMatrixMultiplyNode.h>
 #include <nodes/include/NeuralNetworkPredictorNode.h>
 #include <nodes/include/ReinterpretLayoutNode.h>
 #include <nodes/include/SimpleConvolutionNode.h>
@@ -196,6 +198,50 @@ model::Map GenerateBinaryConvolutionModel(size_t imageRows, size_t imageColumns,
     return map;
 }
 
+model::Map GenerateConvolutionalLayerModel(size_t imageRows, size_t imageColumns, size_t numChannels, size_t numFilters)
+{
+    using namespace predictors::neural;
+
+    using ElementType = float;
+    using InputParameters = typename InputLayer<ElementType>::InputParameters;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using Shape = typename Layer<ElementType>::Shape;
+
+    const size_t k = 3;
+    const size_t stride = 1;
+    const size_t inputPaddingSize = 1;
+    const size_t outputPaddingSize = 0;
+    const auto paddingScheme = PaddingScheme::zeros;
+
+    typename predictors::NeuralNetworkPredictor<ElementType>::InputLayerReference inputLayer;
+    typename predictors::NeuralNetworkPredictor<ElementType>::Layers layers;
+
+    Shape inputShape = { imageRows, imageColumns, numChannels };
+    Shape paddedInputShape = { imageRows + 2 * inputPaddingSize, imageColumns + 2 * inputPaddingSize, numChannels };
+    Shape outputShape = { imageRows + 2 * outputPaddingSize, imageColumns + 2 * outputPaddingSize, numFilters };
+
+    // Input layer
+    InputParameters inputParams = { inputShape, NoPadding(), paddedInputShape, { paddingScheme, inputPaddingSize }, 1 };
+    inputLayer = std::make_unique<InputLayer<ElementType>>(inputParams);
+
+    LayerParameters layerParams{ inputLayer->GetOutput(), { paddingScheme, inputPaddingSize }, outputShape, { paddingScheme, outputPaddingSize } };
+    ConvolutionalParameters convolutionalParams{ k, stride, ConvolutionMethod::automatic, 1 };
+    TensorType convWeights(convolutionalParams.receptiveField * outputShape.NumChannels(), convolutionalParams.receptiveField, numChannels);
+    FillRandomTensor(convWeights);
+
+    layers.push_back(std::unique_ptr<Layer<ElementType>>(new ConvolutionalLayer<ElementType>(layerParams, convolutionalParams, convWeights)));
+
+    predictors::NeuralNetworkPredictor<ElementType> neuralNetwork(std::move(inputLayer), std::move(layers));
+
+    // Create model
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(GetShapeSize(neuralNetwork.GetInputShape()));
+    const auto& predictor = nodes::NeuralNetwork(inputNode->output, neuralNetwork);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", predictor } });
+    return map;
+}
+
 model::Map GenerateBinaryConvolutionPlusDenseModel(size_t imageRows, size_t imageColumns, size_t numChannels, size_t numFilters, size_t numOutputs)
 {
     using ElementType = float;
@@ -601,4 +647,23 @@ model::Map GenerateConvolutionModel(int inputRows, int inputColumns, int numChan
     return map;
 }
 
+//
+// Linear algebra
+//
+
+model::Map GenerateMatrixMultiplyModel(int m, int n, int k)
+{
+    using ValueType = float;
+
+    // Multiply an m x k input matrix by a constant k x n matrix
+    auto matrixB = GetRandomVector<std::vector<ValueType>>(k * n);
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(m * k);
+    auto matrixBNode = model.AddNode<nodes::ConstantNode<ValueType>>(matrixB);
+    auto multiplyNode = model.AddNode<nodes::MatrixMatrixMultiplyNode<ValueType>>(inputNode->output, m, n, k, k, matrixBNode->output, n, n);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", multiplyNode->output } });
+    return map;
+}
+
 } // namespace ell
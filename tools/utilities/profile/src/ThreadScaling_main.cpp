@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ThreadScaling_main.cpp (profile)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GenerateTestModels.h"
+
+#include <model/include/IRCompiledMap.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/Map.h>
+
+#include <passes/include/StandardTransformations.h>
+
+#include <utilities/include/CommandLineParser.h>
+#include <utilities/include/Exception.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ell;
+
+// Compiles `map` with the given thread settings and returns the average time per evaluation, in milliseconds
+double TimeCompiledMap(const model::Map& map, int numThreads, bool useWorkStealing, int numIterations, int numBurnInIterations)
+{
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = true;
+    settings.compilerSettings.useBlas = false; // BLAS has its own threading, which would hide ours
+    settings.compilerSettings.parallelize = numThreads > 1;
+    settings.compilerSettings.useThreadPool = true;
+    settings.compilerSettings.maxThreads = numThreads;
+    settings.compilerSettings.useWorkStealing = useWorkStealing;
+
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+
+    std::vector<float> input(compiledMap.GetInputSize(), 1.0f);
+    for (int iter = 0; iter < numBurnInIterations; ++iter)
+    {
+        compiledMap.Compute<float>(input);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int iter = 0; iter < numIterations; ++iter)
+    {
+        compiledMap.Compute<float>(input);
+    }
+    auto elapsed = std::chrono::high_resolution_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count() / numIterations;
+}
+
+void PrintScaling(const std::string& modelName, const model::Map& map, int maxThreads, int numIterations, int numBurnInIterations)
+{
+    std::cout << modelName << std::endl;
+    std::cout << "threads\tstatic (ms)\tspeedup\tstealing (ms)\tspeedup" << std::endl;
+
+    double baselineTime = 0;
+    for (int numThreads = 1; numThreads <= maxThreads; ++numThreads)
+    {
+        auto staticTime = TimeCompiledMap(map, numThreads, false, numIterations, numBurnInIterations);
+        auto stealingTime = TimeCompiledMap(map, numThreads, true, numIterations, numBurnInIterations);
+        if (numThreads == 1)
+        {
+            baselineTime = staticTime;
+        }
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << numThreads << "\t"
+                  << staticTime << "\t" << baselineTime / staticTime << "\t"
+                  << stealingTime << "\t" << baselineTime / stealingTime << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        int maxThreads = 4;
+        int numIterations = 20;
+        int numBurnInIterations = 2;
+
+        utilities::CommandLineParser commandLineParser(argc, argv);
+        commandLineParser.AddOption(maxThreads, "maxThreads", "th", "Largest number of threads to measure", 4);
+        commandLineParser.AddOption(numIterations, "numIterations", "n", "Number of timed evaluations of each model", 20);
+        commandLineParser.AddOption(numBurnInIterations, "burnIn", "", "Number of evaluations to run before timing", 2);
+        commandLineParser.Parse();
+
+        passes::AddStandardTransformationsToRegistry();
+
+        PrintScaling("MatrixMatrixMultiplyNode (256x256x256)", GenerateMatrixMultiplyModel(256, 256, 256), maxThreads, numIterations, numBurnInIterations);
+        PrintScaling("ConvolutionalLayerNode (64x64x32 -> 64x64x64)", GenerateConvolutionalLayerModel(64, 64, 32, 64), maxThreads, numIterations, numBurnInIterations);
+    }
+    catch (const utilities::CommandLineParserPrintHelpException& exception)
+    {
+        std::cout << exception.GetHelpText() << std::endl;
+        return 0;
+    }
+    catch (const utilities::CommandLineParserErrorException& exception)
+    {
+        std::cerr << "Command line parse error:" << std::endl;
+        for (const auto& error : exception.GetParseErrors())
+        {
+            std::cerr << error.GetMessage() << std::endl;
+        }
+        return 1;
+    }
+    catch (utilities::Exception& exception)
+    {
+        std::cerr << "Exception: " << exception.GetMessage() << std::endl;
+        return 1;
+    }
+    catch (std::exception& exception)
+    {
+        std::cerr << "Exception: " << exception.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,45 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizeArguments.h (quantize)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <utilities/include/CommandLineParser.h>
+
+#include <cstddef>
+
+namespace ell
+{
+/// <summary> Command line arguments for the quantize executable. </summary>
+struct QuantizeArguments
+{
+    /// <summary> The maximum number of examples to calibrate the map with. </summary>
+    size_t maxCalibrationExamples = 100;
+
+    /// <summary> Compile the original and quantized maps, and report how their outputs and speed compare. </summary>
+    bool evaluate = true;
+
+    /// <summary> The number of times each compiled map is run on each example when measuring its speed. </summary>
+    size_t numTimingIterations = 10;
+};
+
+/// <summary> Parsed command line arguments for the quantize executable. </summary>
+struct ParsedQuantizeArguments : public QuantizeArguments
+    , public utilities::ParsedArgSet
+{
+    /// <summary> Adds the arguments to the command line parser. </summary>
+    ///
+    /// <param name="parser"> [in,out] The parser. </param>
+    void AddArgs(utilities::CommandLineParser& parser) override;
+
+    /// <summary> Check the parsed arguments. </summary>
+    ///
+    /// <param name="parser"> The parser. </param>
+    ///
+    /// <returns> An utilities::CommandLineParseResult. </returns>
+    utilities::CommandLineParseResult PostProcess(const utilities::CommandLineParser& parser) override;
+};
+} // namespace ell
@@ -0,0 +1,49 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizeArguments.cpp (quantize)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizeArguments.h"
+
+namespace ell
+{
+void ParsedQuantizeArguments::AddArgs(utilities::CommandLineParser& parser)
+{
+    parser.AddOption(
+        maxCalibrationExamples,
+        "maxCalibrationExamples",
+        "mce",
+        "Maximum number of examples from the dataset used to measure the range of each layer's input.",
+        100);
+
+    parser.AddOption(
+        evaluate,
+        "evaluate",
+        "e",
+        "Compile the original and quantized maps and report their difference in accuracy and speed on the calibration examples.",
+        true);
+
+    parser.AddOption(
+        numTimingIterations,
+        "numTimingIterations",
+        "nti",
+        "Number of times each compiled map is run on each example when measuring its speed.",
+        10);
+}
+
+utilities::CommandLineParseResult ParsedQuantizeArguments::PostProcess(const utilities::CommandLineParser& parser)
+{
+    std::vector<std::string> errors;
+    if (maxCalibrationExamples == 0)
+    {
+        errors.push_back("maxCalibrationExamples must be greater than zero");
+    }
+    if (numTimingIterations == 0)
+    {
+        errors.push_back("numTimingIterations must be greater than zero");
+    }
+    return errors;
+}
+} // namespace ell
@@ -0,0 +1,206 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     main.cpp (quantize)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizeArguments.h"
+
+#include <utilities/include/CommandLineParser.h>
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+
+#include <data/include/DataVector.h>
+#include <data/include/Example.h>
+
+#include <common/include/DataLoadArguments.h>
+#include <common/include/DataLoaders.h>
+#include <common/include/LoadModel.h>
+#include <common/include/MapCompilerArguments.h>
+#include <common/include/MapLoadArguments.h>
+#include <common/include/MapSaveArguments.h>
+
+#include <model/include/IRCompiledMap.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/Map.h>
+
+#include <passes/include/QuantizationCalibrator.h>
+#include <passes/include/StandardTransformations.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ell;
+
+namespace
+{
+struct EvaluationResult
+{
+    std::vector<std::vector<double>> outputs;
+    double millisecondsPerExample = 0;
+};
+
+model::IRCompiledMap CompileMap(const model::Map& map, const common::MapCompilerArguments& mapCompilerArguments, const std::string& name, bool quantize)
+{
+    model::MapCompilerOptions settings = mapCompilerArguments.GetMapCompilerOptions(name);
+    auto optimizerOptions = mapCompilerArguments.GetModelOptimizerOptions();
+    optimizerOptions["quantizeInt8"] = quantize;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    return compiler.Compile(map);
+}
+
+EvaluationResult Evaluate(model::IRCompiledMap& compiledMap, const std::vector<std::vector<double>>& examples, size_t numTimingIterations)
+{
+    EvaluationResult result;
+    for (const auto& example : examples)
+    {
+        result.outputs.push_back(compiledMap.Compute<data::DoubleDataVector>(data::DoubleDataVector(example)).ToArray());
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t iteration = 0; iteration < numTimingIterations; ++iteration)
+    {
+        for (const auto& example : examples)
+        {
+            compiledMap.Compute<data::DoubleDataVector>(data::DoubleDataVector(example));
+        }
+    }
+    auto elapsed = std::chrono::high_resolution_clock::now() - start;
+    result.millisecondsPerExample = std::chrono::duration<double, std::milli>(elapsed).count() / (numTimingIterations * examples.size());
+    return result;
+}
+
+size_t ArgMax(const std::vector<double>& values)
+{
+    return static_cast<size_t>(std::distance(values.begin(), std::max_element(values.begin(), values.end())));
+}
+
+void PrintComparison(const EvaluationResult& reference, const EvaluationResult& quantized, std::ostream& out)
+{
+    double maxError = 0;
+    double totalError = 0;
+    size_t numValues = 0;
+    size_t numSameArgMax = 0;
+    for (size_t exampleIndex = 0; exampleIndex < reference.outputs.size(); ++exampleIndex)
+    {
+        const auto& referenceOutput = reference.outputs[exampleIndex];
+        const auto& quantizedOutput = quantized.outputs[exampleIndex];
+        for (size_t index = 0; index < referenceOutput.size(); ++index)
+        {
+            auto error = std::abs(referenceOutput[index] - quantizedOutput[index]);
+            maxError = std::max(maxError, error);
+            totalError += error;
+            ++numValues;
+        }
+        if (!referenceOutput.empty() && ArgMax(referenceOutput) == ArgMax(quantizedOutput))
+        {
+            ++numSameArgMax;
+        }
+    }
+
+    out << "Max absolute error:\t" << maxError << std::endl;
+    out << "Mean absolute error:\t" << (numValues == 0 ? 0.0 : totalError / numValues) << std::endl;
+    out << "Top-1 agreement:\t" << numSameArgMax << " / " << reference.outputs.size() << std::endl;
+    out << "Float time (ms/example):\t" << reference.millisecondsPerExample << std::endl;
+    out << "Int8 time (ms/example):\t" << quantized.millisecondsPerExample << std::endl;
+    if (quantized.millisecondsPerExample > 0)
+    {
+        out << "Speedup:\t" << reference.millisecondsPerExample / quantized.millisecondsPerExample << std::endl;
+    }
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        // create a command line parser
+        utilities::CommandLineParser commandLineParser(argc, argv);
+
+        // add arguments to the command line parser
+        common::ParsedDataLoadArguments dataLoadArguments;
+        common::ParsedMapLoadArguments mapLoadArguments;
+        common::ParsedMapSaveArguments mapSaveArguments;
+        common::ParsedMapCompilerArguments mapCompilerArguments;
+        ParsedQuantizeArguments quantizeArguments;
+
+        commandLineParser.AddOptionSet(dataLoadArguments);
+        commandLineParser.AddOptionSet(mapLoadArguments);
+        commandLineParser.AddOptionSet(mapSaveArguments);
+        commandLineParser.AddOptionSet(mapCompilerArguments);
+        commandLineParser.AddOptionSet(quantizeArguments);
+
+        // parse command line
+        commandLineParser.Parse();
+
+        // load map
+        auto map = common::LoadMap(mapLoadArguments);
+        passes::QuantizationCalibrator calibrator(map);
+
+        // get the calibration examples
+        auto stream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
+        auto exampleIterator = common::GetAutoSupervisedExampleIterator(stream);
+        std::vector<std::vector<double>> examples;
+        while (exampleIterator.IsValid() && examples.size() < quantizeArguments.maxCalibrationExamples)
+        {
+            examples.push_back(exampleIterator.Get().GetDataVector().ToArray(map.GetInputSize()));
+            exampleIterator.Next();
+        }
+
+        if (examples.empty())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The dataset has no examples to calibrate with");
+        }
+
+        for (const auto& example : examples)
+        {
+            calibrator.AddExample(example);
+        }
+        const auto& calibratedMap = calibrator.GetCalibratedMap();
+
+        // When the map is written to standard out, keep the report out of it
+        auto& reportStream = mapSaveArguments.outputMapFilename.empty() ? std::cerr : std::cout;
+        reportStream << "Calibrated " << calibrator.NumQuantizableNodes() << " quantizable nodes on " << calibrator.NumExamples() << " examples" << std::endl;
+
+        if (mapSaveArguments.hasOutputStream)
+        {
+            common::SaveMap(calibratedMap, mapSaveArguments.outputMapStream, mapSaveArguments.outputMapFormat);
+        }
+
+        if (quantizeArguments.evaluate)
+        {
+            passes::AddStandardTransformationsToRegistry();
+            auto referenceMap = CompileMap(calibratedMap, mapCompilerArguments, "reference", false);
+            auto quantizedMap = CompileMap(calibratedMap, mapCompilerArguments, "quantized", true);
+            auto referenceResult = Evaluate(referenceMap, examples, quantizeArguments.numTimingIterations);
+            auto quantizedResult = Evaluate(quantizedMap, examples, quantizeArguments.numTimingIterations);
+            PrintComparison(referenceResult, quantizedResult, reportStream);
+        }
+    }
+    catch (const utilities::CommandLineParserPrintHelpException& exception)
+    {
+        std::cout << exception.GetHelpText() << std::endl;
+        return 0;
+    }
+    catch (const utilities::CommandLineParserErrorException& exception)
+    {
+        std::cerr << "Command line parse error:" << std::endl;
+        for (const auto& error : exception.GetParseErrors())
+        {
+            std::cerr << error.GetMessage() << std::endl;
+        }
+        return 1;
+    }
+    catch (const utilities::Exception& exception)
+    {
+        std::cerr << "exception: " << exception.GetMessage() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}